@@ -27,6 +27,7 @@
 //  THE SOFTWARE.
 
 #import "DSDerivationPath.h"
+#import "DSMerkleTree.h"
 #import "NSData+DSHash.h"
 #import "NSData+Dash.h"
 #import "NSError+Dash.h"
@@ -1585,31 +1586,13 @@ UInt256 uInt256MultiplyUInt32LE(UInt256 a, uint32_t b) {
 }
 
 + (NSData *)merkleRootFromHashes:(NSArray *)hashes {
-    NSMutableArray *higherLevel = [NSMutableArray array];
-    NSArray *level = hashes;
     if (hashes.count == 1) return hashes[0];
     if (hashes.count == 0) return nil;
-    while (level.count != 1) {
-        for (int i = 0; i < level.count; i += 2) {
-            if ([level count] - i > 1) {
-                NSData *left = level[i + 0];
-                NSData *right = level[i + 1];
-                NSMutableData *combined = [NSMutableData data];
-                [combined appendData:left];
-                [combined appendData:right];
-                [higherLevel addObject:[NSData dataWithUInt256:combined.SHA256_2]];
-            } else {
-                NSData *left = level[i];
-                NSMutableData *combined = [NSMutableData data];
-                [combined appendData:left];
-                [combined appendData:left];
-                [higherLevel addObject:[NSData dataWithUInt256:combined.SHA256_2]];
-            }
-        }
-        level = [higherLevel copy];
-        higherLevel = [NSMutableArray array];
+    NSMutableData *leaves = [NSMutableData dataWithCapacity:hashes.count * sizeof(UInt256)];
+    for (NSData *hash in hashes) {
+        [leaves appendData:hash];
     }
-    return level[0];
+    return [NSData dataWithUInt256:[DSMerkleTree merkleRootOfHashes:leaves hashFunction:DSMerkleTreeHashFunction_SHA256_2]];
 }
 
 - (BOOL)isSizedForAddress {
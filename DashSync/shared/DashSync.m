@@ -24,6 +24,7 @@
 #import "DSQuorumSnapshotEntity+CoreDataClass.h"
 #import "DSSporkManager+Protected.h"
 #import "DSTransactionEntity+CoreDataClass.h"
+#import "DSTransactionManager+Protected.h"
 #import "NSManagedObject+Sugar.h"
 #import <BackgroundTasks/BackgroundTasks.h>
 #import <mach-o/dyld.h>
@@ -161,6 +162,7 @@ static NSString *const BG_TASK_REFRESH_IDENTIFIER = @"org.dashcore.dashsync.back
         [DSMerkleBlockEntity deleteBlocksOnChainEntity:chainEntity];
         [DSAddressEntity deleteAddressesOnChainEntity:chainEntity];
         [DSTransactionHashEntity deleteTransactionHashesOnChainEntity:chainEntity];
+        [chain.chainManager.transactionManager.seenTransactionStore removeAllTransactionHashes];
         [DSDerivationPathEntity deleteDerivationPathsOnChainEntity:chainEntity];
         [DSFriendRequestEntity deleteFriendRequestsOnChainEntity:chainEntity];
         [chain wipeBlockchainInfoInContext:context];
@@ -191,6 +193,7 @@ static NSString *const BG_TASK_REFRESH_IDENTIFIER = @"org.dashcore.dashsync.back
         chainEntity.syncLocators = nil;
         [DSAddressEntity deleteAddressesOnChainEntity:chainEntity];
         [DSTransactionHashEntity deleteTransactionHashesOnChainEntity:chainEntity];
+        [chain.chainManager.transactionManager.seenTransactionStore removeAllTransactionHashes];
         [DSDerivationPathEntity deleteDerivationPathsOnChainEntity:chainEntity];
         [DSFriendRequestEntity deleteFriendRequestsOnChainEntity:chainEntity];
         [chain wipeBlockchainNonTerminalInfoInContext:context];
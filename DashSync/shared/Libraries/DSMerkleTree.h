@@ -33,11 +33,25 @@ typedef NS_ENUM(NSInteger, DSMerkleTreeHashFunction)
 @property (nonatomic, readonly) NSData *flags;
 @property (nonatomic, readonly) UInt256 merkleRoot;
 @property (nonatomic, readonly) DSMerkleTreeHashFunction hashFunction;
+/*! @brief Whether the hashes and flags form a well formed partial tree, with every hash and flag used and no branch duplicating its left child. */
+@property (nonatomic, readonly, getter=isValid) BOOL valid;
+/*! @brief Matched element hashes packed as UInt256, in tree order. */
+@property (nonatomic, readonly) NSData *matchedHashes;
+/*! @brief Index in the tree of each matched element, packed as uint32_t. */
+@property (nonatomic, readonly) NSData *matchedPositions;
+
+/*! @brief Root of the tree over the UInt256 leaves packed in the data, built level by level in a single buffer. The last node of an odd level is paired with itself. UINT256_ZERO when there are no leaves. */
++ (UInt256)merkleRootOfHashes:(NSData *)hashes hashFunction:(DSMerkleTreeHashFunction)hashFunction;
+/*! @brief Siblings of the leaf at each level from the leaves up, packed as UInt256, nil if there is no such leaf. */
++ (NSData *_Nullable)merkleBranchOfHashes:(NSData *)hashes leafIndex:(uint32_t)leafIndex hashFunction:(DSMerkleTreeHashFunction)hashFunction;
+/*! @brief Root a branch proves for the leaf at the index, to compare with the expected root. */
++ (UInt256)merkleRootOfBranch:(NSData *)branch leaf:(UInt256)leaf leafIndex:(uint32_t)leafIndex hashFunction:(DSMerkleTreeHashFunction)hashFunction;
 
 - (instancetype)initWithHashes:(NSData *)hashes flags:(NSData *)flags treeElementCount:(uint32_t)elementCount hashFunction:(DSMerkleTreeHashFunction)hashFunction;
 
 - (NSArray *)elementHashes;
 
+/*! @brief Whether the hash is one of the elements stored in the tree, matched or not. */
 - (BOOL)containsHash:(UInt256)hash;
 
 - (BOOL)merkleTreeHasRoot:(UInt256)desiredMerkleRoot;
@@ -57,6 +57,8 @@
 // flag bits (little endian): 00001011 [merkleRoot = 1, m1 = 1, tx1 = 0, tx2 = 1, m2 = 0, byte padding = 000]
 // hashes: [tx1, tx2, m2]
 
+#define MERKLE_TREE_MAX_HEIGHT 32
+
 inline static int ceil_log2(int x) {
     int r = (x & (x - 1)) ? 1 : 0;
 
@@ -64,6 +66,46 @@ inline static int ceil_log2(int x) {
     return r;
 }
 
+// number of nodes at the given height above the leaves
+inline static uint64_t merkle_tree_width(uint32_t elementCount, int height) {
+    return ((uint64_t)elementCount + (1ULL << height) - 1) >> height;
+}
+
+inline static int compare_uint256(const void *a, const void *b) {
+    return memcmp(a, b, sizeof(UInt256));
+}
+
+// hashes two sibling nodes laid out next to each other
+static UInt256 merkle_hash_pair(const uint8_t *pair, DSMerkleTreeHashFunction hashFunction) {
+    UInt256 hash;
+    switch (hashFunction) {
+        case DSMerkleTreeHashFunction_BLAKE3:
+            return [NSData dataWithBytesNoCopy:(void *)pair length:sizeof(UInt256) * 2 freeWhenDone:NO].blake3;
+        case DSMerkleTreeHashFunction_SHA256_2:
+        default:
+            SHA256(&hash, pair, sizeof(UInt256) * 2);
+            SHA256(&hash, &hash, sizeof(hash));
+            return hash;
+    }
+}
+
+// builds each level over the one below it in the same buffer, which holds the leaves and room for one more node to
+// duplicate the last one of odd levels. The sibling of the leaf at leafIndex is collected at each level when a branch is given
+static UInt256 merkle_root_in_place(UInt256 *nodes, NSUInteger count, NSUInteger leafIndex, UInt256 *branch, NSUInteger *branchLength, DSMerkleTreeHashFunction hashFunction) {
+    NSUInteger index = leafIndex, depth = 0;
+    while (count > 1) {
+        if (count & 1) nodes[count] = nodes[count - 1];
+        if (branch) branch[depth++] = nodes[index ^ 1];
+        for (NSUInteger i = 0; i < count; i += 2) {
+            nodes[i / 2] = merkle_hash_pair((const uint8_t *)&nodes[i], hashFunction);
+        }
+        count = (count + 1) / 2;
+        index /= 2;
+    }
+    if (branchLength) *branchLength = depth;
+    return nodes[0];
+}
+
 @interface DSMerkleTree ()
 
 @property (nonatomic, assign) uint32_t treeElementCount;
@@ -71,6 +113,15 @@ inline static int ceil_log2(int x) {
 @property (nonatomic, strong) NSData *flags;
 @property (nonatomic, assign) DSMerkleTreeHashFunction hashFunction;
 
+@property (nonatomic, assign) BOOL decoded;
+@property (nonatomic, assign) BOOL decodedValid;
+@property (nonatomic, assign) UInt256 decodedMerkleRoot;
+@property (nonatomic, strong) NSData *decodedMatchedHashes;
+@property (nonatomic, strong) NSData *decodedMatchedPositions;
+@property (nonatomic, strong) NSArray *decodedElementHashes;
+// hashes stored at the leaf level, matched or not, sorted for lookups
+@property (nonatomic, strong) NSData *sortedLeafHashes;
+
 @end
 
 @implementation DSMerkleTree
@@ -102,100 +153,186 @@ inline static int ceil_log2(int x) {
 
 // true if the given tx hash is included in the block
 - (BOOL)containsHash:(UInt256)hash {
-    for (NSUInteger i = 0; i < self.hashes.length; i += sizeof(UInt256)) {
-        if (uint256_eq(hash, [self.hashes UInt256AtOffset:i])) return YES;
-    }
-
-    return NO;
+    [self decodeIfNeeded];
+    NSData *leafHashes = self.sortedLeafHashes;
+    return bsearch(&hash, leafHashes.bytes, leafHashes.length / sizeof(UInt256), sizeof(UInt256), compare_uint256) != NULL;
 }
 
 // returns an array of the matched tx hashes
 - (NSArray *)elementHashes {
-    int hashIdx = 0, flagIdx = 0;
-    NSArray *hashes =
-        [self walkHashIdx:&hashIdx
-            flagIdx:&flagIdx
-            depth:0
-            leaf:^id(id hash, BOOL flag) {
-                return (flag && hash) ? @[hash] : @[];
-            }
-            branch:^id(id left, id right) {
-                return [left arrayByAddingObjectsFromArray:right];
-            }];
+    [self decodeIfNeeded];
+    return self.decodedElementHashes;
+}
 
-    return hashes;
+- (NSData *)matchedHashes {
+    [self decodeIfNeeded];
+    return self.decodedMatchedHashes;
 }
 
-- (id)hashData:(NSMutableData *)data {
-    switch (self.hashFunction) {
-        case DSMerkleTreeHashFunction_SHA256_2:
-            return uint256_obj(data.SHA256_2);
-            break;
-        case DSMerkleTreeHashFunction_BLAKE3:
-            return uint256_obj(data.blake3);
-            break;
+- (NSData *)matchedPositions {
+    [self decodeIfNeeded];
+    return self.decodedMatchedPositions;
+}
 
-        default:
-            return uint256_obj(data.SHA256_2);
-            break;
-    }
+- (BOOL)isValid {
+    [self decodeIfNeeded];
+    return self.decodedValid;
 }
 
 - (UInt256)merkleRoot {
-    NSMutableData *d = [NSMutableData data];
-    UInt256 merkleRoot = UINT256_ZERO;
-    int hashIdx = 0, flagIdx = 0;
-    NSValue *root = [self walkHashIdx:&hashIdx
-        flagIdx:&flagIdx
-        depth:0
-        leaf:^id(id hash, BOOL flag) {
-            return hash;
-        }
-        branch:^id(id left, id right) {
-            UInt256 l, r;
-
-            if (!right) right = left; // if right branch is missing, duplicate left branch
-            [left getValue:&l];
-            [right getValue:&r];
-            d.length = 0;
-            [d appendBytes:&l length:sizeof(l)];
-            [d appendBytes:&r length:sizeof(r)];
-            return [self hashData:d];
-        }];
-
-    [root getValue:&merkleRoot];
-    return merkleRoot;
+    [self decodeIfNeeded];
+    return self.decodedMerkleRoot;
 }
 
 - (BOOL)merkleTreeHasRoot:(UInt256)desiredMerkleRoot {
     //DSLog(@"%@ - %@",uint256_hex(merkleRoot),uint256_hex(_merkleRoot));
-    if (self.treeElementCount > 0 && !uint256_eq(self.merkleRoot, desiredMerkleRoot)) return NO; // merkle root check failed
+    if (self.treeElementCount > 0 && (!self.isValid || !uint256_eq(self.merkleRoot, desiredMerkleRoot))) return NO; // merkle root check failed
     return YES;
 }
 
-// recursively walks the merkle tree in depth first order, calling leaf(hash, flag) for each stored hash, and
-// branch(left, right) with the result from each branch
-- (id)walkHashIdx:(int *)hashIdx flagIdx:(int *)flagIdx
-            depth:(int)depth
-             leaf:(id (^)(id, BOOL))leaf
-           branch:(id (^)(id, id))branch {
-    if ((*flagIdx) / 8 >= _flags.length || (*hashIdx + 1) * sizeof(UInt256) > _hashes.length) return leaf(nil, NO);
+// MARK: - Building
+
++ (UInt256)merkleRootOfHashes:(NSData *)hashes hashFunction:(DSMerkleTreeHashFunction)hashFunction {
+    NSUInteger count = hashes.length / sizeof(UInt256);
+    if (count == 0) return UINT256_ZERO;
+    NSMutableData *nodes = [NSMutableData dataWithLength:(count + 1) * sizeof(UInt256)];
+    memcpy(nodes.mutableBytes, hashes.bytes, count * sizeof(UInt256));
+    return merkle_root_in_place(nodes.mutableBytes, count, 0, NULL, NULL, hashFunction);
+}
+
++ (NSData *)merkleBranchOfHashes:(NSData *)hashes leafIndex:(uint32_t)leafIndex hashFunction:(DSMerkleTreeHashFunction)hashFunction {
+    NSUInteger count = hashes.length / sizeof(UInt256), branchLength = 0;
+    if (leafIndex >= count) return nil;
+    NSMutableData *nodes = [NSMutableData dataWithLength:(count + 1) * sizeof(UInt256)];
+    memcpy(nodes.mutableBytes, hashes.bytes, count * sizeof(UInt256));
+    NSMutableData *branch = [NSMutableData dataWithLength:(ceil_log2((int)count) + 1) * sizeof(UInt256)];
+    merkle_root_in_place(nodes.mutableBytes, count, leafIndex, branch.mutableBytes, &branchLength, hashFunction);
+    branch.length = branchLength * sizeof(UInt256);
+    return branch;
+}
+
++ (UInt256)merkleRootOfBranch:(NSData *)branch leaf:(UInt256)leaf leafIndex:(uint32_t)leafIndex hashFunction:(DSMerkleTreeHashFunction)hashFunction {
+    UInt256 pair[2], node = leaf;
+    for (NSUInteger i = 0; i < branch.length / sizeof(UInt256); i++, leafIndex >>= 1) {
+        pair[leafIndex & 1] = node;
+        memcpy(&pair[!(leafIndex & 1)], (const uint8_t *)branch.bytes + i * sizeof(UInt256), sizeof(UInt256));
+        node = merkle_hash_pair((const uint8_t *)pair, hashFunction);
+    }
+    return node;
+}
+
+// MARK: - Decoding
+
+// hashes the concatenation of two nodes, the scratch buffer is reused across the whole tree
+- (UInt256)hashLeft:(const UInt256 *)left right:(const UInt256 *)right scratch:(uint8_t *)scratch {
+    memcpy(scratch, left, sizeof(UInt256));
+    memcpy(scratch + sizeof(UInt256), right, sizeof(UInt256));
+    return merkle_hash_pair(scratch, self.hashFunction);
+}
+
+- (void)decodeIfNeeded {
+    @synchronized(self) {
+        if (!self.decoded) [self decode];
+    }
+}
+
+// walks the tree once in depth first order, with an explicit stack of at most one pending left hash per level, and
+// collects the root, the matched leaves with their positions and the leaf hashes together. Like Dash Core, the tree
+// is only valid if every hash and flag is used, and no branch has two identical children (CVE-2012-2459)
+- (void)decode {
+    self.decoded = YES;
+    self.decodedValid = NO;
+    self.decodedMerkleRoot = UINT256_ZERO;
+    self.decodedMatchedHashes = [NSData data];
+    self.decodedMatchedPositions = [NSData data];
+    self.decodedElementHashes = @[];
+    self.sortedLeafHashes = [NSData data];
 
-    BOOL flag = (((const uint8_t *)_flags.bytes)[*flagIdx / 8] & (1 << (*flagIdx % 8)));
+    const uint8_t *hashes = self.hashes.bytes, *flags = self.flags.bytes;
+    NSUInteger hashCount = self.hashes.length / sizeof(UInt256), flagCount = self.flags.length * 8;
+    uint32_t elementCount = self.treeElementCount;
+    if (self.hashes.length % sizeof(UInt256) != 0) return;
+    if (elementCount == 0 || elementCount > INT32_MAX || hashCount == 0 || hashCount > elementCount || flagCount < hashCount) return;
 
-    (*flagIdx)++;
+    int height = ceil_log2((int)elementCount);
+    NSMutableData *matchedHashes = [NSMutableData dataWithLength:hashCount * sizeof(UInt256)];
+    NSMutableData *matchedPositions = [NSMutableData dataWithLength:hashCount * sizeof(uint32_t)];
+    NSMutableData *leafHashes = [NSMutableData dataWithLength:hashCount * sizeof(UInt256)];
+    UInt256 *matchedHashBytes = matchedHashes.mutableBytes, *leafHashBytes = leafHashes.mutableBytes;
+    uint32_t *matchedPositionBytes = matchedPositions.mutableBytes;
+    NSUInteger matchedCount = 0, leafCount = 0, hashIdx = 0, flagIdx = 0;
 
-    if (!flag || depth == ceil_log2(self.treeElementCount)) {
-        UInt256 hash = [_hashes UInt256AtOffset:(*hashIdx) * sizeof(UInt256)];
+    // stack[depth] holds the left child of the branch at that depth while its right child is walked
+    UInt256 stack[MERKLE_TREE_MAX_HEIGHT + 1];
+    uint64_t positions[MERKLE_TREE_MAX_HEIGHT + 1];
+    BOOL walkingRight[MERKLE_TREE_MAX_HEIGHT + 1];
+    uint8_t scratch[sizeof(UInt256) * 2];
+    UInt256 node = UINT256_ZERO;
+    int depth = 0;
+    uint64_t position = 0;
 
-        (*hashIdx)++;
-        return leaf(uint256_obj(hash), flag);
+    BOOL walked = NO;
+    while (!walked) {
+        // descend until a node with a stored hash
+        while (YES) {
+            if (flagIdx >= flagCount) return;
+            BOOL flag = (flags[flagIdx / 8] >> (flagIdx % 8)) & 1;
+            flagIdx++;
+            if (!flag || depth == height) {
+                if (hashIdx >= hashCount) return;
+                memcpy(&node, hashes + hashIdx++ * sizeof(UInt256), sizeof(UInt256)); // message bytes may be unaligned
+                if (depth == height) {
+                    leafHashBytes[leafCount++] = node;
+                    if (flag) {
+                        matchedHashBytes[matchedCount] = node;
+                        matchedPositionBytes[matchedCount++] = (uint32_t)position;
+                    }
+                }
+                break;
+            }
+            positions[depth] = position;
+            walkingRight[depth] = NO;
+            depth++;
+            position *= 2;
+        }
+        // climb back up, hashing finished branches, until a right child is left to walk or the root is reached
+        walked = YES;
+        while (depth > 0) {
+            int parent = depth - 1;
+            if (!walkingRight[parent]) {
+                uint64_t rightPosition = positions[parent] * 2 + 1;
+                if (rightPosition < merkle_tree_width(elementCount, height - depth)) {
+                    stack[parent] = node;
+                    walkingRight[parent] = YES;
+                    position = rightPosition;
+                    walked = NO;
+                    break;
+                }
+                node = [self hashLeft:&node right:&node scratch:scratch]; // if right branch is missing, duplicate left branch
+            } else {
+                if (uint256_eq(stack[parent], node)) return;
+                node = [self hashLeft:&stack[parent] right:&node scratch:scratch];
+            }
+            depth = parent;
+        }
     }
+    if (hashIdx != hashCount || (flagIdx + 7) / 8 != self.flags.length) return;
 
-    id left = [self walkHashIdx:hashIdx flagIdx:flagIdx depth:depth + 1 leaf:leaf branch:branch];
-    id right = [self walkHashIdx:hashIdx flagIdx:flagIdx depth:depth + 1 leaf:leaf branch:branch];
+    matchedHashes.length = matchedCount * sizeof(UInt256);
+    matchedPositions.length = matchedCount * sizeof(uint32_t);
+    leafHashes.length = leafCount * sizeof(UInt256);
+    qsort(leafHashes.mutableBytes, leafCount, sizeof(UInt256), compare_uint256);
+    NSMutableArray *elementHashes = [NSMutableArray arrayWithCapacity:matchedCount];
+    for (NSUInteger i = 0; i < matchedCount; i++) {
+        [elementHashes addObject:uint256_obj(((const UInt256 *)matchedHashes.bytes)[i])];
+    }
 
-    return branch(left, right);
+    self.decodedValid = YES;
+    self.decodedMerkleRoot = node;
+    self.decodedMatchedHashes = matchedHashes;
+    self.decodedMatchedPositions = matchedPositions;
+    self.decodedElementHashes = elementHashes;
+    self.sortedLeafHashes = leafHashes;
 }
 
 - (id)copyWithZone:(NSZone *)zone {
@@ -203,6 +340,7 @@ inline static int ceil_log2(int x) {
     copy.treeElementCount = self.treeElementCount;
     copy.hashes = [self.hashes copyWithZone:zone];
     copy.flags = [self.flags copyWithZone:zone];
+    copy.hashFunction = self.hashFunction;
     return copy;
 }
 
@@ -0,0 +1,49 @@
+//
+//  DSBlockMiner.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSFullBlock;
+
+/*! @brief Mines devnet and regtest blocks on every core. The search space is the nonce extended by the timestamp, handed out to the workers in chunks of nonces from a shared counter, and each worker hashes a fixed 80 byte header it rewrites the nonce of in place. Mining stops at the first header meeting the target, on timeout or when cancelled. */
+@interface DSBlockMiner : NSObject
+
+/*! @brief Defaults to the number of active processors. */
+@property (nonatomic, assign) NSUInteger threadCount;
+
+@property (nonatomic, readonly, getter=isCancelled) BOOL cancelled;
+
+/*! @brief Set when the last mining run stopped because a header could not be hashed. */
+@property (nonatomic, readonly, getter=isFailed) BOOL failed;
+
+/*! @brief Hashes computed by the last mining run. */
+@property (nonatomic, readonly) uint64_t attempts;
+
+/*! @brief Hashes per second of the last mining run. */
+@property (nonatomic, readonly) double hashRate;
+
+/*! @brief Searches a nonce and timestamp for which the block hashes below its own target, starting at nonceOffset and the block's timestamp. On success the block's nonce, timestamp and hash are set. A timeout of 0 means no timeout. */
+- (BOOL)mineBlock:(DSFullBlock *)block withNonceOffset:(uint32_t)nonceOffset withTimeout:(NSTimeInterval)timeout;
+
+/*! @brief Stops the current run and makes every later run on this miner fail right away. */
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
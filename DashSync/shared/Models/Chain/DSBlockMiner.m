@@ -0,0 +1,141 @@
+//
+//  DSBlockMiner.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSBlockMiner.h"
+#import "DSBlock+Protected.h"
+#import "DSFullBlock.h"
+#import "DSKeyManager.h"
+#import "NSData+Dash.h"
+#import <stdatomic.h>
+
+#define BLOCK_HEADER_LENGTH 80
+#define BLOCK_HEADER_TIMESTAMP_OFFSET 68
+#define BLOCK_HEADER_NONCE_OFFSET 76
+#define MINING_CHUNK_BITS 12 // 4096 nonces, a few milliseconds of work between checks of the clock
+#define MINING_CHUNKS_PER_TIMESTAMP_BITS (32 - MINING_CHUNK_BITS)
+
+@interface DSBlockMiner () {
+    atomic_bool _cancelled;
+    atomic_bool _stopped;
+    atomic_uint_fast64_t _nextChunk;
+    atomic_uint_fast64_t _attempts;
+}
+
+@property (nonatomic, assign) double hashRate;
+@property (nonatomic, assign) BOOL found;
+@property (nonatomic, assign) BOOL failed;
+@property (nonatomic, assign) uint32_t foundNonce;
+@property (nonatomic, assign) uint32_t foundTimestamp;
+@property (nonatomic, assign) UInt256 foundBlockHash;
+
+@end
+
+@implementation DSBlockMiner
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.threadCount = [NSProcessInfo processInfo].activeProcessorCount;
+    atomic_init(&_cancelled, false);
+    atomic_init(&_stopped, false);
+    atomic_init(&_nextChunk, 0);
+    atomic_init(&_attempts, 0);
+    return self;
+}
+
+- (BOOL)isCancelled {
+    return atomic_load(&_cancelled);
+}
+
+- (uint64_t)attempts {
+    return atomic_load(&_attempts);
+}
+
+- (void)cancel {
+    atomic_store(&_cancelled, true);
+    atomic_store(&_stopped, true);
+}
+
+- (BOOL)mineBlock:(DSFullBlock *)block withNonceOffset:(uint32_t)nonceOffset withTimeout:(NSTimeInterval)timeout {
+    NSData *header = [block toData];
+    NSAssert(header.length == BLOCK_HEADER_LENGTH, @"A block header is 80 bytes");
+    if (header.length != BLOCK_HEADER_LENGTH) return NO;
+    UInt256 fullTarget = setCompactLE(block.target);
+    uint32_t baseTimestamp = block.timestamp;
+    NSTimeInterval start = [[NSDate date] timeIntervalSince1970];
+    NSTimeInterval deadline = timeout > 0 ? start + timeout : DBL_MAX;
+    @synchronized(self) {
+        self.found = NO;
+        self.failed = NO;
+        self.hashRate = 0;
+    }
+    atomic_store(&_stopped, atomic_load(&_cancelled));
+    atomic_store(&_nextChunk, 0);
+    atomic_store(&_attempts, 0);
+    dispatch_apply(MAX(self.threadCount, 1), dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        uint8_t buffer[BLOCK_HEADER_LENGTH];
+        memcpy(buffer, header.bytes, BLOCK_HEADER_LENGTH);
+        UInt256 blockHash;
+        while (!atomic_load_explicit(&self->_stopped, memory_order_relaxed)) {
+            uint64_t chunk = atomic_fetch_add(&self->_nextChunk, 1);
+            uint32_t timestamp = baseTimestamp + (uint32_t)(chunk >> MINING_CHUNKS_PER_TIMESTAMP_BITS);
+            uint32_t nonce = nonceOffset + ((uint32_t)chunk << MINING_CHUNK_BITS);
+            uint32_t littleEndianTimestamp = CFSwapInt32HostToLittle(timestamp);
+            memcpy(buffer + BLOCK_HEADER_TIMESTAMP_OFFSET, &littleEndianTimestamp, sizeof(uint32_t));
+            uint64_t hashes = 0;
+            for (uint32_t i = 0; i < (1 << MINING_CHUNK_BITS); i++, nonce++) {
+                uint32_t littleEndianNonce = CFSwapInt32HostToLittle(nonce);
+                memcpy(buffer + BLOCK_HEADER_NONCE_OFFSET, &littleEndianNonce, sizeof(uint32_t));
+                if (![DSKeyManager x11Bytes:buffer length:BLOCK_HEADER_LENGTH intoHash:&blockHash]) {
+                    @synchronized(self) {
+                        self.failed = YES;
+                    }
+                    atomic_store(&self->_stopped, true);
+                    break;
+                }
+                hashes++;
+                if (!uint256_sup(blockHash, fullTarget)) {
+                    @synchronized(self) {
+                        if (!self.found) {
+                            self.found = YES;
+                            self.foundNonce = nonce;
+                            self.foundTimestamp = timestamp;
+                            self.foundBlockHash = blockHash;
+                        }
+                    }
+                    atomic_store(&self->_stopped, true);
+                    break;
+                }
+                if (atomic_load_explicit(&self->_stopped, memory_order_relaxed)) break;
+            }
+            atomic_fetch_add(&self->_attempts, hashes);
+            if ([[NSDate date] timeIntervalSince1970] > deadline) {
+                atomic_store(&self->_stopped, true);
+            }
+        }
+    });
+    NSTimeInterval elapsed = [[NSDate date] timeIntervalSince1970] - start;
+    @synchronized(self) {
+        self.hashRate = elapsed > 0 ? self.attempts / elapsed : 0;
+        if (!self.found || self.failed) return NO;
+        block.nonce = self.foundNonce;
+        block.timestamp = self.foundTimestamp;
+        block.blockHash = self.foundBlockHash;
+        return YES;
+    }
+}
+
+@end
@@ -17,6 +17,8 @@
 
 #import "DSChain.h"
 
+@class DSTransactionIndex;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface DSChain ()
@@ -75,6 +77,9 @@ NS_ASSUME_NONNULL_BEGIN
 /*! @brief Add a wallet to the chain. It is only temporarily in the chain if externaly added this way.  */
 - (BOOL)addWallet:(DSWallet *)wallet;
 
+/*! @brief Maps transaction hashes of every wallet on the chain to the transaction and the accounts and wallets holding it.  */
+@property (nonatomic, readonly) DSTransactionIndex *transactionIndex;
+
 - (BOOL)registerSpecialTransaction:(DSTransaction *)transaction saveImmediately:(BOOL)saveImmediately;
 
 - (void)triggerUpdatesForLocalReferences:(DSTransaction *)transaction;
@@ -23,7 +23,7 @@
 //  THE SOFTWARE.
 
 #import "BigIntTypes.h"
-#import "DSAccount.h"
+#import "DSAccount+Protected.h"
 #import "DSLogger.h"
 #import "DSAuthenticationKeysDerivationPath.h"
 #import "DSBIP39Mnemonic.h"
@@ -44,6 +44,7 @@
 #import "DSChainsManager.h"
 #import "DSCheckpoint.h"
 #import "DSCreditFundingTransaction.h"
+#import "DSDarkGravityWave.h"
 #import "DSDerivationPath.h"
 #import "DSDerivationPathEntity+CoreDataProperties.h"
 #import "DSDerivationPathFactory.h"
@@ -78,6 +79,7 @@
 #import "DSTransaction.h"
 #import "DSTransactionEntity+CoreDataClass.h"
 #import "DSTransactionHashEntity+CoreDataProperties.h"
+#import "DSTransactionIndex.h"
 #import "DSTransactionInput.h"
 #import "DSTransactionOutput.h"
 #import "DSTransition.h"
@@ -138,12 +140,14 @@ typedef NS_ENUM(uint16_t, DSBlockPosition)
 
 @property (nonatomic, strong) DSBlock *lastSyncBlock, *lastTerminalBlock, *lastOrphan;
 @property (nonatomic, strong) NSMutableDictionary<NSValue *, DSBlock *> *mSyncBlocks, *mTerminalBlocks, *mOrphans;
+@property (nonatomic, strong) DSDarkGravityWave *syncDarkGravityWave, *terminalDarkGravityWave;
 @property (nonatomic, strong) NSMutableDictionary<NSData *, DSCheckpoint *> *checkpointsByHashDictionary;
 @property (nonatomic, strong) NSMutableDictionary<NSNumber *, DSCheckpoint *> *checkpointsByHeightDictionary;
 @property (nonatomic, strong) NSArray<DSCheckpoint *> *checkpoints;
 @property (nonatomic, copy) NSString *uniqueID;
 @property (nonatomic, copy) NSString *networkName;
 @property (nonatomic, strong) NSMutableArray<DSWallet *> *mWallets;
+@property (nonatomic, strong) DSTransactionIndex *transactionIndex;
 @property (nonatomic, strong) DSAccount *viewingAccount;
 @property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSMutableArray<DSPeer *> *> *estimatedBlockHeights;
 @property (nonatomic, assign) uint32_t cachedMinimumDifficultyBlocks;
@@ -179,7 +183,10 @@ typedef NS_ENUM(uint16_t, DSBlockPosition)
     self.mOrphans = [NSMutableDictionary dictionary];
     self.mSyncBlocks = [NSMutableDictionary dictionary];
     self.mTerminalBlocks = [NSMutableDictionary dictionary];
+    self.syncDarkGravityWave = [[DSDarkGravityWave alloc] initWithChain:self];
+    self.terminalDarkGravityWave = [[DSDarkGravityWave alloc] initWithChain:self];
     self.mWallets = [NSMutableArray array];
+    self.transactionIndex = [[DSTransactionIndex alloc] init];
     self.estimatedBlockHeights = [NSMutableDictionary dictionary];
     
     self.transactionHashHeights = [NSMutableDictionary dictionary];
@@ -1273,7 +1280,7 @@ static dispatch_once_t devnetToken = 0;
             
             for (DSTransactionInput *input in tx.inputs) {
                 o = (DSUTXO){input.inputHash, input.index};
-                DSTransaction *t = [wallet transactionForHash:o.hash];
+                DSTransaction *t = [self transactionForHash:o.hash];
                 if (o.n < t.outputs.count && [wallet containsAddress:t.outputs[o.n].address]) {
                     [inputs addObject:dsutxo_data(o)];
                     elemCount++;
@@ -1404,6 +1411,7 @@ static dispatch_once_t devnetToken = 0;
     [wallet wipeBlockchainInfoInContext:self.chainManagedObjectContext];
     [wallet wipeWalletInfo];
     [self.mWallets removeObject:wallet];
+    [self.transactionIndex detachWallet:wallet];
     NSError *error = nil;
     NSMutableArray *keyChainArray = [getKeychainArray(self.chainWalletsKey, @[[NSString class]], &error) mutableCopy];
     if (!keyChainArray) keyChainArray = [NSMutableArray array];
@@ -1421,6 +1429,7 @@ static dispatch_once_t devnetToken = 0;
     }
     if (!alreadyPresent) {
         [self.mWallets addObject:walletToAdd];
+        [self.transactionIndex attachWallet:walletToAdd];
         return TRUE;
     }
     return FALSE;
@@ -1875,10 +1884,11 @@ static dispatch_once_t devnetToken = 0;
         equivalentTerminalBlock = self.mTerminalBlocks[blockHash];
     }
     
-    if (!equivalentTerminalBlock && ((blockPosition & DSBlockPosition_Terminal) || [block canCalculateDifficultyWithPreviousBlocks:self.mSyncBlocks])) { //no need to check difficulty if we already have terminal blocks
+    if (!equivalentTerminalBlock && ((blockPosition & DSBlockPosition_Terminal) || [self.syncDarkGravityWave canCalculateDifficultyForBlock:block withPreviousBlocks:self.mSyncBlocks])) { //no need to check difficulty if we already have terminal blocks
         uint32_t foundDifficulty = 0;
+        DSDarkGravityWave *darkGravityWave = (blockPosition & DSBlockPosition_Terminal) ? self.terminalDarkGravityWave : self.syncDarkGravityWave;
         if ((block.height > self.minimumDifficultyBlocks) && (block.height > (lastCheckpoint.height + DGW_PAST_BLOCKS_MAX)) &&
-            ![block verifyDifficultyWithPreviousBlocks:(blockPosition & DSBlockPosition_Terminal) ? self.mTerminalBlocks : self.mSyncBlocks rDifficulty:&foundDifficulty]) {
+            ![darkGravityWave verifyDifficultyForBlock:block withPreviousBlocks:(blockPosition & DSBlockPosition_Terminal) ? self.mTerminalBlocks : self.mSyncBlocks rDifficulty:&foundDifficulty]) {
             if (peer) {
                 [self.chainManager chain:self badBlockReceivedFromPeer:peer];
             }
@@ -2711,49 +2721,36 @@ static dispatch_once_t devnetToken = 0;
 
 // returns an account to which the given transaction hash is associated with, no account if the transaction hash is not associated with the wallet
 - (DSAccount *_Nullable)firstAccountForTransactionHash:(UInt256)txHash transaction:(DSTransaction **)transaction wallet:(DSWallet **)wallet {
-    for (DSWallet *lWallet in self.wallets) {
-        for (DSAccount *account in lWallet.accounts) {
-            DSTransaction *lTransaction = [account transactionForHash:txHash];
-            if (lTransaction) {
-                if (transaction) *transaction = lTransaction;
-                if (wallet) *wallet = lWallet;
-                return account;
-            }
-        }
-    }
-    return nil;
+    DSTransactionIndexEntry *entry = [self transactionIndexEntryForHash:txHash];
+    DSAccount *account = entry.accounts.firstObject;
+    if (!account) return nil;
+    if (transaction) *transaction = entry.transaction;
+    if (wallet) *wallet = account.wallet;
+    return account;
 }
 
 // returns an account to which the given transaction hash is associated with, no account if the transaction hash is not associated with the wallet
 - (NSArray<DSAccount *> *)accountsForTransactionHash:(UInt256)txHash transaction:(DSTransaction **)transaction {
-    NSMutableArray *accounts = [NSMutableArray array];
-    for (DSWallet *lWallet in self.wallets) {
-        for (DSAccount *account in lWallet.accounts) {
-            DSTransaction *lTransaction = [account transactionForHash:txHash];
-            if (lTransaction) {
-                if (transaction) *transaction = lTransaction;
-                [accounts addObject:account];
-            }
-        }
-    }
-    return [accounts copy];
+    DSTransactionIndexEntry *entry = [self transactionIndexEntryForHash:txHash];
+    if (!entry.accounts.count) return @[];
+    if (transaction) *transaction = entry.transaction;
+    return entry.accounts;
 }
 
 // MARK: - Transactions
 
+- (DSTransactionIndexEntry *_Nullable)transactionIndexEntryForHash:(UInt256)txHash {
+    return [self.transactionIndex entryForTransactionHash:txHash];
+}
+
 - (DSTransaction *)transactionForHash:(UInt256)txHash {
     return [self transactionForHash:txHash returnWallet:nil];
 }
 
 - (DSTransaction *)transactionForHash:(UInt256)txHash returnWallet:(DSWallet **)rWallet {
-    for (DSWallet *wallet in self.wallets) {
-        DSTransaction *transaction = [wallet transactionForHash:txHash];
-        if (transaction) {
-            if (rWallet) *rWallet = wallet;
-            return transaction;
-        }
-    }
-    return nil;
+    DSTransactionIndexEntry *entry = [self transactionIndexEntryForHash:txHash];
+    if (entry && rWallet) *rWallet = entry.wallets.firstObject;
+    return entry.transaction;
 }
 
 - (NSArray<DSTransaction *> *)allTransactions {
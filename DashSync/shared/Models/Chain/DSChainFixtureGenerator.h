@@ -0,0 +1,81 @@
+//
+//  DSChainFixtureGenerator.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSBlock, DSChain;
+
+@interface DSChainFixtureConfiguration : NSObject
+
+@property (nonatomic, assign) uint32_t blockCount;
+/*! @brief Transactions in each block once coinbases have matured, besides the coinbase. */
+@property (nonatomic, assign) uint32_t transactionsPerBlock;
+@property (nonatomic, assign) uint32_t maximumInputsPerTransaction;
+/*! @brief Fan-out of each transaction. */
+@property (nonatomic, assign) uint32_t outputsPerTransaction;
+/*! @brief Chance that an output pays an address of the wallet that was already paid. */
+@property (nonatomic, assign) double addressReuseRate;
+/*! @brief Chance that an output pays outside the wallet, such outputs are never spent. */
+@property (nonatomic, assign) double foreignOutputRate;
+/*! @brief Chance that a transaction splits its inputs into CoinJoin denominations. */
+@property (nonatomic, assign) double denominationRate;
+/*! @brief Chance that a transaction is relayed with an InstantSend lock before its block. */
+@property (nonatomic, assign) double instantSendLockRate;
+/*! @brief A chain lock follows every chainLockInterval blocks, 0 for none. */
+@property (nonatomic, assign) uint32_t chainLockInterval;
+@property (nonatomic, assign) uint32_t coinbaseMaturity;
+@property (nonatomic, assign) uint32_t blockSpacing;
+@property (nonatomic, assign) uint64_t seed;
+
+@end
+
+/*! @brief Generates a devnet chain on top of a block, paying the given wallet addresses, and writes it as a fixture file that DSChainFixtureReader replays. The same configuration, base block and addresses always give the same file: timestamps follow the block spacing, every choice comes from a generator seeded by the configuration and blocks are mined on a single thread. Signatures of inputs, InstantSend locks and chain locks are random bytes, the fixture exercises sync, balance and filter code, not signature verification. Use a devnet whose minimum difficulty blocks cover the fixture so that mining is instant. */
+@interface DSChainFixtureGenerator : NSObject
+
+@property (nonatomic, readonly) DSChain *chain;
+@property (nonatomic, readonly) DSChainFixtureConfiguration *configuration;
+@property (nonatomic, readonly) NSUInteger generatedTransactionCount;
+@property (nonatomic, readonly) NSUInteger generatedInstantSendLockCount;
+@property (nonatomic, readonly) NSUInteger generatedChainLockCount;
+/*! @brief What the wallet addresses can spend at the last block: unspent outputs paid to them, coinbases once they matured. */
+@property (nonatomic, readonly) uint64_t spendableWalletBalance;
+@property (nonatomic, readonly, nullable) DSBlock *lastBlock;
+
+- (instancetype)initWithChain:(DSChain *)chain configuration:(DSChainFixtureConfiguration *)configuration walletAddresses:(NSArray<NSString *> *)walletAddresses NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+- (BOOL)writeFixtureToURL:(NSURL *)url afterBlock:(DSBlock *)block previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks error:(NSError *_Nullable *_Nullable)error;
+
+@end
+
+/*! @brief Reads a fixture written by DSChainFixtureGenerator as the messages a peer would have sent, in order: tx and islock for locked transactions, then block, then clsig. The file is memory mapped, messages are handed out one at a time. */
+@interface DSChainFixtureReader : NSObject
+
+@property (nonatomic, readonly) UInt256 baseBlockHash;
+@property (nonatomic, readonly) uint32_t baseBlockHeight;
+
+- (instancetype _Nullable)initWithURL:(NSURL *)url error:(NSError *_Nullable *_Nullable)error NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+- (void)enumerateMessagesUsingBlock:(void (^)(NSString *type, NSData *message, BOOL *stop))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
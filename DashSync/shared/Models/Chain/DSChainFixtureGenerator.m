@@ -0,0 +1,392 @@
+//
+//  DSChainFixtureGenerator.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSChainFixtureGenerator.h"
+#import "DSBlockMiner.h"
+#import "DSChain.h"
+#import "DSCoinbaseTransaction.h"
+#import "DSFullBlock.h"
+#import "DSInstantSendTransactionLock.h"
+#import "DSPeer.h"
+#import "DSTransaction.h"
+#import "DSTransactionInput.h"
+#import "DSTransactionOutput.h"
+#import "NSData+DSHash.h"
+#import "NSData+Dash.h"
+#import "NSError+Dash.h"
+#import "NSMutableData+Dash.h"
+#import "NSString+Dash.h"
+
+#define FIXTURE_MAGIC 0x58465344 // "DSFX"
+#define FIXTURE_VERSION 1
+#define FIXTURE_HEADER_LENGTH 44
+#define FIXTURE_TRANSACTION_FEE 1000
+#define FIXTURE_MINIMUM_OUTPUT 10000
+#define FIXTURE_KEPT_PREVIOUS_BLOCKS 32 // enough for DarkGravityWave
+#define FIXTURE_WRITE_BUFFER_LENGTH (4 * 1024 * 1024)
+
+static const uint64_t DSChainFixtureDenominations[] = {1000010000, 100001000, 10000100, 1000010, 100001};
+
+// splitmix64, the fixture has to come out the same on every platform
+static inline uint64_t DSChainFixtureRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+@implementation DSChainFixtureConfiguration
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.blockCount = 1000;
+    self.transactionsPerBlock = 4;
+    self.maximumInputsPerTransaction = 2;
+    self.outputsPerTransaction = 2;
+    self.addressReuseRate = 0.1;
+    self.foreignOutputRate = 0.2;
+    self.denominationRate = 0.1;
+    self.instantSendLockRate = 0.3;
+    self.chainLockInterval = 1;
+    self.coinbaseMaturity = 100;
+    self.blockSpacing = 150;
+    self.seed = 1;
+    return self;
+}
+
+@end
+
+@interface DSChainFixtureCoin : NSObject
+
+@property (nonatomic, assign) DSUTXO outpoint;
+@property (nonatomic, assign) uint64_t amount;
+@property (nonatomic, assign) uint32_t spendableHeight;
+
+@end
+
+@implementation DSChainFixtureCoin
+
+@end
+
+@interface DSChainFixtureGenerator ()
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) DSChainFixtureConfiguration *configuration;
+@property (nonatomic, strong) NSArray<NSString *> *walletAddresses;
+@property (nonatomic, strong) NSMutableArray<NSString *> *usedWalletAddresses;
+@property (nonatomic, assign) NSUInteger nextWalletAddressIndex;
+@property (nonatomic, strong) NSMutableArray<DSChainFixtureCoin *> *coins;
+@property (nonatomic, strong) NSMutableArray<DSChainFixtureCoin *> *immatureCoins;
+@property (nonatomic, assign) uint64_t randomState;
+@property (nonatomic, assign) NSUInteger generatedTransactionCount;
+@property (nonatomic, assign) NSUInteger generatedInstantSendLockCount;
+@property (nonatomic, assign) NSUInteger generatedChainLockCount;
+@property (nonatomic, assign) uint64_t spendableWalletBalance;
+@property (nonatomic, strong) DSBlock *lastBlock;
+@property (nonatomic, strong) NSFileHandle *fileHandle;
+@property (nonatomic, strong) NSMutableData *buffer;
+
+@end
+
+@implementation DSChainFixtureGenerator
+
+- (instancetype)initWithChain:(DSChain *)chain configuration:(DSChainFixtureConfiguration *)configuration walletAddresses:(NSArray<NSString *> *)walletAddresses {
+    NSParameterAssert(chain);
+    NSParameterAssert(walletAddresses.count);
+    if (!(self = [super init])) return nil;
+    self.chain = chain;
+    self.configuration = configuration;
+    self.walletAddresses = [walletAddresses copy];
+    return self;
+}
+
+// MARK: - Randomness
+
+- (uint64_t)random {
+    return DSChainFixtureRandom(&_randomState);
+}
+
+- (uint64_t)randomBelow:(uint64_t)bound {
+    return bound ? [self random] % bound : 0;
+}
+
+- (BOOL)randomChance:(double)rate {
+    return ([self random] >> 11) * 0x1.0p-53 < rate;
+}
+
+- (NSData *)randomDataOfLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    uint8_t *bytes = data.mutableBytes;
+    for (NSUInteger i = 0; i < length; i += sizeof(uint64_t)) {
+        uint64_t r = [self random];
+        memcpy(bytes + i, &r, MIN(sizeof(uint64_t), length - i));
+    }
+    return data;
+}
+
+- (UInt768)randomSignature {
+    return [self randomDataOfLength:sizeof(UInt768)].UInt768;
+}
+
+// the shape of a pay to pubkey hash input script, a signature then a compressed public key
+- (NSData *)randomInputScript {
+    NSMutableData *script = [NSMutableData data];
+    [script appendUInt8:71];
+    [script appendData:[self randomDataOfLength:71]];
+    [script appendUInt8:33];
+    [script appendData:[self randomDataOfLength:33]];
+    return script;
+}
+
+// MARK: - Addresses
+
+- (NSString *)walletOutputAddress {
+    if (self.usedWalletAddresses.count && [self randomChance:self.configuration.addressReuseRate]) {
+        return self.usedWalletAddresses[[self randomBelow:self.usedWalletAddresses.count]];
+    }
+    NSString *address = self.walletAddresses[self.nextWalletAddressIndex % self.walletAddresses.count];
+    if (self.nextWalletAddressIndex < self.walletAddresses.count) {
+        [self.usedWalletAddresses addObject:address];
+    }
+    self.nextWalletAddressIndex++;
+    return address;
+}
+
+- (NSString *_Nullable)foreignOutputAddress {
+    if (![self randomChance:self.configuration.foreignOutputRate]) return nil;
+    return [NSString addressWithHash160:[self randomDataOfLength:sizeof(UInt160)].UInt160 onChain:self.chain];
+}
+
+// MARK: - Transactions
+
+- (DSTransaction *_Nullable)transactionWithNewCoins:(NSMutableArray<DSChainFixtureCoin *> *)newCoins {
+    NSUInteger inputCount = MIN(1 + [self randomBelow:MAX(self.configuration.maximumInputsPerTransaction, 1)], self.coins.count);
+    if (!inputCount) return nil;
+    DSTransaction *transaction = [[DSTransaction alloc] initOnChain:self.chain];
+    NSMutableArray<DSChainFixtureCoin *> *inputCoins = [NSMutableArray array];
+    uint64_t total = 0;
+    for (NSUInteger i = 0; i < inputCount; i++) {
+        NSUInteger index = [self randomBelow:self.coins.count];
+        DSChainFixtureCoin *coin = self.coins[index];
+        self.coins[index] = self.coins.lastObject;
+        [self.coins removeLastObject];
+        [transaction addInputHash:coin.outpoint.hash index:coin.outpoint.n script:nil signature:[self randomInputScript] sequence:TXIN_SEQUENCE];
+        [inputCoins addObject:coin];
+        total += coin.amount;
+    }
+    if (total < FIXTURE_TRANSACTION_FEE + FIXTURE_MINIMUM_OUTPUT) {
+        // not worth a transaction, the coins stay unspent
+        [self.coins addObjectsFromArray:inputCoins];
+        return nil;
+    }
+    uint64_t remaining = total - FIXTURE_TRANSACTION_FEE;
+    NSMutableArray<NSNumber *> *amounts = [NSMutableArray array];
+    uint32_t outputCount = MAX(self.configuration.outputsPerTransaction, 1);
+    if ([self randomChance:self.configuration.denominationRate]) {
+        for (size_t d = 0; d < sizeof(DSChainFixtureDenominations) / sizeof(uint64_t) && amounts.count < outputCount; d++) {
+            while (remaining >= DSChainFixtureDenominations[d] + FIXTURE_MINIMUM_OUTPUT && amounts.count < outputCount) {
+                [amounts addObject:@(DSChainFixtureDenominations[d])];
+                remaining -= DSChainFixtureDenominations[d];
+            }
+        }
+        [amounts addObject:@(remaining)]; // change
+    } else {
+        uint64_t share = remaining / outputCount;
+        for (uint32_t i = 0; i < outputCount && share >= FIXTURE_MINIMUM_OUTPUT; i++) {
+            uint64_t amount = (i == outputCount - 1) ? remaining : share;
+            [amounts addObject:@(amount)];
+            remaining -= amount;
+        }
+        if (!amounts.count) [amounts addObject:@(remaining)];
+    }
+    NSMutableIndexSet *walletOutputIndexes = [NSMutableIndexSet indexSet];
+    for (NSNumber *amount in amounts) {
+        NSString *address = [self foreignOutputAddress];
+        if (!address) {
+            address = [self walletOutputAddress];
+            [walletOutputIndexes addIndex:transaction.outputs.count];
+        }
+        [transaction addOutputAddress:address amount:amount.unsignedLongLongValue];
+    }
+    transaction.txHash = transaction.toData.SHA256_2;
+    [walletOutputIndexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        DSChainFixtureCoin *coin = [[DSChainFixtureCoin alloc] init];
+        coin.outpoint = (DSUTXO){transaction.txHash, index};
+        coin.amount = transaction.outputs[index].amount;
+        [newCoins addObject:coin];
+    }];
+    return transaction;
+}
+
+- (NSData *)instantSendLockMessageForTransaction:(DSTransaction *)transaction {
+    NSMutableArray<NSData *> *inputOutpoints = [NSMutableArray array];
+    for (DSTransactionInput *input in transaction.inputs) {
+        DSUTXO outpoint = (DSUTXO){input.inputHash, input.index};
+        [inputOutpoints addObject:dsutxo_data(outpoint)];
+    }
+    DSInstantSendTransactionLock *lock = [[DSInstantSendTransactionLock alloc] initWithTransactionHash:transaction.txHash withInputOutpoints:inputOutpoints signature:[self randomSignature] signatureVerified:NO quorumVerified:NO onChain:self.chain];
+    return [lock toData];
+}
+
+- (NSData *)chainLockMessageForBlock:(DSBlock *)block {
+    NSMutableData *message = [NSMutableData data];
+    [message appendUInt32:block.height];
+    [message appendUInt256:block.blockHash];
+    [message appendUInt768:[self randomSignature]];
+    return message;
+}
+
+// MARK: - Writing
+
+- (void)writeMessage:(NSData *)message type:(NSString *)type {
+    [self.buffer appendString:type];
+    [self.buffer appendCountedData:message];
+    if (self.buffer.length >= FIXTURE_WRITE_BUFFER_LENGTH) {
+        [self.fileHandle writeData:self.buffer];
+        self.buffer.length = 0;
+    }
+}
+
+- (BOOL)writeFixtureToURL:(NSURL *)url afterBlock:(DSBlock *)baseBlock previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks error:(NSError **)error {
+    if (![[NSFileManager defaultManager] createFileAtPath:url.path contents:nil attributes:nil] ||
+        !(self.fileHandle = [NSFileHandle fileHandleForWritingToURL:url error:error])) {
+        if (error && !*error) *error = [NSError errorWithCode:500 localizedDescriptionKey:@"The fixture file could not be created."];
+        return NO;
+    }
+    DSChainFixtureConfiguration *configuration = self.configuration;
+    self.randomState = configuration.seed;
+    self.usedWalletAddresses = [NSMutableArray array];
+    self.nextWalletAddressIndex = 0;
+    self.coins = [NSMutableArray array];
+    self.immatureCoins = [NSMutableArray array];
+    self.generatedTransactionCount = 0;
+    self.generatedInstantSendLockCount = 0;
+    self.generatedChainLockCount = 0;
+    self.spendableWalletBalance = 0;
+    self.buffer = [NSMutableData dataWithCapacity:FIXTURE_WRITE_BUFFER_LENGTH];
+    [self.buffer appendUInt32:FIXTURE_MAGIC];
+    [self.buffer appendUInt32:FIXTURE_VERSION];
+    [self.buffer appendUInt256:baseBlock.blockHash];
+    [self.buffer appendUInt32:baseBlock.height];
+
+    DSBlockMiner *miner = [[DSBlockMiner alloc] init];
+    miner.threadCount = 1; // the first nonce found must not depend on scheduling
+    NSMutableDictionary<NSValue *, DSBlock *> *mPreviousBlocks = [previousBlocks mutableCopy];
+    NSMutableArray<NSValue *> *previousBlockHashes = [NSMutableArray array];
+    DSBlock *previousBlock = baseBlock;
+    for (uint32_t i = 1; i <= configuration.blockCount; i++) {
+        @autoreleasepool {
+            uint32_t height = baseBlock.height + i;
+            while (self.immatureCoins.count && self.immatureCoins.firstObject.spendableHeight <= height) {
+                [self.coins addObject:self.immatureCoins.firstObject];
+                [self.immatureCoins removeObjectAtIndex:0];
+            }
+            NSMutableArray<DSTransaction *> *transactions = [NSMutableArray array];
+            NSMutableArray<DSChainFixtureCoin *> *newCoins = [NSMutableArray array];
+            for (uint32_t t = 0; t < configuration.transactionsPerBlock && self.coins.count; t++) {
+                DSTransaction *transaction = [self transactionWithNewCoins:newCoins];
+                if (!transaction) continue;
+                [transactions addObject:transaction];
+                if ([self randomChance:configuration.instantSendLockRate]) {
+                    [self writeMessage:transaction.toData type:MSG_TX];
+                    [self writeMessage:[self instantSendLockMessageForTransaction:transaction] type:MSG_ISLOCK];
+                    self.generatedInstantSendLockCount++;
+                }
+            }
+            DSCoinbaseTransaction *coinbaseTransaction = [[DSCoinbaseTransaction alloc] initWithCoinbaseMessage:@"Fixture" paymentAddresses:@[[self walletOutputAddress]] atHeight:height onChain:self.chain];
+            DSFullBlock *block = [[DSFullBlock alloc] initWithCoinbaseTransaction:coinbaseTransaction orderedTransactions:transactions previousBlockHash:previousBlock.blockHash previousBlocks:mPreviousBlocks timestamp:baseBlock.timestamp + i * configuration.blockSpacing height:height onChain:self.chain];
+            uint64_t attempts = 0;
+            if (![block mineBlockAfterBlock:previousBlock withNonceOffset:0 withTimeout:0 usingMiner:miner rAttempts:&attempts]) {
+                if (error) *error = [NSError errorWithCode:500 localizedDescriptionKey:@"A fixture block could not be mined."];
+                [self.fileHandle closeFile];
+                return NO;
+            }
+            [self writeMessage:[block blockMessage] type:MSG_BLOCK];
+            if (configuration.chainLockInterval && height % configuration.chainLockInterval == 0) {
+                [self writeMessage:[self chainLockMessageForBlock:block] type:MSG_CHAINLOCK];
+                self.generatedChainLockCount++;
+            }
+            self.generatedTransactionCount += transactions.count + 1;
+
+            DSChainFixtureCoin *coinbaseCoin = [[DSChainFixtureCoin alloc] init];
+            coinbaseCoin.outpoint = (DSUTXO){coinbaseTransaction.txHash, 0};
+            coinbaseCoin.amount = coinbaseTransaction.outputs.firstObject.amount;
+            coinbaseCoin.spendableHeight = height + configuration.coinbaseMaturity;
+            [self.immatureCoins addObject:coinbaseCoin];
+            [self.coins addObjectsFromArray:newCoins];
+
+            mPreviousBlocks[block.blockHashValue] = block;
+            [previousBlockHashes addObject:block.blockHashValue];
+            if (previousBlockHashes.count > FIXTURE_KEPT_PREVIOUS_BLOCKS) {
+                [mPreviousBlocks removeObjectForKey:previousBlockHashes.firstObject];
+                [previousBlockHashes removeObjectAtIndex:0];
+            }
+            previousBlock = block;
+        }
+    }
+    [self.fileHandle writeData:self.buffer];
+    [self.fileHandle closeFile];
+    self.buffer = nil;
+    self.fileHandle = nil;
+    self.lastBlock = previousBlock;
+    for (DSChainFixtureCoin *coin in self.coins) {
+        self.spendableWalletBalance += coin.amount;
+    }
+    return YES;
+}
+
+@end
+
+@interface DSChainFixtureReader ()
+
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, assign) UInt256 baseBlockHash;
+@property (nonatomic, assign) uint32_t baseBlockHeight;
+
+@end
+
+@implementation DSChainFixtureReader
+
+- (instancetype)initWithURL:(NSURL *)url error:(NSError **)error {
+    if (!(self = [super init])) return nil;
+    self.data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:error];
+    if (!self.data) return nil;
+    if (self.data.length < FIXTURE_HEADER_LENGTH || [self.data UInt32AtOffset:0] != FIXTURE_MAGIC || [self.data UInt32AtOffset:4] != FIXTURE_VERSION) {
+        if (error) *error = [NSError errorWithCode:500 localizedDescriptionKey:@"This is not a chain fixture."];
+        return nil;
+    }
+    self.baseBlockHash = [self.data UInt256AtOffset:8];
+    self.baseBlockHeight = [self.data UInt32AtOffset:40];
+    return self;
+}
+
+- (void)enumerateMessagesUsingBlock:(void (^)(NSString *type, NSData *message, BOOL *stop))block {
+    NSUInteger offset = FIXTURE_HEADER_LENGTH;
+    BOOL stop = NO;
+    while (!stop && offset < self.data.length) {
+        NSNumber *length = nil;
+        NSString *type = [self.data stringAtOffset:offset length:&length];
+        if (!type) break;
+        offset += length.unsignedIntegerValue;
+        NSData *message = [self.data dataAtOffset:offset length:&length];
+        if (!message) break;
+        offset += length.unsignedIntegerValue;
+        block(type, message, &stop);
+    }
+}
+
+@end
@@ -52,6 +52,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)verifySignature;
 
+// YES once the verified quorum the signature is checked against first is known, a failed verification is then final
+- (BOOL)isSigningQuorumKnown;
+
 - (void)saveInitial;
 
 - (void)saveSignatureValid;
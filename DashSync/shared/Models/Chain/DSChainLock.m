@@ -160,6 +160,11 @@
     return [self verifySignatureWithQuorumOffset:8];
 }
 
+- (BOOL)isSigningQuorumKnown {
+    DSQuorumEntry *quorumEntry = [self.chain.chainManager.masternodeManager quorumEntryForChainLockRequestID:[self requestID] forBlockHeight:self.height - 8];
+    return quorumEntry && quorumEntry.verified;
+}
+
 - (void)saveInitial {
     if (_saved) return;
     //saving here will only create, not update.
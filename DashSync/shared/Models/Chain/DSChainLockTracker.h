@@ -0,0 +1,64 @@
+//
+//  DSChainLockTracker.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define CHAIN_LOCK_TRACKER_WAITING_CAPACITY 64
+#define CHAIN_LOCK_TRACKER_ENTRY_CAPACITY 1024
+#define CHAIN_LOCK_TRACKER_MAXIMUM_HEIGHT_ABOVE_TIP 24
+
+@class DSChainLock;
+
+typedef BOOL (^DSChainLockVerificationBlock)(DSChainLock *chainLock);
+
+/*! @brief ChainLocks relayed by the peers of a chain. Only the highest verified lock matters for finality, so copies of a lock already handled and locks at or below the best verified height are dropped before any signature check, and locks waiting for their quorum are verified from the highest down, stopping at the first valid one. A lock is identified by its block hash and signature, a forged lock for a block does not hide the genuine one. */
+@interface DSChainLockTracker : NSObject
+
+/*! @brief Highest lock with a valid signature. */
+@property (nonatomic, readonly, nullable) DSChainLock *bestChainLock;
+@property (nonatomic, readonly) NSUInteger waitingCount;
+@property (nonatomic, readonly) NSUInteger verificationCount;
+@property (nonatomic, readonly) NSUInteger skippedCount;
+/*! @brief Height of the best known header, locks more than CHAIN_LOCK_TRACKER_MAXIMUM_HEIGHT_ABOVE_TIP blocks above it are not accepted. 0 until the tip is known. */
+@property (nonatomic, assign) uint32_t tipHeight;
+
+- (instancetype)initWithWaitingCapacity:(NSUInteger)waitingCapacity NS_DESIGNATED_INITIALIZER;
+
+/*! @brief NO for a lock at or below the best verified height, far above the tip, or already received with the same signature. The locks received are remembered up to CHAIN_LOCK_TRACKER_ENTRY_CAPACITY, the earliest ones are forgotten first. */
+- (BOOL)acceptChainLock:(DSChainLock *)chainLock;
+
+/*! @brief Result of the block, unless a lock at the same height or higher was verified meanwhile. A valid lock becomes the best lock and supersedes the lower waiting ones. */
+- (BOOL)verifyChainLock:(DSChainLock *)chainLock usingBlock:(DSChainLockVerificationBlock)verifyBlock;
+
+/*! @brief Keeps the lock until quorums change, the earliest waiting locks are dropped past the capacity so that forged locks claiming higher blocks can't push out the ones that came first. Locks for the same block with different signatures all wait. */
+- (void)addChainLockWaitingForQuorum:(DSChainLock *)chainLock;
+
+/*! @brief Verifies waiting locks from the highest down and returns the first valid one, lower locks are then dropped without being verified. */
+- (DSChainLock *_Nullable)verifyWaitingChainLocksUsingBlock:(DSChainLockVerificationBlock)verifyBlock;
+/*! @brief Locks for the excluded block hashes are neither verified nor dropped, they keep waiting. */
+- (DSChainLock *_Nullable)verifyWaitingChainLocksExcludingBlockHashes:(NSSet<NSData *> *)excludedBlockHashes usingBlock:(DSChainLockVerificationBlock)verifyBlock;
+/*! @brief A lock failing verification while the quorum block says its quorum is known is dropped, the others keep waiting for their quorum. */
+- (DSChainLock *_Nullable)verifyWaitingChainLocksExcludingBlockHashes:(NSSet<NSData *> *)excludedBlockHashes usingBlock:(DSChainLockVerificationBlock)verifyBlock quorumKnownBlock:(DSChainLockVerificationBlock _Nullable)quorumKnownBlock;
+
+- (DSChainLock *_Nullable)waitingChainLockForBlockHash:(UInt256)blockHash;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,187 @@
+//
+//  DSChainLockTracker.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSChainLockTracker.h"
+#import "DSChainLock.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+@interface DSChainLockTracker ()
+
+@property (nonatomic, assign) NSUInteger waitingCapacity;
+@property (nonatomic, strong) DSChainLock *bestChainLock;
+// block hash and signature of the locks received above the best verified height, to their height. Until a lock is
+// verified anyone can relay one for the block, a forged signature must not hide the genuine lock
+@property (nonatomic, strong) NSMutableDictionary<NSData *, NSNumber *> *entries;
+@property (nonatomic, strong) NSMutableOrderedSet<NSData *> *entryKeys; // in arrival order
+@property (nonatomic, strong) NSMutableDictionary<NSData *, DSChainLock *> *waitingChainLocks;
+@property (nonatomic, strong) NSMutableOrderedSet<NSData *> *waitingKeys; // in arrival order
+@property (nonatomic, assign) NSUInteger verificationCount, skippedCount;
+
+@end
+
+@implementation DSChainLockTracker
+
+- (instancetype)init {
+    return [self initWithWaitingCapacity:CHAIN_LOCK_TRACKER_WAITING_CAPACITY];
+}
+
+- (instancetype)initWithWaitingCapacity:(NSUInteger)waitingCapacity {
+    NSParameterAssert(waitingCapacity > 0);
+    if (!(self = [super init])) return nil;
+    self.waitingCapacity = waitingCapacity;
+    self.entries = [NSMutableDictionary dictionary];
+    self.entryKeys = [NSMutableOrderedSet orderedSet];
+    self.waitingChainLocks = [NSMutableDictionary dictionary];
+    self.waitingKeys = [NSMutableOrderedSet orderedSet];
+    return self;
+}
+
++ (NSData *)keyForChainLock:(DSChainLock *)chainLock {
+    NSMutableData *key = [NSMutableData dataWithCapacity:sizeof(UInt256) + sizeof(UInt768)];
+    [key appendUInt256:chainLock.blockHash];
+    [key appendUInt768:chainLock.signature];
+    return key;
+}
+
+- (NSUInteger)waitingCount {
+    @synchronized(self) {
+        return self.waitingChainLocks.count;
+    }
+}
+
+// only called while synchronized
+- (BOOL)isSuperseded:(DSChainLock *)chainLock {
+    return self.bestChainLock && chainLock.height <= self.bestChainLock.height;
+}
+
+- (BOOL)acceptChainLock:(DSChainLock *)chainLock {
+    NSData *key = [DSChainLockTracker keyForChainLock:chainLock];
+    @synchronized(self) {
+        BOOL aboveTip = self.tipHeight && chainLock.height > self.tipHeight + CHAIN_LOCK_TRACKER_MAXIMUM_HEIGHT_ABOVE_TIP;
+        if ([self isSuperseded:chainLock] || aboveTip || self.entries[key]) {
+            self.skippedCount++;
+            return NO;
+        }
+        self.entries[key] = @(chainLock.height);
+        [self.entryKeys addObject:key];
+        // a forgotten lock is only verified again if it is relayed again
+        if (self.entryKeys.count > CHAIN_LOCK_TRACKER_ENTRY_CAPACITY) {
+            [self.entries removeObjectForKey:self.entryKeys.firstObject];
+            [self.entryKeys removeObjectAtIndex:0];
+        }
+        return YES;
+    }
+}
+
+// only called while synchronized
+- (void)setValidChainLock:(DSChainLock *)chainLock {
+    if ([self isSuperseded:chainLock]) return;
+    self.bestChainLock = chainLock;
+    for (NSData *key in [self.entries copy]) {
+        if (self.entries[key].unsignedIntValue < chainLock.height) {
+            [self.entries removeObjectForKey:key];
+            [self.entryKeys removeObject:key];
+        }
+    }
+    for (NSData *key in [self.waitingChainLocks copy]) {
+        if (self.waitingChainLocks[key].height <= chainLock.height) [self removeWaitingChainLockForKey:key];
+    }
+}
+
+- (BOOL)verifyChainLock:(DSChainLock *)chainLock usingBlock:(DSChainLockVerificationBlock)verifyBlock {
+    @synchronized(self) {
+        if ([self isSuperseded:chainLock]) {
+            self.skippedCount++;
+            return NO;
+        }
+    }
+    // verified outside of the lock, BLS checks are slow
+    BOOL valid = verifyBlock(chainLock);
+    @synchronized(self) {
+        self.verificationCount++;
+        // an invalid lock stays received, its copies are dropped while other signatures for the block are still checked
+        if (valid) [self setValidChainLock:chainLock];
+    }
+    return valid;
+}
+
+// only called while synchronized
+- (void)removeWaitingChainLockForKey:(NSData *)key {
+    [self.waitingChainLocks removeObjectForKey:key];
+    [self.waitingKeys removeObject:key];
+}
+
+- (void)addChainLockWaitingForQuorum:(DSChainLock *)chainLock {
+    NSData *key = [DSChainLockTracker keyForChainLock:chainLock];
+    @synchronized(self) {
+        if ([self isSuperseded:chainLock]) return;
+        self.waitingChainLocks[key] = chainLock;
+        [self.waitingKeys addObject:key];
+        if (self.waitingKeys.count > self.waitingCapacity) [self removeWaitingChainLockForKey:self.waitingKeys.firstObject];
+    }
+}
+
+- (DSChainLock *)verifyWaitingChainLocksUsingBlock:(DSChainLockVerificationBlock)verifyBlock {
+    return [self verifyWaitingChainLocksExcludingBlockHashes:[NSSet set] usingBlock:verifyBlock];
+}
+
+- (DSChainLock *)verifyWaitingChainLocksExcludingBlockHashes:(NSSet<NSData *> *)excludedBlockHashes usingBlock:(DSChainLockVerificationBlock)verifyBlock {
+    return [self verifyWaitingChainLocksExcludingBlockHashes:excludedBlockHashes usingBlock:verifyBlock quorumKnownBlock:nil];
+}
+
+- (DSChainLock *)verifyWaitingChainLocksExcludingBlockHashes:(NSSet<NSData *> *)excludedBlockHashes usingBlock:(DSChainLockVerificationBlock)verifyBlock quorumKnownBlock:(DSChainLockVerificationBlock)quorumKnownBlock {
+    NSMutableArray<DSChainLock *> *waitingChainLocks = [NSMutableArray array];
+    @synchronized(self) {
+        for (DSChainLock *chainLock in self.waitingChainLocks.allValues) {
+            // left waiting, it does not supersede anything until it can be verified
+            if (![excludedBlockHashes containsObject:uint256_data(chainLock.blockHash)]) [waitingChainLocks addObject:chainLock];
+        }
+    }
+    [waitingChainLocks sortUsingComparator:^NSComparisonResult(DSChainLock *chainLock1, DSChainLock *chainLock2) {
+        if (chainLock1.height == chainLock2.height) return NSOrderedSame;
+        return chainLock1.height > chainLock2.height ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    for (NSUInteger index = 0; index < waitingChainLocks.count; index++) {
+        DSChainLock *chainLock = waitingChainLocks[index];
+        if ([self verifyChainLock:chainLock usingBlock:verifyBlock]) {
+            // the lock and the lower ones were dropped once it became the best lock
+            @synchronized(self) {
+                self.skippedCount += waitingChainLocks.count - index - 1;
+            }
+            return chainLock;
+        }
+        // with its quorum known the signature won't become valid later
+        if (quorumKnownBlock && quorumKnownBlock(chainLock)) {
+            @synchronized(self) {
+                [self removeWaitingChainLockForKey:[DSChainLockTracker keyForChainLock:chainLock]];
+            }
+        }
+    }
+    return nil;
+}
+
+- (DSChainLock *)waitingChainLockForBlockHash:(UInt256)blockHash {
+    @synchronized(self) {
+        for (DSChainLock *chainLock in self.waitingChainLocks.allValues) {
+            if (uint256_eq(chainLock.blockHash, blockHash)) return chainLock;
+        }
+        return nil;
+    }
+}
+
+@end
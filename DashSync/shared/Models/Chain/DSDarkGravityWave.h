@@ -0,0 +1,47 @@
+//
+//  DSDarkGravityWave.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSBlock, DSChain;
+
+/*! @brief Sliding window DarkGravityWave v3 calculator. It keeps the (timestamp, target) pairs of the last headers of one branch in a ring along with the sum of their expanded targets, so a header appended on top of the window costs a single lookup of its parent and one add and one subtract instead of walking 24 predecessors. When a header doesn't build on the window (a fork, a switch between the sync and terminal chains) the window is rebuilt from the previous blocks. Targets are identical to -[DSBlock darkGravityWaveTargetWithPreviousBlocks:], which is used whenever the window can't be filled. */
+@interface DSDarkGravityWave : NSObject
+
+@property (nonatomic, readonly) UInt256 tipBlockHash;
+@property (nonatomic, readonly) NSUInteger count;
+
+- (instancetype)initWithChain:(DSChain *)chain NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Same answer as -[DSBlock canCalculateDifficultyWithPreviousBlocks:]. */
+- (BOOL)canCalculateDifficultyForBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks;
+
+/*! @brief Same answer as -[DSBlock verifyDifficultyWithPreviousBlocks:rDifficulty:]. */
+- (BOOL)verifyDifficultyForBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks rDifficulty:(uint32_t *_Nullable)difficulty;
+
+/*! @brief Same answer as -[DSBlock darkGravityWaveTargetWithPreviousBlocks:]. */
+- (int32_t)darkGravityWaveTargetForBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks;
+
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
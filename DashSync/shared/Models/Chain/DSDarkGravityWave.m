@@ -0,0 +1,270 @@
+//
+//  DSDarkGravityWave.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSDarkGravityWave.h"
+#import "DSBlock.h"
+#import "DSChain.h"
+#import "NSData+Dash.h"
+
+// one more entry than the window, canCalculateDifficultyWithPreviousBlocks: also wants the parent of the oldest block
+#define DGW_RING_CAPACITY (DGW_PAST_BLOCKS_MAX + 1)
+#define DGW_TARGET_SPACING 150 // 2.5 minutes
+
+typedef struct {
+    UInt256 blockHash;
+    UInt256 prevBlock;
+    UInt256 target; // expanded from the compact target once, when the header enters the ring
+    uint32_t timestamp;
+    uint32_t height;
+} DSDarkGravityWaveEntry;
+
+// The window sum never gets near 2^256 (25 targets of at most 2^236), these only have to agree with the generic
+// uInt256 helpers on that range, but they work on whole words instead of bit by bit.
+
+static inline UInt256 dgwAdd(UInt256 a, UInt256 b) {
+    UInt256 r;
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t s = a.u64[i] + carry;
+        carry = s < carry;
+        r.u64[i] = s + b.u64[i];
+        carry += r.u64[i] < s;
+    }
+    return r;
+}
+
+static inline UInt256 dgwSubtract(UInt256 a, UInt256 b) {
+    UInt256 r;
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t d = a.u64[i] - b.u64[i];
+        uint64_t nextBorrow = a.u64[i] < b.u64[i];
+        r.u64[i] = d - borrow;
+        nextBorrow |= d < borrow;
+        borrow = nextBorrow;
+    }
+    return r;
+}
+
+static inline UInt256 dgwMultiply(UInt256 a, uint32_t b) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t n = carry + (uint64_t)b * (uint64_t)a.u32[i];
+        a.u32[i] = (uint32_t)n;
+        carry = n >> 32;
+    }
+    return a;
+}
+
+static inline UInt256 dgwDivide(UInt256 a, uint32_t b) {
+    UInt256 r;
+    uint64_t remainder = 0;
+    for (int i = 7; i >= 0; i--) {
+        uint64_t n = (remainder << 32) | a.u32[i];
+        r.u32[i] = (uint32_t)(n / b);
+        remainder = n % b;
+    }
+    return r;
+}
+
+@interface DSDarkGravityWave () {
+    DSDarkGravityWaveEntry _entries[DGW_RING_CAPACITY];
+    NSUInteger _head; // newest entry
+    NSUInteger _count;
+    UInt256 _sumTargets; // over the newest DGW_PAST_BLOCKS_MAX entries
+}
+
+@property (nonatomic, weak) DSChain *chain;
+
+@end
+
+@implementation DSDarkGravityWave
+
+- (instancetype)initWithChain:(DSChain *)chain {
+    NSParameterAssert(chain);
+    if (!(self = [super init])) return nil;
+    self.chain = chain;
+    return self;
+}
+
+- (UInt256)tipBlockHash {
+    @synchronized(self) {
+        return _count ? _entries[_head].blockHash : UINT256_ZERO;
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized(self) {
+        return _count;
+    }
+}
+
+- (void)reset {
+    @synchronized(self) {
+        [self clear];
+    }
+}
+
+// MARK: - Ring
+
+- (void)clear {
+    _head = 0;
+    _count = 0;
+    _sumTargets = UINT256_ZERO;
+}
+
+// 0 is the newest entry
+- (DSDarkGravityWaveEntry *)entryAtDepth:(NSUInteger)depth {
+    return &_entries[(_head + DGW_RING_CAPACITY - depth) % DGW_RING_CAPACITY];
+}
+
+- (void)fillEntry:(DSDarkGravityWaveEntry *)entry withBlock:(DSBlock *)block {
+    entry->blockHash = block.blockHash;
+    entry->prevBlock = block.prevBlock;
+    entry->target = setCompactLE(block.target);
+    entry->timestamp = block.timestamp;
+    entry->height = block.height;
+}
+
+- (void)appendNewerBlock:(DSBlock *)block {
+    if (_count >= DGW_PAST_BLOCKS_MAX) {
+        // the oldest entry of the window slides out of the sum
+        _sumTargets = dgwSubtract(_sumTargets, [self entryAtDepth:DGW_PAST_BLOCKS_MAX - 1]->target);
+    }
+    if (_count) _head = (_head + 1) % DGW_RING_CAPACITY;
+    DSDarkGravityWaveEntry *entry = &_entries[_head];
+    [self fillEntry:entry withBlock:block];
+    _sumTargets = dgwAdd(_sumTargets, entry->target);
+    if (_count < DGW_RING_CAPACITY) _count++;
+}
+
+- (void)appendOlderBlock:(DSBlock *)block {
+    NSAssert(_count < DGW_RING_CAPACITY, @"The ring is full");
+    DSDarkGravityWaveEntry *entry = [self entryAtDepth:_count];
+    [self fillEntry:entry withBlock:block];
+    if (_count < DGW_PAST_BLOCKS_MAX) {
+        _sumTargets = dgwAdd(_sumTargets, entry->target);
+    }
+    _count++;
+}
+
+// Moves the newest entry to the given block hash. Headers usually arrive one after the other so this is a single
+// lookup, otherwise the branch is walked back until it meets the ring or the ring is rebuilt from scratch.
+- (void)moveToBlockHash:(UInt256)blockHash withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks {
+    if (!_count || !uint256_eq(_entries[_head].blockHash, blockHash)) {
+        UInt256 tipBlockHash = _count ? _entries[_head].blockHash : UINT256_ZERO;
+        NSMutableArray<DSBlock *> *blocks = [NSMutableArray array];
+        DSBlock *block = uint256_is_zero(blockHash) ? nil : previousBlocks[uint256_obj(blockHash)];
+        while (block && blocks.count < DGW_RING_CAPACITY && !(_count && uint256_eq(block.blockHash, tipBlockHash))) {
+            [blocks addObject:block];
+            block = previousBlocks[block.prevBlockValue];
+        }
+        if (block && _count && uint256_eq(block.blockHash, tipBlockHash)) {
+            for (DSBlock *newerBlock in [blocks reverseObjectEnumerator]) {
+                [self appendNewerBlock:newerBlock];
+            }
+        } else {
+            [self clear];
+            for (DSBlock *olderBlock in blocks) {
+                [self appendOlderBlock:olderBlock];
+            }
+        }
+    }
+    // a ring started right after a checkpoint grows back as far as the previous blocks go
+    while (_count && _count < DGW_RING_CAPACITY) {
+        DSDarkGravityWaveEntry *oldest = [self entryAtDepth:_count - 1];
+        if (oldest->height == 0 || uint256_is_zero(oldest->prevBlock)) break;
+        DSBlock *olderBlock = previousBlocks[uint256_obj(oldest->prevBlock)];
+        if (!olderBlock) break;
+        [self appendOlderBlock:olderBlock];
+    }
+}
+
+// MARK: - Difficulty
+
+- (BOOL)canCalculateDifficultyForBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks {
+    DSChain *chain = self.chain;
+    @synchronized(self) {
+        [self moveToBlockHash:block.prevBlock withPreviousBlocks:previousBlocks];
+        if (!_count) {
+            return FALSE;
+        }
+        DSDarkGravityWaveEntry *previous = &_entries[_head];
+        if (previous->height == 0 || previous->height < DGW_PAST_BLOCKS_MIN + (chain.isDevnetAny ? 1 : 0)) {
+            return TRUE;
+        }
+        if (chain.allowMinDifficultyBlocks && block.timestamp > previous->timestamp + 600) {
+            return TRUE;
+        }
+        return _count == DGW_RING_CAPACITY;
+    }
+}
+
+- (BOOL)verifyDifficultyForBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks rDifficulty:(uint32_t *)difficulty {
+    if ([self.chain isDevnetAny]) {
+        return true;
+    }
+    uint32_t darkGravityWaveTarget = [self darkGravityWaveTargetForBlock:block withPreviousBlocks:previousBlocks];
+    if (difficulty) {
+        *difficulty = darkGravityWaveTarget;
+    }
+    int32_t diff = block.target - darkGravityWaveTarget;
+    return (abs(diff) < 2); // same tolerance as -[DSBlock verifyDifficultyWithPreviousBlocks:rDifficulty:]
+}
+
+- (int32_t)darkGravityWaveTargetForBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks {
+    DSChain *chain = self.chain;
+    @synchronized(self) {
+        [self moveToBlockHash:block.prevBlock withPreviousBlocks:previousBlocks];
+        if (!_count) {
+            return chain.maxProofOfWorkTarget;
+        }
+        DSDarkGravityWaveEntry *previous = &_entries[_head];
+        if (previous->height == 0 || previous->height < DGW_PAST_BLOCKS_MIN + (chain.isDevnetAny ? 1 : 0)) {
+            return chain.maxProofOfWorkTarget;
+        }
+        if (chain.allowMinDifficultyBlocks) {
+            if (block.timestamp > previous->timestamp + 2 * 60 * 60) {
+                return chain.maxProofOfWorkTarget;
+            }
+            if (block.timestamp > (previous->timestamp + 2.5 * 60 * 4)) {
+                uint32_t compact = getCompactLE(dgwMultiply(previous->target, 10));
+                return compact > chain.maxProofOfWorkTarget ? chain.maxProofOfWorkTarget : compact;
+            }
+        }
+        if (_count < DGW_PAST_BLOCKS_MAX) {
+            // part of the window is missing, the walk decides what to make of it
+            return [block darkGravityWaveTargetWithPreviousBlocks:previousBlocks];
+        }
+        // the original walk adds the newest target twice and divides by one more than the window
+        UInt256 darkTarget = dgwDivide(dgwAdd(_sumTargets, previous->target), DGW_PAST_BLOCKS_MAX + 1);
+        int64_t targetTimespan = DGW_PAST_BLOCKS_MAX * DGW_TARGET_SPACING;
+        int64_t actualTimespan = (int32_t)((int64_t)previous->timestamp - (int64_t)[self entryAtDepth:DGW_PAST_BLOCKS_MAX - 1]->timestamp);
+        // Limit the re-adjustment to 3x or 0.33x
+        if (actualTimespan < targetTimespan / 3)
+            actualTimespan = targetTimespan / 3;
+        if (actualTimespan > targetTimespan * 3)
+            actualTimespan = targetTimespan * 3;
+        darkTarget = dgwDivide(dgwMultiply(darkTarget, (uint32_t)actualTimespan), (uint32_t)targetTimespan);
+        if (uint256_sup(darkTarget, chain.maxProofOfWork)) {
+            return chain.maxProofOfWorkTarget;
+        }
+        return getCompactLE(darkTarget);
+    }
+}
+
+@end
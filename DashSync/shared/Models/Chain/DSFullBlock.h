@@ -21,14 +21,23 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class DSBlockMiner;
+
 @interface DSFullBlock : DSBlock
 
 @property (nonatomic, readonly) NSArray<DSTransaction *> *transactions;
 
 - (instancetype)initWithCoinbaseTransaction:(DSCoinbaseTransaction *)coinbaseTransaction transactions:(NSSet<DSTransaction *> *)transactions previousBlockHash:(UInt256)previousBlockHash previousBlocks:(NSDictionary *)previousBlocks timestamp:(uint32_t)timestamp height:(uint32_t)height onChain:(DSChain *)chain;
 
+- (instancetype)initWithCoinbaseTransaction:(DSCoinbaseTransaction *)coinbaseTransaction orderedTransactions:(NSArray<DSTransaction *> *)transactions previousBlockHash:(UInt256)previousBlockHash previousBlocks:(NSDictionary *)previousBlocks timestamp:(uint32_t)timestamp height:(uint32_t)height onChain:(DSChain *)chain;
+
+/*! @brief The block message, header then transactions with the coinbase first. */
+- (NSData *)blockMessage;
+
 - (BOOL)mineBlockAfterBlock:(DSBlock *)block withNonceOffset:(uint32_t)nonceOffset withTimeout:(NSTimeInterval)timeout rAttempts:(uint64_t *)rAttempts;
 
+- (BOOL)mineBlockAfterBlock:(DSBlock *)block withNonceOffset:(uint32_t)nonceOffset withTimeout:(NSTimeInterval)timeout usingMiner:(DSBlockMiner *)miner rAttempts:(uint64_t *)rAttempts;
+
 - (void)setTargetWithPreviousBlocks:(NSDictionary *)previousBlocks;
 
 + (instancetype)fullBlockWithMessage:(NSData *)message onChain:(DSChain *)chain;
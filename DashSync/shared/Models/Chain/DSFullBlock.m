@@ -17,9 +17,11 @@
 
 #import "DSFullBlock.h"
 #import "DSBlock+Protected.h"
+#import "DSBlockMiner.h"
 #import "DSChain.h"
 #import "DSChainLock.h"
 #import "DSKeyManager.h"
+#import "DSMerkleTree.h"
 #import "DSTransactionFactory.h"
 #import "NSData+DSHash.h"
 #import "NSData+Dash.h"
@@ -90,21 +92,22 @@
 }
 
 - (instancetype)initWithCoinbaseTransaction:(DSCoinbaseTransaction *)coinbaseTransaction transactions:(NSSet<DSTransaction *> *)transactions previousBlockHash:(UInt256)previousBlockHash previousBlocks:(NSDictionary *)previousBlocks timestamp:(uint32_t)timestamp height:(uint32_t)height onChain:(DSChain *)chain {
+    return [self initWithCoinbaseTransaction:coinbaseTransaction orderedTransactions:[transactions allObjects] previousBlockHash:previousBlockHash previousBlocks:previousBlocks timestamp:timestamp height:height onChain:chain];
+}
+
+- (instancetype)initWithCoinbaseTransaction:(DSCoinbaseTransaction *)coinbaseTransaction orderedTransactions:(NSArray<DSTransaction *> *)transactions previousBlockHash:(UInt256)previousBlockHash previousBlocks:(NSDictionary *)previousBlocks timestamp:(uint32_t)timestamp height:(uint32_t)height onChain:(DSChain *)chain {
     if (!(self = [super initWithVersion:COINBASE_TX_CORE_19 timestamp:timestamp height:height onChain:chain])) return nil;
-    NSMutableSet *totalTransactionsSet = [transactions mutableCopy];
-    [totalTransactionsSet addObject:coinbaseTransaction];
-    self.totalTransactions = (uint32_t)[totalTransactionsSet count];
-    if (!transactions.count) {
-        self.merkleRoot = coinbaseTransaction.txHash;
-    }
     self.prevBlock = previousBlockHash;
-    self.mTransactions = [[transactions allObjects] mutableCopy];
-    [self.mTransactions addObject:coinbaseTransaction];
+    // the coinbase comes first
+    self.mTransactions = [NSMutableArray arrayWithObject:coinbaseTransaction];
+    [self.mTransactions addObjectsFromArray:transactions];
+    self.totalTransactions = (uint32_t)self.mTransactions.count;
     NSMutableArray<NSValue *> *mTxHashes = [NSMutableArray array];
     for (DSTransaction *transaction in self.mTransactions) {
         [mTxHashes addObject:uint256_obj(transaction.txHash)];
     }
     self.transactionHashes = [mTxHashes copy];
+    self.merkleRoot = [DSMerkleTree merkleRootOfHashes:[self packedTransactionHashes] hashFunction:DSMerkleTreeHashFunction_SHA256_2];
     [self setTargetWithPreviousBlocks:previousBlocks];
     return self;
 }
@@ -113,6 +116,15 @@
     return [_mTransactions copy];
 }
 
+- (NSData *)blockMessage {
+    NSMutableData *d = [[self toData] mutableCopy];
+    [d appendVarInt:self.mTransactions.count];
+    for (DSTransaction *transaction in self.mTransactions) {
+        [d appendData:transaction.toData];
+    }
+    return d;
+}
+
 - (void)setTargetWithPreviousBlocks:(NSDictionary *)previousBlocks {
     if (self.height <= self.chain.minimumDifficultyBlocks) {
         self.target = self.chain.maxProofOfWorkTarget;
@@ -121,17 +133,6 @@
     }
 }
 
-- (NSMutableData *)preNonceMutableData {
-    NSMutableData *d = [NSMutableData data];
-
-    [d appendUInt32:self.version];
-    [d appendUInt256:self.prevBlock];
-    [d appendUInt256:self.merkleRoot];
-    [d appendUInt32:self.timestamp];
-    [d appendUInt32:self.target];
-    return d;
-}
-
 - (NSArray *)transactionHashes {
     NSMutableArray *mArray = [NSMutableArray array];
     for (DSTransaction *transaction in self.mTransactions) {
@@ -140,46 +141,30 @@
     return [mArray copy];
 }
 
-- (NSArray *)transactionHashesAsData {
-    NSMutableArray *mArray = [NSMutableArray array];
+- (NSData *)packedTransactionHashes {
+    NSMutableData *hashes = [NSMutableData dataWithCapacity:self.mTransactions.count * sizeof(UInt256)];
     for (DSTransaction *transaction in self.mTransactions) {
-        [mArray addObject:uint256_data(transaction.txHash)];
+        [hashes appendUInt256:transaction.txHash];
     }
-    return [mArray copy];
+    return hashes;
 }
 
 - (BOOL)isMerkleTreeValid {
-    UInt256 merkleRoot = [NSData merkleRootFromHashes:[self transactionHashesAsData]].UInt256;
+    UInt256 merkleRoot = [DSMerkleTree merkleRootOfHashes:[self packedTransactionHashes] hashFunction:DSMerkleTreeHashFunction_SHA256_2];
     if (self.totalTransactions > 0 && !uint256_eq(merkleRoot, self.merkleRoot)) return NO; // merkle root check failed
     return YES;
 }
 
-#define LOG_MINING_BEST_TRIES 0
-
 - (BOOL)mineBlockAfterBlock:(DSBlock *)block withNonceOffset:(uint32_t)nonceOffset withTimeout:(NSTimeInterval)timeout rAttempts:(uint64_t *)rAttempts {
-    BOOL found = false;
+    return [self mineBlockAfterBlock:block withNonceOffset:nonceOffset withTimeout:timeout usingMiner:[[DSBlockMiner alloc] init] rAttempts:rAttempts];
+}
+
+- (BOOL)mineBlockAfterBlock:(DSBlock *)block withNonceOffset:(uint32_t)nonceOffset withTimeout:(NSTimeInterval)timeout usingMiner:(DSBlockMiner *)miner rAttempts:(uint64_t *)rAttempts {
     self.prevBlock = block.blockHash;
-    NSMutableData *preNonceMutableData = [self preNonceMutableData];
-    uint32_t i = 0;
-    UInt256 fullTarget = setCompactLE(block.target);
-    do {
-        NSMutableData *d = [preNonceMutableData mutableCopy];
-        [d appendUInt32:i];
-        UInt256 potentialBlockHash = [DSKeyManager x11:d];
-
-        if (!uint256_sup(potentialBlockHash, fullTarget)) {
-            //We found a block
-            self.blockHash = potentialBlockHash;
-            found = TRUE;
-            break;
-        }
-        i++;
-    } while (i != UINT32_MAX);
-    if (!found) {
-        self.timestamp++;
-        return [self mineBlockAfterBlock:block withNonceOffset:0 withTimeout:timeout rAttempts:rAttempts];
+    BOOL found = [miner mineBlock:self withNonceOffset:nonceOffset withTimeout:timeout];
+    if (rAttempts) {
+        *rAttempts += miner.attempts;
     }
-    rAttempts += i;
     return found;
 }
 
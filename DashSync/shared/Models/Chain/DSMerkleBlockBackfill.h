@@ -0,0 +1,77 @@
+//
+//  DSMerkleBlockBackfill.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define MERKLE_BLOCK_BACKFILL_RANGE_LENGTH 500 // a block zone
+#define MERKLE_BLOCK_BACKFILL_WINDOW_RANGES 8
+#define MERKLE_BLOCK_BACKFILL_REQUEST_TIMEOUT 20.0
+
+@class DSBlock, DSMerkleBlock, DSPeer, DSTransaction;
+
+/*! @brief YES when the merkleblocks of the range are needed, NO when its headers are enough. */
+typedef BOOL (^DSMerkleBlockBackfillZoneFilterBlock)(DSBlock *firstHeader, DSBlock *lastHeader);
+/*! @brief Registers the transactions the block matched, then adds the block to the chain, NO when it did not extend it. */
+typedef BOOL (^DSMerkleBlockBackfillApplyBlock)(DSBlock *block, NSArray<DSTransaction *> *transactions, BOOL isHeaderOnly, DSPeer *_Nullable peer);
+
+/*! @brief Fetches merkleblocks behind a header chain that is already known, from several peers at once. The headers are cut into ranges along block zones, ranges of zones the wallets care about are handed out to peers in any order while the other ranges only need their headers. Received blocks and the transactions they matched are checked against their header and kept in a reorder buffer until every block before them is there, then applied in order, so that a spend is never registered before the transaction it spends. At most windowRanges ranges past the applied height are requested or buffered at a time. */
+@interface DSMerkleBlockBackfill : NSObject
+
+@property (nonatomic, readonly) uint32_t startHeight;
+@property (nonatomic, readonly) uint32_t endHeight;
+/*! @brief Height of the last applied block, startHeight - 1 before any. */
+@property (nonatomic, readonly) uint32_t appliedHeight;
+@property (nonatomic, readonly) NSUInteger rangeCount;
+@property (nonatomic, readonly) NSUInteger merkleBlockRangeCount;
+@property (nonatomic, readonly) NSUInteger requestCount;
+@property (nonatomic, readonly) NSUInteger bufferedCount;
+@property (nonatomic, readonly) NSUInteger maximumBufferedCount;
+@property (nonatomic, readonly) NSUInteger rejectedCount;
+@property (nonatomic, readonly, getter=isComplete) BOOL complete;
+/*! @brief Set once a block could not be applied, nothing is requested anymore. */
+@property (nonatomic, readonly, getter=isFailed) BOOL failed;
+/*! @brief A range without progress for that long is handed to the next idle peer. */
+@property (nonatomic, assign) NSTimeInterval requestTimeout;
+
+/*! @brief The headers follow each other with their heights set, the first one extends the chain the blocks are applied to. */
+- (instancetype)initWithHeaders:(NSArray<DSBlock *> *)headers zoneFilter:(DSMerkleBlockBackfillZoneFilterBlock _Nullable)zoneFilter usingBlock:(DSMerkleBlockBackfillApplyBlock)applyBlock;
+- (instancetype)initWithHeaders:(NSArray<DSBlock *> *)headers windowRanges:(NSUInteger)windowRanges zoneFilter:(DSMerkleBlockBackfillZoneFilterBlock _Nullable)zoneFilter usingBlock:(DSMerkleBlockBackfillApplyBlock)applyBlock NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Applies the leading ranges that only need their headers. */
+- (void)start;
+
+/*! @brief Hashes of the blocks to get from the peer, nil while it still has a range to deliver or when the window is full. */
+- (NSArray<NSValue *> *_Nullable)nextBlockHashesForPeer:(DSPeer *)peer;
+
+- (BOOL)containsBlockHash:(UInt256)blockHash;
+/*! @brief Keeps a transaction matched by a block that was not applied yet, it is handed over with the block. NO for a block that is not backfilled or was already applied. */
+- (BOOL)receivedTransaction:(DSTransaction *)transaction inBlock:(DSBlock *)block;
+/*! @brief NO for a block that is not behind a known header, does not match it, or was already received. Blocks are applied in order as soon as every block before them was received. */
+- (BOOL)receivedBlock:(DSMerkleBlock *)block fromPeer:(DSPeer *)peer;
+
+/*! @brief Ranges the peer was asked for go back to the queue, blocks it already delivered are kept. */
+- (void)peerDisconnected:(DSPeer *)peer;
+/*! @brief Drops the buffered blocks and queues every range that was not applied, after the filter of the peers changed. */
+- (void)restart;
+
+@end
+
+NS_ASSUME_NONNULL_END
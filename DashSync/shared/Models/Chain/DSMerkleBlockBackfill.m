@@ -0,0 +1,295 @@
+//
+//  DSMerkleBlockBackfill.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSMerkleBlockBackfill.h"
+#import "DSBlock+Protected.h"
+#import "DSLogger.h"
+#import "DSMerkleBlock.h"
+#import "DSPeer.h"
+#import "DSTransaction.h"
+#import "NSData+Dash.h"
+#import "NSDate+Utils.h"
+
+typedef NS_ENUM(NSUInteger, DSMerkleBlockBackfillRangeState)
+{
+    DSMerkleBlockBackfillRangeState_Queued,
+    DSMerkleBlockBackfillRangeState_Requested,
+    DSMerkleBlockBackfillRangeState_Received,
+    DSMerkleBlockBackfillRangeState_Applied,
+};
+
+@interface DSMerkleBlockBackfillRange : NSObject
+
+// indexes of the headers in the range, the end one excluded
+@property (nonatomic, assign) NSUInteger startIndex, endIndex;
+@property (nonatomic, assign) BOOL needsMerkleBlocks;
+@property (nonatomic, assign) DSMerkleBlockBackfillRangeState state;
+@property (nonatomic, strong) DSPeer *peer;
+// applied or buffered blocks
+@property (nonatomic, assign) NSUInteger receivedCount;
+// last request or received block
+@property (nonatomic, assign) NSTimeInterval progressTime;
+
+@end
+
+@implementation DSMerkleBlockBackfillRange
+
+@end
+
+@interface DSMerkleBlockBackfill ()
+
+@property (nonatomic, strong) NSArray<DSBlock *> *headers;
+@property (nonatomic, strong) NSDictionary<NSValue *, NSNumber *> *headerIndexes;
+@property (nonatomic, strong) NSArray<DSMerkleBlockBackfillRange *> *ranges;
+@property (nonatomic, assign) NSUInteger windowRanges;
+@property (nonatomic, copy) DSMerkleBlockBackfillApplyBlock applyBlock;
+// header index to the block received for it and the peer it came from
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, DSMerkleBlock *> *bufferedBlocks;
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, DSPeer *> *bufferedPeers;
+// header index to the transactions matched by the block, they arrive before it
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSMutableArray<DSTransaction *> *> *bufferedTransactions;
+@property (nonatomic, assign) NSUInteger nextIndex, firstRangeIndex;
+@property (nonatomic, assign) NSUInteger merkleBlockRangeCount, requestCount, maximumBufferedCount, rejectedCount;
+@property (nonatomic, assign) BOOL failed;
+
+@end
+
+@implementation DSMerkleBlockBackfill
+
+- (instancetype)initWithHeaders:(NSArray<DSBlock *> *)headers zoneFilter:(DSMerkleBlockBackfillZoneFilterBlock)zoneFilter usingBlock:(DSMerkleBlockBackfillApplyBlock)applyBlock {
+    return [self initWithHeaders:headers windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:zoneFilter usingBlock:applyBlock];
+}
+
+- (instancetype)initWithHeaders:(NSArray<DSBlock *> *)headers windowRanges:(NSUInteger)windowRanges zoneFilter:(DSMerkleBlockBackfillZoneFilterBlock)zoneFilter usingBlock:(DSMerkleBlockBackfillApplyBlock)applyBlock {
+    NSParameterAssert(headers.count > 0);
+    NSParameterAssert(windowRanges > 0);
+    if (!(self = [super init])) return nil;
+    self.headers = headers;
+    self.windowRanges = windowRanges;
+    self.applyBlock = applyBlock;
+    self.requestTimeout = MERKLE_BLOCK_BACKFILL_REQUEST_TIMEOUT;
+    self.bufferedBlocks = [NSMutableDictionary dictionary];
+    self.bufferedPeers = [NSMutableDictionary dictionary];
+    self.bufferedTransactions = [NSMutableDictionary dictionary];
+
+    NSMutableDictionary<NSValue *, NSNumber *> *headerIndexes = [NSMutableDictionary dictionaryWithCapacity:headers.count];
+    NSMutableArray<DSMerkleBlockBackfillRange *> *ranges = [NSMutableArray array];
+    for (NSUInteger index = 0; index < headers.count; index++) {
+        DSBlock *header = headers[index];
+        NSAssert(index == 0 || header.height == headers[index - 1].height + 1, @"headers should follow each other");
+        headerIndexes[uint256_obj(header.blockHash)] = @(index);
+        if (index == 0 || header.height % MERKLE_BLOCK_BACKFILL_RANGE_LENGTH == 0) {
+            DSMerkleBlockBackfillRange *range = [[DSMerkleBlockBackfillRange alloc] init];
+            range.startIndex = index;
+            [ranges addObject:range];
+        }
+        ranges.lastObject.endIndex = index + 1;
+    }
+    for (DSMerkleBlockBackfillRange *range in ranges) {
+        range.needsMerkleBlocks = !zoneFilter || zoneFilter(headers[range.startIndex], headers[range.endIndex - 1]);
+        if (range.needsMerkleBlocks) self.merkleBlockRangeCount++;
+    }
+    self.headerIndexes = headerIndexes;
+    self.ranges = ranges;
+    return self;
+}
+
+- (uint32_t)startHeight {
+    return self.headers.firstObject.height;
+}
+
+- (uint32_t)endHeight {
+    return self.headers.lastObject.height;
+}
+
+- (uint32_t)appliedHeight {
+    @synchronized(self) {
+        return self.startHeight + (uint32_t)self.nextIndex - 1;
+    }
+}
+
+- (NSUInteger)rangeCount {
+    return self.ranges.count;
+}
+
+- (NSUInteger)bufferedCount {
+    @synchronized(self) {
+        return self.bufferedBlocks.count;
+    }
+}
+
+- (BOOL)isComplete {
+    @synchronized(self) {
+        return self.nextIndex == self.headers.count;
+    }
+}
+
+- (DSMerkleBlockBackfillRange *)rangeForIndex:(NSUInteger)index {
+    return self.ranges[self.headers[index].height / MERKLE_BLOCK_BACKFILL_RANGE_LENGTH - self.startHeight / MERKLE_BLOCK_BACKFILL_RANGE_LENGTH];
+}
+
+// MARK: - Applying
+
+- (void)start {
+    @synchronized(self) {
+        [self applyReadyBlocks];
+    }
+}
+
+// only called while synchronized, blocks are applied under the lock so that they can only be applied in order
+- (void)applyReadyBlocks {
+    while (!self.failed && self.nextIndex < self.headers.count) {
+        DSMerkleBlockBackfillRange *range = self.ranges[self.firstRangeIndex];
+        NSNumber *index = @(self.nextIndex);
+        DSBlock *block = range.needsMerkleBlocks ? self.bufferedBlocks[index] : self.headers[self.nextIndex];
+        if (!block) break;
+        DSPeer *peer = self.bufferedPeers[index];
+        NSArray<DSTransaction *> *transactions = self.bufferedTransactions[index] ?: @[];
+        [self.bufferedBlocks removeObjectForKey:index];
+        [self.bufferedPeers removeObjectForKey:index];
+        [self.bufferedTransactions removeObjectForKey:index];
+        if (!self.applyBlock(block, transactions, !range.needsMerkleBlocks, peer)) {
+            DSLogWarn(@"DSMerkleBlockBackfill", @"block %@ at height %u did not extend the chain, stopping backfill", uint256_reverse_hex(block.blockHash), block.height);
+            self.failed = YES;
+            break;
+        }
+        self.nextIndex++;
+        if (self.nextIndex == range.endIndex) {
+            range.state = DSMerkleBlockBackfillRangeState_Applied;
+            range.peer = nil;
+            self.firstRangeIndex++;
+        }
+    }
+}
+
+// MARK: - Requesting
+
+- (NSArray<NSValue *> *)nextBlockHashesForPeer:(DSPeer *)peer {
+    @synchronized(self) {
+        if (self.failed) return nil;
+        NSUInteger windowEnd = MIN(self.firstRangeIndex + self.windowRanges, self.ranges.count);
+        NSTimeInterval now = [NSDate timeIntervalSince1970];
+        DSMerkleBlockBackfillRange *queuedRange = nil, *stalledRange = nil;
+        for (NSUInteger rangeIndex = self.firstRangeIndex; rangeIndex < windowEnd; rangeIndex++) {
+            DSMerkleBlockBackfillRange *range = self.ranges[rangeIndex];
+            if (!range.needsMerkleBlocks) continue;
+            if (range.state == DSMerkleBlockBackfillRangeState_Requested) {
+                if ([range.peer isEqual:peer]) return nil;
+                if (!stalledRange && now - range.progressTime > self.requestTimeout) stalledRange = range;
+            } else if (!queuedRange && range.state == DSMerkleBlockBackfillRangeState_Queued) {
+                queuedRange = range;
+            }
+        }
+        DSMerkleBlockBackfillRange *range = queuedRange ? queuedRange : stalledRange;
+        if (!range) return nil;
+        if (range == stalledRange) DSLogInfo(@"DSMerkleBlockBackfill", @"range at height %u stalled on %@, asking %@", self.headers[range.startIndex].height, range.peer.host, peer.host);
+        range.state = DSMerkleBlockBackfillRangeState_Requested;
+        range.peer = peer;
+        range.progressTime = now;
+        self.requestCount++;
+        NSMutableArray<NSValue *> *blockHashes = [NSMutableArray arrayWithCapacity:range.endIndex - range.startIndex];
+        for (NSUInteger index = MAX(range.startIndex, self.nextIndex); index < range.endIndex; index++) {
+            if (self.bufferedBlocks[@(index)]) continue;
+            [blockHashes addObject:uint256_obj(self.headers[index].blockHash)];
+        }
+        return blockHashes;
+    }
+}
+
+// MARK: - Receiving
+
+- (BOOL)containsBlockHash:(UInt256)blockHash {
+    return self.headerIndexes[uint256_obj(blockHash)] != nil;
+}
+
+- (BOOL)receivedTransaction:(DSTransaction *)transaction inBlock:(DSBlock *)block {
+    NSNumber *index = self.headerIndexes[uint256_obj(block.blockHash)];
+    if (!index) return NO;
+    @synchronized(self) {
+        DSMerkleBlockBackfillRange *range = [self rangeForIndex:index.unsignedIntegerValue];
+        if (self.failed || !range.needsMerkleBlocks || index.unsignedIntegerValue < self.nextIndex) return NO;
+        NSMutableArray<DSTransaction *> *transactions = self.bufferedTransactions[index];
+        if (!transactions) {
+            transactions = [NSMutableArray array];
+            self.bufferedTransactions[index] = transactions;
+        }
+        // a range handed to another peer brings its transactions again
+        for (DSTransaction *bufferedTransaction in transactions) {
+            if (uint256_eq(bufferedTransaction.txHash, transaction.txHash)) return YES;
+        }
+        [transactions addObject:transaction];
+        return YES;
+    }
+}
+
+- (BOOL)receivedBlock:(DSMerkleBlock *)block fromPeer:(DSPeer *)peer {
+    NSNumber *index = self.headerIndexes[uint256_obj(block.blockHash)];
+    if (!index) return NO;
+    @synchronized(self) {
+        DSBlock *header = self.headers[index.unsignedIntegerValue];
+        DSMerkleBlockBackfillRange *range = [self rangeForIndex:index.unsignedIntegerValue];
+        if (self.failed || !range.needsMerkleBlocks || index.unsignedIntegerValue < self.nextIndex || self.bufferedBlocks[index]) return NO;
+        if (!uint256_eq(block.prevBlock, header.prevBlock) || !uint256_eq(block.merkleRoot, header.merkleRoot)) {
+            // the transactions came with the forged block
+            [self.bufferedTransactions removeObjectForKey:index];
+            self.rejectedCount++;
+            return NO;
+        }
+        block.height = header.height;
+        self.bufferedBlocks[index] = block;
+        if (peer) self.bufferedPeers[index] = peer;
+        self.maximumBufferedCount = MAX(self.maximumBufferedCount, self.bufferedBlocks.count);
+        range.progressTime = [NSDate timeIntervalSince1970];
+        range.receivedCount++;
+        if (range.receivedCount == range.endIndex - range.startIndex) {
+            range.state = DSMerkleBlockBackfillRangeState_Received;
+            range.peer = nil;
+        }
+        [self applyReadyBlocks];
+        return YES;
+    }
+}
+
+// MARK: - Recovering
+
+- (void)peerDisconnected:(DSPeer *)peer {
+    @synchronized(self) {
+        for (NSUInteger rangeIndex = self.firstRangeIndex; rangeIndex < self.ranges.count; rangeIndex++) {
+            DSMerkleBlockBackfillRange *range = self.ranges[rangeIndex];
+            if (range.state != DSMerkleBlockBackfillRangeState_Requested || ![range.peer isEqual:peer]) continue;
+            range.state = DSMerkleBlockBackfillRangeState_Queued;
+            range.peer = nil;
+        }
+    }
+}
+
+- (void)restart {
+    @synchronized(self) {
+        [self.bufferedBlocks removeAllObjects];
+        [self.bufferedPeers removeAllObjects];
+        [self.bufferedTransactions removeAllObjects];
+        for (NSUInteger rangeIndex = self.firstRangeIndex; rangeIndex < self.ranges.count; rangeIndex++) {
+            DSMerkleBlockBackfillRange *range = self.ranges[rangeIndex];
+            if (!range.needsMerkleBlocks) continue;
+            range.state = DSMerkleBlockBackfillRangeState_Queued;
+            range.peer = nil;
+            range.receivedCount = self.nextIndex > range.startIndex ? self.nextIndex - range.startIndex : 0;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,58 @@
+//
+//  DSTransactionIndex.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSAccount, DSTransaction, DSWallet;
+
+/*! @brief What the chain knows about a transaction hash. Entries are immutable, a change to the owners replaces the entry. */
+@interface DSTransactionIndexEntry : NSObject
+
+@property (nonatomic, readonly) DSTransaction *transaction;
+/*! @brief Accounts holding the transaction, in the order they registered it. */
+@property (nonatomic, readonly) NSArray<DSAccount *> *accounts;
+/*! @brief Wallets of those accounts, then wallets holding it as a special transaction. */
+@property (nonatomic, readonly) NSArray<DSWallet *> *wallets;
+
+@end
+
+/*! @brief Chain wide map from transaction hash to the transaction and the accounts and wallets holding it. Accounts and special transaction holders report every change to their transaction dictionaries, only wallets registered on the chain are indexed. The map is split in stripes by the first byte of the hash, each behind a read write lock, so lookups never wait on each other and only wait on a writer of the same stripe. */
+@interface DSTransactionIndex : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;
+
+- (DSTransactionIndexEntry *_Nullable)entryForTransactionHash:(UInt256)txHash;
+- (DSTransaction *_Nullable)transactionForHash:(UInt256)txHash;
+
+/*! @brief Starts indexing a wallet, adding what its accounts and special transaction holder already have in memory. */
+- (void)attachWallet:(DSWallet *)wallet;
+- (void)detachWallet:(DSWallet *)wallet;
+
+/*! @brief Returns the transaction already indexed under its hash, or the transaction itself, the account holds the returned one so every account shares a single object per hash. */
+- (DSTransaction *)addTransaction:(DSTransaction *)transaction forAccount:(DSAccount *)account;
+- (void)removeTransactionHash:(UInt256)txHash forAccount:(DSAccount *)account;
+- (void)removeTransactionHashes:(NSArray<NSValue *> *)txHashes forAccount:(DSAccount *)account;
+
+- (void)addSpecialTransaction:(DSTransaction *)transaction forWallet:(DSWallet *)wallet;
+- (void)removeSpecialTransactionHashes:(NSArray<NSValue *> *)txHashes forWallet:(DSWallet *)wallet;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,240 @@
+//
+//  DSTransactionIndex.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSTransactionIndex.h"
+#import "DSAccount+Protected.h"
+#import "DSSpecialTransactionsWalletHolder.h"
+#import "DSTransaction.h"
+#import "DSWallet.h"
+#import "NSData+Dash.h"
+#import <pthread.h>
+
+#define TRANSACTION_INDEX_STRIPES 16
+
+// transaction hashes are uniformly distributed, the first byte is as good a stripe as any
+static inline NSUInteger DSTransactionIndexStripe(UInt256 txHash) {
+    return txHash.u8[0] % TRANSACTION_INDEX_STRIPES;
+}
+
+@interface DSTransactionIndexEntry ()
+
+@property (nonatomic, strong) DSTransaction *transaction;
+@property (nonatomic, strong) NSArray<DSAccount *> *accounts;
+@property (nonatomic, strong) NSArray<DSWallet *> *specialTransactionWallets;
+@property (nonatomic, strong) NSArray<DSWallet *> *wallets;
+
+@end
+
+@implementation DSTransactionIndexEntry
+
+- (instancetype)initWithTransaction:(DSTransaction *)transaction accounts:(NSArray<DSAccount *> *)accounts specialTransactionWallets:(NSArray<DSWallet *> *)specialTransactionWallets {
+    if (!(self = [super init])) return nil;
+    self.transaction = transaction;
+    self.accounts = accounts;
+    self.specialTransactionWallets = specialTransactionWallets;
+    NSMutableOrderedSet<DSWallet *> *wallets = [NSMutableOrderedSet orderedSet];
+    for (DSAccount *account in accounts) {
+        if (account.wallet) [wallets addObject:account.wallet];
+    }
+    [wallets addObjectsFromArray:specialTransactionWallets];
+    self.wallets = wallets.array;
+    return self;
+}
+
+- (DSTransactionIndexEntry *_Nullable)entryWithAccounts:(NSArray<DSAccount *> *)accounts specialTransactionWallets:(NSArray<DSWallet *> *)specialTransactionWallets {
+    if (!accounts.count && !specialTransactionWallets.count) return nil;
+    return [[DSTransactionIndexEntry alloc] initWithTransaction:self.transaction accounts:accounts specialTransactionWallets:specialTransactionWallets];
+}
+
+@end
+
+@interface DSTransactionIndex () {
+    pthread_rwlock_t _locks[TRANSACTION_INDEX_STRIPES];
+}
+
+@property (nonatomic, strong) NSArray<NSMutableDictionary<NSValue *, DSTransactionIndexEntry *> *> *stripes;
+@property (atomic, strong) NSSet<DSWallet *> *attachedWallets;
+
+@end
+
+@implementation DSTransactionIndex
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    NSMutableArray *stripes = [NSMutableArray arrayWithCapacity:TRANSACTION_INDEX_STRIPES];
+    for (NSUInteger i = 0; i < TRANSACTION_INDEX_STRIPES; i++) {
+        pthread_rwlock_init(&_locks[i], NULL);
+        [stripes addObject:[NSMutableDictionary dictionary]];
+    }
+    self.stripes = stripes;
+    self.attachedWallets = [NSSet set];
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < TRANSACTION_INDEX_STRIPES; i++) {
+        pthread_rwlock_destroy(&_locks[i]);
+    }
+}
+
+- (NSUInteger)count {
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < TRANSACTION_INDEX_STRIPES; i++) {
+        pthread_rwlock_rdlock(&_locks[i]);
+        count += self.stripes[i].count;
+        pthread_rwlock_unlock(&_locks[i]);
+    }
+    return count;
+}
+
+// MARK: - Lookup
+
+- (DSTransactionIndexEntry *)entryForTransactionHash:(UInt256)txHash {
+    NSUInteger stripe = DSTransactionIndexStripe(txHash);
+    NSValue *hash = uint256_obj(txHash);
+    pthread_rwlock_rdlock(&_locks[stripe]);
+    DSTransactionIndexEntry *entry = self.stripes[stripe][hash];
+    pthread_rwlock_unlock(&_locks[stripe]);
+    return entry;
+}
+
+- (DSTransaction *)transactionForHash:(UInt256)txHash {
+    return [self entryForTransactionHash:txHash].transaction;
+}
+
+// MARK: - Updates
+
+// the block returns the entry replacing the current one, nil removes the hash
+- (void)updateEntryForHash:(NSValue *)hash usingBlock:(DSTransactionIndexEntry *_Nullable (^)(DSTransactionIndexEntry *_Nullable entry))block {
+    UInt256 txHash;
+    [hash getValue:&txHash];
+    NSUInteger stripe = DSTransactionIndexStripe(txHash);
+    pthread_rwlock_wrlock(&_locks[stripe]);
+    NSMutableDictionary<NSValue *, DSTransactionIndexEntry *> *entries = self.stripes[stripe];
+    DSTransactionIndexEntry *entry = entries[hash];
+    DSTransactionIndexEntry *updatedEntry = block(entry);
+    if (updatedEntry != entry) {
+        if (updatedEntry) {
+            entries[hash] = updatedEntry;
+        } else {
+            [entries removeObjectForKey:hash];
+        }
+    }
+    pthread_rwlock_unlock(&_locks[stripe]);
+}
+
+- (BOOL)isAttachedWallet:(DSWallet *)wallet {
+    return wallet && [self.attachedWallets containsObject:wallet];
+}
+
+- (DSTransaction *)addTransaction:(DSTransaction *)transaction forAccount:(DSAccount *)account {
+    if (![self isAttachedWallet:account.wallet]) return transaction;
+    __block DSTransaction *indexedTransaction = transaction;
+    [self updateEntryForHash:uint256_obj(transaction.txHash)
+                  usingBlock:^DSTransactionIndexEntry *(DSTransactionIndexEntry *entry) {
+                      if (!entry) return [[DSTransactionIndexEntry alloc] initWithTransaction:transaction accounts:@[account] specialTransactionWallets:@[]];
+                      indexedTransaction = entry.transaction;
+                      if ([entry.accounts indexOfObjectIdenticalTo:account] != NSNotFound) return entry;
+                      return [entry entryWithAccounts:[entry.accounts arrayByAddingObject:account] specialTransactionWallets:entry.specialTransactionWallets];
+                  }];
+    return indexedTransaction;
+}
+
+- (void)removeTransactionHash:(UInt256)txHash forAccount:(DSAccount *)account {
+    [self removeTransactionHashes:@[uint256_obj(txHash)] forAccount:account];
+}
+
+- (void)removeTransactionHashes:(NSArray<NSValue *> *)txHashes forAccount:(DSAccount *)account {
+    for (NSValue *hash in txHashes) {
+        [self updateEntryForHash:hash
+                      usingBlock:^DSTransactionIndexEntry *(DSTransactionIndexEntry *entry) {
+                          if (!entry || [entry.accounts indexOfObjectIdenticalTo:account] == NSNotFound) return entry;
+                          NSMutableArray<DSAccount *> *accounts = [entry.accounts mutableCopy];
+                          [accounts removeObjectIdenticalTo:account];
+                          return [entry entryWithAccounts:accounts specialTransactionWallets:entry.specialTransactionWallets];
+                      }];
+    }
+}
+
+- (void)addSpecialTransaction:(DSTransaction *)transaction forWallet:(DSWallet *)wallet {
+    if (![self isAttachedWallet:wallet]) return;
+    [self updateEntryForHash:uint256_obj(transaction.txHash)
+                  usingBlock:^DSTransactionIndexEntry *(DSTransactionIndexEntry *entry) {
+                      if (!entry) return [[DSTransactionIndexEntry alloc] initWithTransaction:transaction accounts:@[] specialTransactionWallets:@[wallet]];
+                      if ([entry.specialTransactionWallets indexOfObjectIdenticalTo:wallet] != NSNotFound) return entry;
+                      return [entry entryWithAccounts:entry.accounts specialTransactionWallets:[entry.specialTransactionWallets arrayByAddingObject:wallet]];
+                  }];
+}
+
+- (void)removeSpecialTransactionHashes:(NSArray<NSValue *> *)txHashes forWallet:(DSWallet *)wallet {
+    for (NSValue *hash in txHashes) {
+        [self updateEntryForHash:hash
+                      usingBlock:^DSTransactionIndexEntry *(DSTransactionIndexEntry *entry) {
+                          if (!entry || [entry.specialTransactionWallets indexOfObjectIdenticalTo:wallet] == NSNotFound) return entry;
+                          NSMutableArray<DSWallet *> *wallets = [entry.specialTransactionWallets mutableCopy];
+                          [wallets removeObjectIdenticalTo:wallet];
+                          return [entry entryWithAccounts:entry.accounts specialTransactionWallets:wallets];
+                      }];
+    }
+}
+
+// MARK: - Wallets
+
+- (void)attachWallet:(DSWallet *)wallet {
+    @synchronized(self) {
+        if ([self.attachedWallets containsObject:wallet]) return;
+        self.attachedWallets = [self.attachedWallets setByAddingObject:wallet];
+    }
+    // anything added concurrently is added twice, which is harmless
+    for (DSAccount *account in wallet.accounts) {
+        [account addLoadedTransactionsToTransactionIndex:self];
+    }
+    for (DSTransaction *transaction in wallet.specialTransactionsHolder.allTransactions) {
+        [self addSpecialTransaction:transaction forWallet:wallet];
+    }
+}
+
+- (void)detachWallet:(DSWallet *)wallet {
+    @synchronized(self) {
+        if (![self.attachedWallets containsObject:wallet]) return;
+        NSMutableSet<DSWallet *> *attachedWallets = [self.attachedWallets mutableCopy];
+        [attachedWallets removeObject:wallet];
+        self.attachedWallets = attachedWallets;
+    }
+    for (NSUInteger i = 0; i < TRANSACTION_INDEX_STRIPES; i++) {
+        pthread_rwlock_wrlock(&_locks[i]);
+        NSMutableDictionary<NSValue *, DSTransactionIndexEntry *> *entries = self.stripes[i];
+        for (NSValue *hash in [entries allKeys]) {
+            DSTransactionIndexEntry *entry = entries[hash];
+            if ([entry.wallets indexOfObjectIdenticalTo:wallet] == NSNotFound) continue;
+            NSIndexSet *keptAccounts = [entry.accounts indexesOfObjectsPassingTest:^BOOL(DSAccount *account, NSUInteger idx, BOOL *stop) {
+                return account.wallet != wallet;
+            }];
+            NSMutableArray<DSWallet *> *specialTransactionWallets = [entry.specialTransactionWallets mutableCopy];
+            [specialTransactionWallets removeObjectIdenticalTo:wallet];
+            DSTransactionIndexEntry *updatedEntry = [entry entryWithAccounts:[entry.accounts objectsAtIndexes:keptAccounts] specialTransactionWallets:specialTransactionWallets];
+            if (updatedEntry) {
+                entries[hash] = updatedEntry;
+            } else {
+                [entries removeObjectForKey:hash];
+            }
+        }
+        pthread_rwlock_unlock(&_locks[i]);
+    }
+}
+
+@end
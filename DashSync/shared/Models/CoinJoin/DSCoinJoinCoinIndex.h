@@ -0,0 +1,85 @@
+//
+//  DSCoinJoinCoinIndex.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "BigIntTypes.h"
+#import "dash_shared_core.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSAccount, DSTransaction, DSTransactionOutput, DSCoinJoinWrapper;
+
+typedef NS_ENUM(NSUInteger, DSCoinJoinCoinKind)
+{
+    DSCoinJoinCoinKind_Denominated,
+    DSCoinJoinCoinKind_Collateral,
+    DSCoinJoinCoinKind_Other, // everything else, masternode collateral included
+};
+
+@interface DSCoinJoinIndexedCoin : NSObject
+
+@property (nonatomic, readonly) DSTransaction *transaction;
+@property (nonatomic, readonly) DSTransactionOutput *output;
+@property (nonatomic, readonly) DSUTXO outpoint;
+@property (nonatomic, readonly) uint64_t amount;
+@property (nonatomic, readonly) DSCoinJoinCoinKind kind;
+/*! @brief The output pays to an address of the account, addresses never leave the account so this is computed once. */
+@property (nonatomic, readonly) BOOL isMine;
+/*! @brief The output pays to an address of the account's CoinJoin derivation path. */
+@property (nonatomic, readonly) BOOL isCoinJoinAddress;
+
+@end
+
+/*! @brief Classifies the unspent outputs of an account once, keyed by outpoint, into denominated, collateral and other coins each sorted by amount, so coin selection only visits the coins of the requested type and amount range. The account reports the transactions it registers, confirms and removes to the index, which applies them on its next query: the used output addresses grow by the outputs of new transactions, and what was memoized about unknown mixing rounds is forgotten. The index catches up with the unspent outputs only when the account recomputed them. Mixing progress and CoinJoin balances are kept as running totals: a coin's contribution is computed once when it enters the index and taken back out when it is spent, so only new coins cost a round trip to the mixing engine. Known rounds never change, they are kept in a file of the caches directory so a restart doesn't have to walk the ancestry of every coin again. */
+@interface DSCoinJoinCoinIndex : NSObject
+
+@property (nonatomic, readonly) DSAccount *account;
+@property (nonatomic, readonly) NSUInteger coinCount;
+
+- (instancetype)initWithAccount:(DSAccount *)account;
+/*! @brief Keeps the known rounds in the file at the path, nil keeps them in memory only. */
+- (instancetype)initWithAccount:(DSAccount *)account knownRoundsPath:(NSString *_Nullable)knownRoundsPath NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Removes the known rounds of the account, to be called when the wallet info is wiped. */
++ (void)wipeKnownRoundsForAccount:(DSAccount *)account;
+
+/*! @brief Called by the account while it holds its lock, only records the change. */
+- (void)accountRegisteredTransaction:(DSTransaction *)transaction;
+- (void)accountUpdatedTransactions;
+- (void)accountRemovedTransactions;
+
+/*! @brief Enumerates the coins that can match the coin type within the amount range, in ascending amount. */
+- (void)enumerateCoinsForCoinType:(CoinType)coinType minimumAmount:(uint64_t)minimumAmount maximumAmount:(uint64_t)maximumAmount usingBlock:(void (^)(DSCoinJoinIndexedCoin *coin, BOOL *stop))block;
+
+/*! @brief Forgets whether coins are fully mixed, to be called when the rounds goal changes. */
+- (void)invalidateMixingState;
+
+/*! @brief Memoized is_fully_mixed until the account's transactions change. */
+- (BOOL)isCoinFullyMixed:(DSCoinJoinIndexedCoin *)coin walletEx:(WalletEx *)walletEx;
+
+/*! @brief Same answer as -[DSAccount transactionAddressAlreadySeenInOutputs:] from a set of output addresses. */
+- (BOOL)isAddressUsedInOutputs:(NSString *)address;
+
+/*! @brief Mixed inputs and their rounds plus the inputs the non CoinJoin coins would be denominated into, as getMixingProgress counts them. */
+- (void)getMixingProgressInputs:(int32_t *)totalInputs rounds:(int32_t *)totalRounds withWrapper:(DSCoinJoinWrapper *)wrapper;
+
+- (void)getAnonymizedBalance:(uint64_t *)anonymizedBalance denominatedBalance:(uint64_t *)denominatedBalance withWrapper:(DSCoinJoinWrapper *)wrapper;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,520 @@
+//
+//  DSCoinJoinCoinIndex.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSCoinJoinCoinIndex.h"
+#import "DSAccount+Protected.h"
+#import "DSChain.h"
+#import "DSCoinJoinWrapper.h"
+#import "DSFundsDerivationPath.h"
+#import "DSKeyManager.h"
+#import "DSLogger.h"
+#import "DSTransaction.h"
+#import "DSTransactionOutput.h"
+#import "DSWallet.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+#define MASTERNODE_COLLATERAL_AMOUNT (1000 * DUFFS)
+#define COINJOIN_ROUNDS_CACHE_FILE_PREFIX @"COINJOIN_ROUNDS_CACHE_"
+#define COINJOIN_ROUNDS_RECORD_SIZE (sizeof(UInt256) + sizeof(uint32_t) + sizeof(uint32_t))
+#define UNKNOWN_ROUNDS INT32_MIN
+
+typedef NS_ENUM(NSUInteger, DSCoinJoinFullyMixedState)
+{
+    DSCoinJoinFullyMixedState_Unknown,
+    DSCoinJoinFullyMixedState_No,
+    DSCoinJoinFullyMixedState_Yes,
+};
+
+@interface DSCoinJoinIndexedCoin ()
+
+@property (nonatomic, strong) DSTransaction *transaction;
+@property (nonatomic, strong) DSTransactionOutput *output;
+@property (nonatomic, assign) DSUTXO outpoint;
+@property (nonatomic, assign) uint64_t amount;
+@property (nonatomic, assign) DSCoinJoinCoinKind kind;
+@property (nonatomic, assign) BOOL isMine;
+@property (nonatomic, assign) BOOL isCoinJoinAddress;
+@property (nonatomic, assign) BOOL isInCoinJoinDerivationPath;
+@property (nonatomic, assign) DSCoinJoinFullyMixedState fullyMixedState;        // per the wallet, used by coin selection
+@property (nonatomic, assign) DSCoinJoinFullyMixedState managerFullyMixedState; // per the client manager, used by the balance
+@property (nonatomic, assign) int32_t rounds;
+// what the coin adds to the running totals, only valid while counted
+@property (nonatomic, assign) BOOL counted;
+@property (nonatomic, assign) int32_t progressInputs;
+@property (nonatomic, assign) int32_t progressRounds;
+@property (nonatomic, assign) uint64_t anonymizedAmount;
+
+@end
+
+@implementation DSCoinJoinIndexedCoin
+
+@end
+
+@interface DSCoinJoinCoinIndex ()
+
+@property (nonatomic, strong) DSAccount *account;
+@property (nonatomic, strong) NSMutableDictionary<NSValue *, DSCoinJoinIndexedCoin *> *coins;
+@property (nonatomic, strong) NSArray<NSMutableArray<DSCoinJoinIndexedCoin *> *> *coinsByKind; // each sorted by amount
+@property (nonatomic, strong) NSMutableSet<NSString *> *usedOutputAddresses;
+@property (nonatomic, assign) NSUInteger indexedUnspentOutputsRevision;
+// what the account reported since the last refresh, guarded by itself as the account reports while holding its own lock
+@property (nonatomic, strong) NSMutableArray<DSTransaction *> *pendingRegisteredTransactions;
+@property (nonatomic, assign) BOOL pendingTransactionsChanged;
+@property (nonatomic, assign) BOOL pendingTransactionsRemoved;
+@property (nonatomic, assign) BOOL pendingKnownRoundsWipe;
+@property (nonatomic, strong) NSMutableSet<DSCoinJoinIndexedCoin *> *uncountedCoins;
+// bumped whenever the memoized mixing states are reset, an answer computed before a reset isn't memoized
+@property (nonatomic, assign) NSUInteger mixingStateGeneration;
+@property (nonatomic, assign) int32_t totalProgressInputs;
+@property (nonatomic, assign) int32_t totalProgressRounds;
+@property (nonatomic, assign) uint64_t totalAnonymizedBalance;
+@property (nonatomic, assign) uint64_t totalDenominatedBalance;
+@property (nonatomic, strong) NSMutableDictionary<NSValue *, NSNumber *> *knownRounds;
+@property (nonatomic, strong) NSString *knownRoundsPath;
+@property (nonatomic, assign) BOOL knownRoundsChanged;
+@property (nonatomic, strong) NSArray<NSNumber *> *standardDenominations;
+@property (nonatomic, assign) uint64_t collateralAmount;
+
+@end
+
+@implementation DSCoinJoinCoinIndex
+
+- (instancetype)initWithAccount:(DSAccount *)account {
+    return [self initWithAccount:account knownRoundsPath:[DSCoinJoinCoinIndex knownRoundsPathForAccount:account]];
+}
+
+- (instancetype)initWithAccount:(DSAccount *)account knownRoundsPath:(NSString *)knownRoundsPath {
+    NSParameterAssert(account);
+    if (!(self = [super init])) return nil;
+    self.account = account;
+    self.knownRoundsPath = knownRoundsPath;
+    self.coins = [NSMutableDictionary dictionary];
+    self.coinsByKind = @[[NSMutableArray array], [NSMutableArray array], [NSMutableArray array]];
+    self.uncountedCoins = [NSMutableSet set];
+    self.indexedUnspentOutputsRevision = NSNotFound;
+    self.pendingRegisteredTransactions = [NSMutableArray array];
+    // the used addresses are collected from the whole history once, later only from new transactions
+    self.pendingTransactionsRemoved = YES;
+    [self loadKnownRounds];
+    account.coinJoinCoinIndex = self;
+    return self;
+}
+
+- (NSUInteger)coinCount {
+    @synchronized(self) {
+        return self.coins.count;
+    }
+}
+
+// first index whose amount is not below the given amount
+static NSUInteger lowerBoundForAmount(NSArray<DSCoinJoinIndexedCoin *> *coins, uint64_t amount) {
+    NSUInteger low = 0, high = coins.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (coins[mid].amount < amount) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// MARK: - Known Rounds
+
+static dispatch_queue_t DSCoinJoinRoundsCacheQueue(void) {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("org.dashcore.dashsync.coinjoinroundscache", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
++ (NSString *)knownRoundsPathForAccount:(DSAccount *)account {
+    DSWallet *wallet = account.wallet;
+    if (!wallet || wallet.isTransient) return nil;
+    NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    NSString *fileName = [NSString stringWithFormat:@"%@%@_%u", COINJOIN_ROUNDS_CACHE_FILE_PREFIX, wallet.uniqueIDString, account.accountNumber];
+    return [cachesDirectory stringByAppendingPathComponent:fileName];
+}
+
++ (void)wipeKnownRoundsForAccount:(DSAccount *)account {
+    DSCoinJoinCoinIndex *coinIndex = account.coinJoinCoinIndex;
+    if (coinIndex) {
+        @synchronized(coinIndex.pendingRegisteredTransactions) {
+            coinIndex.pendingKnownRoundsWipe = YES;
+        }
+    }
+    NSString *path = coinIndex ? coinIndex.knownRoundsPath : [self knownRoundsPathForAccount:account];
+    if (!path) return;
+    // queued behind any pending write of the rounds
+    dispatch_async(DSCoinJoinRoundsCacheQueue(), ^{
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    });
+}
+
+- (void)loadKnownRounds {
+    self.knownRounds = [NSMutableDictionary dictionary];
+    NSString *path = self.knownRoundsPath;
+    if (!path) return;
+    // read behind any pending write of the rounds, a previous index of the account may still be saving them
+    __block NSData *data = nil;
+    dispatch_sync(DSCoinJoinRoundsCacheQueue(), ^{
+        data = [NSData dataWithContentsOfFile:path];
+    });
+    if (data.length % COINJOIN_ROUNDS_RECORD_SIZE) return;
+    for (NSUInteger offset = 0; offset < data.length; offset += COINJOIN_ROUNDS_RECORD_SIZE) {
+        DSUTXO outpoint = (DSUTXO){[data UInt256AtOffset:offset], [data UInt32AtOffset:offset + sizeof(UInt256)]};
+        self.knownRounds[dsutxo_obj(outpoint)] = @([data UInt32AtOffset:offset + sizeof(UInt256) + sizeof(uint32_t)]);
+    }
+}
+
+// only rounds of coins still unspent are kept, the file is written on a serial queue so the index lock isn't held during file access
+- (void)saveKnownRoundsIfNeeded {
+    if (!self.knownRoundsChanged) return;
+    self.knownRoundsChanged = NO;
+    NSString *path = self.knownRoundsPath;
+    if (!path) return;
+    NSMutableData *data = [NSMutableData dataWithCapacity:self.knownRounds.count * COINJOIN_ROUNDS_RECORD_SIZE];
+    for (NSValue *value in self.knownRounds.allKeys) {
+        if (!self.coins[value]) {
+            [self.knownRounds removeObjectForKey:value];
+            continue;
+        }
+        DSUTXO outpoint;
+        [value getValue:&outpoint];
+        [data appendUInt256:outpoint.hash];
+        [data appendUInt32:(uint32_t)outpoint.n];
+        [data appendUInt32:self.knownRounds[value].unsignedIntValue];
+    }
+    dispatch_async(DSCoinJoinRoundsCacheQueue(), ^{
+        if (![data writeToFile:path atomically:YES]) {
+            DSLogWarn(@"DSCoinJoinCoinIndex", @"Could not write CoinJoin rounds to %@", path);
+        }
+    });
+}
+
+// MARK: - Account Changes
+
+- (void)accountRegisteredTransaction:(DSTransaction *)transaction {
+    @synchronized(self.pendingRegisteredTransactions) {
+        [self.pendingRegisteredTransactions addObject:transaction];
+        self.pendingTransactionsChanged = YES;
+    }
+}
+
+- (void)accountUpdatedTransactions {
+    @synchronized(self.pendingRegisteredTransactions) {
+        self.pendingTransactionsChanged = YES;
+    }
+}
+
+- (void)accountRemovedTransactions {
+    @synchronized(self.pendingRegisteredTransactions) {
+        [self.pendingRegisteredTransactions removeAllObjects];
+        self.pendingTransactionsChanged = YES;
+        self.pendingTransactionsRemoved = YES;
+    }
+}
+
+// MARK: - Indexing
+
+- (DSCoinJoinIndexedCoin *)coinForOutpoint:(DSUTXO)outpoint {
+    DSTransaction *transaction = [self.account transactionForHash:outpoint.hash];
+    if (!transaction || outpoint.n >= transaction.outputs.count) return nil;
+    DSCoinJoinIndexedCoin *coin = [[DSCoinJoinIndexedCoin alloc] init];
+    DSTransactionOutput *output = transaction.outputs[outpoint.n];
+    coin.transaction = transaction;
+    coin.output = output;
+    coin.outpoint = outpoint;
+    coin.amount = output.amount;
+    if (is_denominated_amount(output.amount)) {
+        coin.kind = DSCoinJoinCoinKind_Denominated;
+    } else if (is_collateral_amount(output.amount)) {
+        coin.kind = DSCoinJoinCoinKind_Collateral;
+    } else {
+        coin.kind = DSCoinJoinCoinKind_Other;
+    }
+    coin.isMine = output.address && [self.account containsAddress:output.address];
+    NSString *scriptAddress = [DSKeyManager addressWithScriptPubKey:output.outScript forChain:self.account.wallet.chain];
+    coin.isCoinJoinAddress = scriptAddress && [self.account containsCoinJoinAddress:scriptAddress];
+    coin.isInCoinJoinDerivationPath = output.address && [self.account.coinJoinDerivationPath containsAddress:output.address];
+    NSNumber *knownRounds = self.knownRounds[dsutxo_obj(outpoint)];
+    coin.rounds = knownRounds ? knownRounds.intValue : UNKNOWN_ROUNDS;
+    return coin;
+}
+
+- (void)insertCoin:(DSCoinJoinIndexedCoin *)coin {
+    NSMutableArray<DSCoinJoinIndexedCoin *> *coins = self.coinsByKind[coin.kind];
+    [coins insertObject:coin atIndex:lowerBoundForAmount(coins, coin.amount + 1)];
+    if (coin.kind == DSCoinJoinCoinKind_Denominated) self.totalDenominatedBalance += coin.amount;
+    [self.uncountedCoins addObject:coin];
+}
+
+- (void)uncountCoin:(DSCoinJoinIndexedCoin *)coin {
+    if (!coin.counted) return;
+    self.totalProgressInputs -= coin.progressInputs;
+    self.totalProgressRounds -= coin.progressRounds;
+    self.totalAnonymizedBalance -= coin.anonymizedAmount;
+    coin.counted = NO;
+    [self.uncountedCoins addObject:coin];
+}
+
+- (void)removeCoin:(DSCoinJoinIndexedCoin *)coin {
+    [self uncountCoin:coin];
+    [self.uncountedCoins removeObject:coin];
+    if (coin.kind == DSCoinJoinCoinKind_Denominated) self.totalDenominatedBalance -= coin.amount;
+    NSMutableArray<DSCoinJoinIndexedCoin *> *coins = self.coinsByKind[coin.kind];
+    for (NSUInteger i = lowerBoundForAmount(coins, coin.amount); i < coins.count && coins[i].amount == coin.amount; i++) {
+        if (coins[i] == coin) {
+            [coins removeObjectAtIndex:i];
+            return;
+        }
+    }
+}
+
+// applies what the account reported since the last refresh, the whole history is only visited again after a removal
+- (void)refreshTransactionState {
+    NSArray<DSTransaction *> *registeredTransactions = nil;
+    BOOL transactionsChanged, transactionsRemoved, knownRoundsWipe;
+    @synchronized(self.pendingRegisteredTransactions) {
+        transactionsChanged = self.pendingTransactionsChanged;
+        transactionsRemoved = self.pendingTransactionsRemoved;
+        knownRoundsWipe = self.pendingKnownRoundsWipe;
+        if (!transactionsChanged && !transactionsRemoved && !knownRoundsWipe) return;
+        registeredTransactions = [self.pendingRegisteredTransactions copy];
+        [self.pendingRegisteredTransactions removeAllObjects];
+        self.pendingTransactionsChanged = NO;
+        self.pendingTransactionsRemoved = NO;
+        self.pendingKnownRoundsWipe = NO;
+    }
+    if (knownRoundsWipe) {
+        [self.knownRounds removeAllObjects];
+        self.knownRoundsChanged = NO;
+    }
+    if (transactionsRemoved) {
+        self.usedOutputAddresses = [NSMutableSet set];
+        registeredTransactions = self.account.allTransactions;
+    }
+    for (DSTransaction *transaction in registeredTransactions) {
+        for (DSTransactionOutput *output in transaction.outputs) {
+            if (output.address) [self.usedOutputAddresses addObject:output.address];
+        }
+    }
+    if (!transactionsChanged) return;
+    // a new transaction can give a coin its missing rounds, known rounds can't change anymore
+    self.mixingStateGeneration++;
+    for (DSCoinJoinIndexedCoin *coin in self.coins.allValues) {
+        BOOL settled = coin.rounds >= 0 && coin.managerFullyMixedState == DSCoinJoinFullyMixedState_Yes;
+        if (coin.rounds < 0) coin.rounds = UNKNOWN_ROUNDS;
+        if (coin.fullyMixedState == DSCoinJoinFullyMixedState_No) coin.fullyMixedState = DSCoinJoinFullyMixedState_Unknown;
+        if (coin.managerFullyMixedState == DSCoinJoinFullyMixedState_No) coin.managerFullyMixedState = DSCoinJoinFullyMixedState_Unknown;
+        if (!settled) [self uncountCoin:coin];
+    }
+}
+
+- (void)refresh {
+    @synchronized(self) {
+        [self refreshTransactionState];
+        NSUInteger revision = self.account.unspentOutputsRevision;
+        if (revision == self.indexedUnspentOutputsRevision) return;
+        self.indexedUnspentOutputsRevision = revision;
+        NSArray<NSValue *> *unspentOutputs = self.account.unspentOutputs;
+        BOOL changed = unspentOutputs.count != self.coins.count;
+        for (NSUInteger i = 0; !changed && i < unspentOutputs.count; i++) {
+            changed = !self.coins[unspentOutputs[i]];
+        }
+        if (!changed) return;
+        NSSet<NSValue *> *unspentOutpoints = [NSSet setWithArray:unspentOutputs];
+        for (NSValue *value in self.coins.allKeys) {
+            if ([unspentOutpoints containsObject:value]) continue;
+            [self removeCoin:self.coins[value]];
+            [self.coins removeObjectForKey:value];
+            if (self.knownRounds[value]) self.knownRoundsChanged = YES;
+        }
+        for (NSValue *value in unspentOutputs) {
+            if (self.coins[value]) continue;
+            DSUTXO outpoint;
+            [value getValue:&outpoint];
+            DSCoinJoinIndexedCoin *coin = [self coinForOutpoint:outpoint];
+            if (!coin) {
+                // the transaction isn't loaded yet, try again next time
+                self.indexedUnspentOutputsRevision = NSNotFound;
+                continue;
+            }
+            self.coins[value] = coin;
+            [self insertCoin:coin];
+        }
+    }
+}
+
+- (void)invalidateMixingState {
+    @synchronized(self) {
+        self.mixingStateGeneration++;
+        for (DSCoinJoinIndexedCoin *coin in self.coins.allValues) {
+            coin.fullyMixedState = DSCoinJoinFullyMixedState_Unknown;
+            coin.managerFullyMixedState = DSCoinJoinFullyMixedState_Unknown;
+            [self uncountCoin:coin];
+        }
+    }
+}
+
+// MARK: - Queries
+
+- (void)enumerateCoinsForCoinType:(CoinType)coinType minimumAmount:(uint64_t)minimumAmount maximumAmount:(uint64_t)maximumAmount usingBlock:(void (^)(DSCoinJoinIndexedCoin *coin, BOOL *stop))block {
+    NSArray<NSNumber *> *kinds = nil;
+    switch (coinType) {
+        case CoinType_OnlyFullyMixed:
+        case CoinType_OnlyReadyToMix:
+            kinds = @[@(DSCoinJoinCoinKind_Denominated)];
+            break;
+        case CoinType_OnlyNonDenominated:
+            kinds = @[@(DSCoinJoinCoinKind_Other)];
+            break;
+        case CoinType_OnlyCoinJoinCollateral:
+            kinds = @[@(DSCoinJoinCoinKind_Collateral)];
+            break;
+        case CoinType_OnlyMasternodeCollateral:
+            kinds = @[@(DSCoinJoinCoinKind_Other)];
+            minimumAmount = MAX(minimumAmount, MASTERNODE_COLLATERAL_AMOUNT);
+            maximumAmount = MIN(maximumAmount, MASTERNODE_COLLATERAL_AMOUNT);
+            break;
+        default:
+            kinds = @[@(DSCoinJoinCoinKind_Denominated), @(DSCoinJoinCoinKind_Collateral), @(DSCoinJoinCoinKind_Other)];
+            break;
+    }
+    NSMutableArray<DSCoinJoinIndexedCoin *> *candidates = [NSMutableArray array];
+    @synchronized(self) {
+        [self refresh];
+        for (NSNumber *kind in kinds) {
+            NSArray<DSCoinJoinIndexedCoin *> *coins = self.coinsByKind[kind.unsignedIntegerValue];
+            for (NSUInteger i = lowerBoundForAmount(coins, minimumAmount); i < coins.count && coins[i].amount <= maximumAmount; i++) {
+                [candidates addObject:coins[i]];
+            }
+        }
+    }
+    BOOL stop = NO;
+    for (DSCoinJoinIndexedCoin *coin in candidates) {
+        block(coin, &stop);
+        if (stop) break;
+    }
+}
+
+// the mixing engine is asked without holding the index lock since it calls back into the wallet
+- (BOOL)isCoinFullyMixed:(DSCoinJoinIndexedCoin *)coin walletEx:(WalletEx *)walletEx {
+    NSUInteger generation;
+    @synchronized(self) {
+        if (coin.fullyMixedState != DSCoinJoinFullyMixedState_Unknown) return coin.fullyMixedState == DSCoinJoinFullyMixedState_Yes;
+        generation = self.mixingStateGeneration;
+    }
+    UInt256 hash = coin.outpoint.hash;
+    BOOL fullyMixed = is_fully_mixed(walletEx, (uint8_t(*)[32])(hash.u8), (uint32_t)coin.outpoint.n);
+    @synchronized(self) {
+        if (generation == self.mixingStateGeneration) {
+            coin.fullyMixedState = fullyMixed ? DSCoinJoinFullyMixedState_Yes : DSCoinJoinFullyMixedState_No;
+        }
+    }
+    return fullyMixed;
+}
+
+- (BOOL)isAddressUsedInOutputs:(NSString *)address {
+    if (![address isKindOfClass:[NSString class]]) return NO;
+    @synchronized(self) {
+        [self refreshTransactionState];
+        return [self.usedOutputAddresses containsObject:address];
+    }
+}
+
+// MARK: - Totals
+
+// how many standard denominations the coin would be split into once the collateral is taken out
+- (int32_t)unmixedInputsForAmount:(uint64_t)amount {
+    int32_t unmixedInputs = 0;
+    int64_t outputValue = amount - self.collateralAmount;
+    for (NSNumber *denomination in self.standardDenominations) {
+        while (outputValue - denomination.longLongValue > 0) {
+            unmixedInputs++;
+            outputValue -= denomination.longLongValue;
+        }
+    }
+    return unmixedInputs;
+}
+
+- (void)countCoin:(DSCoinJoinIndexedCoin *)coin withWrapper:(DSCoinJoinWrapper *)wrapper {
+    coin.progressInputs = 0;
+    coin.progressRounds = 0;
+    coin.anonymizedAmount = 0;
+    if (coin.isCoinJoinAddress) {
+        if (coin.rounds == UNKNOWN_ROUNDS) {
+            coin.rounds = [wrapper getRealOutpointCoinJoinRounds:coin.outpoint];
+            if (coin.rounds >= 0) {
+                self.knownRounds[dsutxo_obj(coin.outpoint)] = @(coin.rounds);
+                self.knownRoundsChanged = YES;
+            }
+        }
+        if (coin.rounds >= 0) {
+            coin.progressInputs = 1;
+            coin.progressRounds = coin.rounds;
+        }
+    } else {
+        coin.progressInputs = [self unmixedInputsForAmount:coin.amount];
+    }
+    if (coin.kind == DSCoinJoinCoinKind_Denominated && coin.isInCoinJoinDerivationPath) {
+        if (coin.managerFullyMixedState == DSCoinJoinFullyMixedState_Unknown) {
+            coin.managerFullyMixedState = [wrapper isFullyMixed:coin.outpoint] ? DSCoinJoinFullyMixedState_Yes : DSCoinJoinFullyMixedState_No;
+        }
+        if (coin.managerFullyMixedState == DSCoinJoinFullyMixedState_Yes) coin.anonymizedAmount = coin.amount;
+    }
+    self.totalProgressInputs += coin.progressInputs;
+    self.totalProgressRounds += coin.progressRounds;
+    self.totalAnonymizedBalance += coin.anonymizedAmount;
+    coin.counted = YES;
+}
+
+- (void)countUncountedCoinsWithWrapper:(DSCoinJoinWrapper *)wrapper {
+    [self refresh];
+    if (!self.uncountedCoins.count) return;
+    if (!self.standardDenominations) {
+        self.standardDenominations = [wrapper getStandardDenominations];
+        self.collateralAmount = [wrapper getCollateralAmount];
+    }
+    for (DSCoinJoinIndexedCoin *coin in self.uncountedCoins) {
+        [self countCoin:coin withWrapper:wrapper];
+    }
+    [self.uncountedCoins removeAllObjects];
+    [self saveKnownRoundsIfNeeded];
+}
+
+- (void)getMixingProgressInputs:(int32_t *)totalInputs rounds:(int32_t *)totalRounds withWrapper:(DSCoinJoinWrapper *)wrapper {
+    @synchronized(self) {
+        [self countUncountedCoinsWithWrapper:wrapper];
+        if (totalInputs) *totalInputs = self.totalProgressInputs;
+        if (totalRounds) *totalRounds = self.totalProgressRounds;
+    }
+}
+
+- (void)getAnonymizedBalance:(uint64_t *)anonymizedBalance denominatedBalance:(uint64_t *)denominatedBalance withWrapper:(DSCoinJoinWrapper *)wrapper {
+    @synchronized(self) {
+        [self countUncountedCoinsWithWrapper:wrapper];
+        if (anonymizedBalance) *anonymizedBalance = self.totalAnonymizedBalance;
+        if (denominatedBalance) *denominatedBalance = self.totalDenominatedBalance;
+    }
+}
+
+@end
@@ -20,6 +20,7 @@
 #import "DSTransactionOutput.h"
 #import "DSAccount.h"
 #import "DSCoinControl.h"
+#import "DSCoinJoinCoinIndex.h"
 #import "DSWallet.h"
 #import "BigIntTypes.h"
 #import "NSString+Bitcoin.h"
@@ -50,6 +51,7 @@ int32_t const MIN_BLOCKS_TO_WAIT = 1;
 @property (atomic) double lastReportedProgress;
 @property (atomic) BOOL hasReportedSuccess;
 @property (atomic) BOOL hasReportedFailure;
+@property (nonatomic, strong) DSCoinJoinCoinIndex *coinIndex;
 
 @end
 
@@ -150,6 +152,7 @@ static dispatch_once_t managerChainToken = 0;
     self.options->coinjoin_multi_session = multisession;
     self.options->coinjoin_denoms_goal = denomGoal;
     self.options->coinjoin_denoms_hardcap = denomHardCap;
+    [self.coinIndex invalidateMixingState];
 
     if (self.wrapper.isRegistered) {
         [self.wrapper updateOptions:self.options];
@@ -516,118 +519,109 @@ static dispatch_once_t managerChainToken = 0;
     @synchronized(self) {
         CoinType coinType = coinControl != nil ? coinControl.coinType : CoinType_AllCoins;
 
-        uint64_t total = 0;
+        __block uint64_t total = 0;
         // Either the WALLET_FLAG_AVOID_REUSE flag is not set (in which case we always allow), or we default to avoiding, and only in the case where a coin control object is provided, and has the avoid address reuse flag set to false, do we allow already used addresses
         BOOL allowUsedAddresses = /* !IsWalletFlagSet(WALLET_FLAG_AVOID_REUSE) || */ (coinControl != nil && !coinControl.avoidAddressReuse);
         int32_t minDepth = coinControl != nil ? coinControl.minDepth : DEFAULT_MIN_DEPTH;
         int32_t maxDepth = coinControl != nil ? coinControl.maxDepth : DEFAULT_MAX_DEPTH;
-        NSSet<DSTransaction *> *spendables = [self getSpendableTXs];
+        DSAccount *account = self.chain.wallets.firstObject.accounts.firstObject;
+        DSCoinJoinCoinIndex *coinIndex = [self coinIndexForAccount:account];
 
-        for (DSTransaction *coin in spendables) {
-            UInt256 wtxid = coin.txHash;
-            DSAccount *account = self.chain.wallets.firstObject.accounts.firstObject;
+        if (!coinIndex) {
+            return vCoins;
+        }
 
-            if ([account transactionIsPending:coin]) {
-                continue;
-            }
+        // the transaction level checks are shared by all outputs of a transaction
+        NSMutableDictionary<NSValue *, NSNumber *> *eligibleTransactions = [NSMutableDictionary dictionary];
 
-            if (coin.isImmatureCoinBase) {
-                continue;
-            }
+        [coinIndex enumerateCoinsForCoinType:coinType minimumAmount:minimumAmount maximumAmount:maximumAmount usingBlock:^(DSCoinJoinIndexedCoin *indexedCoin, BOOL *stop) {
+            DSTransaction *coin = indexedCoin.transaction;
+            NSValue *wtxidValue = uint256_obj(coin.txHash);
+            NSNumber *eligible = eligibleTransactions[wtxidValue];
 
-            BOOL safeTx = coin.instantSendReceived || [account transactionIsVerified:coin];
-
-            if (onlySafe && !safeTx) {
-                continue;
+            if (!eligible) {
+                BOOL safeTx = coin.instantSendReceived || [account transactionIsVerified:coin];
+                uint32_t depth = coin.confirmations;
+                eligible = @(![account transactionIsPending:coin] && !coin.isImmatureCoinBase && (!onlySafe || safeTx) && !(depth < minDepth || depth > maxDepth));
+                eligibleTransactions[wtxidValue] = eligible;
             }
 
-            uint32_t depth = coin.confirmations;
-
-            if (depth < minDepth || depth > maxDepth) {
-                continue;
+            if (!eligible.boolValue) {
+                return;
             }
 
-            for (uint32_t i = 0; i < coin.outputs.count; i++) {
-                DSTransactionOutput *output = coin.outputs[i];
-                uint64_t value = output.amount;
-                BOOL found = NO;
-
-                if (coinType == CoinType_OnlyFullyMixed) {
-                    if (!is_denominated_amount(value)) {
-                        continue;
-                    }
+            uint64_t value = indexedCoin.amount;
+            BOOL found = NO;
 
-                    found = is_fully_mixed(walletEx, (uint8_t (*)[32])(wtxid.u8), (uint32_t)i);
-                } else if (coinType == CoinType_OnlyReadyToMix) {
-                    if (!is_denominated_amount(value)) {
-                        continue;
-                    }
+            if (coinType == CoinType_OnlyFullyMixed) {
+                found = [coinIndex isCoinFullyMixed:indexedCoin walletEx:walletEx];
+            } else if (coinType == CoinType_OnlyReadyToMix) {
+                found = ![coinIndex isCoinFullyMixed:indexedCoin walletEx:walletEx];
+            } else {
+                found = YES; // the index only returned coins of the requested kind and amount
+            }
 
-                    found = !is_fully_mixed(walletEx, (uint8_t (*)[32])(wtxid.u8), (uint32_t)i);
-                } else if (coinType == CoinType_OnlyNonDenominated) {
-                    if (is_collateral_amount(value)) {
-                        continue; // do not use collateral amounts
-                    }
+            if (!found) {
+                return;
+            }
 
-                    found = !is_denominated_amount(value);
-                } else if (coinType == CoinType_OnlyMasternodeCollateral) {
-                    found = value == 1000 * DUFFS;
-                } else if (coinType == CoinType_OnlyCoinJoinCollateral) {
-                    found = is_collateral_amount(value);
-                } else {
-                    found = YES;
-                }
+            DSUTXO utxo = indexedCoin.outpoint;
+            UInt256 wtxid = utxo.hash;
 
-                if (!found) {
-                    continue;
-                }
+            if (coinControl != nil && coinControl.hasSelected && !coinControl.allowOtherInputs && ![coinControl isSelected:utxo]) {
+                return;
+            }
 
-                if (value < minimumAmount || value > maximumAmount) {
-                    continue;
-                }
+            if (is_locked_coin(walletEx, (uint8_t (*)[32])(wtxid.u8), (uint32_t)utxo.n) && coinType != CoinType_OnlyMasternodeCollateral) {
+                return;
+            }
 
-                DSUTXO utxo = ((DSUTXO){wtxid, i});
+            if ([account isSpent:dsutxo_obj(utxo)]) {
+                return;
+            }
 
-                if (coinControl != nil && coinControl.hasSelected && !coinControl.allowOtherInputs && ![coinControl isSelected:utxo]) {
-                    continue;
-                }
+            if (!indexedCoin.isMine) {
+                return;
+            }
 
-                if (is_locked_coin(walletEx, (uint8_t (*)[32])(wtxid.u8), (uint32_t)i) && coinType != CoinType_OnlyMasternodeCollateral) {
-                    continue;
-                }
+            if (!allowUsedAddresses && [coinIndex isAddressUsedInOutputs:indexedCoin.output.address]) {
+                return;
+            }
 
-                if ([account isSpent:dsutxo_obj(utxo)]) {
-                    continue;
-                }
+            [vCoins addObject:[[DSInputCoin alloc] initWithTx:coin index:(int32_t)utxo.n]];
 
-                if (output.address == nil || ![account containsAddress:output.address]) {
-                    continue;
-                }
+            // Checks the sum amount of all UTXO's.
+            if (minimumSumAmount != MAX_MONEY) {
+                total += value;
 
-                if (!allowUsedAddresses && [account transactionAddressAlreadySeenInOutputs:output.address]) {
-                    continue;
+                if (total >= minimumSumAmount) {
+                    *stop = YES;
+                    return;
                 }
+            }
 
-                [vCoins addObject:[[DSInputCoin alloc] initWithTx:coin index:i]];
+            // Checks the maximum number of UTXO's.
+            if (maximumCount > 0 && vCoins.count >= maximumCount) {
+                *stop = YES;
+            }
+        }];
+    }
 
-                // Checks the sum amount of all UTXO's.
-                if (minimumSumAmount != MAX_MONEY) {
-                    total += value;
+    return vCoins;
+}
 
-                    if (total >= minimumSumAmount) {
-                        return vCoins;
-                    }
-                }
+- (DSCoinJoinCoinIndex *)coinIndexForAccount:(DSAccount *)account {
+    if (!account) {
+        return nil;
+    }
 
-                // Checks the maximum number of UTXO's.
-                if (maximumCount > 0 && vCoins.count >= maximumCount) {
-                    return vCoins;
-                }
-            }
+    @synchronized(self) {
+        if (self.coinIndex.account != account) {
+            self.coinIndex = [[DSCoinJoinCoinIndex alloc] initWithAccount:account];
         }
-    }
 
-    return vCoins;
+        return self.coinIndex;
+    }
 }
 
 - (double)getMixingProgress {
@@ -636,43 +630,12 @@ static dispatch_once_t managerChainToken = 0;
     }
 
     double requiredRounds = self.options->coinjoin_rounds + 0.875; // 1 x 50% + 1 x 50%^2 + 1 x 50%^3
-    __block int totalInputs = 0;
-    __block int totalRounds = 0;
-
-    NSDictionary<NSNumber *, NSArray<NSValue *> *> *outputs = [self getOutputs];
-    uint64_t collateralAmount = [self.wrapper getCollateralAmount];
-    NSArray<NSNumber *> *denominations = [self.wrapper getStandardDenominations];
-
-    [outputs enumerateKeysAndObjectsUsingBlock:^(NSNumber *denom, NSArray<NSValue *> *outputs, BOOL *stop) {
-        [outputs enumerateObjectsUsingBlock:^(NSValue *output, NSUInteger idx, BOOL *stop) {
-            DSUTXO outpoint;
-            [output getValue:&outpoint];
+    int32_t totalInputs = 0;
+    int32_t totalRounds = 0;
 
-            if (denom.intValue >= 0) {
-                int rounds = [self.wrapper getRealOutpointCoinJoinRounds:outpoint];
-
-                if (rounds >= 0) {
-                    totalInputs += 1;
-                    totalRounds += rounds;
-                }
-            } else if (denom.intValue == -2) {
-                DSTransaction *tx = [self.chain transactionForHash:outpoint.hash];
-                DSTransactionOutput *output = tx.outputs[outpoint.n];
-
-                __block int unmixedInputs = 0;
-                __block int64_t outputValue = output.amount - collateralAmount;
-
-                [denominations enumerateObjectsUsingBlock:^(NSNumber *coin, NSUInteger idx, BOOL *stop) {
-                    while (outputValue - coin.longLongValue > 0) {
-                        unmixedInputs++;
-                        outputValue -= coin.longLongValue;
-                    }
-                }];
-
-                totalInputs += unmixedInputs;
-            }
-        }];
-    }];
+    // running totals, only coins that arrived since the last call cost a round trip to the mixing engine
+    DSCoinJoinCoinIndex *coinIndex = [self coinIndexForAccount:self.chain.wallets.firstObject.accounts.firstObject];
+    [coinIndex getMixingProgressInputs:&totalInputs rounds:&totalRounds withWrapper:self.wrapper];
 
     double progress = totalInputs != 0 ? (double)totalRounds / (requiredRounds * totalInputs) : 0.0;
 
@@ -684,39 +647,6 @@ static dispatch_once_t managerChainToken = 0;
     return fmax(0.0, fmin(progress, 1.0));
 }
 
-- (NSDictionary<NSNumber *, NSArray<NSValue *> *> *)getOutputs {
-    NSMutableDictionary<NSNumber *, NSMutableArray<NSValue *> *> *outputs = [NSMutableDictionary dictionary];
-
-    for (NSNumber *amount in [self.wrapper getStandardDenominations]) {
-        outputs[@([self.wrapper amountToDenomination:amount.unsignedLongLongValue])] = [NSMutableArray array];
-    }
-
-    outputs[@(-2)] = [NSMutableArray array];
-    outputs[@(0)] = [NSMutableArray array];
-    DSAccount *account = self.chain.wallets.firstObject.accounts.firstObject;
-    NSArray *utxos = account.unspentOutputs;
-    DSUTXO outpoint;
-
-    for (NSValue *value in utxos) {
-        [value getValue:&outpoint];
-
-        DSTransaction *tx = [self.chain transactionForHash:outpoint.hash];
-        DSTransactionOutput *output = tx.outputs[outpoint.n];
-        NSString *address = [DSKeyManager addressWithScriptPubKey:output.outScript forChain:self.chain];
-
-        if ([account containsCoinJoinAddress:address]) {
-            int denom = [self.wrapper amountToDenomination:output.amount];
-            NSMutableArray<NSValue *> *listDenoms = outputs[@(denom)];
-            [listDenoms addObject:value];
-        } else {
-            // non-denominated and non-collateral coins
-            [outputs[@(-2)] addObject:value];
-        }
-    }
-
-    return outputs;
-}
-
 - (BOOL)isCoinJoinOutput:(DSTransactionOutput *)output utxo:(DSUTXO)utxo {
     if (![self.wrapper isDenominatedAmount:output.amount]) {
         return false;
@@ -737,22 +667,7 @@ static dispatch_once_t managerChainToken = 0;
     DSAccount *account = self.chain.wallets.firstObject.accounts.firstObject;
     uint64_t anonymizedBalance = 0;
     uint64_t denominatedBalance = 0;
-    DSUTXO outpoint;
-    NSArray *utxos = account.unspentOutputs;
-
-    for (NSValue *value in utxos) {
-        [value getValue:&outpoint];
-        DSTransaction *tx = [account transactionForHash:outpoint.hash];
-        DSTransactionOutput *output = tx.outputs[outpoint.n];
-
-        if ([self isCoinJoinOutput:output utxo:outpoint]) {
-            anonymizedBalance += output.amount;
-        }
-
-        if ([self.wrapper isDenominatedAmount:output.amount]) {
-            denominatedBalance += output.amount;
-        }
-    }
+    [[self coinIndexForAccount:account] getAnonymizedBalance:&anonymizedBalance denominatedBalance:&denominatedBalance withWrapper:self.wrapper];
 
     // TODO(DashJ): support more balance types?
     DSCoinJoinBalance *balance =
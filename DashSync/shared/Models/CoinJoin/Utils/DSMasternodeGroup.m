@@ -554,7 +554,7 @@ float_t const BACKOFF_MULTIPLIER = 1.001;
     }
 }
 
-- (void)peer:(nonnull DSPeer *)peer relayedPeers:(nonnull NSArray *)peers {
+- (void)peer:(nonnull DSPeer *)peer relayedAddresses:(nonnull NSArray<NSValue *> *)addresses {
     // TODO ?
 }
 
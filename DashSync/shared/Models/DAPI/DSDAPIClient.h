@@ -15,6 +15,7 @@
 //  limitations under the License.
 //
 
+#import "DSDAPINetworkServiceRequest.h"
 #import <Foundation/Foundation.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -27,7 +28,9 @@ typedef NS_ENUM(NSUInteger, DSDAPIClientErrorCode)
     DSDAPIClientErrorCodeNoKnownDAPINodes = 2,
 };
 
-@class DSChain, DSBlockchainIdentity, DPDocument, DSTransition, DPSTPacket, DPContract, DSDAPIPlatformNetworkService, DSDAPICoreNetworkService, DSPeer, DSSimplifiedMasternodeEntry;
+@class DSChain, DSBlockchainIdentity, DPDocument, DSTransition, DPSTPacket, DPContract, DSDAPIPlatformNetworkService, DSDAPICoreNetworkService, DSPeer, DSSimplifiedMasternodeEntry, DSPlatformDocumentsCache, DSDAPIEndpointSelector, DSDAPIServicePool;
+
+typedef id<DSDAPINetworkServiceRequest> _Nullable (^DSDAPIPlatformReadBlock)(DSDAPIPlatformNetworkService *service, void (^success)(id result), void (^failure)(NSError *error));
 
 @interface DSDAPIClient : NSObject
 
@@ -36,6 +39,12 @@ typedef NS_ENUM(NSUInteger, DSDAPIClientErrorCode)
 @property (nonatomic, nullable, readonly) DSDAPICoreNetworkService *DAPICoreNetworkService;
 @property (atomic, readonly) dispatch_queue_t coreNetworkingDispatchQueue;
 @property (atomic, readonly) dispatch_queue_t platformMetadataDispatchQueue;
+@property (nonatomic, readonly) DSPlatformDocumentsCache *platformDocumentsCache;
+@property (nonatomic, readonly) DSDAPIEndpointSelector *endpointSelector;
+/*! @brief The core and platform services of the nodes in use, its counters show how often connections are reused. */
+@property (nonatomic, readonly) DSDAPIServicePool *servicePool;
+/*! @brief When a read sent through performIdempotentPlatformRead: takes longer than the 95th percentile of recent answers, it is also sent to a second node and the first answer wins. Defaults to YES. */
+@property (nonatomic, assign) BOOL hedgesIdempotentReads;
 
 - (instancetype)initWithChain:(DSChain *)chain NS_DESIGNATED_INITIALIZER;
 
@@ -61,6 +70,11 @@ typedef NS_ENUM(NSUInteger, DSDAPIClientErrorCode)
                   success:(void (^)(NSDictionary *successDictionary, BOOL added))success
                   failure:(void (^)(NSError *error))failure;
 
+/*! @brief Performs a read that is safe to send to several nodes on a node picked by the endpoint selector, hedging it to a second node when it is slow or fails. The read block must call back on the queue it wants the result on. */
+- (id<DSDAPINetworkServiceRequest> _Nullable)performIdempotentPlatformRead:(DSDAPIPlatformReadBlock)read
+                                                                   success:(void (^)(id result))success
+                                                                   failure:(void (^)(NSError *error))failure;
+
 - (void)checkPingTimesForMasternodes:(NSArray<DSSimplifiedMasternodeEntry *> *)masternodes completion:(void (^)(NSMutableDictionary<NSData *, NSNumber *> *pingTimes, NSMutableDictionary<NSData *, NSError *> *))completion;
 @end
 
@@ -19,10 +19,13 @@
 
 #import "DSChain+Protected.h"
 #import "DSDAPICoreNetworkService.h"
+#import "DSDAPIEndpointSelector.h"
 #import "DSDAPIPlatformNetworkService.h"
+#import "DSDAPIServicePool.h"
 #import "DSDashPlatform.h"
 #import "DSDocumentTransition.h"
 #import "DSIdentitiesManager+Protected.h"
+#import "DSPlatformDocumentsCache.h"
 #import "NSError+Dash.h"
 #import <DashSync/DSTransition.h>
 #import <DashSync/DashSync.h>
@@ -39,10 +42,37 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
 @property (nonatomic, strong) DSChain *chain;
 @property (nonatomic, strong) NSMutableSet<NSString *> *availablePeers;
 @property (nonatomic, strong) NSMutableSet<NSString *> *usedPeers;
-@property (nonatomic, strong) NSMutableArray<DSDAPIPlatformNetworkService *> *activePlatformServices;
-@property (nonatomic, strong) NSMutableArray<DSDAPICoreNetworkService *> *activeCoreServices;
 @property (atomic, strong) dispatch_queue_t coreNetworkingDispatchQueue;
 @property (atomic, strong) dispatch_queue_t platformMetadataDispatchQueue;
+@property (nonatomic, strong) DSPlatformDocumentsCache *platformDocumentsCache;
+@property (nonatomic, strong) DSDAPIEndpointSelector *endpointSelector;
+@property (nonatomic, strong) DSDAPIServicePool *servicePool;
+
+@end
+
+@interface DSDAPIHedgedRequest : NSObject <DSDAPINetworkServiceRequest>
+
+@property (nonatomic, strong) NSMutableArray<id<DSDAPINetworkServiceRequest>> *calls;
+@property (nonatomic, strong) NSString *firstHost;
+@property (nonatomic, assign) NSUInteger outstandingCalls;
+@property (nonatomic, assign) BOOL hedged;
+@property (nonatomic, assign) BOOL finished;
+@property (nonatomic, copy) void (^hedge)(void); //cleared once it ran or the request finished
+
+@end
+
+@implementation DSDAPIHedgedRequest
+
+- (void)cancel {
+    NSArray<id<DSDAPINetworkServiceRequest>> *calls = nil;
+    @synchronized(self) {
+        self.finished = YES;
+        calls = [self.calls copy];
+    }
+    for (id<DSDAPINetworkServiceRequest> call in calls) {
+        [call cancel];
+    }
+}
 
 @end
 
@@ -53,10 +83,12 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
     if (self) {
         _chain = chain;
         self.availablePeers = [NSMutableSet set];
-        self.activePlatformServices = [NSMutableArray array];
-        self.activeCoreServices = [NSMutableArray array];
         self.coreNetworkingDispatchQueue = self.chain.networkingQueue;
         self.platformMetadataDispatchQueue = self.chain.dapiMetadataQueue;
+        self.platformDocumentsCache = [[DSPlatformDocumentsCache alloc] init];
+        self.endpointSelector = [[DSDAPIEndpointSelector alloc] init];
+        self.servicePool = [[DSDAPIServicePool alloc] init];
+        self.hedgesIdempotentReads = YES;
     }
     return self;
 }
@@ -192,7 +224,7 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
             if (!masternode.isValid) continue;
             dispatch_semaphore_wait(dispatchSemaphore, DISPATCH_TIME_FOREVER);
             dispatch_group_enter(dispatch_group);
-            DSDAPICoreNetworkService *coreNetworkService = [[DSDAPICoreNetworkService alloc] initWithDAPINodeIPAddress:masternode.ipAddressString httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
+            DSDAPICoreNetworkService *coreNetworkService = [self sweepCoreNetworkServiceForHost:masternode.ipAddressString httpLoaderFactory:loaderFactory];
             __block NSDate *time = [NSDate date];
             [coreNetworkService
                 getStatusWithCompletionQueue:self.platformMetadataDispatchQueue
@@ -200,6 +232,7 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
                     NSTimeInterval platformPing = -[time timeIntervalSinceNow] * 1000;
                     pingTimeDictionary[uint256_data(masternode.providerRegistrationTransactionHash)] = @(platformPing);
                     [masternode setPlatformPing:platformPing at:[NSDate date]];
+                    [self.endpointSelector recordPingTime:platformPing / 1000 forHost:masternode.ipAddressString];
                     dispatch_semaphore_signal(dispatchSemaphore);
                     dispatch_group_leave(dispatch_group);
                 }
@@ -220,22 +253,47 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
 
 #pragma mark - Peers
 
+- (DSDAPIPlatformNetworkService *)platformNetworkServiceForHost:(NSString *)host {
+    return [self.servicePool serviceOfClass:[DSDAPIPlatformNetworkService class]
+                                    forHost:host
+                                       port:self.chain.standardDapiGRPCPort
+                                     create:^id {
+                                         HTTPLoaderFactory *loaderFactory = [DSNetworkingCoordinator sharedInstance].loaderFactory;
+                                         DSDAPIPlatformNetworkService *DAPINetworkService = [[DSDAPIPlatformNetworkService alloc] initWithDAPINodeIPAddress:host httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
+                                         DAPINetworkService.documentsCache = self.platformDocumentsCache;
+                                         DAPINetworkService.endpointSelector = self.endpointSelector;
+                                         return DAPINetworkService;
+                                     }];
+}
+
+- (DSDAPICoreNetworkService *)coreNetworkServiceForHost:(NSString *)host {
+    return [self.servicePool serviceOfClass:[DSDAPICoreNetworkService class]
+                                    forHost:host
+                                       port:self.chain.standardDapiGRPCPort
+                                     create:^id {
+                                         HTTPLoaderFactory *loaderFactory = [DSNetworkingCoordinator sharedInstance].loaderFactory;
+                                         DSDAPICoreNetworkService *DAPINetworkService = [[DSDAPICoreNetworkService alloc] initWithDAPINodeIPAddress:host httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
+                                         DAPINetworkService.endpointSelector = self.endpointSelector;
+                                         return DAPINetworkService;
+                                     }];
+}
+
+// sweeps over every masternode reuse a pooled node's service but don't pool the others, so they never evict the nodes in use
+- (DSDAPICoreNetworkService *)sweepCoreNetworkServiceForHost:(NSString *)host httpLoaderFactory:(HTTPLoaderFactory *)loaderFactory {
+    DSDAPICoreNetworkService *coreNetworkService = [self.servicePool pooledServiceOfClass:[DSDAPICoreNetworkService class] forHost:host port:self.chain.standardDapiGRPCPort];
+    if (coreNetworkService) return coreNetworkService;
+    coreNetworkService = [[DSDAPICoreNetworkService alloc] initWithDAPINodeIPAddress:host httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
+    coreNetworkService.endpointSelector = self.endpointSelector;
+    return coreNetworkService;
+}
+
 - (void)addDAPINodeByAddress:(NSString *)host {
 #if DAPI_CONNECT_SINGLE_NODE
     return;
 #endif
-    [self.availablePeers addObject:host];
-    DSDAPIPlatformNetworkService *foundNetworkService = nil;
-    for (DSDAPIPlatformNetworkService *networkService in self.activePlatformServices) {
-        if ([networkService.ipAddress isEqualToString:host]) {
-            foundNetworkService = networkService;
-            break;
-        }
-    }
-    if (!foundNetworkService) {
-        HTTPLoaderFactory *loaderFactory = [DSNetworkingCoordinator sharedInstance].loaderFactory;
-        DSDAPIPlatformNetworkService *DAPINetworkService = [[DSDAPIPlatformNetworkService alloc] initWithDAPINodeIPAddress:host httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
-        [self.activePlatformServices addObject:DAPINetworkService];
+    @synchronized(self) {
+        [self.availablePeers addObject:host];
+        [self.endpointSelector addHost:host];
     }
 }
 
@@ -245,52 +303,167 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
 #endif
     @synchronized(self) {
         [self.availablePeers removeObject:host];
-        for (DSDAPIPlatformNetworkService *networkService in [self.activePlatformServices copy]) {
-            if ([networkService.ipAddress isEqualToString:host]) {
-                [self.activePlatformServices removeObject:networkService];
-            }
-        }
+        [self.endpointSelector removeHost:host];
+        [self.servicePool removeServicesForHost:host port:self.chain.standardDapiGRPCPort];
     }
 }
 
-- (DSDAPIPlatformNetworkService *)DAPIPlatformNetworkService {
-    @synchronized(self) {
-        if ([self.activePlatformServices count]) {
-            if ([self.activePlatformServices count] == 1) return [self.activePlatformServices objectAtIndex:0];                   //if only 1 service, just use first one
-            return [self.activePlatformServices objectAtIndex:arc4random_uniform((uint32_t)[self.activePlatformServices count])]; //use a random service
-        } else if ([self.availablePeers count] || DAPI_CONNECT_SINGLE_NODE) {
+// ejected nodes come back into rotation only after answering a status request
+- (void)probeEjectedDAPINodes {
+    NSArray<NSString *> *hosts = [self.endpointSelector hostsNeedingProbe];
+    if (!hosts.count) return;
+    dispatch_async(self.platformMetadataDispatchQueue, ^{
+        HTTPLoaderFactory *loaderFactory = [DSNetworkingCoordinator sharedInstance].loaderFactory;
+        for (NSString *host in hosts) {
+            DSDAPICoreNetworkService *coreNetworkService = [self sweepCoreNetworkServiceForHost:host httpLoaderFactory:loaderFactory];
+            [coreNetworkService getStatusWithCompletionQueue:self.platformMetadataDispatchQueue
+                                                     success:^(NSDictionary *_Nonnull status) {
+                                                         DSLogInfo(@"DSDAPIClient", @"DAPI node %@ is back in rotation", host);
+                                                     }
+                                                     failure:^(NSError *_Nonnull error) {
+                                                         DSLogInfo(@"DSDAPIClient", @"DAPI node %@ is still unhealthy: %@", host, error);
+                                                     }];
+        }
+    });
+}
+
+// while the pool is full only healthy pooled nodes are picked, so calls go over connections that are already open
+- (NSString *)selectDAPIHostExcludingHost:(NSString *)excludedHost {
 #if DAPI_CONNECT_SINGLE_NODE
-            NSString *peerHost = DAPI_SINGLE_NODE;
+    NSArray<NSString *> *hosts = @[DAPI_SINGLE_NODE];
 #else
-            NSString *peerHost = self.availablePeers.anyObject;
+    NSArray<NSString *> *hosts = [self.availablePeers allObjects];
 #endif
-            HTTPLoaderFactory *loaderFactory = [DSNetworkingCoordinator sharedInstance].loaderFactory;
-            DSDAPIPlatformNetworkService *DAPINetworkService = [[DSDAPIPlatformNetworkService alloc] initWithDAPINodeIPAddress:peerHost httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
-            [self.activePlatformServices addObject:DAPINetworkService];
-            return DAPINetworkService;
-        }
-        return nil;
+    if (![hosts count]) return nil;
+    if (self.servicePool.entryCount >= self.servicePool.maximumEntryCount) {
+        NSString *pooledHost = [self.endpointSelector selectHostFromHosts:[self.servicePool pooledHostsForPort:self.chain.standardDapiGRPCPort] excludingHost:excludedHost];
+        if (pooledHost && ![self.endpointSelector isHostEjected:pooledHost]) return pooledHost;
+    }
+    return [self.endpointSelector selectHostFromHosts:hosts excludingHost:excludedHost];
+}
+
+- (DSDAPIPlatformNetworkService *)DAPIPlatformNetworkService {
+    return [self DAPIPlatformNetworkServiceExcludingHost:nil];
+}
+
+- (DSDAPIPlatformNetworkService *)DAPIPlatformNetworkServiceExcludingHost:(NSString *)excludedHost {
+    [self probeEjectedDAPINodes];
+    @synchronized(self) {
+        NSString *host = [self selectDAPIHostExcludingHost:excludedHost];
+        return host ? [self platformNetworkServiceForHost:host] : nil;
     }
 }
 
 - (DSDAPICoreNetworkService *)DAPICoreNetworkService {
+    [self probeEjectedDAPINodes];
     @synchronized(self) {
-        if ([self.activeCoreServices count]) {
-            if ([self.activeCoreServices count] == 1) return [self.activeCoreServices objectAtIndex:0];                   //if only 1 service, just use first one
-            return [self.activeCoreServices objectAtIndex:arc4random_uniform((uint32_t)[self.activeCoreServices count])]; //use a random service
-        } else if ([self.availablePeers count]) {
-#if DAPI_CONNECT_SINGLE_NODE
-            NSString *peerHost = DAPI_SINGLE_NODE;
-#else
-            NSString *peerHost = [[self.availablePeers allObjects] objectAtIndex:arc4random_uniform((uint32_t)[self.availablePeers count])];
-#endif
-            HTTPLoaderFactory *loaderFactory = [DSNetworkingCoordinator sharedInstance].loaderFactory;
-            DSDAPICoreNetworkService *DAPINetworkService = [[DSDAPICoreNetworkService alloc] initWithDAPINodeIPAddress:peerHost httpLoaderFactory:loaderFactory usingGRPCDispatchQueue:self.coreNetworkingDispatchQueue onChain:self.chain];
-            [self.activeCoreServices addObject:DAPINetworkService];
-            return DAPINetworkService;
+        NSString *host = [self selectDAPIHostExcludingHost:nil];
+        return host ? [self coreNetworkServiceForHost:host] : nil;
+    }
+}
+
+#pragma mark - Reads
+
+- (id<DSDAPINetworkServiceRequest>)performIdempotentPlatformRead:(DSDAPIPlatformReadBlock)read
+                                                         success:(void (^)(id result))success
+                                                         failure:(void (^)(NSError *error))failure {
+    NSParameterAssert(read);
+    DSDAPIPlatformNetworkService *service = self.DAPIPlatformNetworkService;
+    if (!service) {
+        if (failure) {
+            failure([NSError errorWithDomain:DSDAPIClientErrorDomain
+                                        code:DSDAPIClientErrorCodeNoKnownDAPINodes
+                                    userInfo:@{NSLocalizedDescriptionKey: @"No known DAPI Nodes"}]);
         }
         return nil;
     }
+    DSDAPIHedgedRequest *hedgedRequest = [[DSDAPIHedgedRequest alloc] init];
+    hedgedRequest.calls = [NSMutableArray array];
+    hedgedRequest.firstHost = service.ipAddress;
+    hedgedRequest.outstandingCalls = 1;
+    void (^succeeded)(id) = ^(id result) {
+        NSArray<id<DSDAPINetworkServiceRequest>> *calls = nil;
+        @synchronized(hedgedRequest) {
+            if (hedgedRequest.finished) return;
+            hedgedRequest.finished = YES;
+            hedgedRequest.hedge = nil;
+            calls = [hedgedRequest.calls copy];
+        }
+        for (id<DSDAPINetworkServiceRequest> call in calls) {
+            [call cancel]; //the slower node's call, the finished one ignores it
+        }
+        if (success) {
+            success(result);
+        }
+    };
+    void (^failed)(NSError *) = ^(NSError *error) {
+        void (^hedge)(void) = nil;
+        @synchronized(hedgedRequest) {
+            if (hedgedRequest.finished) return;
+            hedgedRequest.outstandingCalls--;
+            hedge = hedgedRequest.hedge;
+            if (!hedge && hedgedRequest.outstandingCalls) return; //the other node might still answer
+            if (!hedge) hedgedRequest.finished = YES;
+        }
+        if (hedge) {
+            hedge(); //don't wait for the hedge delay, the first node already gave up
+        } else if (failure) {
+            failure(error);
+        }
+    };
+    __weak typeof(self) weakSelf = self;
+    __weak DSDAPIHedgedRequest *weakHedgedRequest = hedgedRequest;
+    if (self.hedgesIdempotentReads && self.activePlatformServices.count > 1) {
+        hedgedRequest.hedge = ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            __strong DSDAPIHedgedRequest *strongHedgedRequest = weakHedgedRequest;
+            if (!strongSelf || !strongHedgedRequest) return;
+            DSDAPIPlatformNetworkService *hedgeService = [strongSelf DAPIPlatformNetworkServiceExcludingHost:strongHedgedRequest.firstHost];
+            BOOL failedEverywhere = NO;
+            @synchronized(strongHedgedRequest) {
+                if (strongHedgedRequest.finished || !strongHedgedRequest.hedge) return;
+                strongHedgedRequest.hedge = nil;
+                if (hedgeService) {
+                    strongHedgedRequest.outstandingCalls++;
+                } else if (!strongHedgedRequest.outstandingCalls) {
+                    strongHedgedRequest.finished = YES;
+                    failedEverywhere = YES;
+                }
+            }
+            if (failedEverywhere) {
+                if (failure) {
+                    failure([NSError errorWithDomain:DSDAPIClientErrorDomain
+                                                code:DSDAPIClientErrorCodeNoKnownDAPINodes
+                                            userInfo:@{NSLocalizedDescriptionKey: @"No other DAPI node could answer"}]);
+                }
+                return;
+            }
+            if (!hedgeService) return;
+            id<DSDAPINetworkServiceRequest> call = read(hedgeService, succeeded, failed);
+            if (call) {
+                @synchronized(strongHedgedRequest) {
+                    [strongHedgedRequest.calls addObject:call];
+                }
+            }
+        };
+    }
+    id<DSDAPINetworkServiceRequest> call = read(service, succeeded, failed);
+    if (call) {
+        @synchronized(hedgedRequest) {
+            [hedgedRequest.calls addObject:call];
+        }
+    }
+    if (hedgedRequest.hedge) {
+        //the first node is slower than most answers we've seen lately, ask a second one as well
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)([self.endpointSelector hedgeDelay] * NSEC_PER_SEC)), self.platformMetadataDispatchQueue, ^{
+            void (^hedge)(void) = nil;
+            @synchronized(hedgedRequest) {
+                hedge = hedgedRequest.hedge;
+            }
+            if (hedge) hedge();
+        });
+    }
+    return hedgedRequest;
 }
 
 - (void)publishTransition:(DSTransition *)stateTransition
@@ -349,7 +522,17 @@ NSErrorDomain const DSDAPIClientErrorDomain = @"DSDAPIClientErrorDomain";
 
     [service publishTransition:transition
                completionQueue:completionQueue
-                       success:success
+                       success:^(NSDictionary *_Nonnull successDictionary, BOOL added) {
+                           if ([transition isKindOfClass:[DSDocumentTransition class]]) {
+                               //cached queries over the changed document types are now stale
+                               for (DPDocument *document in [(DSDocumentTransition *)transition documents]) {
+                                   [self.platformDocumentsCache removeDocumentsForContractId:document.contractId documentType:document.tableName];
+                               }
+                           }
+                           if (success) {
+                               success(successDictionary, added);
+                           }
+                       }
                        failure:^(NSError *_Nonnull error) {
                            if (error.code == 12) { //UNIMPLEMENTED, this would mean that we are connecting to an old node
                                [self removeDAPINodeByAddress:service.ipAddress];
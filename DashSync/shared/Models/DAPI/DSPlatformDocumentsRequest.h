@@ -59,6 +59,10 @@ typedef NS_ENUM(NSUInteger, DSPlatformQueryType)
 
 + (instancetype)dpnsRequestForUserId:(NSData *)userId;
 
++ (instancetype)dpnsRequestForUserIds:(NSArray<NSData *> *)userIds;
+
++ (instancetype)dpnsRequestForUserIds:(NSArray<NSData *> *)userIds startAfter:(NSData *_Nullable)startAfter;
+
 + (instancetype)dpnsRequestForUsername:(NSString *)username inDomain:(NSString *)domain;
 
 + (instancetype)dpnsRequestForUsernames:(NSArray *)usernames inDomain:(NSString *)domain;
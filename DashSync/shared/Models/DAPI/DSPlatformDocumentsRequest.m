@@ -17,6 +17,7 @@
 
 #import "DSPlatformDocumentsRequest.h"
 #import "DPContract.h"
+#import "DSDAPIPlatformNetworkServiceProtocol.h"
 #import "DSDirectionalKey.h"
 #import "DSDirectionalRange.h"
 #import "DSPlatformQuery.h"
@@ -67,6 +68,24 @@
     return platformDocumentsRequest;
 }
 
++ (instancetype)dpnsRequestForUserIds:(NSArray<NSData *> *)userIds {
+    return [self dpnsRequestForUserIds:userIds startAfter:nil];
+}
+
++ (instancetype)dpnsRequestForUserIds:(NSArray<NSData *> *)userIds startAfter:(NSData *_Nullable)startAfter {
+    DSPlatformDocumentsRequest *platformDocumentsRequest = [[DSPlatformDocumentsRequest alloc] init];
+    platformDocumentsRequest.predicate = [NSPredicate predicateWithFormat:@"records.dashUniqueIdentityId IN %@", userIds];
+    platformDocumentsRequest.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:@"records.dashUniqueIdentityId" ascending:YES]];
+    platformDocumentsRequest.startAt = startAfter;
+    platformDocumentsRequest.startAtIncluded = false;
+    platformDocumentsRequest.limit = DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT; // an identity can own several names, a full page means there are more
+    platformDocumentsRequest.queryType = DSPlatformQueryType_IndividualElements;
+    platformDocumentsRequest.type = DSPlatformDocumentType_Document;
+    platformDocumentsRequest.tableName = @"domain";
+    platformDocumentsRequest.prove = DSPROVE_PLATFORM_SINDEXES;
+    return platformDocumentsRequest;
+}
+
 + (instancetype)dpnsRequestForUsernames:(NSArray *)usernames inDomain:(NSString *)domain {
     NSMutableArray *lowercaseUsernames = [NSMutableArray array];
     for (NSString *username in usernames) {
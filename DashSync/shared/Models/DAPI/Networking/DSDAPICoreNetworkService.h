@@ -23,11 +23,13 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class HTTPLoaderFactory, DSChain;
+@class HTTPLoaderFactory, DSChain, DSDAPIEndpointSelector;
 
 @interface DSDAPICoreNetworkService : NSObject <DSDAPICoreNetworkServiceProtocol>
 
 @property (readonly, nonatomic) NSString *ipAddress;
+/*! @brief Receives the latency and outcome of every call made through this service. */
+@property (nonatomic, weak, nullable) DSDAPIEndpointSelector *endpointSelector;
 
 - (instancetype)initWithDAPINodeIPAddress:(NSString *)ipAddress httpLoaderFactory:(HTTPLoaderFactory *)httpLoaderFactory usingGRPCDispatchQueue:(dispatch_queue_t)grpcDispatchQueue onChain:(DSChain *)chain NS_DESIGNATED_INITIALIZER;
 - (instancetype)init NS_UNAVAILABLE;
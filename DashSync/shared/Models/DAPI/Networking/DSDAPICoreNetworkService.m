@@ -69,6 +69,7 @@
     GetStatusRequest *statusRequest = [[GetStatusRequest alloc] init];
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initWithChain:self.chain requireProof:NO];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -85,6 +86,7 @@
     transactionRequest.id_p = uint256_hex(transactionHash);
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initWithChain:self.chain requireProof:NO];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = ^(NSDictionary *successDictionary) {
@@ -0,0 +1,72 @@
+//
+//  DSDAPIEndpointSelector.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Keeps an exponentially weighted moving average of the latency and error rate of every DAPI node and picks nodes with the power of two choices: two random candidates are drawn and the healthier one wins. Nodes that keep failing are ejected for a while and become eligible for a probe once their ejection ends. */
+@interface DSDAPIEndpointSelector : NSObject
+
+/*! @brief Weight given to the newest sample in the moving averages. Defaults to 0.2. */
+@property (nonatomic, assign) double smoothingFactor;
+
+/*! @brief Latency assumed for a node that was never measured, in seconds. Defaults to 0.3. */
+@property (nonatomic, assign) NSTimeInterval defaultLatency;
+
+/*! @brief A node is ejected after this many failures in a row. Defaults to 3. */
+@property (nonatomic, assign) NSUInteger consecutiveFailuresBeforeEjection;
+
+/*! @brief How long a node stays out of rotation the first time it is ejected, each ejection in a row doubles it up to ten minutes. Defaults to 30 seconds. */
+@property (nonatomic, assign) NSTimeInterval ejectionDuration;
+
+/*! @brief A probe that got no answer for that long counts as failed. Defaults to 10 seconds. */
+@property (nonatomic, assign) NSTimeInterval probeTimeout;
+
+- (void)addHost:(NSString *)host;
+
+- (void)removeHost:(NSString *)host;
+
+/*! @brief Picks the better of two random healthy hosts among the given ones. Ejected hosts are only returned when nothing else is available. */
+- (NSString *_Nullable)selectHostFromHosts:(NSArray<NSString *> *)hosts excludingHost:(NSString *_Nullable)excludedHost;
+
+- (void)requestStartedForHost:(NSString *)host;
+
+- (void)recordSuccessForHost:(NSString *)host latency:(NSTimeInterval)latency;
+
+- (void)recordFailureForHost:(NSString *)host;
+
+- (void)requestCancelledForHost:(NSString *)host;
+
+/*! @brief Seeds the latency of a host from a ping without counting it as a request. */
+- (void)recordPingTime:(NSTimeInterval)pingTime forHost:(NSString *)host;
+
+- (BOOL)isHostEjected:(NSString *)host;
+
+/*! @brief Hosts whose ejection ended and that should be probed before being trusted again, each host is only returned once per ejection. A probe that timed out ejects its host again. */
+- (NSArray<NSString *> *)hostsNeedingProbe;
+
+/*! @brief The 95th percentile of recently observed latencies, used as the delay before hedging a read to a second node. */
+- (NSTimeInterval)hedgeDelay;
+
+- (NSTimeInterval)latencyForHost:(NSString *)host;
+
+- (double)errorRateForHost:(NSString *)host;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,245 @@
+//
+//  DSDAPIEndpointSelector.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSDAPIEndpointSelector.h"
+
+#define DEFAULT_SMOOTHING_FACTOR 0.2
+#define DEFAULT_LATENCY 0.3
+#define DEFAULT_CONSECUTIVE_FAILURES_BEFORE_EJECTION 3
+#define DEFAULT_EJECTION_DURATION 30
+#define MAX_EJECTION_DURATION 600
+#define DEFAULT_PROBE_TIMEOUT 10
+#define RECENT_LATENCY_SAMPLE_COUNT 128
+#define MIN_HEDGE_SAMPLE_COUNT 16
+#define MIN_HEDGE_DELAY 0.05
+#define MAX_HEDGE_DELAY 5.0
+
+@interface DSDAPIEndpointStats : NSObject
+
+@property (nonatomic, assign) NSTimeInterval latency; // 0 until measured
+@property (nonatomic, assign) double errorRate;
+@property (nonatomic, assign) NSUInteger inFlight;
+@property (nonatomic, assign) NSUInteger consecutiveFailures;
+@property (nonatomic, assign) NSUInteger ejectionCount;
+@property (nonatomic, assign) NSTimeInterval ejectedUntil;
+@property (nonatomic, assign) BOOL needsProbe;
+@property (nonatomic, assign) BOOL probing;
+@property (nonatomic, assign) NSTimeInterval probingUntil;
+
+@end
+
+@implementation DSDAPIEndpointStats
+
+@end
+
+@interface DSDAPIEndpointSelector ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, DSDAPIEndpointStats *> *stats;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *recentLatencies;
+@property (nonatomic, assign) NSUInteger recentLatencyIndex;
+
+@end
+
+@implementation DSDAPIEndpointSelector
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.stats = [NSMutableDictionary dictionary];
+    self.recentLatencies = [NSMutableArray arrayWithCapacity:RECENT_LATENCY_SAMPLE_COUNT];
+    self.smoothingFactor = DEFAULT_SMOOTHING_FACTOR;
+    self.defaultLatency = DEFAULT_LATENCY;
+    self.consecutiveFailuresBeforeEjection = DEFAULT_CONSECUTIVE_FAILURES_BEFORE_EJECTION;
+    self.ejectionDuration = DEFAULT_EJECTION_DURATION;
+    self.probeTimeout = DEFAULT_PROBE_TIMEOUT;
+    return self;
+}
+
+- (DSDAPIEndpointStats *)statsForHost:(NSString *)host {
+    DSDAPIEndpointStats *stats = self.stats[host];
+    if (!stats) {
+        stats = [[DSDAPIEndpointStats alloc] init];
+        self.stats[host] = stats;
+    }
+    return stats;
+}
+
+- (void)addHost:(NSString *)host {
+    @synchronized(self) {
+        [self statsForHost:host];
+    }
+}
+
+- (void)removeHost:(NSString *)host {
+    @synchronized(self) {
+        [self.stats removeObjectForKey:host];
+    }
+}
+
+// MARK: - Selection
+
+// lower is better, a node that is slow, busy or failing half of the time is avoided proportionally
+- (double)scoreForStats:(DSDAPIEndpointStats *)stats {
+    NSTimeInterval latency = stats.latency > 0 ? stats.latency : self.defaultLatency;
+    return latency * (stats.inFlight + 1) / MAX(0.05, 1.0 - stats.errorRate);
+}
+
+- (NSString *)selectHostFromHosts:(NSArray<NSString *> *)hosts excludingHost:(NSString *)excludedHost {
+    @synchronized(self) {
+        NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+        NSMutableArray<NSString *> *candidates = [NSMutableArray arrayWithCapacity:hosts.count];
+        NSString *leastRecentlyEjectedHost = nil;
+        NSTimeInterval leastRecentlyEjectedUntil = DBL_MAX;
+        for (NSString *host in hosts) {
+            if (excludedHost && [host isEqualToString:excludedHost]) continue;
+            DSDAPIEndpointStats *stats = [self statsForHost:host];
+            if (stats.ejectedUntil > now || stats.needsProbe || stats.probing) {
+                if (stats.ejectedUntil < leastRecentlyEjectedUntil) {
+                    leastRecentlyEjectedUntil = stats.ejectedUntil;
+                    leastRecentlyEjectedHost = host;
+                }
+                continue;
+            }
+            [candidates addObject:host];
+        }
+        if (!candidates.count) return leastRecentlyEjectedHost;
+        if (candidates.count == 1) return candidates.firstObject;
+        uint32_t first = arc4random_uniform((uint32_t)candidates.count);
+        uint32_t second = arc4random_uniform((uint32_t)candidates.count - 1);
+        if (second >= first) second++;
+        NSString *firstHost = candidates[first], *secondHost = candidates[second];
+        return ([self scoreForStats:self.stats[secondHost]] < [self scoreForStats:self.stats[firstHost]]) ? secondHost : firstHost;
+    }
+}
+
+// MARK: - Recording
+
+- (void)requestStartedForHost:(NSString *)host {
+    @synchronized(self) {
+        [self statsForHost:host].inFlight++;
+    }
+}
+
+- (void)addLatencySample:(NSTimeInterval)latency toStats:(DSDAPIEndpointStats *)stats {
+    stats.latency = stats.latency > 0 ? stats.latency + self.smoothingFactor * (latency - stats.latency) : latency;
+}
+
+- (void)recordSuccessForHost:(NSString *)host latency:(NSTimeInterval)latency {
+    @synchronized(self) {
+        DSDAPIEndpointStats *stats = [self statsForHost:host];
+        if (stats.inFlight) stats.inFlight--;
+        [self addLatencySample:latency toStats:stats];
+        stats.errorRate -= self.smoothingFactor * stats.errorRate;
+        stats.consecutiveFailures = 0;
+        stats.ejectionCount = 0;
+        stats.ejectedUntil = 0;
+        stats.needsProbe = NO;
+        stats.probing = NO;
+        if (self.recentLatencies.count < RECENT_LATENCY_SAMPLE_COUNT) {
+            [self.recentLatencies addObject:@(latency)];
+        } else {
+            self.recentLatencies[self.recentLatencyIndex] = @(latency);
+        }
+        self.recentLatencyIndex = (self.recentLatencyIndex + 1) % RECENT_LATENCY_SAMPLE_COUNT;
+    }
+}
+
+- (void)recordFailureForHost:(NSString *)host {
+    @synchronized(self) {
+        DSDAPIEndpointStats *stats = [self statsForHost:host];
+        if (stats.inFlight) stats.inFlight--;
+        stats.errorRate += self.smoothingFactor * (1.0 - stats.errorRate);
+        stats.consecutiveFailures++;
+        if ((stats.probing || stats.consecutiveFailures >= self.consecutiveFailuresBeforeEjection) && !stats.needsProbe) {
+            [self ejectStats:stats at:[[NSDate date] timeIntervalSince1970]];
+        }
+    }
+}
+
+// must be called while synchronized
+- (void)ejectStats:(DSDAPIEndpointStats *)stats at:(NSTimeInterval)time {
+    NSTimeInterval ejectionDuration = MIN(MAX_EJECTION_DURATION, self.ejectionDuration * (1 << MIN(stats.ejectionCount, 10)));
+    stats.ejectionCount++;
+    stats.ejectedUntil = time + ejectionDuration;
+    stats.needsProbe = YES;
+    stats.probing = NO;
+    stats.consecutiveFailures = 0;
+}
+
+- (void)requestCancelledForHost:(NSString *)host {
+    @synchronized(self) {
+        DSDAPIEndpointStats *stats = self.stats[host];
+        if (stats.inFlight) stats.inFlight--;
+    }
+}
+
+- (void)recordPingTime:(NSTimeInterval)pingTime forHost:(NSString *)host {
+    @synchronized(self) {
+        [self addLatencySample:pingTime toStats:[self statsForHost:host]];
+    }
+}
+
+// MARK: - Health
+
+- (BOOL)isHostEjected:(NSString *)host {
+    @synchronized(self) {
+        DSDAPIEndpointStats *stats = self.stats[host];
+        return stats.needsProbe || stats.probing;
+    }
+}
+
+- (NSArray<NSString *> *)hostsNeedingProbe {
+    @synchronized(self) {
+        NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+        NSMutableArray<NSString *> *hosts = [NSMutableArray array];
+        [self.stats enumerateKeysAndObjectsUsingBlock:^(NSString *host, DSDAPIEndpointStats *stats, BOOL *stop) {
+            //a probe that never called back would keep the host out of rotation for good
+            if (stats.probing && stats.probingUntil <= now) [self ejectStats:stats at:now];
+            if (stats.needsProbe && stats.ejectedUntil && stats.ejectedUntil <= now) {
+                //stays out of rotation until the probe succeeds, a failed probe ejects it again for longer
+                stats.needsProbe = NO;
+                stats.probing = YES;
+                stats.probingUntil = now + self.probeTimeout;
+                [hosts addObject:host];
+            }
+        }];
+        return hosts;
+    }
+}
+
+- (NSTimeInterval)hedgeDelay {
+    @synchronized(self) {
+        if (self.recentLatencies.count < MIN_HEDGE_SAMPLE_COUNT) return MAX_HEDGE_DELAY / 5;
+        NSArray<NSNumber *> *sortedLatencies = [self.recentLatencies sortedArrayUsingSelector:@selector(compare:)];
+        NSTimeInterval p95 = [sortedLatencies[(sortedLatencies.count * 95) / 100] doubleValue];
+        return MIN(MAX_HEDGE_DELAY, MAX(MIN_HEDGE_DELAY, p95));
+    }
+}
+
+- (NSTimeInterval)latencyForHost:(NSString *)host {
+    @synchronized(self) {
+        DSDAPIEndpointStats *stats = self.stats[host];
+        return (stats.latency > 0) ? stats.latency : self.defaultLatency;
+    }
+}
+
+- (double)errorRateForHost:(NSString *)host {
+    @synchronized(self) {
+        return self.stats[host].errorRate;
+    }
+}
+
+@end
@@ -23,7 +23,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class DSQuorumEntry, DSPlatformQuery, DSTransition;
+@class DSQuorumEntry, DSPlatformQuery, DSTransition, DSDAPIEndpointSelector;
 
 @interface DSDAPIGRPCResponseHandler : NSObject <GRPCProtoResponseHandler>
 
@@ -48,6 +48,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initForGetIdentityIDsByPublicKeyHashesRequest:(NSArray<NSData *> *)hashes withChain:(DSChain *)chain requireProof:(BOOL)requireProof;
 - (instancetype)initForGetIdentitiesByPublicKeyHashesRequest:(NSArray<NSData *> *)hashes withChain:(DSChain *)chain requireProof:(BOOL)requireProof;
 
+/*! @brief Reports how long the call took and whether it failed to the endpoint selector once the call closes, cancelled calls are not reported. */
+- (void)observeLatencyForHost:(NSString *)host withEndpointSelector:(DSDAPIEndpointSelector *_Nullable)endpointSelector;
+
 + (NSDictionary *)verifyAndExtractFromProof:(Proof *)proof withMetadata:(ResponseMetadata *)metaData query:(DSPlatformQuery *_Nullable)query forQuorumEntry:(DSQuorumEntry *)quorumEntry quorumType:(LLMQType)quorumType error:(NSError **)error;
 
 @end
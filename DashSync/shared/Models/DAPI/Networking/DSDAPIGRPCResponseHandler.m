@@ -19,6 +19,7 @@
 #import "DPContract.h"
 #import "DSChain.h"
 #import "DSChainManager.h"
+#import "DSDAPIEndpointSelector.h"
 #import "DSDocumentTransition.h"
 #import "DSMasternodeManager.h"
 #import "DSPlatformQuery.h"
@@ -46,6 +47,9 @@
 @property (nonatomic, strong) DSChain *chain;
 @property (nonatomic, assign) BOOL requireProof;
 @property (nonatomic, strong) DSPlatformQuery *query;
+@property (nonatomic, weak) DSDAPIEndpointSelector *endpointSelector;
+@property (nonatomic, strong) NSString *endpointHost;
+@property (nonatomic, assign) NSTimeInterval startTime;
 
 @end
 
@@ -378,6 +382,27 @@
     }
 }
 
+- (void)observeLatencyForHost:(NSString *)host withEndpointSelector:(DSDAPIEndpointSelector *)endpointSelector {
+    if (!endpointSelector) return;
+    self.endpointSelector = endpointSelector;
+    self.endpointHost = host;
+    self.startTime = [[NSDate date] timeIntervalSince1970];
+    [endpointSelector requestStartedForHost:host];
+}
+
+- (void)reportCompletionWithError:(NSError *)error {
+    DSDAPIEndpointSelector *endpointSelector = self.endpointSelector;
+    if (!endpointSelector || !self.endpointHost) return;
+    if (!error) {
+        [endpointSelector recordSuccessForHost:self.endpointHost latency:[[NSDate date] timeIntervalSince1970] - self.startTime];
+    } else if ([error.domain isEqualToString:kGRPCErrorDomain] && error.code == GRPCErrorCodeCancelled) {
+        //we gave up on the call, the node did nothing wrong
+        [endpointSelector requestCancelledForHost:self.endpointHost];
+    } else {
+        [endpointSelector recordFailureForHost:self.endpointHost];
+    }
+}
+
 - (void)didReceiveInitialMetadata:(nullable NSDictionary *)initialMetadata {
 }
 
@@ -409,6 +434,8 @@
 - (void)didCloseWithTrailingMetadata:(nullable NSDictionary *)trailingMetadata
                                error:(nullable NSError *)error {
     NSAssert(self.completionQueue, @"Completion queue must be set");
+    //a response that doesn't decode or verify counts against the node as much as a transport error
+    [self reportCompletionWithError:error ?: self.decodingError];
     if (!error && self.decodingError) {
         error = self.decodingError;
     }
@@ -438,10 +465,12 @@
     NSData *quorumHashData = proof.signatureLlmqHash;
     if (!quorumHashData) {
         *error = [NSError errorWithCode:500 localizedDescriptionKey:@"Platform returned no quorum hash data"];
+        return nil;
     }
     UInt256 quorumHash = quorumHashData.reverse.UInt256;
     if (uint256_is_zero(quorumHash)) {
         *error = [NSError errorWithCode:500 localizedDescriptionKey:@"Platform returned an empty quorum hash"];
+        return nil;
     }
     DSQuorumEntry *quorumEntry = [chain.chainManager.masternodeManager quorumEntryForPlatformHavingQuorumHash:quorumHash forBlockHeight:metaData.coreChainLockedHeight];
     if (quorumEntry && quorumEntry.verified) {
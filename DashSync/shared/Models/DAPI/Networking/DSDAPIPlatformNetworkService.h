@@ -23,11 +23,15 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class HTTPLoaderFactory, DSChain;
+@class HTTPLoaderFactory, DSChain, DSPlatformDocumentsCache, DSDAPIEndpointSelector;
 
 @interface DSDAPIPlatformNetworkService : NSObject <DSDAPIPlatformNetworkServiceProtocol>
 
 @property (readonly, nonatomic) NSString *ipAddress;
+/*! @brief Receives the latency and outcome of every call made through this service. */
+@property (nonatomic, weak, nullable) DSDAPIEndpointSelector *endpointSelector;
+/*! @brief When set, profile and DPNS lookups by identity are answered from this cache and identical concurrent lookups share one call. */
+@property (nonatomic, strong, nullable) DSPlatformDocumentsCache *documentsCache;
 
 - (instancetype)initWithDAPINodeIPAddress:(NSString *)ipAddress httpLoaderFactory:(HTTPLoaderFactory *)httpLoaderFactory usingGRPCDispatchQueue:(dispatch_queue_t)grpcDispatchQueue onChain:(DSChain *)chain NS_DESIGNATED_INITIALIZER;
 - (instancetype)init NS_UNAVAILABLE;
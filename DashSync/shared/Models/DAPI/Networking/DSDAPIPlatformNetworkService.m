@@ -24,6 +24,7 @@
 #import "DSDashPlatform.h"
 #import "DSHTTPJSONRPCClient.h"
 #import "DSPeer.h"
+#import "DSPlatformDocumentsCache.h"
 #import "DSPlatformDocumentsRequest.h"
 #import "DSTransition.h"
 #import "NSData+Dash.h"
@@ -32,6 +33,8 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
 
 #define DSPlatformRequestLog(frmt, ...) DDLogInfo(frmt, ##__VA_ARGS__)
 
+#define DAPI_PLATFORM_MAXIMUM_CONCURRENT_IDENTITY_REQUESTS 8
+
 
 @interface DSDAPIPlatformNetworkService ()
 
@@ -43,6 +46,48 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
 
 @end
 
+@interface DSDAPIPlatformBatchedRequest : NSObject <DSDAPINetworkServiceRequest>
+
+@property (nonatomic, strong) NSMutableArray<id<DSDAPINetworkServiceRequest>> *requests;
+@property (nonatomic, assign, getter=isCancelled) BOOL cancelled;
+
+- (BOOL)addRequest:(id<DSDAPINetworkServiceRequest>)request;
+
+@end
+
+@implementation DSDAPIPlatformBatchedRequest
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.requests = [NSMutableArray array];
+    return self;
+}
+
+// returns NO if the batch was cancelled in the meantime, in which case the request is cancelled as well
+- (BOOL)addRequest:(id<DSDAPINetworkServiceRequest>)request {
+    @synchronized(self) {
+        if (!self.cancelled) {
+            [self.requests addObject:request];
+            return YES;
+        }
+    }
+    [request cancel];
+    return NO;
+}
+
+- (void)cancel {
+    NSArray<id<DSDAPINetworkServiceRequest>> *requests;
+    @synchronized(self) {
+        self.cancelled = YES;
+        requests = [self.requests copy];
+    }
+    for (id<DSDAPINetworkServiceRequest> request in requests) {
+        [request cancel];
+    }
+}
+
+@end
+
 @implementation DSDAPIPlatformNetworkService
 
 - (instancetype)initWithDAPINodeIPAddress:(NSString *)ipAddress httpLoaderFactory:(HTTPLoaderFactory *)httpLoaderFactory usingGRPCDispatchQueue:(dispatch_queue_t)grpcDispatchQueue onChain:(DSChain *)chain {
@@ -462,6 +507,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     getIdentityIdsByPublicKeyHashesRequest.prove = DSPROVE_PLATFORM;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForGetIdentityIDsByPublicKeyHashesRequest:keyHashesArray withChain:self.chain requireProof:DSPROVE_PLATFORM];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -483,6 +529,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     getIdentitiesByPublicKeyHashesRequest.prove = DSPROVE_PLATFORM;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForGetIdentitiesByPublicKeyHashesRequest:keyHashesArray withChain:self.chain requireProof:DSPROVE_PLATFORM];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -504,6 +551,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     getDataContractRequest.prove = DSPROVE_PLATFORM;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForContractRequest:contractId withChain:self.chain requireProof:DSPROVE_PLATFORM];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -524,6 +572,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dpnsContract;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -542,15 +591,21 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     DSPlatformRequestLog(@"getDPNSDocumentsForIdentityWithUserId (base58) %@", userId.base58String);
     DSPlatformDocumentsRequest *platformDocumentsRequest = [DSPlatformDocumentsRequest dpnsRequestForUserId:userId];
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dpnsContract;
-    DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
-    responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
-    responseHandler.dispatchQueue = self.grpcDispatchQueue;
-    responseHandler.completionQueue = completionQueue;
-    responseHandler.successHandler = success;
-    responseHandler.errorHandler = failure;
-    GRPCUnaryProtoCall *call = [self.gRPCClient getDocumentsWithMessage:platformDocumentsRequest.getDocumentsRequest responseHandler:responseHandler callOptions:nil];
-    [call start];
-    return (id<DSDAPINetworkServiceRequest>)call;
+    return [self cachedDocumentsWithRequest:platformDocumentsRequest completionQueue:completionQueue success:success failure:failure];
+}
+
+- (id<DSDAPINetworkServiceRequest>)getDPNSDocumentsForIdentitiesWithUserIds:(NSArray<NSData *> *)userIds
+                                                                 startAfter:(NSData *_Nullable)startAfter
+                                                            completionQueue:(dispatch_queue_t)completionQueue
+                                                                    success:(void (^)(NSArray<NSDictionary *> *documents))success
+                                                                    failure:(void (^)(NSError *error))failure {
+    NSParameterAssert(userIds);
+    NSParameterAssert(completionQueue);
+    NSAssert(userIds.count > 0, @"You must query at least 1 userId");
+    DSPlatformRequestLog(@"getDPNSDocumentsForIdentitiesWithUserIds %lu identities", (unsigned long)userIds.count);
+    DSPlatformDocumentsRequest *platformDocumentsRequest = [DSPlatformDocumentsRequest dpnsRequestForUserIds:userIds startAfter:startAfter];
+    platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dpnsContract;
+    return [self cachedDocumentsWithRequest:platformDocumentsRequest completionQueue:completionQueue success:success failure:failure];
 }
 
 - (id<DSDAPINetworkServiceRequest>)getDPNSDocumentsForUsernames:(NSArray *)usernames
@@ -565,6 +620,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dpnsContract;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -588,6 +644,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dpnsContract;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -610,6 +667,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dpnsContract;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = ^(NSArray *dpnsDictionaries) {
@@ -654,6 +712,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     getIdentityRequest.prove = DSPROVE_PLATFORM;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForIdentityRequest:userId withChain:self.chain requireProof:DSPROVE_PLATFORM];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -663,6 +722,77 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     return (id<DSDAPINetworkServiceRequest>)call;
 }
 
+- (id<DSDAPINetworkServiceRequest>)getIdentitiesByIds:(NSArray<NSData *> *)userIds
+                                      completionQueue:(dispatch_queue_t)completionQueue
+                                              success:(void (^)(NSDictionary<NSData *, NSDictionary *> *blockchainIdentities))success
+                                              failure:(void (^)(NSError *error))failure {
+    NSParameterAssert(userIds);
+    NSParameterAssert(completionQueue);
+    DSPlatformRequestLog(@"getIdentitiesByIds %lu identities", (unsigned long)userIds.count);
+    //Platform does not expose a multi identity query yet, so fan out single lookups over the same channel and gather them
+    //only a bounded window of lookups is in flight at once, each completion starts the next one
+    DSDAPIPlatformBatchedRequest *batchedRequest = [[DSDAPIPlatformBatchedRequest alloc] init];
+    NSArray<NSData *> *uniqueUserIds = [[NSOrderedSet orderedSetWithArray:userIds] array];
+    NSMutableDictionary<NSData *, NSDictionary *> *identityDictionaries = [NSMutableDictionary dictionary];
+    __block NSError *lastError = nil;
+    __block NSUInteger nextUserIdIndex = 0;
+    dispatch_group_t dispatchGroup = dispatch_group_create();
+    for (NSUInteger i = 0; i < uniqueUserIds.count; i++) {
+        dispatch_group_enter(dispatchGroup);
+    }
+    __block void (^fetchNextIdentity)(void);
+    fetchNextIdentity = ^{
+        NSData *userId = nil;
+        @synchronized(identityDictionaries) {
+            if (nextUserIdIndex < uniqueUserIds.count) {
+                userId = uniqueUserIds[nextUserIdIndex++];
+            }
+        }
+        if (!userId) return;
+        if (batchedRequest.isCancelled) {
+            //nothing more will be issued, account for this id and every remaining one
+            fetchNextIdentity();
+            dispatch_group_leave(dispatchGroup);
+            return;
+        }
+        id<DSDAPINetworkServiceRequest> request = [self getIdentityById:userId
+            completionQueue:self.grpcDispatchQueue
+            success:^(NSDictionary *_Nullable blockchainIdentity) {
+                if (blockchainIdentity) {
+                    @synchronized(identityDictionaries) {
+                        identityDictionaries[userId] = blockchainIdentity;
+                    }
+                }
+                fetchNextIdentity();
+                dispatch_group_leave(dispatchGroup);
+            }
+            failure:^(NSError *_Nonnull error) {
+                @synchronized(identityDictionaries) {
+                    lastError = error;
+                }
+                fetchNextIdentity();
+                dispatch_group_leave(dispatchGroup);
+            }];
+        [batchedRequest addRequest:request];
+    };
+    for (NSUInteger i = 0; i < MIN(uniqueUserIds.count, DAPI_PLATFORM_MAXIMUM_CONCURRENT_IDENTITY_REQUESTS); i++) {
+        fetchNextIdentity();
+    }
+    dispatch_group_notify(dispatchGroup, completionQueue, ^{
+        //every id has been accounted for (the next lookup is always started before leaving the group),
+        //so nothing calls the recursive block anymore and its retain cycle can be broken
+        fetchNextIdentity = nil;
+        if (!identityDictionaries.count && lastError) {
+            if (failure) {
+                failure(lastError);
+            }
+        } else if (success) {
+            success([identityDictionaries copy]);
+        }
+    });
+    return batchedRequest;
+}
+
 - (id<DSDAPINetworkServiceRequest>)publishTransition:(DSTransition *)stateTransition
                                      completionQueue:(dispatch_queue_t)completionQueue
                                              success:(void (^)(NSDictionary *successDictionary, BOOL added))success
@@ -699,6 +829,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     // There is no way to prove that the message was added to the mempool, so we should not require proof
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initWithChain:self.chain requireProof:NO];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = ^(NSDictionary *successDictionary) {
@@ -724,6 +855,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dashPayContract;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -745,6 +877,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dashPayContract;
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -764,15 +897,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     DSPlatformRequestLog(@"getDashpayProfileForUserId (base58) %@", userId.base58String);
     DSPlatformDocumentsRequest *platformDocumentsRequest = [DSPlatformDocumentsRequest dashpayRequestForProfileWithUserId:userId];
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dashPayContract;
-    DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
-    responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
-    responseHandler.dispatchQueue = self.grpcDispatchQueue;
-    responseHandler.completionQueue = completionQueue;
-    responseHandler.successHandler = success;
-    responseHandler.errorHandler = failure;
-    GRPCUnaryProtoCall *call = [self.gRPCClient getDocumentsWithMessage:platformDocumentsRequest.getDocumentsRequest responseHandler:responseHandler callOptions:nil];
-    [call start];
-    return (id<DSDAPINetworkServiceRequest>)call;
+    return [self cachedDocumentsWithRequest:platformDocumentsRequest completionQueue:completionQueue success:success failure:failure];
 }
 
 - (id<DSDAPINetworkServiceRequest>)getDashpayProfilesForUserIds:(NSArray<NSData *> *)userIds
@@ -785,15 +910,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     DSPlatformRequestLog(@"getDashpayProfilesForUserIds %@", userIds);
     DSPlatformDocumentsRequest *platformDocumentsRequest = [DSPlatformDocumentsRequest dashpayRequestForProfilesWithUserIds:userIds];
     platformDocumentsRequest.contract = [DSDashPlatform sharedInstanceForChain:self.chain].dashPayContract;
-    DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
-    responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
-    responseHandler.dispatchQueue = self.grpcDispatchQueue;
-    responseHandler.completionQueue = completionQueue;
-    responseHandler.successHandler = success;
-    responseHandler.errorHandler = failure;
-    GRPCUnaryProtoCall *call = [self.gRPCClient getDocumentsWithMessage:platformDocumentsRequest.getDocumentsRequest responseHandler:responseHandler callOptions:nil];
-    [call start];
-    return (id<DSDAPINetworkServiceRequest>)call;
+    return [self cachedDocumentsWithRequest:platformDocumentsRequest completionQueue:completionQueue success:success failure:failure];
 }
 
 - (id<DSDAPINetworkServiceRequest>)fetchDocumentsWithRequest:(DSPlatformDocumentsRequest *)platformDocumentsRequest
@@ -805,6 +922,7 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
     DSPlatformRequestLog(@"fetchDocumentsWithRequest %@", platformDocumentsRequest);
     DSDAPIGRPCResponseHandler *responseHandler = [[DSDAPIGRPCResponseHandler alloc] initForDocumentsQueryRequest:platformDocumentsRequest withChain:self.chain requireProof:DSPROVE_PLATFORM_SINDEXES];
     responseHandler.host = [NSString stringWithFormat:@"%@:%d", self.ipAddress, self.chain.standardDapiGRPCPort];
+    [responseHandler observeLatencyForHost:self.ipAddress withEndpointSelector:self.endpointSelector];
     responseHandler.dispatchQueue = self.grpcDispatchQueue;
     responseHandler.completionQueue = completionQueue;
     responseHandler.successHandler = success;
@@ -817,6 +935,24 @@ NSString *const DSDAPINetworkServiceErrorDomain = @"dash.dapi-network-service.er
 
 #pragma mark - Private
 
+- (id<DSDAPINetworkServiceRequest>)cachedDocumentsWithRequest:(DSPlatformDocumentsRequest *)platformDocumentsRequest
+                                              completionQueue:(dispatch_queue_t)completionQueue
+                                                      success:(void (^)(NSArray<NSDictionary *> *documents))success
+                                                      failure:(void (^)(NSError *error))failure {
+    DSPlatformDocumentsCache *documentsCache = self.documentsCache;
+    if (!documentsCache) {
+        return [self fetchDocumentsWithRequest:platformDocumentsRequest completionQueue:completionQueue success:success failure:failure];
+    }
+    return [documentsCache documentsForRequest:platformDocumentsRequest
+                                          host:self.ipAddress
+                               completionQueue:completionQueue
+                                       success:success
+                                       failure:failure
+                                         fetch:^id<DSDAPINetworkServiceRequest>(DSPlatformDocumentsSuccessBlock fetchSuccess, DSPlatformDocumentsFailureBlock fetchFailure) {
+        return [self fetchDocumentsWithRequest:platformDocumentsRequest completionQueue:self.grpcDispatchQueue success:fetchSuccess failure:fetchFailure];
+    }];
+}
+
 - (void)requestWithMethod:(NSString *)method
                parameters:(nullable NSDictionary *)parameters
      validateAgainstClass:(Class)responseClass
@@ -404,6 +404,19 @@ typedef NS_ENUM(NSUInteger, DSDAPINetworkServiceErrorCode)
                                            success:(void (^)(NSDictionary *_Nullable blockchainIdentity))success
                                            failure:(void (^)(NSError *error))failure;
 
+/**
+ Get several blockchain users by ID. All lookups share the node's gRPC channel and are issued concurrently.
+
+ @param userIds Blockchain users' IDs
+ @param completionQueue The queue in which to return the result on
+ @param success A block object to be executed when the request operation finishes, identities that were not found are absent from the result
+ @param failure A block object to be executed when no identity could be retrieved because of an error
+ */
+- (id<DSDAPINetworkServiceRequest>)getIdentitiesByIds:(NSArray<NSData *> *)userIds
+                                      completionQueue:(dispatch_queue_t)completionQueue
+                                              success:(void (^)(NSDictionary<NSData *, NSDictionary *> *blockchainIdentities))success
+                                              failure:(void (^)(NSError *error))failure;
+
 /**
  Sends raw state transition to the network
  
@@ -444,6 +457,20 @@ typedef NS_ENUM(NSUInteger, DSDAPINetworkServiceErrorCode)
                                                                  success:(void (^)(NSArray<NSDictionary *> *documents))success
                                                                  failure:(void (^)(NSError *error))failure;
 
+/**
+Get the DPNS domain documents of several identities with a single `in` query
+
+@param userIds The unique ids of the identities, at most 100
+@param startAfter The id of the last document of the previous page, a page of DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT documents means there are more
+@param success A block object to be executed when the request operation finishes successfully
+@param failure A block object to be executed when the request operation finishes unsuccessfully
+*/
+- (id<DSDAPINetworkServiceRequest>)getDPNSDocumentsForIdentitiesWithUserIds:(NSArray<NSData *> *)userIds
+                                                                 startAfter:(NSData *_Nullable)startAfter
+                                                            completionQueue:(dispatch_queue_t)completionQueue
+                                                                    success:(void (^)(NSArray<NSDictionary *> *documents))success
+                                                                    failure:(void (^)(NSError *error))failure;
+
 /**
 Get a list of users after matching search criteria
 
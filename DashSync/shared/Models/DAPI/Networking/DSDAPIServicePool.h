@@ -0,0 +1,54 @@
+//
+//  DSDAPIServicePool.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Keeps the network services of recently used DAPI nodes, keyed by the node's gRPC host:port, so every call site reuses them. The core and platform services of a node build the same call options and gRPC sends their calls over one shared HTTP/2 channel, which it closes once no calls are left on it. Bounding the pooled nodes therefore bounds the connections kept open. Thread safe. */
+@interface DSDAPIServicePool : NSObject
+
+/*! @brief The most nodes kept, the least recently used one is evicted when a new node is added. Defaults to 16. */
+@property (nonatomic, assign) NSUInteger maximumEntryCount;
+
+/*! @brief Nodes without a service handed out for this long are evicted. Defaults to 5 minutes. */
+@property (nonatomic, assign) NSTimeInterval idleTimeout;
+
+@property (nonatomic, readonly) NSUInteger entryCount;
+/*! @brief Services handed out from a pooled node. */
+@property (nonatomic, readonly) NSUInteger reusedCount;
+/*! @brief Services created because their node wasn't pooled yet. */
+@property (nonatomic, readonly) NSUInteger openedCount;
+/*! @brief Nodes dropped to stay within maximumEntryCount or after idling. */
+@property (nonatomic, readonly) NSUInteger evictedCount;
+
+/*! @brief Returns the pooled service of the class for the node, creating and pooling it if needed, and marks the node as used. */
+- (id)serviceOfClass:(Class)serviceClass forHost:(NSString *)host port:(uint32_t)port create:(id (^)(void))create;
+
+/*! @brief Returns the pooled service of the class for the node without pooling a new one or marking the node as used, for sweeps over many nodes that shouldn't evict the ones in use. */
+- (id _Nullable)pooledServiceOfClass:(Class)serviceClass forHost:(NSString *)host port:(uint32_t)port;
+
+/*! @brief The hosts of the pooled nodes on the port, least recently used first. */
+- (NSArray<NSString *> *)pooledHostsForPort:(uint32_t)port;
+
+- (void)removeServicesForHost:(NSString *)host port:(uint32_t)port;
+
+- (void)removeAllServices;
+
+@end
+
+NS_ASSUME_NONNULL_END
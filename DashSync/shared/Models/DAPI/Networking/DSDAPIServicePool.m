@@ -0,0 +1,150 @@
+//
+//  DSDAPIServicePool.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSDAPIServicePool.h"
+
+#define DEFAULT_MAXIMUM_ENTRY_COUNT 16
+#define DEFAULT_IDLE_TIMEOUT 300
+
+@interface DSDAPIServicePoolEntry : NSObject
+
+@property (nonatomic, strong) NSString *host;
+@property (nonatomic, assign) uint32_t port;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *services;
+@property (nonatomic, assign) NSTimeInterval lastUse;
+
+@end
+
+@implementation DSDAPIServicePoolEntry
+
+@end
+
+@interface DSDAPIServicePool ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, DSDAPIServicePoolEntry *> *entries;
+@property (nonatomic, strong) NSMutableArray<NSString *> *keys; //least recently used first
+@property (nonatomic, assign) NSUInteger reusedCount;
+@property (nonatomic, assign) NSUInteger openedCount;
+@property (nonatomic, assign) NSUInteger evictedCount;
+
+@end
+
+@implementation DSDAPIServicePool
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.entries = [NSMutableDictionary dictionary];
+    self.keys = [NSMutableArray array];
+    self.maximumEntryCount = DEFAULT_MAXIMUM_ENTRY_COUNT;
+    self.idleTimeout = DEFAULT_IDLE_TIMEOUT;
+    return self;
+}
+
+static NSString *poolKey(NSString *host, uint32_t port) {
+    return [NSString stringWithFormat:@"%@:%u", host, port];
+}
+
+- (NSUInteger)entryCount {
+    @synchronized(self) {
+        return self.entries.count;
+    }
+}
+
+- (void)evictEntryForKey:(NSString *)key {
+    [self.entries removeObjectForKey:key];
+    [self.keys removeObject:key];
+    self.evictedCount++;
+}
+
+// the least recently used nodes come first, so idle ones are found at the front
+- (void)evictIdleEntriesAt:(NSTimeInterval)now {
+    while (self.keys.count && now - self.entries[self.keys.firstObject].lastUse > self.idleTimeout) {
+        [self evictEntryForKey:self.keys.firstObject];
+    }
+}
+
+- (id)serviceOfClass:(Class)serviceClass forHost:(NSString *)host port:(uint32_t)port create:(id (^)(void))create {
+    NSParameterAssert(host);
+    NSParameterAssert(create);
+    NSString *key = poolKey(host, port);
+    NSString *serviceKey = NSStringFromClass(serviceClass);
+    @synchronized(self) {
+        NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+        [self evictIdleEntriesAt:now];
+        DSDAPIServicePoolEntry *entry = self.entries[key];
+        if (entry) {
+            [self.keys removeObject:key];
+        } else {
+            entry = [[DSDAPIServicePoolEntry alloc] init];
+            entry.host = host;
+            entry.port = port;
+            entry.services = [NSMutableDictionary dictionary];
+            self.entries[key] = entry;
+        }
+        [self.keys addObject:key];
+        entry.lastUse = now;
+        id service = entry.services[serviceKey];
+        if (service) {
+            self.reusedCount++;
+        } else {
+            service = create();
+            entry.services[serviceKey] = service;
+            self.openedCount++;
+        }
+        while (self.keys.count > MAX(self.maximumEntryCount, 1)) {
+            [self evictEntryForKey:self.keys.firstObject];
+        }
+        return service;
+    }
+}
+
+- (id)pooledServiceOfClass:(Class)serviceClass forHost:(NSString *)host port:(uint32_t)port {
+    NSParameterAssert(host);
+    @synchronized(self) {
+        id service = self.entries[poolKey(host, port)].services[NSStringFromClass(serviceClass)];
+        if (service) self.reusedCount++;
+        return service;
+    }
+}
+
+- (NSArray<NSString *> *)pooledHostsForPort:(uint32_t)port {
+    @synchronized(self) {
+        NSMutableArray<NSString *> *hosts = [NSMutableArray arrayWithCapacity:self.keys.count];
+        for (NSString *key in self.keys) {
+            DSDAPIServicePoolEntry *entry = self.entries[key];
+            if (entry.port == port) [hosts addObject:entry.host];
+        }
+        return hosts;
+    }
+}
+
+- (void)removeServicesForHost:(NSString *)host port:(uint32_t)port {
+    NSString *key = poolKey(host, port);
+    @synchronized(self) {
+        [self.entries removeObjectForKey:key];
+        [self.keys removeObject:key];
+    }
+}
+
+- (void)removeAllServices {
+    @synchronized(self) {
+        [self.entries removeAllObjects];
+        [self.keys removeAllObjects];
+    }
+}
+
+@end
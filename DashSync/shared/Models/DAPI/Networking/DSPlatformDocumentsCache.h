@@ -0,0 +1,57 @@
+//
+//  DSPlatformDocumentsCache.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import "DSDAPINetworkServiceRequest.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSPlatformDocumentsRequest;
+
+typedef void (^DSPlatformDocumentsSuccessBlock)(NSArray<NSDictionary *> *documents);
+typedef void (^DSPlatformDocumentsFailureBlock)(NSError *error);
+typedef id<DSDAPINetworkServiceRequest> _Nullable (^DSPlatformDocumentsFetchBlock)(DSPlatformDocumentsSuccessBlock success, DSPlatformDocumentsFailureBlock failure);
+
+/*! @brief Caches document query results keyed by (contract, document type, query) and merges concurrent identical queries into a single DAPI call. */
+@interface DSPlatformDocumentsCache : NSObject
+
+/*! @brief How long the results of a query are served from the cache. This is only a time to live, cached results are not checked against the platform height. Defaults to 15 seconds, which is enough to absorb retries and screens querying the same identities. */
+@property (nonatomic, assign) NSTimeInterval timeToLive;
+
+/*! @brief The most query results kept, the least recently used ones are dropped first. Defaults to 256. */
+@property (nonatomic, assign) NSUInteger maximumEntryCount;
+
+@property (nonatomic, readonly) NSUInteger hitCount;
+@property (nonatomic, readonly) NSUInteger coalescedCount;
+@property (nonatomic, readonly) NSUInteger missCount;
+
+/*! @brief Returns cached documents for the request if they are still fresh, joins an identical query that is already in flight to the same host, or performs the fetch block otherwise. Only successful responses are cached. A read hedged to a second node is therefore sent to that node rather than waiting on the first one. */
+- (id<DSDAPINetworkServiceRequest>)documentsForRequest:(DSPlatformDocumentsRequest *)platformDocumentsRequest
+                                                  host:(NSString *_Nullable)host
+                                       completionQueue:(dispatch_queue_t)completionQueue
+                                               success:(DSPlatformDocumentsSuccessBlock)success
+                                               failure:(DSPlatformDocumentsFailureBlock)failure
+                                                 fetch:(DSPlatformDocumentsFetchBlock)fetchBlock;
+
+- (void)removeDocumentsForContractId:(UInt256)contractId documentType:(NSString *)documentType;
+
+- (void)removeAllDocuments;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,280 @@
+//
+//  DSPlatformDocumentsCache.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSPlatformDocumentsCache.h"
+#import "DPContract.h"
+#import "DSPlatformDocumentsRequest.h"
+#import "NSData+Dash.h"
+#import <DAPI-GRPC/Platform.pbobjc.h>
+
+#define DEFAULT_TIME_TO_LIVE 15
+#define DEFAULT_MAXIMUM_ENTRY_COUNT 256
+
+@class DSPlatformDocumentsFetch;
+
+@interface DSPlatformDocumentsCacheEntry : NSObject
+
+@property (nonatomic, strong) NSData *contractId;
+@property (nonatomic, strong) NSString *documentType;
+@property (nonatomic, strong) NSArray<NSDictionary *> *documents;
+@property (nonatomic, assign) NSTimeInterval expiresAt;
+@property (nonatomic, assign) uint64_t lastUse;
+
+@end
+
+@implementation DSPlatformDocumentsCacheEntry
+
+@end
+
+@interface DSPlatformDocumentsCacheRequest : NSObject <DSDAPINetworkServiceRequest>
+
+@property (nonatomic, weak) DSPlatformDocumentsCache *cache;
+@property (nonatomic, weak) DSPlatformDocumentsFetch *fetch;
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@property (nonatomic, copy) DSPlatformDocumentsSuccessBlock success;
+@property (nonatomic, copy) DSPlatformDocumentsFailureBlock failure;
+
+@end
+
+@interface DSPlatformDocumentsFetch : NSObject
+
+@property (nonatomic, strong) NSData *key;
+@property (nonatomic, strong) NSData *contractId;
+@property (nonatomic, strong) NSString *documentType;
+@property (nonatomic, assign) BOOL invalidated;
+@property (nonatomic, strong) NSMutableArray<DSPlatformDocumentsCacheRequest *> *waiters;
+@property (nonatomic, strong) id<DSDAPINetworkServiceRequest> call;
+
+@end
+
+@implementation DSPlatformDocumentsFetch
+
+@end
+
+@interface DSPlatformDocumentsCache ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSData *, DSPlatformDocumentsCacheEntry *> *entries;
+@property (nonatomic, strong) NSMutableDictionary<NSData *, DSPlatformDocumentsFetch *> *fetches;
+@property (nonatomic, assign) NSUInteger hitCount;
+@property (nonatomic, assign) NSUInteger coalescedCount;
+@property (nonatomic, assign) NSUInteger missCount;
+@property (nonatomic, assign) uint64_t useCount;
+
+- (void)cancelRequest:(DSPlatformDocumentsCacheRequest *)request;
+
+@end
+
+@implementation DSPlatformDocumentsCacheRequest
+
+- (void)cancel {
+    [self.cache cancelRequest:self];
+}
+
+@end
+
+@implementation DSPlatformDocumentsCache
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.entries = [NSMutableDictionary dictionary];
+    self.fetches = [NSMutableDictionary dictionary];
+    self.timeToLive = DEFAULT_TIME_TO_LIVE;
+    self.maximumEntryCount = DEFAULT_MAXIMUM_ENTRY_COUNT;
+    return self;
+}
+
+- (id<DSDAPINetworkServiceRequest>)documentsForRequest:(DSPlatformDocumentsRequest *)platformDocumentsRequest
+                                                  host:(NSString *)host
+                                       completionQueue:(dispatch_queue_t)completionQueue
+                                               success:(DSPlatformDocumentsSuccessBlock)success
+                                               failure:(DSPlatformDocumentsFailureBlock)failure
+                                                 fetch:(DSPlatformDocumentsFetchBlock)fetchBlock {
+    NSParameterAssert(platformDocumentsRequest);
+    NSParameterAssert(completionQueue);
+    NSParameterAssert(fetchBlock);
+    //the serialized grpc message holds the contract, the document type and every part of the query
+    NSData *key = [[platformDocumentsRequest getDocumentsRequest] data];
+    NSData *fetchKey = key;
+    if (host) {
+        NSMutableData *hostKey = [key mutableCopy];
+        [hostKey appendData:[host dataUsingEncoding:NSUTF8StringEncoding]];
+        fetchKey = hostKey;
+    }
+    DSPlatformDocumentsCacheRequest *request = [[DSPlatformDocumentsCacheRequest alloc] init];
+    request.cache = self;
+    request.completionQueue = completionQueue;
+    request.success = success;
+    request.failure = failure;
+    DSPlatformDocumentsFetch *fetch = nil;
+    @synchronized(self) {
+        DSPlatformDocumentsCacheEntry *entry = self.entries[key];
+        if (entry && entry.expiresAt > [[NSDate date] timeIntervalSince1970]) {
+            self.hitCount++;
+            entry.lastUse = ++self.useCount;
+            NSArray<NSDictionary *> *documents = entry.documents;
+            dispatch_async(completionQueue, ^{
+                if (success) {
+                    success(documents);
+                }
+            });
+            return request;
+        } else if (entry) {
+            [self.entries removeObjectForKey:key];
+        }
+        DSPlatformDocumentsFetch *inFlightFetch = self.fetches[fetchKey];
+        if (inFlightFetch) {
+            self.coalescedCount++;
+            request.fetch = inFlightFetch;
+            [inFlightFetch.waiters addObject:request];
+            return request;
+        }
+        self.missCount++;
+        fetch = [[DSPlatformDocumentsFetch alloc] init];
+        fetch.key = fetchKey;
+        fetch.contractId = uint256_data(platformDocumentsRequest.contract.contractId);
+        fetch.documentType = platformDocumentsRequest.tableName;
+        fetch.waiters = [NSMutableArray arrayWithObject:request];
+        request.fetch = fetch;
+        self.fetches[fetchKey] = fetch;
+    }
+    NSTimeInterval timeToLive = self.timeToLive;
+    __weak typeof(self) weakSelf = self;
+    id<DSDAPINetworkServiceRequest> call = fetchBlock(^(NSArray<NSDictionary *> *documents) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) return;
+        NSArray<DSPlatformDocumentsCacheRequest *> *waiters = nil;
+        @synchronized(strongSelf) {
+            fetch.call = nil;
+            if (strongSelf.fetches[fetchKey] != fetch) return; //every waiter cancelled
+            [strongSelf.fetches removeObjectForKey:fetchKey];
+            waiters = [fetch.waiters copy];
+            if (timeToLive > 0 && strongSelf.maximumEntryCount && !fetch.invalidated) {
+                NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+                [strongSelf.entries removeObjectForKey:key];
+                [strongSelf removeEntriesExpiredAt:now];
+                [strongSelf removeLeastRecentlyUsedEntriesKeeping:strongSelf.maximumEntryCount - 1];
+                DSPlatformDocumentsCacheEntry *entry = [[DSPlatformDocumentsCacheEntry alloc] init];
+                entry.contractId = fetch.contractId;
+                entry.documentType = fetch.documentType;
+                entry.documents = documents;
+                entry.expiresAt = now + timeToLive;
+                entry.lastUse = ++strongSelf.useCount;
+                strongSelf.entries[key] = entry;
+            }
+        }
+        for (DSPlatformDocumentsCacheRequest *waiter in waiters) {
+            dispatch_async(waiter.completionQueue, ^{
+                if (waiter.success) {
+                    waiter.success(documents);
+                }
+            });
+        }
+    },
+        ^(NSError *error) {
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) return;
+            NSArray<DSPlatformDocumentsCacheRequest *> *waiters = nil;
+            @synchronized(strongSelf) {
+                fetch.call = nil;
+                if (strongSelf.fetches[fetchKey] == fetch) {
+                    [strongSelf.fetches removeObjectForKey:fetchKey];
+                }
+                waiters = [fetch.waiters copy];
+            }
+            for (DSPlatformDocumentsCacheRequest *waiter in waiters) {
+                dispatch_async(waiter.completionQueue, ^{
+                    if (waiter.failure) {
+                        waiter.failure(error);
+                    }
+                });
+            }
+        });
+    @synchronized(self) {
+        if (self.fetches[fetchKey] == fetch) {
+            fetch.call = call;
+        }
+    }
+    return request;
+}
+
+// must be called while synchronized
+- (void)removeEntriesExpiredAt:(NSTimeInterval)time {
+    for (NSData *key in [self.entries allKeys]) {
+        if (self.entries[key].expiresAt <= time) {
+            [self.entries removeObjectForKey:key];
+        }
+    }
+}
+
+// must be called while synchronized
+- (void)removeLeastRecentlyUsedEntriesKeeping:(NSUInteger)count {
+    while (self.entries.count > count) {
+        __block NSData *leastRecentlyUsedKey = nil;
+        __block uint64_t leastRecentUse = UINT64_MAX;
+        [self.entries enumerateKeysAndObjectsUsingBlock:^(NSData *_Nonnull key, DSPlatformDocumentsCacheEntry *_Nonnull entry, BOOL *_Nonnull stop) {
+            if (entry.lastUse < leastRecentUse) {
+                leastRecentUse = entry.lastUse;
+                leastRecentlyUsedKey = key;
+            }
+        }];
+        [self.entries removeObjectForKey:leastRecentlyUsedKey];
+    }
+}
+
+- (void)cancelRequest:(DSPlatformDocumentsCacheRequest *)request {
+    id<DSDAPINetworkServiceRequest> callToCancel = nil;
+    @synchronized(self) {
+        DSPlatformDocumentsFetch *fetch = request.fetch;
+        if (!fetch) return;
+        [fetch.waiters removeObject:request];
+        if (!fetch.waiters.count && self.fetches[fetch.key] == fetch) {
+            //nobody is waiting on this query anymore
+            [self.fetches removeObjectForKey:fetch.key];
+            callToCancel = fetch.call;
+        }
+    }
+    [callToCancel cancel];
+}
+
+- (void)removeDocumentsForContractId:(UInt256)contractId documentType:(NSString *)documentType {
+    NSData *contractIdData = uint256_data(contractId);
+    @synchronized(self) {
+        for (NSData *key in [self.entries allKeys]) {
+            DSPlatformDocumentsCacheEntry *entry = self.entries[key];
+            if ([entry.contractId isEqualToData:contractIdData] && [entry.documentType isEqualToString:documentType]) {
+                [self.entries removeObjectForKey:key];
+            }
+        }
+        //queries already in flight might have been answered before the change, deliver them but don't keep them
+        for (DSPlatformDocumentsFetch *fetch in [self.fetches allValues]) {
+            if ([fetch.contractId isEqualToData:contractIdData] && [fetch.documentType isEqualToString:documentType]) {
+                fetch.invalidated = YES;
+            }
+        }
+    }
+}
+
+- (void)removeAllDocuments {
+    @synchronized(self) {
+        [self.entries removeAllObjects];
+        for (DSPlatformDocumentsFetch *fetch in [self.fetches allValues]) {
+            fetch.invalidated = YES;
+        }
+    }
+}
+
+@end
@@ -41,6 +41,12 @@ NS_ASSUME_NONNULL_BEGIN
 // all previously generated internal addresses
 @property (nonatomic, readonly) NSArray *allChangeAddresses;
 
+// previously generated external addresses from the index onwards, in derivation order
+- (NSArray *)receiveAddressesFromIndex:(NSUInteger)index;
+
+// previously generated internal addresses from the index onwards, in derivation order
+- (NSArray *)changeAddressesFromIndex:(NSUInteger)index;
+
 // used external addresses
 @property (nonatomic, readonly) NSArray *usedReceiveAddresses;
 
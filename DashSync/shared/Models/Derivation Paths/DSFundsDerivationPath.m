@@ -285,6 +285,22 @@
     return [self.internalAddresses copy];
 }
 
+static NSArray *addressesFromIndex(NSArray *addresses, NSUInteger index) {
+    return (index < addresses.count) ? [addresses subarrayWithRange:NSMakeRange(index, addresses.count - index)] : @[];
+}
+
+- (NSArray *)receiveAddressesFromIndex:(NSUInteger)index {
+    @synchronized(self) {
+        return addressesFromIndex(self.externalAddresses, index);
+    }
+}
+
+- (NSArray *)changeAddressesFromIndex:(NSUInteger)index {
+    @synchronized(self) {
+        return addressesFromIndex(self.internalAddresses, index);
+    }
+}
+
 // true if the address is controlled by the wallet
 - (BOOL)containsChangeAddress:(NSString *)address {
     return address && [self.allChangeAddresses containsObject:address];
@@ -42,6 +42,9 @@ NS_ASSUME_NONNULL_BEGIN
 // all previously generated external addresses
 @property (nonatomic, readonly) NSArray *allReceiveAddresses;
 
+// previously generated external addresses from the index onwards, in derivation order
+- (NSArray *)receiveAddressesFromIndex:(NSUInteger)index;
+
 // used external addresses
 @property (nonatomic, readonly) NSArray *usedReceiveAddresses;
 
@@ -274,6 +274,13 @@
     return [self.externalAddresses copy];
 }
 
+- (NSArray *)receiveAddressesFromIndex:(NSUInteger)index {
+    @synchronized(self) {
+        NSArray *addresses = self.externalAddresses;
+        return (index < addresses.count) ? [addresses subarrayWithRange:NSMakeRange(index, addresses.count - index)] : @[];
+    }
+}
+
 - (NSArray *)usedReceiveAddresses {
     NSMutableSet *intersection = [NSMutableSet setWithArray:self.allReceiveAddresses];
     [intersection intersectSet:self.mUsedAddresses];
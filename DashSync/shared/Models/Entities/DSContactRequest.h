@@ -41,6 +41,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSData *)decryptedPublicKeyDataWithKey:(OpaqueKey *)key;
 
+/*! @brief Same as decryptedPublicKeyDataWithKey: but with our secret key already loaded, so that many requests can be decrypted without reading the keychain for each of them. */
+- (NSData *_Nullable)decryptedPublicKeyDataWithKey:(OpaqueKey *)key usingSecretKey:(OpaqueKey *)secretKey;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -96,6 +96,12 @@
     return [self.encryptedPublicKeyData decryptWithSecretKey:[self secretKeyForDecryptionOfType:(int16_t) key->tag] fromPublicKey:key];
 }
 
+- (NSData *)decryptedPublicKeyDataWithKey:(OpaqueKey *)key usingSecretKey:(OpaqueKey *)secretKey {
+    NSParameterAssert(key);
+    NSParameterAssert(secretKey);
+    return [self.encryptedPublicKeyData decryptWithSecretKey:secretKey fromPublicKey:key];
+}
+
 - (NSString *)debugDescription {
     return [NSString stringWithFormat:@"%@ - from %@/%d to %@/%d", [super debugDescription], uint256_base58(self.senderBlockchainIdentityUniqueId), self.senderKeyIndex, uint256_base58(self.recipientBlockchainIdentityUniqueId), self.recipientKeyIndex];
 }
@@ -78,6 +78,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)applyProfileChanges:(DSTransientDashpayUser *)transientDashpayUser inContext:(NSManagedObjectContext *)context saveContext:(BOOL)saveContext completion:(void (^_Nullable)(BOOL success, NSError *_Nullable error))completion onCompletionQueue:(dispatch_queue_t)completionQueue;
 
+- (void)applyUsernameDocuments:(NSArray<NSDictionary *> *)documents inContext:(NSManagedObjectContext *)context completion:(void (^_Nullable)(void))completion;
+
 - (void)setInvitationUniqueId:(UInt256)uniqueId;
 
 - (void)setInvitationRegistrationCreditFundingTransaction:(DSCreditFundingTransaction *)creditFundingTransaction;
@@ -2475,6 +2475,33 @@ typedef NS_ENUM(NSUInteger, DSBlockchainIdentityKeyDictionary)
             return;
         }
         //todo verify return is true
+        [strongSelf applyUsernameDocuments:documents
+                                 inContext:context
+                                completion:^{
+            if (completion) {
+                dispatch_async(completionQueue, ^{
+                    completion(YES, nil);
+                });
+            }
+        }];
+    }
+                                                      failure:^(NSError *_Nonnull error) {
+        if (error.code == 12) { //UNIMPLEMENTED, this would mean that we are connecting to an old node
+            [self.DAPIClient removeDAPINodeByAddress:dapiNetworkService.ipAddress];
+            [self fetchUsernamesInContext:context withCompletion:completion onCompletionQueue:completionQueue];
+        } else {
+            if (completion) {
+                dispatch_async(completionQueue, ^{
+                    completion(NO, error);
+                });
+            }
+        }
+    }];
+}
+
+
+- (void)applyUsernameDocuments:(NSArray<NSDictionary *> *)documents inContext:(NSManagedObjectContext *)context completion:(void (^_Nullable)(void))completion {
+    [context performBlock:^{
         for (NSDictionary *nameDictionary in documents) {
             NSString *username = nameDictionary[@"label"];
             NSString *lowercaseUsername = nameDictionary[@"normalizedLabel"];
@@ -2498,26 +2525,11 @@ typedef NS_ENUM(NSUInteger, DSBlockchainIdentityKeyDictionary)
             }
         }
         if (completion) {
-            dispatch_async(completionQueue, ^{
-                completion(YES, nil);
-            });
-        }
-    }
-                                                      failure:^(NSError *_Nonnull error) {
-        if (error.code == 12) { //UNIMPLEMENTED, this would mean that we are connecting to an old node
-            [self.DAPIClient removeDAPINodeByAddress:dapiNetworkService.ipAddress];
-            [self fetchUsernamesInContext:context withCompletion:completion onCompletionQueue:completionQueue];
-        } else {
-            if (completion) {
-                dispatch_async(completionQueue, ^{
-                    completion(NO, error);
-                });
-            }
+            completion();
         }
     }];
 }
 
-
 // MARK: - Monitoring
 
 - (void)updateCreditBalance {
@@ -3627,7 +3639,7 @@ typedef NS_ENUM(NSUInteger, DSBlockchainIdentityKeyDictionary)
     [self internalFetchProfileInContext:context
                          withCompletion:^(BOOL success, NSError *error) {
         if (!success && retryCount > 0) {
-            [self fetchUsernamesInContext:context retryCount:retryCount - 1 withCompletion:completion onCompletionQueue:completionQueue];
+            [self fetchProfileInContext:context retryCount:retryCount - 1 withCompletion:completion onCompletionQueue:completionQueue];
         } else if (completion) {
             completion(success, error);
         }
@@ -4032,142 +4044,212 @@ typedef NS_ENUM(NSUInteger, DSBlockchainIdentityKeyDictionary)
         }
         return;
     }
+    __block NSMutableArray<DSContactRequest *> *localRequests = [NSMutableArray array];
+    __block NSMutableArray<DSContactRequest *> *remoteRequests = [NSMutableArray array];
+    __block NSMutableDictionary<NSData *, DSBlockchainIdentity *> *senderBlockchainIdentities = [NSMutableDictionary dictionary];
+    __block NSMutableOrderedSet<NSData *> *unresolvedSenderIds = [NSMutableOrderedSet orderedSet];
     [context performBlockAndWait:^{
-        __block BOOL succeeded = YES;
-        __block NSMutableArray *errors = [NSMutableArray array];
-        dispatch_group_t dispatchGroup = dispatch_group_create();
-        
+        NSMutableArray<NSData *> *senderIds = [NSMutableArray arrayWithCapacity:incomingRequests.count];
         for (DSContactRequest *contactRequest in incomingRequests) {
-            DSBlockchainIdentityEntity *externalBlockchainIdentityEntity = [DSBlockchainIdentityEntity anyObjectInContext:context matching:@"uniqueID == %@", uint256_data(contactRequest.senderBlockchainIdentityUniqueId)];
-            if (!externalBlockchainIdentityEntity) {
-                //no externalBlockchainIdentity exists yet, which means no dashpay user
-                dispatch_group_enter(dispatchGroup);
-                DSBlockchainIdentity *senderBlockchainIdentity = [self.identitiesManager foreignBlockchainIdentityWithUniqueId:contactRequest.senderBlockchainIdentityUniqueId createIfMissing:YES inContext:context];
-                
-                [senderBlockchainIdentity fetchNeededNetworkStateInformationInContext:self.platformContext
-                                                                       withCompletion:^(DSBlockchainIdentityQueryStep failureStep, NSArray<NSError *> *_Nullable networkErrors) {
-                    if (!failureStep) {
-                        OpaqueKey *senderPublicKey = [senderBlockchainIdentity keyAtIndex:contactRequest.senderKeyIndex];
-                        NSData *extendedPublicKeyData = [contactRequest decryptedPublicKeyDataWithKey:senderPublicKey];
-                        OpaqueKey *extendedPublicKey = [DSKeyManager keyWithExtendedPublicKeyData:extendedPublicKeyData ofType:KeyKind_ECDSA];
-                        if (!extendedPublicKey) {
-                            succeeded = FALSE;
-                            [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Incorrect key format after contact request decryption"]];
-                        } else {
-                            DSDashpayUserEntity *senderDashpayUserEntity = [senderBlockchainIdentity blockchainIdentityEntityInContext:context].matchingDashpayUser;
-                            NSAssert(senderDashpayUserEntity, @"The sender should exist");
-                            [self addIncomingRequestFromContact:senderDashpayUserEntity
-                                           forExtendedPublicKey:extendedPublicKey
-                                                    atTimestamp:contactRequest.createdAt];
-                        }
-                    } else {
-                        [errors addObjectsFromArray:networkErrors];
-                    }
-                    dispatch_group_leave(dispatchGroup);
-                }
-                                                                    onCompletionQueue:self.identityQueue];
-                
-            } else {
-                if ([self.chain blockchainIdentityForUniqueId:externalBlockchainIdentityEntity.uniqueID.UInt256]) {
-                    //it's also local (aka both contacts are local to this device), we should store the extended public key for the destination
-                    DSBlockchainIdentity *sourceBlockchainIdentity = [self.chain blockchainIdentityForUniqueId:externalBlockchainIdentityEntity.uniqueID.UInt256];
-                    
-                    DSAccount *account = [sourceBlockchainIdentity.wallet accountWithNumber:0];
-                    
-                    DSPotentialOneWayFriendship *potentialFriendship = [[DSPotentialOneWayFriendship alloc] initWithDestinationBlockchainIdentity:self destinationKeyIndex:contactRequest.recipientKeyIndex sourceBlockchainIdentity:sourceBlockchainIdentity sourceKeyIndex:contactRequest.senderKeyIndex account:account];
-                    
-                    if (![DSFriendRequestEntity existingFriendRequestEntityWithSourceIdentifier:sourceBlockchainIdentity.uniqueID destinationIdentifier:self.uniqueID onAccountIndex:account.accountNumber inContext:context]) {
-                        dispatch_group_enter(dispatchGroup);
-                        [potentialFriendship createDerivationPathAndSaveExtendedPublicKeyWithCompletion:^(BOOL success, DSIncomingFundsDerivationPath *_Nonnull incomingFundsDerivationPath) {
-                            if (success) {
-                                DSDashpayUserEntity *matchingDashpayUserInContext = [self matchingDashpayUserInContext:context];
-                                DSFriendRequestEntity *friendRequest = [potentialFriendship outgoingFriendRequestForDashpayUserEntity:matchingDashpayUserInContext atTimestamp:contactRequest.createdAt];
-                                [potentialFriendship storeExtendedPublicKeyAssociatedWithFriendRequest:friendRequest];
-                                [matchingDashpayUserInContext addIncomingRequestsObject:friendRequest];
-                                
-                                if ([[friendRequest.sourceContact.incomingRequests filteredSetUsingPredicate:[NSPredicate predicateWithFormat:@"sourceContact == %@", matchingDashpayUserInContext]] count]) {
-                                    [matchingDashpayUserInContext addFriendsObject:friendRequest.sourceContact];
-                                }
-                                
-                                [account addIncomingDerivationPath:incomingFundsDerivationPath
-                                           forFriendshipIdentifier:friendRequest.friendshipIdentifier
-                                                         inContext:context];
-                                [context ds_save];
-                                [self.chain.chainManager.transactionManager updateTransactionsBloomFilter];
-                            } else {
-                                succeeded = FALSE;
-                                [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Could not create friendship derivation path"]];
-                            }
-                            dispatch_group_leave(dispatchGroup);
-                        }];
-                    }
-                    
+            [senderIds addObject:uint256_data(contactRequest.senderBlockchainIdentityUniqueId)];
+        }
+        //prefetch all senders at once instead of querying the store for every contact request
+        NSMutableDictionary<NSData *, DSBlockchainIdentityEntity *> *senderEntities = [NSMutableDictionary dictionary];
+        for (DSBlockchainIdentityEntity *entity in [DSBlockchainIdentityEntity objectsInContext:context matching:@"uniqueID IN %@", senderIds]) {
+            senderEntities[entity.uniqueID] = entity;
+        }
+        for (DSContactRequest *contactRequest in incomingRequests) {
+            NSData *senderId = uint256_data(contactRequest.senderBlockchainIdentityUniqueId);
+            DSBlockchainIdentityEntity *senderEntity = senderEntities[senderId];
+            if (senderEntity && [self.chain blockchainIdentityForUniqueId:contactRequest.senderBlockchainIdentityUniqueId]) {
+                //it's also local (aka both contacts are local to this device)
+                [localRequests addObject:contactRequest];
+                continue;
+            }
+            [remoteRequests addObject:contactRequest];
+            DSBlockchainIdentity *senderBlockchainIdentity = senderBlockchainIdentities[senderId];
+            if (!senderBlockchainIdentity) {
+                if (senderEntity) {
+                    senderBlockchainIdentity = [[DSBlockchainIdentity alloc] initWithBlockchainIdentityEntity:senderEntity];
                 } else {
-                    DSBlockchainIdentity *sourceBlockchainIdentity = [[DSBlockchainIdentity alloc] initWithBlockchainIdentityEntity:externalBlockchainIdentityEntity];
-                    NSAssert(sourceBlockchainIdentity, @"This should not be null");
-                    if ([sourceBlockchainIdentity activeKeyCount] > 0 && [sourceBlockchainIdentity keyAtIndex:contactRequest.senderKeyIndex]) {
-                        //the contact already existed, and has an encryption public key set, create the incoming friend request, add a friendship if an outgoing friend request also exists
-                        OpaqueKey *key = [sourceBlockchainIdentity keyAtIndex:contactRequest.senderKeyIndex];
-                        NSData *decryptedExtendedPublicKeyData = [contactRequest decryptedPublicKeyDataWithKey:key];
-                        NSAssert(decryptedExtendedPublicKeyData, @"Data should be decrypted");
-                        OpaqueKey *extendedPublicKey = [DSKeyManager keyWithExtendedPublicKeyData:decryptedExtendedPublicKeyData ofType:KeyKind_ECDSA];
-                        if (!extendedPublicKey) {
-                            succeeded = FALSE;
-                            [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Contact request extended public key is incorrectly encrypted."]];
-                            return;
-                        }
-                        [self addIncomingRequestFromContact:externalBlockchainIdentityEntity.matchingDashpayUser
-                                       forExtendedPublicKey:extendedPublicKey
-                                                atTimestamp:contactRequest.createdAt];
-                        
-                        DSDashpayUserEntity *matchingDashpayUserInContext = [self matchingDashpayUserInContext:context];
-                        if ([[externalBlockchainIdentityEntity.matchingDashpayUser.incomingRequests filteredSetUsingPredicate:[NSPredicate predicateWithFormat:@"sourceContact == %@", matchingDashpayUserInContext]] count]) {
-                            [matchingDashpayUserInContext addFriendsObject:[externalBlockchainIdentityEntity matchingDashpayUser]];
-                            [context ds_save];
-                        }
-                        
-                    } else {
-                        //the blockchain identity is already known, but needs to updated to get the right key, create the incoming friend request, add a friendship if an outgoing friend request also exists
-                        dispatch_group_enter(dispatchGroup);
-                        [sourceBlockchainIdentity fetchNeededNetworkStateInformationInContext:context
-                                                                               withCompletion:^(DSBlockchainIdentityQueryStep failureStep, NSArray<NSError *> *networkStateInformationErrors) {
-                            if (!failureStep) {
-                                [context performBlockAndWait:^{
-                                    OpaqueKey *key = [sourceBlockchainIdentity keyAtIndex:contactRequest.senderKeyIndex];
-                                    NSAssert(key, @"key should be known");
-                                    NSData *decryptedExtendedPublicKeyData = [contactRequest decryptedPublicKeyDataWithKey:key];
-                                    NSAssert(decryptedExtendedPublicKeyData, @"Data should be decrypted");
-                                    OpaqueKey *extendedPublicKey = [DSKeyManager keyWithExtendedPublicKeyData:decryptedExtendedPublicKeyData ofType:KeyKind_ECDSA];
-                                    NSAssert(extendedPublicKey, @"A key should be recovered");
-                                    [self addIncomingRequestFromContact:externalBlockchainIdentityEntity.matchingDashpayUser
-                                                   forExtendedPublicKey:extendedPublicKey
-                                                            atTimestamp:contactRequest.createdAt];
-                                    DSDashpayUserEntity *matchingDashpayUserInContext = [self matchingDashpayUserInContext:context];
-                                    if ([[externalBlockchainIdentityEntity.matchingDashpayUser.incomingRequests filteredSetUsingPredicate:[NSPredicate predicateWithFormat:@"sourceContact == %@", matchingDashpayUserInContext]] count]) {
-                                        [matchingDashpayUserInContext addFriendsObject:externalBlockchainIdentityEntity.matchingDashpayUser];
-                                        [context ds_save];
-                                    }
-                                }];
-                            } else {
-                                succeeded = FALSE;
-                                [errors addObjectsFromArray:networkStateInformationErrors];
-                            }
-                            dispatch_group_leave(dispatchGroup);
-                        }
-                                                                            onCompletionQueue:self.identityQueue];
-                    }
+                    //no externalBlockchainIdentity exists yet, which means no dashpay user
+                    senderBlockchainIdentity = [self.identitiesManager foreignBlockchainIdentityWithUniqueId:contactRequest.senderBlockchainIdentityUniqueId createIfMissing:YES inContext:context];
                 }
+                NSAssert(senderBlockchainIdentity, @"This should not be null");
+                senderBlockchainIdentities[senderId] = senderBlockchainIdentity;
+            }
+            if (![senderBlockchainIdentity keyAtIndex:contactRequest.senderKeyIndex]) {
+                //the blockchain identity is unknown or needs to be updated to get the right key
+                [unresolvedSenderIds addObject:senderId];
             }
         }
-        
-        dispatch_group_notify(dispatchGroup, completionQueue, ^{
-            if (completion) {
-                completion(succeeded, [errors copy]);
+    }];
+    
+    __block NSMutableArray *errors = [NSMutableArray array];
+    void (^commitRequests)(void) = ^{
+        [errors addObjectsFromArray:[self commitIncomingRemoteRequests:remoteRequests
+                                                          localRequests:localRequests
+                                                    fromSenderIdentities:senderBlockchainIdentities
+                                                               inContext:context]];
+        if (completion) {
+            dispatch_async(completionQueue, ^{
+                completion(!errors.count, [errors copy]);
+            });
+        }
+        //profiles and usernames of new contacts are not needed to establish the friendship, get them afterwards in one batch
+        DSBlockchainIdentityQueryStep queryStep = DSBlockchainIdentityQueryStep_None;
+        if ([DSOptionsManager sharedInstance].syncType & DSSyncType_DPNS) {
+            queryStep |= DSBlockchainIdentityQueryStep_Username;
+        }
+        if ([DSOptionsManager sharedInstance].syncType & DSSyncType_Dashpay) {
+            queryStep |= DSBlockchainIdentityQueryStep_Profile;
+        }
+        NSMutableArray<DSBlockchainIdentity *> *newSenderBlockchainIdentities = [NSMutableArray array];
+        for (NSData *senderId in unresolvedSenderIds) {
+            [newSenderBlockchainIdentities addObject:senderBlockchainIdentities[senderId]];
+        }
+        [self.identitiesManager fetchUsernamesAndProfilesForBlockchainIdentities:newSenderBlockchainIdentities
+                                                                      queryStep:queryStep
+                                                                      inContext:context
+                                                                 withCompletion:nil
+                                                              onCompletionQueue:self.identityQueue];
+    };
+    
+    if (!unresolvedSenderIds.count) {
+        dispatch_async(self.identityQueue, commitRequests);
+        return;
+    }
+    [self.DAPINetworkService getIdentitiesByIds:[unresolvedSenderIds array]
+                                completionQueue:self.identityQueue
+                                        success:^(NSDictionary<NSData *, NSDictionary *> *_Nonnull blockchainIdentities) {
+        [context performBlockAndWait:^{
+            for (NSData *senderId in blockchainIdentities) {
+                NSDictionary *versionedIdentityDictionary = blockchainIdentities[senderId];
+                if (![versionedIdentityDictionary respondsToSelector:@selector(objectForKey:)]) continue;
+                NSNumber *version = [versionedIdentityDictionary objectForKey:@(DSPlatformStoredMessage_Version)];
+                NSDictionary *identityDictionary = [versionedIdentityDictionary objectForKey:@(DSPlatformStoredMessage_Item)];
+                if (!identityDictionary.count) continue;
+                DSBlockchainIdentity *senderBlockchainIdentity = senderBlockchainIdentities[senderId];
+                [senderBlockchainIdentity applyIdentityDictionary:identityDictionary version:[version intValue] save:!senderBlockchainIdentity.isTransient inContext:context];
+                senderBlockchainIdentity.registrationStatus = DSBlockchainIdentityRegistrationStatus_Registered;
+                [senderBlockchainIdentity saveInContext:context];
             }
-        });
+        }];
+        commitRequests();
+    }
+                                        failure:^(NSError *_Nonnull error) {
+        if (error.code == 12) { //UNIMPLEMENTED, this would mean that we are connecting to an old node
+            [self.DAPIClient removeDAPINodeByAddress:self.DAPINetworkService.ipAddress];
+        }
+        [errors addObject:error];
+        commitRequests();
     }];
 }
 
+/// Creates the friend requests for contact requests whose sender keys are known, decrypting the extended public keys in parallel.
+/// Everything is saved with a single context save and the bloom filter is refreshed once at the end.
+/// @return The errors for contact requests that could not be processed.
+- (NSArray<NSError *> *)commitIncomingRemoteRequests:(NSArray<DSContactRequest *> *)remoteRequests
+                                        localRequests:(NSArray<DSContactRequest *> *)localRequests
+                                 fromSenderIdentities:(NSDictionary<NSData *, DSBlockchainIdentity *> *)senderBlockchainIdentities
+                                            inContext:(NSManagedObjectContext *)context {
+    NSMutableArray<NSError *> *errors = [NSMutableArray array];
+    NSMutableArray<DSContactRequest *> *decryptableRequests = [NSMutableArray arrayWithCapacity:remoteRequests.count];
+    OpaqueKey **senderKeys = calloc(MAX(remoteRequests.count, 1), sizeof(OpaqueKey *));
+    OpaqueKey **secretKeys = calloc(MAX(remoteRequests.count, 1), sizeof(OpaqueKey *));
+    //our secret key only depends on the key index and type, don't read it from the keychain for every request
+    NSMutableDictionary<NSString *, NSValue *> *secretKeysByIndex = [NSMutableDictionary dictionary];
+    for (DSContactRequest *contactRequest in remoteRequests) {
+        DSBlockchainIdentity *senderBlockchainIdentity = senderBlockchainIdentities[uint256_data(contactRequest.senderBlockchainIdentityUniqueId)];
+        OpaqueKey *senderKey = [senderBlockchainIdentity keyAtIndex:contactRequest.senderKeyIndex];
+        if (!senderKey) {
+            [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Could not retrieve the key of the contact request sender"]];
+            continue;
+        }
+        NSString *secretKeyIdentifier = [NSString stringWithFormat:@"%u-%u", contactRequest.recipientKeyIndex, (uint32_t)senderKey->tag];
+        NSValue *secretKeyValue = secretKeysByIndex[secretKeyIdentifier];
+        if (!secretKeyValue) {
+            OpaqueKey *secretKey = [self privateKeyAtIndex:contactRequest.recipientKeyIndex ofType:(int16_t)senderKey->tag];
+            if (!secretKey) {
+                [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Could not retrieve our key for contact request decryption"]];
+                continue;
+            }
+            secretKeyValue = [NSValue valueWithPointer:secretKey];
+            secretKeysByIndex[secretKeyIdentifier] = secretKeyValue;
+        }
+        senderKeys[decryptableRequests.count] = senderKey;
+        secretKeys[decryptableRequests.count] = secretKeyValue.pointerValue;
+        [decryptableRequests addObject:contactRequest];
+    }
+    
+    NSUInteger decryptableCount = decryptableRequests.count;
+    OpaqueKey **extendedPublicKeys = calloc(MAX(decryptableCount, 1), sizeof(OpaqueKey *));
+    dispatch_apply(decryptableCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        NSData *extendedPublicKeyData = [decryptableRequests[i] decryptedPublicKeyDataWithKey:senderKeys[i] usingSecretKey:secretKeys[i]];
+        extendedPublicKeys[i] = extendedPublicKeyData ? [DSKeyManager keyWithExtendedPublicKeyData:extendedPublicKeyData ofType:KeyKind_ECDSA] : NULL;
+    });
+    for (NSValue *secretKeyValue in [secretKeysByIndex allValues]) {
+        processor_destroy_opaque_key(secretKeyValue.pointerValue);
+    }
+    free(senderKeys);
+    free(secretKeys);
+    
+    __block BOOL addedFriendRequests = NO;
+    [context performBlockAndWait:^{
+        for (NSUInteger i = 0; i < decryptableCount; i++) {
+            DSContactRequest *contactRequest = decryptableRequests[i];
+            if (!extendedPublicKeys[i]) {
+                [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Contact request extended public key is incorrectly encrypted."]];
+                continue;
+            }
+            DSBlockchainIdentity *senderBlockchainIdentity = senderBlockchainIdentities[uint256_data(contactRequest.senderBlockchainIdentityUniqueId)];
+            DSDashpayUserEntity *senderDashpayUserEntity = [senderBlockchainIdentity blockchainIdentityEntityInContext:context].matchingDashpayUser;
+            NSAssert(senderDashpayUserEntity, @"The sender should exist");
+            [self addIncomingRequestFromContact:senderDashpayUserEntity
+                           forExtendedPublicKey:extendedPublicKeys[i]
+                                    atTimestamp:contactRequest.createdAt
+                                           save:NO];
+            addedFriendRequests = YES;
+        }
+        
+        DSDashpayUserEntity *matchingDashpayUserInContext = [self matchingDashpayUserInContext:context];
+        for (DSContactRequest *contactRequest in localRequests) {
+            //we should store the extended public key for the destination
+            DSBlockchainIdentity *sourceBlockchainIdentity = [self.chain blockchainIdentityForUniqueId:contactRequest.senderBlockchainIdentityUniqueId];
+            DSAccount *account = [sourceBlockchainIdentity.wallet accountWithNumber:0];
+            if ([DSFriendRequestEntity existingFriendRequestEntityWithSourceIdentifier:sourceBlockchainIdentity.uniqueID destinationIdentifier:self.uniqueID onAccountIndex:account.accountNumber inContext:context]) continue;
+            DSPotentialOneWayFriendship *potentialFriendship = [[DSPotentialOneWayFriendship alloc] initWithDestinationBlockchainIdentity:self destinationKeyIndex:contactRequest.recipientKeyIndex sourceBlockchainIdentity:sourceBlockchainIdentity sourceKeyIndex:contactRequest.senderKeyIndex account:account];
+            [potentialFriendship createDerivationPathAndSaveExtendedPublicKeyWithCompletion:^(BOOL success, DSIncomingFundsDerivationPath *_Nonnull incomingFundsDerivationPath) {
+                if (!success) {
+                    [errors addObject:[NSError errorWithCode:500 localizedDescriptionKey:@"Could not create friendship derivation path"]];
+                    return;
+                }
+                DSFriendRequestEntity *friendRequest = [potentialFriendship outgoingFriendRequestForDashpayUserEntity:matchingDashpayUserInContext atTimestamp:contactRequest.createdAt];
+                [potentialFriendship storeExtendedPublicKeyAssociatedWithFriendRequest:friendRequest];
+                [matchingDashpayUserInContext addIncomingRequestsObject:friendRequest];
+                
+                if ([[friendRequest.sourceContact.incomingRequests filteredSetUsingPredicate:[NSPredicate predicateWithFormat:@"sourceContact == %@", matchingDashpayUserInContext]] count]) {
+                    [matchingDashpayUserInContext addFriendsObject:friendRequest.sourceContact];
+                }
+                
+                [account addIncomingDerivationPath:incomingFundsDerivationPath
+                           forFriendshipIdentifier:friendRequest.friendshipIdentifier
+                                         inContext:context];
+                addedFriendRequests = YES;
+            }];
+        }
+        if (addedFriendRequests) {
+            [context ds_save];
+        }
+    }];
+    free(extendedPublicKeys);
+    
+    if (addedFriendRequests) {
+        [self.chain.chainManager.transactionManager updateTransactionsBloomFilter];
+    }
+    return errors;
+}
+
 - (void)addFriendship:(DSPotentialOneWayFriendship *)friendship inContext:(NSManagedObjectContext *)context completion:(void (^)(BOOL success, NSError *error))completion {
     //DSFriendRequestEntity * friendRequestEntity = [friendship outgoingFriendRequestForDashpayUserEntity:friendship.destinationBlockchainIdentity.matchingDashpayUser];
     DSFriendRequestEntity *friendRequestEntity = [DSFriendRequestEntity managedObjectInBlockedContext:context];
@@ -4311,6 +4393,13 @@ typedef NS_ENUM(NSUInteger, DSBlockchainIdentityKeyDictionary)
 - (void)addIncomingRequestFromContact:(DSDashpayUserEntity *)dashpayUserEntity
                  forExtendedPublicKey:(OpaqueKey *)extendedPublicKey
                           atTimestamp:(NSTimeInterval)timestamp {
+    [self addIncomingRequestFromContact:dashpayUserEntity forExtendedPublicKey:extendedPublicKey atTimestamp:timestamp save:YES];
+}
+
+- (void)addIncomingRequestFromContact:(DSDashpayUserEntity *)dashpayUserEntity
+                 forExtendedPublicKey:(OpaqueKey *)extendedPublicKey
+                          atTimestamp:(NSTimeInterval)timestamp
+                                 save:(BOOL)save {
     NSManagedObjectContext *context = dashpayUserEntity.managedObjectContext;
     DSFriendRequestEntity *friendRequestEntity = [DSFriendRequestEntity managedObjectInBlockedContext:context];
     friendRequestEntity.sourceContact = dashpayUserEntity;
@@ -4353,8 +4442,10 @@ typedef NS_ENUM(NSUInteger, DSBlockchainIdentityKeyDictionary)
         [matchingDashpayUser addFriendsObject:friendRequestEntity.sourceContact];
     }
     
-    [context ds_save];
-    [self.chain.chainManager.transactionManager updateTransactionsBloomFilter];
+    if (save) {
+        [context ds_save];
+        [self.chain.chainManager.transactionManager updateTransactionsBloomFilter];
+    }
 }
 
 // MARK: - Persistence
@@ -18,6 +18,7 @@
 #import "DSBackgroundManager.h"
 #import "DSChainManager.h"
 #import "DSPeerManager+Protected.h"
+#import "DSTransactionManager+Protected.h"
 
 @interface DSBackgroundManager ()
 
@@ -25,7 +26,7 @@
 
 #if TARGET_OS_IOS
 
-@property (nonatomic, strong) id backgroundObserver;
+@property (nonatomic, strong) id backgroundObserver, terminateObserver;
 @property (nonatomic, assign) NSUInteger terminalHeadersSaveTaskId, blockLocatorsSaveTaskId;
 
 #endif
@@ -40,8 +41,13 @@
     self.terminalHeadersSaveTaskId = UIBackgroundTaskInvalid;
     self.backgroundObserver =
         [[NSNotificationCenter defaultCenter] addObserverForName:UIApplicationDidEnterBackgroundNotification object:nil queue:nil usingBlock:^(NSNotification *note) {
+            [chain.chainManager.transactionManager.seenTransactionStore synchronize];
             [chain.chainManager.peerManager startBackgroundMode:self.terminalHeadersSaveTaskId == UIBackgroundTaskInvalid];
         }];
+    self.terminateObserver =
+        [[NSNotificationCenter defaultCenter] addObserverForName:UIApplicationWillTerminateNotification object:nil queue:nil usingBlock:^(NSNotification *note) {
+            [chain.chainManager.transactionManager.seenTransactionStore synchronize];
+        }];
 #endif
 
     return self;
@@ -52,6 +58,8 @@
     [NSObject cancelPreviousPerformRequestsWithTarget:self];
     if (self.backgroundObserver) 
         [[NSNotificationCenter defaultCenter] removeObserver:self.backgroundObserver];
+    if (self.terminateObserver)
+        [[NSNotificationCenter defaultCenter] removeObserver:self.terminateObserver];
 #endif
 }
 
@@ -20,34 +20,38 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class DSBlockMiner;
+
 @interface DSChainManager (Mining)
 
 // MARK: - Mining
 
-- (void)mineEmptyBlocks:(uint32_t)blockCount 
-       toPaymentAddress:(NSString *)paymentAddress
-            withTimeout:(NSTimeInterval)timeout
-             completion:(MultipleBlockMiningCompletionBlock)completion;
-
-- (void)mineEmptyBlocks:(uint32_t)blockCount 
-       toPaymentAddress:(NSString *)paymentAddress
-             afterBlock:(DSBlock *)block
-         previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
-            withTimeout:(NSTimeInterval)timeout
-             completion:(MultipleBlockMiningCompletionBlock)completion;
+/*! @brief Every call mines with a miner of its own and returns it. Cancelling it stops the block being mined, a multiple block run then completes with the blocks mined so far. Its hashRate is that of the last block mined or attempted. */
+- (DSBlockMiner *)mineEmptyBlocks:(uint32_t)blockCount
+                 toPaymentAddress:(NSString *)paymentAddress
+                      withTimeout:(NSTimeInterval)timeout
+                       completion:(MultipleBlockMiningCompletionBlock)completion;
 
-- (void)mineBlockToPaymentAddress:(NSString *)paymentAddress 
-                 withTransactions:(NSArray<DSTransaction *> *_Nullable)transactions
+- (DSBlockMiner *)mineEmptyBlocks:(uint32_t)blockCount
+                 toPaymentAddress:(NSString *)paymentAddress
+                       afterBlock:(DSBlock *)block
+                   previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
                       withTimeout:(NSTimeInterval)timeout
-                       completion:(BlockMiningCompletionBlock)completion;
-
-- (void)mineBlockAfterBlock:(DSBlock *)block 
-           toPaymentAddress:(NSString *)paymentAddress
-           withTransactions:(NSArray<DSTransaction *> *_Nullable)transactions
-             previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
-                nonceOffset:(uint32_t)nonceOffset
-                withTimeout:(NSTimeInterval)timeout
-                 completion:(BlockMiningCompletionBlock)completion;
+                       completion:(MultipleBlockMiningCompletionBlock)completion;
+
+/*! @brief Mines on the calling thread, the returned miner has finished by then. */
+- (DSBlockMiner *)mineBlockToPaymentAddress:(NSString *)paymentAddress
+                           withTransactions:(NSArray<DSTransaction *> *_Nullable)transactions
+                                withTimeout:(NSTimeInterval)timeout
+                                 completion:(BlockMiningCompletionBlock)completion;
+
+- (DSBlockMiner *)mineBlockAfterBlock:(DSBlock *)block
+                     toPaymentAddress:(NSString *)paymentAddress
+                     withTransactions:(NSArray<DSTransaction *> *_Nullable)transactions
+                       previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
+                          nonceOffset:(uint32_t)nonceOffset
+                          withTimeout:(NSTimeInterval)timeout
+                           completion:(BlockMiningCompletionBlock)completion;
 
 @end
 
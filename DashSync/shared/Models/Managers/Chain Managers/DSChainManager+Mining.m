@@ -15,90 +15,115 @@
 //  limitations under the License.
 //
 
+#import "DSBlockMiner.h"
 #import "DSChain+Protected.h"
 #import "DSChainManager+Protected.h"
 #import "DSChainManager+Mining.h"
 #import "DSFullBlock.h"
+#import "DSLogger.h"
 #import "NSError+Dash.h"
 
 @implementation DSChainManager (Mining)
 
-- (void)mineEmptyBlocks:(uint32_t)blockCount
-       toPaymentAddress:(NSString *)paymentAddress
-            withTimeout:(NSTimeInterval)timeout
-             completion:(MultipleBlockMiningCompletionBlock)completion {
-    [self mineEmptyBlocks:blockCount toPaymentAddress:paymentAddress afterBlock:self.chain.lastTerminalBlock previousBlocks:self.chain.terminalBlocks withTimeout:timeout completion:completion];
+- (DSBlockMiner *)mineEmptyBlocks:(uint32_t)blockCount
+                 toPaymentAddress:(NSString *)paymentAddress
+                      withTimeout:(NSTimeInterval)timeout
+                       completion:(MultipleBlockMiningCompletionBlock)completion {
+    return [self mineEmptyBlocks:blockCount toPaymentAddress:paymentAddress afterBlock:self.chain.lastTerminalBlock previousBlocks:self.chain.terminalBlocks withTimeout:timeout completion:completion];
 }
 
-- (void)mineEmptyBlocks:(uint32_t)blockCount 
-       toPaymentAddress:(NSString *)paymentAddress
-             afterBlock:(DSBlock *)previousBlock
-         previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
-            withTimeout:(NSTimeInterval)timeout
-             completion:(MultipleBlockMiningCompletionBlock)completion {
+- (DSBlockMiner *)mineEmptyBlocks:(uint32_t)blockCount
+                 toPaymentAddress:(NSString *)paymentAddress
+                       afterBlock:(DSBlock *)previousBlock
+                   previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
+                      withTimeout:(NSTimeInterval)timeout
+                       completion:(MultipleBlockMiningCompletionBlock)completion {
+    DSBlockMiner *miner = [[DSBlockMiner alloc] init];
     dispatch_async(self.miningQueue, ^{
         NSTimeInterval start = [[NSDate date] timeIntervalSince1970];
-        NSTimeInterval end = [[[NSDate alloc] initWithTimeIntervalSinceNow:timeout] timeIntervalSince1970];
+        NSTimeInterval end = start + timeout;
         NSMutableArray *blocksArray = [NSMutableArray array];
         NSMutableArray *attemptsArray = [NSMutableArray array];
-        __block uint32_t blocksRemaining = blockCount;
-        __block NSMutableDictionary<NSValue *, DSBlock *> *mPreviousBlocks = [previousBlocks mutableCopy];
-        __block DSBlock *currentBlock = previousBlock;
-        while ([[NSDate date] timeIntervalSince1970] < end && blocksRemaining > 0) {
-            dispatch_semaphore_t sem = dispatch_semaphore_create(0);
-            [self mineBlockAfterBlock:currentBlock
-                     toPaymentAddress:paymentAddress
-                     withTransactions:[NSArray array]
-                       previousBlocks:mPreviousBlocks
-                          nonceOffset:0
-                          withTimeout:timeout
-                           completion:^(DSFullBlock *_Nullable block, NSUInteger attempts, NSTimeInterval timeUsed, NSError *_Nullable error) {
-                               NSAssert(uint256_is_not_zero(block.blockHash), @"Block hash must not be empty");
-                               dispatch_semaphore_signal(sem);
-                               [blocksArray addObject:block];
-                               [mPreviousBlocks setObject:block forKey:uint256_obj(block.blockHash)];
-                               currentBlock = block;
-                               blocksRemaining--;
-                               [attemptsArray addObject:@(attempts)];
-                           }];
-            dispatch_semaphore_wait(sem, DISPATCH_TIME_FOREVER);
+        NSMutableDictionary<NSValue *, DSBlock *> *mPreviousBlocks = [previousBlocks mutableCopy];
+        DSBlock *currentBlock = previousBlock;
+        uint64_t totalAttempts = 0;
+        NSError *error = nil;
+        // each block builds on the previous one, the parallelism is within a block
+        while (blocksArray.count < blockCount) {
+            NSTimeInterval remaining = end - [[NSDate date] timeIntervalSince1970];
+            if (miner.isCancelled || remaining <= 0) {
+                error = [self miningErrorForMiner:miner];
+                break;
+            }
+            DSFullBlock *block = [self emptyBlockAfterBlock:currentBlock toPaymentAddress:paymentAddress previousBlocks:mPreviousBlocks];
+            uint64_t attempts = 0;
+            BOOL mined = [block mineBlockAfterBlock:currentBlock withNonceOffset:0 withTimeout:remaining usingMiner:miner rAttempts:&attempts];
+            totalAttempts += attempts;
+            if (!mined) {
+                error = [self miningErrorForMiner:miner];
+                break;
+            }
+            NSAssert(uint256_is_not_zero(block.blockHash), @"Block hash must not be empty");
+            [blocksArray addObject:block];
+            [attemptsArray addObject:@(attempts)];
+            [mPreviousBlocks setObject:block forKey:uint256_obj(block.blockHash)];
+            currentBlock = block;
         }
+        NSTimeInterval timeUsed = [[NSDate date] timeIntervalSince1970] - start;
+        DSLogInfo(@"DSChainManager", @"mined %lu blocks in %.2fs at %.0f hashes/s on %lu threads", (unsigned long)blocksArray.count, timeUsed, timeUsed > 0 ? totalAttempts / timeUsed : 0, (unsigned long)miner.threadCount);
         if (completion) {
             dispatch_async(dispatch_get_main_queue(), ^{
-                completion(blocksArray, attemptsArray, [[NSDate date] timeIntervalSince1970] - start, nil);
+                completion(blocksArray, attemptsArray, timeUsed, error);
             });
         }
     });
+    return miner;
 }
 
-- (void)mineBlockToPaymentAddress:(NSString *)paymentAddress 
-                 withTransactions:(NSArray<DSTransaction *> *)transactions
-                      withTimeout:(NSTimeInterval)timeout
-                       completion:(BlockMiningCompletionBlock)completion {
-    [self mineBlockAfterBlock:self.chain.lastTerminalBlock toPaymentAddress:paymentAddress withTransactions:transactions previousBlocks:self.chain.terminalBlocks nonceOffset:0 withTimeout:timeout completion:completion];
+- (DSBlockMiner *)mineBlockToPaymentAddress:(NSString *)paymentAddress
+                           withTransactions:(NSArray<DSTransaction *> *)transactions
+                                withTimeout:(NSTimeInterval)timeout
+                                 completion:(BlockMiningCompletionBlock)completion {
+    return [self mineBlockAfterBlock:self.chain.lastTerminalBlock toPaymentAddress:paymentAddress withTransactions:transactions previousBlocks:self.chain.terminalBlocks nonceOffset:0 withTimeout:timeout completion:completion];
 }
 
-- (void)mineBlockAfterBlock:(DSBlock *)block 
-           toPaymentAddress:(NSString *)paymentAddress
-           withTransactions:(NSArray<DSTransaction *> *)transactions
-             previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
-                nonceOffset:(uint32_t)nonceOffset 
-                withTimeout:(NSTimeInterval)timeout
-                 completion:(nonnull BlockMiningCompletionBlock)completion {
-    DSCoinbaseTransaction *coinbaseTransaction = [[DSCoinbaseTransaction alloc] initWithCoinbaseMessage:@"From iOS" paymentAddresses:@[paymentAddress] atHeight:block.height + 1 onChain:block.chain];
-    DSFullBlock *fullblock = [[DSFullBlock alloc] initWithCoinbaseTransaction:coinbaseTransaction transactions:[NSSet set] previousBlockHash:block.blockHash previousBlocks:previousBlocks timestamp:[[NSDate date] timeIntervalSince1970] height:block.height + 1 onChain:self.chain];
+- (DSBlockMiner *)mineBlockAfterBlock:(DSBlock *)block
+                     toPaymentAddress:(NSString *)paymentAddress
+                     withTransactions:(NSArray<DSTransaction *> *)transactions
+                       previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks
+                          nonceOffset:(uint32_t)nonceOffset
+                          withTimeout:(NSTimeInterval)timeout
+                           completion:(nonnull BlockMiningCompletionBlock)completion {
+    DSFullBlock *fullblock = [self emptyBlockAfterBlock:block toPaymentAddress:paymentAddress previousBlocks:previousBlocks];
+    DSBlockMiner *miner = [[DSBlockMiner alloc] init];
     uint64_t attempts = 0;
     NSDate *startTime = [NSDate date];
-    if ([fullblock mineBlockAfterBlock:block withNonceOffset:nonceOffset withTimeout:timeout rAttempts:&attempts]) {
+    if ([fullblock mineBlockAfterBlock:block withNonceOffset:nonceOffset withTimeout:timeout usingMiner:miner rAttempts:&attempts]) {
         if (completion) {
             completion(fullblock, attempts, -[startTime timeIntervalSinceNow], nil);
         }
     } else {
         if (completion) {
-            NSError *error = [NSError errorWithCode:500 localizedDescriptionKey:@"A block could not be mined in the selected time interval."];
+            NSError *error = [self miningErrorForMiner:miner];
             completion(nil, attempts, -[startTime timeIntervalSinceNow], error);
         }
     }
+    return miner;
+}
+
+- (DSFullBlock *)emptyBlockAfterBlock:(DSBlock *)block toPaymentAddress:(NSString *)paymentAddress previousBlocks:(NSDictionary<NSValue *, DSBlock *> *)previousBlocks {
+    DSCoinbaseTransaction *coinbaseTransaction = [[DSCoinbaseTransaction alloc] initWithCoinbaseMessage:@"From iOS" paymentAddresses:@[paymentAddress] atHeight:block.height + 1 onChain:block.chain];
+    return [[DSFullBlock alloc] initWithCoinbaseTransaction:coinbaseTransaction transactions:[NSSet set] previousBlockHash:block.blockHash previousBlocks:previousBlocks timestamp:MAX((uint32_t)[[NSDate date] timeIntervalSince1970], block.timestamp) height:block.height + 1 onChain:self.chain];
+}
+
+- (NSError *)miningErrorForMiner:(DSBlockMiner *)miner {
+    if (miner.isCancelled) {
+        return [NSError errorWithCode:500 localizedDescriptionKey:@"Mining was cancelled."];
+    }
+    if (miner.isFailed) {
+        return [NSError errorWithCode:500 localizedDescriptionKey:@"A block header could not be hashed."];
+    }
+    return [NSError errorWithCode:500 localizedDescriptionKey:@"A block could not be mined in the selected time interval."];
 }
 
 @end
@@ -8,6 +8,8 @@
 #import "DSChain.h"
 #import "DSChainManager.h"
 
+@class DSMerkleBlockBackfill;
+
 NS_ASSUME_NONNULL_BEGIN
 
 typedef NS_ENUM(uint16_t, DSChainNotificationType) {
@@ -21,6 +23,10 @@ typedef NS_ENUM(uint16_t, DSChainNotificationType) {
 @property (nonatomic, assign) NSTimeInterval lastChainRelayTime;
 @property (nonatomic, assign) DSChainSyncPhase syncPhase;
 @property (nonatomic, strong) dispatch_queue_t miningQueue;
+/*! @brief Only read and changed on the chain's networking queue. */
+@property (nonatomic, readonly, nullable) DSMerkleBlockBackfill *merkleBlockBackfill;
+/*! @brief Set by syncBlocksRescanSkippingZonesWithoutWalletActivity until the sync finishes, merkleblocks of every zone are requested otherwise. */
+@property (nonatomic, assign) BOOL skipsZonesWithoutWalletActivity;
 
 - (void)resetChainSyncStartHeight;
 - (void)restartChainSyncStartHeight;
@@ -33,6 +39,11 @@ typedef NS_ENUM(uint16_t, DSChainNotificationType) {
 
 - (void)wipeMasternodeInfo;
 
+/*! @brief Also called every request timeout while backfilling, must be called on the chain's networking queue. */
+- (void)requestMerkleBlockBackfillRanges;
+- (void)merkleBlockBackfillPeerDisconnected:(DSPeer *)peer;
+- (void)restartMerkleBlockBackfill;
+
 - (void)notify:(NSNotificationName)name userInfo:(NSDictionary *_Nullable)userInfo;
 - (void)notifySyncStateChanged;
 
@@ -20,8 +20,18 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class DSBlockZoneBitmap;
+
 @interface DSChainManager (Transactions)
 
+/*! @brief Loads the bundled transaction density of the chain, per 500 block zone. */
+- (void)loadHeightTransactionZones;
+/*! @brief Zones any wallet of the chain had a transaction in, synced over the range all of them were synced over. */
+- (DSBlockZoneBitmap *)walletBlockZones;
+/*! @brief Transactions the chain holds between the heights, estimated from the bundled density data, 0 without it. */
+- (uint64_t)estimatedTransactionCountBetweenHeight:(uint32_t)startHeight andEndHeight:(uint32_t)endHeight;
+
+/*! @brief Always YES unless skipsZonesWithoutWalletActivity was set by the rescan. */
 - (BOOL)shouldRequestMerkleBlocksForZoneBetweenHeight:(uint32_t)blockHeight andEndHeight:(uint32_t)endBlockHeight;
 - (BOOL)shouldRequestMerkleBlocksForZoneAfterHeight:(uint32_t)blockHeight;
 
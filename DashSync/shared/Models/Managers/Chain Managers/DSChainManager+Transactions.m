@@ -15,6 +15,8 @@
 //  limitations under the License.
 //
 
+#import "DSBlockZoneBitmap.h"
+#import "DSChain.h"
 #import "DSChainManager+Protected.h"
 #import "DSChainManager+Transactions.h"
 #import "DSWallet+Protected.h"
@@ -25,8 +27,6 @@ NSString const *maxTransactionsInfoDataKey = @"maxTransactionsInfoDataKey";
 NSString const *heightTransactionZonesKey = @"heightTransactionZonesKey";
 NSString const *maxTransactionsInfoDataFirstHeightKey = @"maxTransactionsInfoDataFirstHeightKey";
 NSString const *maxTransactionsInfoDataLastHeightKey = @"maxTransactionsInfoDataLastHeightKey";
-NSString const *chainSynchronizationFingerprintKey = @"chainSynchronizationFingerprintKey";
-NSString const *chainSynchronizationBlockZonesKey = @"chainSynchronizationBlockZonesKey";
 
 
 @interface DSChainManager ()
@@ -35,8 +35,6 @@ NSString const *chainSynchronizationBlockZonesKey = @"chainSynchronizationBlockZ
 @property (nonatomic, strong) RHIntervalTree *heightTransactionZones;
 @property (nonatomic, assign) uint32_t maxTransactionsInfoDataFirstHeight;
 @property (nonatomic, assign) uint32_t maxTransactionsInfoDataLastHeight;
-@property (nonatomic, strong) NSData *chainSynchronizationFingerprint;
-@property (nonatomic, strong) NSOrderedSet *chainSynchronizationBlockZones;
 
 @end
 
@@ -57,19 +55,6 @@ NSString const *chainSynchronizationBlockZonesKey = @"chainSynchronizationBlockZ
 }
 
 
-- (void)setChainSynchronizationBlockZones:(NSOrderedSet *)chainSynchronizationBlockZones {
-    objc_setAssociatedObject(self, &chainSynchronizationBlockZonesKey, chainSynchronizationBlockZones, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
-}
-- (NSOrderedSet *)chainSynchronizationBlockZones {
-    NSOrderedSet *obj = objc_getAssociatedObject(self, &chainSynchronizationBlockZonesKey);
-    if (!obj) {
-        obj = [DSWallet blockZonesFromChainSynchronizationFingerprint:self.chainSynchronizationFingerprint rVersion:0 rChainHeight:0];
-        [self setChainSynchronizationBlockZones:obj];
-    }
-    return obj;
-
-}
-
 - (void)loadHeightTransactionZones {
     NSString *bundlePath = [[NSBundle bundleForClass:self.class] pathForResource:@"DashSync" ofType:@"bundle"];
     NSBundle *bundle = [NSBundle bundleWithPath:bundlePath];
@@ -105,6 +90,11 @@ NSString const *chainSynchronizationBlockZonesKey = @"chainSynchronizationBlockZ
     return aggregate / (endHeight - startHeight);
 }
 
+- (uint64_t)estimatedTransactionCountBetweenHeight:(uint32_t)startHeight andEndHeight:(uint32_t)endHeight {
+    if (endHeight <= startHeight) return 0;
+    return (uint64_t)[self averageTransactionsInZoneForStartHeight:startHeight endHeight:endHeight] * (endHeight - startHeight);
+}
+
 - (uint32_t)firstHeightOutOfAverageRangeWithStart500RangeHeight:(uint32_t)height rAverage:(float *)rAverage {
     return [self firstHeightOutOfAverageRangeWithStart500RangeHeight:height startingVarianceLevel:1 endingVarianceLevel:0.2 convergencePolynomial:0.33 rAverage:rAverage];
 }
@@ -182,27 +172,31 @@ NSString const *chainSynchronizationBlockZonesKey = @"chainSynchronizationBlockZ
     return max;
 }
 
-- (BOOL)shouldRequestMerkleBlocksForZoneBetweenHeight:(uint32_t)blockHeight andEndHeight:(uint32_t)endBlockHeight {
-    uint16_t blockZone = blockHeight / 500;
-    uint16_t endBlockZone = endBlockHeight / 500 + (endBlockHeight % 500 ? 1 : 0);
-    if (self.chainSynchronizationFingerprint) {
-        while (blockZone < endBlockZone) {
-            if ([[self chainSynchronizationBlockZones] containsObject:@(blockZone)]) return TRUE;
-        }
-        return NO;
-    } else {
-        return YES;
+- (DSBlockZoneBitmap *)walletBlockZones {
+    NSArray<DSWallet *> *wallets = self.chain.wallets;
+    DSBlockZoneBitmap *blockZones = [[DSBlockZoneBitmap alloc] init];
+    if (!wallets.count) return blockZones;
+    blockZones.syncedStartHeight = 0;
+    blockZones.syncedHeight = UINT32_MAX;
+    for (DSWallet *wallet in wallets) {
+        DSBlockZoneBitmap *walletBlockZones = wallet.blockZones;
+        [blockZones addZonesFromBitmap:walletBlockZones];
+        blockZones.syncedStartHeight = MAX(blockZones.syncedStartHeight, walletBlockZones.syncedStartHeight);
+        blockZones.syncedHeight = MIN(blockZones.syncedHeight, walletBlockZones.syncedHeight);
     }
+    return blockZones;
+}
+
+- (BOOL)shouldRequestMerkleBlocksForZoneBetweenHeight:(uint32_t)blockHeight andEndHeight:(uint32_t)endBlockHeight {
+    if (!self.skipsZonesWithoutWalletActivity) return YES;
+    DSBlockZoneBitmap *blockZones = [self walletBlockZones];
+    // outside of the range every wallet was synced over any zone could hold one of their transactions
+    return ![blockZones isSyncedBetweenHeight:blockHeight andEndHeight:endBlockHeight] || [blockZones containsZoneBetweenHeight:blockHeight andEndHeight:endBlockHeight];
 }
 
 - (BOOL)shouldRequestMerkleBlocksForZoneAfterHeight:(uint32_t)blockHeight {
-    uint16_t blockZone = blockHeight / 500;
-    uint16_t leftOver = blockHeight % 500;
-    if (self.chainSynchronizationFingerprint) {
-        return [[self chainSynchronizationBlockZones] containsObject:@(blockZone)] || [[self chainSynchronizationBlockZones] containsObject:@(blockZone + 1)] || [[self chainSynchronizationBlockZones] containsObject:@(blockZone + 2)] || [[self chainSynchronizationBlockZones] containsObject:@(blockZone + 3)] || (!leftOver && [self shouldRequestMerkleBlocksForZoneAfterHeight:(blockZone + 1) * 500]);
-    } else {
-        return YES;
-    }
+    // getblocks does not stop at zone boundaries, the zones a little ahead are looked at too
+    return [self shouldRequestMerkleBlocksForZoneBetweenHeight:blockHeight andEndHeight:blockHeight + 4 * BLOCK_ZONE_LENGTH];
 }
 
 @end
@@ -83,6 +83,8 @@ typedef void (^MultipleBlockMiningCompletionBlock)(NSArray<DSFullBlock *> *block
 - (void)startSync;
 - (void)stopSync;
 - (void)syncBlocksRescan;
+/*! @brief Rescans only requesting the merkleblocks of zones the wallets had transactions in, within the range their current addresses were last synced over. Transactions a peer omitted in the skipped zones are not recovered, syncBlocksRescan requests every zone. */
+- (void)syncBlocksRescanSkippingZonesWithoutWalletActivity;
 - (void)masternodeListAndBlocksRescan;
 - (void)masternodeListRescan;
 
@@ -23,6 +23,7 @@
 //  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //  THE SOFTWARE.
 
+#import "DSBlockZoneBitmap.h"
 #import "DSBloomFilter.h"
 #import "DSChain+Protected.h"
 #import "DSChainSyncSpeedCalculator.h"
@@ -40,6 +41,7 @@
 #import "DSMasternodeManager+LocalMasternode.h"
 #import "DSMasternodeManager+Protected.h"
 #import "DSMerkleBlock.h"
+#import "DSMerkleBlockBackfill.h"
 #import "DSOptionsManager.h"
 #import "DSPeerManager+Protected.h"
 #import "DSSporkManager+Protected.h"
@@ -73,6 +75,8 @@
 @property (nonatomic, strong) DSSyncState *syncState;
 @property (nonatomic, assign) NSTimeInterval lastNotifiedBlockDidChange;
 @property (nonatomic, strong) NSTimer *lastNotifiedBlockDidChangeTimer;
+@property (nonatomic, strong) DSMerkleBlockBackfill *merkleBlockBackfill;
+@property (nonatomic, strong) dispatch_source_t merkleBlockBackfillTimer;
 
 
 @end
@@ -104,7 +108,7 @@
     }
 
     //[self loadMaxTransactionInfo];
-    //[self loadHeightTransactionZones];
+    [self loadHeightTransactionZones];
 
     self.miningQueue = dispatch_queue_create([[NSString stringWithFormat:@"org.dashcore.dashsync.mining.%@", self.chain.uniqueID] UTF8String], DISPATCH_QUEUE_SERIAL);
     return self;
@@ -181,6 +185,16 @@
 // rescans blocks and transactions after earliestKeyTime, a new random download peer is also selected due to the
 // possibility that a malicious node might lie by omitting transactions that match the bloom filter
 - (void)syncBlocksRescan {
+    self.skipsZonesWithoutWalletActivity = NO;
+    [self rescanBlocks];
+}
+
+- (void)syncBlocksRescanSkippingZonesWithoutWalletActivity {
+    self.skipsZonesWithoutWalletActivity = YES;
+    [self rescanBlocks];
+}
+
+- (void)rescanBlocks {
     if (!self.peerManager.connected) {
         [self disconnectedSyncBlocksRescan];
     } else {
@@ -255,9 +269,14 @@
             [self.masternodeManager startSync];
         } else {
             self.syncState.syncPhase = DSChainSyncPhase_ChainSync;
+            for (DSWallet *wallet in self.chain.wallets) {
+                [wallet blockZonesWillSyncFromHeight:self.chain.lastSyncBlockHeight];
+            }
             BOOL startingDevnetSync = [self.chain isDevnetAny] && self.chain.lastSyncBlockHeight < 5;
             NSTimeInterval cutoffTime = self.chain.earliestWalletCreationTime - HEADER_WINDOW_BUFFER_TIME;
-            if (startingDevnetSync || (self.chain.lastSyncBlockTimestamp >= cutoffTime && [self shouldRequestMerkleBlocksForZoneAfterHeight:[self.chain lastSyncBlockHeight]])) {
+            if ([self startMerkleBlockBackfillIncludingAllZones:startingDevnetSync]) {
+                [self requestMerkleBlockBackfillRanges];
+            } else if (startingDevnetSync || (self.chain.lastSyncBlockTimestamp >= cutoffTime && [self shouldRequestMerkleBlocksForZoneAfterHeight:[self.chain lastSyncBlockHeight]])) {
                 [peer sendGetblocksMessageWithLocators:[self.chain chainSyncBlockLocatorArray] andHashStop:UINT256_ZERO];
             } else {
                 [peer sendGetheadersMessageWithLocators:[self.chain chainSyncBlockLocatorArray] andHashStop:UINT256_ZERO];
@@ -267,6 +286,102 @@
     });
 }
 
+// MARK: - Merkle Block Backfill
+
+// the backfill is only read and changed on the networking queue, where the peers call their delegates
+- (void)setMerkleBlockBackfill:(DSMerkleBlockBackfill *)merkleBlockBackfill {
+    if (self.merkleBlockBackfillTimer) {
+        dispatch_source_cancel(self.merkleBlockBackfillTimer);
+        self.merkleBlockBackfillTimer = nil;
+    }
+    _merkleBlockBackfill = merkleBlockBackfill;
+    if (!merkleBlockBackfill) return;
+    // stalled ranges are handed to the next idle peer when ranges are requested, which also happens when no block arrives anymore
+    uint64_t interval = (uint64_t)(merkleBlockBackfill.requestTimeout * NSEC_PER_SEC);
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.chain.networkingQueue);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, interval / 10);
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf requestMerkleBlockBackfillRanges];
+    });
+    dispatch_resume(timer);
+    self.merkleBlockBackfillTimer = timer;
+}
+
+// the headers up to the tip were synced first, the merkleblocks behind them are fetched from every peer at once
+- (BOOL)startMerkleBlockBackfillIncludingAllZones:(BOOL)includingAllZones {
+    self.merkleBlockBackfill = nil;
+    DSBlock *lastSyncBlock = self.chain.lastSyncBlock;
+    if (!lastSyncBlock || self.chain.lastTerminalBlockHeight < lastSyncBlock.height + MERKLE_BLOCK_BACKFILL_RANGE_LENGTH) return NO; // close to the tip getblocks is as fast
+    NSDictionary<NSValue *, DSBlock *> *terminalBlocks = self.chain.terminalBlocks;
+    NSMutableArray<DSBlock *> *headers = [NSMutableArray array];
+    DSBlock *block = self.chain.lastTerminalBlock;
+    while (block && block.height > lastSyncBlock.height) {
+        [headers addObject:block];
+        block = terminalBlocks[block.prevBlockValue];
+    }
+    // only recent terminal blocks are kept in memory, older gaps are synced with getblocks
+    if (!block || !uint256_eq(block.blockHash, lastSyncBlock.blockHash)) return NO;
+    NSTimeInterval cutoffTime = self.chain.earliestWalletCreationTime - HEADER_WINDOW_BUFFER_TIME;
+    __block NSUInteger skippedRangeCount = 0;
+    __block uint64_t skippedTransactionCount = 0;
+    DSMerkleBlockBackfill *backfill = [[DSMerkleBlockBackfill alloc] initWithHeaders:headers.reverseObjectEnumerator.allObjects
+        zoneFilter:^BOOL(DSBlock *firstHeader, DSBlock *lastHeader) {
+            if (includingAllZones) return YES;
+            if (lastHeader.timestamp < cutoffTime) return NO;
+            if ([self shouldRequestMerkleBlocksForZoneBetweenHeight:firstHeader.height andEndHeight:lastHeader.height + 1]) return YES;
+            // the wallets had nothing in the zone the last time it was synced
+            skippedRangeCount++;
+            skippedTransactionCount += [self estimatedTransactionCountBetweenHeight:firstHeader.height andEndHeight:lastHeader.height + 1];
+            return NO;
+        }
+        usingBlock:^BOOL(DSBlock *header, NSArray<DSTransaction *> *transactions, BOOL isHeaderOnly, DSPeer *peer) {
+            // in the order a peer hands them over, the matched transactions first
+            for (DSTransaction *transaction in transactions) {
+                [self.transactionManager registerRelayedTransaction:transaction inBlock:header fromPeer:peer];
+            }
+            return [self.chain addBlock:header receivedAsHeader:isHeaderOnly fromPeer:peer ? peer : self.peerManager.downloadPeer];
+        }];
+    DSLogInfo(@"DSChainManager", @"backfilling merkleblocks from height %u to %u, %lu of %lu ranges need them", backfill.startHeight, backfill.endHeight, (unsigned long)backfill.merkleBlockRangeCount, (unsigned long)backfill.rangeCount);
+    if (skippedRangeCount) DSLogInfo(@"DSChainManager", @"skipping %lu ranges without wallet activity, about %llu transactions", (unsigned long)skippedRangeCount, skippedTransactionCount);
+    self.merkleBlockBackfill = backfill;
+    // until now only the download peer had a filter
+    for (DSPeer *peer in self.peerManager.connectedPeers) {
+        if (peer == self.peerManager.downloadPeer || peer.status != DSPeerStatus_Connected) continue;
+        [peer sendFilterloadMessage:[self.transactionManager transactionsBloomFilterForPeer:peer].data];
+    }
+    [backfill start];
+    return YES;
+}
+
+- (void)requestMerkleBlockBackfillRanges {
+    DSMerkleBlockBackfill *backfill = self.merkleBlockBackfill;
+    if (!backfill) return;
+    if (backfill.complete || backfill.failed) {
+        self.merkleBlockBackfill = nil;
+        // the tip moved on meanwhile, or a block did not fit, the download peer goes on from the sync tip
+        if (self.chain.lastSyncBlockHeight < self.chain.estimatedBlockHeight) {
+            [self.peerManager.downloadPeer sendGetblocksMessageWithLocators:[self.chain chainSyncBlockLocatorArray] andHashStop:UINT256_ZERO];
+        }
+        return;
+    }
+    for (DSPeer *peer in self.peerManager.connectedPeers) {
+        if (peer.status != DSPeerStatus_Connected || peer.needsFilterUpdate) continue;
+        NSArray<NSValue *> *blockHashes = [backfill nextBlockHashesForPeer:peer];
+        if (!blockHashes.count) continue;
+        [peer sendGetdataMessageWithTxHashes:nil instantSendLockHashes:nil instantSendLockDHashes:nil blockHashes:blockHashes chainLockHashes:nil];
+    }
+}
+
+- (void)merkleBlockBackfillPeerDisconnected:(DSPeer *)peer {
+    [self.merkleBlockBackfill peerDisconnected:peer];
+    [self requestMerkleBlockBackfillRanges];
+}
+
+- (void)restartMerkleBlockBackfill {
+    [self.merkleBlockBackfill restart];
+}
+
 - (void)chainFinishedSyncingInitialHeaders:(DSChain *)chain fromPeer:(DSPeer *)peer onMainChain:(BOOL)onMainChain {
     if (onMainChain && peer && (peer == self.peerManager.downloadPeer)) [self relayedNewItem];
 
@@ -280,10 +395,19 @@
 - (void)chainFinishedSyncingTransactionsAndBlocks:(DSChain *)chain fromPeer:(DSPeer *)peer onMainChain:(BOOL)onMainChain {
     if (onMainChain && peer && (peer == self.peerManager.downloadPeer)) [self relayedNewItem];
 
+    dispatch_async(self.chain.networkingQueue, ^{
+        self.merkleBlockBackfill = nil;
+    });
+    self.skipsZonesWithoutWalletActivity = NO;
     self.syncState.chainSyncStartHeight = 0;
     self.syncState.syncPhase = DSChainSyncPhase_Synced;
     DSLogInfo(@"DSChainManager", @"chain sync completed at height %u", chain.lastSyncBlockHeight);
 
+    // a rescan skipping zones only needs the merkleblocks of zones the wallets had transactions in
+    for (DSWallet *wallet in chain.wallets) {
+        [wallet blockZonesSyncedToHeight:chain.lastSyncBlockHeight];
+    }
+
     // Log transaction list after sync completion
     for (DSWallet *wallet in chain.wallets) {
         NSArray *transactions = wallet.allTransactions;
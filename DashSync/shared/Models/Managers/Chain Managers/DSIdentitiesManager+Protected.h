@@ -27,10 +27,14 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class DSDAPIPlatformNetworkService;
+
 @interface DSIdentitiesManager (Protected)
 
 - (void)clearExternalBlockchainIdentities;
 
+- (void)fetchDPNSDocumentsForUserIds:(NSArray<NSData *> *)userIds startAfter:(NSData *_Nullable)startAfter accumulatedDocuments:(NSMutableArray<NSDictionary *> *)accumulatedDocuments withService:(DSDAPIPlatformNetworkService *)service success:(void (^)(NSArray<NSDictionary *> *documents))success failure:(void (^)(NSError *error))failure;
+
 @property (nonatomic, readonly) dispatch_queue_t identityQueue;
 
 @end
@@ -15,6 +15,7 @@
 //  limitations under the License.
 //
 
+#import "DSBlockchainIdentity.h"
 #import "DSChain.h"
 #import <Foundation/Foundation.h>
 
@@ -77,6 +78,9 @@ typedef void (^DashpayUserInfosCompletionBlock)(BOOL success, NSDictionary<NSDat
 
 - (id<DSDAPINetworkServiceRequest>)fetchProfilesForBlockchainIdentities:(NSArray<DSBlockchainIdentity *> *)blockchainIdentities withCompletion:(DashpayUserInfosCompletionBlock)completion onCompletionQueue:(dispatch_queue_t)completionQueue;
 
+/*! @brief Fetches the DPNS usernames and/or Dashpay profiles (depending on the query step) of many identities with batched in queries and applies them. */
+- (void)fetchUsernamesAndProfilesForBlockchainIdentities:(NSArray<DSBlockchainIdentity *> *)blockchainIdentities queryStep:(DSBlockchainIdentityQueryStep)queryStep inContext:(NSManagedObjectContext *)context withCompletion:(void (^_Nullable)(BOOL success, NSArray<NSError *> *errors))completion onCompletionQueue:(dispatch_queue_t)completionQueue;
+
 - (void)searchIdentitiesByDPNSRegisteredBlockchainIdentityUniqueID:(NSData *)userID withCompletion:(IdentitiesCompletionBlock)completion;
 
 - (void)retrieveIdentitiesByKeysUntilSuccessWithCompletion:(IdentitiesSuccessCompletionBlock)completion completionQueue:(dispatch_queue_t)completionQueue;
@@ -191,10 +191,10 @@
 
 - (id<DSDAPINetworkServiceRequest>)searchIdentityByName:(NSString *)name inDomain:(NSString *)domain withCompletion:(IdentityCompletionBlock)completion {
     DSDAPIClient *client = self.chain.chainManager.DAPIClient;
-    id<DSDAPINetworkServiceRequest> call = [client.DAPIPlatformNetworkService getDPNSDocumentsForUsernames:@[name]
-                                                                                                  inDomain:domain
-                                                                                           completionQueue:self.identityQueue
-                                                                                                   success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+    id<DSDAPINetworkServiceRequest> call = [client performIdempotentPlatformRead:^id<DSDAPINetworkServiceRequest>(DSDAPIPlatformNetworkService *service, void (^readSuccess)(id), void (^readFailure)(NSError *)) {
+        return [service getDPNSDocumentsForUsernames:@[name] inDomain:domain completionQueue:self.identityQueue success:readSuccess failure:readFailure];
+    }
+                                                             success:^(NSArray<NSDictionary *> *_Nonnull documents) {
         __block NSMutableArray *rBlockchainIdentities = [NSMutableArray array];
         for (NSDictionary *document in documents) {
             NSData *userIdData = document[@"$ownerId"];
@@ -240,9 +240,10 @@
         return nil;
     }
     DSDAPIClient *client = self.chain.chainManager.DAPIClient;
-    id<DSDAPINetworkServiceRequest> call = [client.DAPIPlatformNetworkService getDashpayProfileForUserId:blockchainIdentity.uniqueIDData
-                                                                                         completionQueue:self.identityQueue
-                                                                                                 success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+    id<DSDAPINetworkServiceRequest> call = [client performIdempotentPlatformRead:^id<DSDAPINetworkServiceRequest>(DSDAPIPlatformNetworkService *service, void (^readSuccess)(id), void (^readFailure)(NSError *)) {
+        return [service getDashpayProfileForUserId:blockchainIdentity.uniqueIDData completionQueue:self.identityQueue success:readSuccess failure:readFailure];
+    }
+                                                             success:^(NSArray<NSDictionary *> *_Nonnull documents) {
         if (documents.count == 0) {
             if (completion) {
                 dispatch_async(completionQueue, ^{
@@ -293,9 +294,10 @@
         [blockchainIdentityUserIds addObject:blockchainIdentity.uniqueIDData];
     }
     DSDAPIClient *client = self.chain.chainManager.DAPIClient;
-    id<DSDAPINetworkServiceRequest> call = [client.DAPIPlatformNetworkService getDashpayProfilesForUserIds:blockchainIdentityUserIds
-                                                                                           completionQueue:self.identityQueue
-                                                                                                   success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+    id<DSDAPINetworkServiceRequest> call = [client performIdempotentPlatformRead:^id<DSDAPINetworkServiceRequest>(DSDAPIPlatformNetworkService *service, void (^readSuccess)(id), void (^readFailure)(NSError *)) {
+        return [service getDashpayProfilesForUserIds:blockchainIdentityUserIds completionQueue:self.identityQueue success:readSuccess failure:readFailure];
+    }
+                                                             success:^(NSArray<NSDictionary *> *_Nonnull documents) {
         __strong typeof(weakSelf) strongSelf = weakSelf;
         if (!strongSelf) {
             if (completion) {
@@ -333,6 +335,121 @@
     return call;
 }
 
+#define PLATFORM_IN_QUERY_MAX_ITEMS 100
+
+//identities can own several names, so an in query over 100 identities can have more than one page of results
+- (void)fetchDPNSDocumentsForUserIds:(NSArray<NSData *> *)userIds startAfter:(NSData *_Nullable)startAfter accumulatedDocuments:(NSMutableArray<NSDictionary *> *)accumulatedDocuments withService:(DSDAPIPlatformNetworkService *)service success:(void (^)(NSArray<NSDictionary *> *documents))success failure:(void (^)(NSError *error))failure {
+    [service getDPNSDocumentsForIdentitiesWithUserIds:userIds
+                                           startAfter:startAfter
+                                      completionQueue:self.identityQueue
+                                              success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+        [accumulatedDocuments addObjectsFromArray:documents];
+        NSData *hasMoreStartAfter = documents.count == DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT ? documents.lastObject[@"$id"] : nil;
+        if (hasMoreStartAfter) {
+            [self fetchDPNSDocumentsForUserIds:userIds startAfter:hasMoreStartAfter accumulatedDocuments:accumulatedDocuments withService:service success:success failure:failure];
+        } else {
+            success(accumulatedDocuments);
+        }
+    }
+                                              failure:failure];
+}
+
+- (void)fetchUsernamesAndProfilesForBlockchainIdentities:(NSArray<DSBlockchainIdentity *> *)blockchainIdentities queryStep:(DSBlockchainIdentityQueryStep)queryStep inContext:(NSManagedObjectContext *)context withCompletion:(void (^)(BOOL success, NSArray<NSError *> *errors))completion onCompletionQueue:(dispatch_queue_t)completionQueue {
+    DSDashPlatform *platform = [DSDashPlatform sharedInstanceForChain:self.chain];
+    BOOL fetchUsernames = (queryStep & DSBlockchainIdentityQueryStep_Username) && [platform.dpnsContract contractState] == DPContractState_Registered;
+    BOOL fetchProfiles = (queryStep & DSBlockchainIdentityQueryStep_Profile) && [platform.dashPayContract contractState] == DPContractState_Registered;
+    NSMutableDictionary<NSData *, DSBlockchainIdentity *> *blockchainIdentitiesByUniqueId = [NSMutableDictionary dictionary];
+    for (DSBlockchainIdentity *blockchainIdentity in blockchainIdentities) {
+        blockchainIdentitiesByUniqueId[blockchainIdentity.uniqueIDData] = blockchainIdentity;
+    }
+    NSArray<NSData *> *userIds = [blockchainIdentitiesByUniqueId allKeys];
+    DSDAPIPlatformNetworkService *service = self.chain.chainManager.DAPIClient.DAPIPlatformNetworkService;
+    if (!userIds.count || !(fetchUsernames || fetchProfiles) || !service) {
+        if (completion) {
+            NSArray *errors = (userIds.count && (fetchUsernames || fetchProfiles)) ? @[[NSError errorWithCode:500 localizedDescriptionKey:@"No known DAPI Nodes"]] : @[];
+            dispatch_async(completionQueue, ^{
+                completion(!errors.count, errors);
+            });
+        }
+        return;
+    }
+    __block NSMutableArray<NSError *> *errors = [NSMutableArray array];
+    dispatch_group_t dispatchGroup = dispatch_group_create();
+    //one in query per document type for every 100 identities instead of one query per identity and document type
+    for (NSUInteger offset = 0; offset < userIds.count; offset += PLATFORM_IN_QUERY_MAX_ITEMS) {
+        NSArray<NSData *> *userIdsChunk = [userIds subarrayWithRange:NSMakeRange(offset, MIN(PLATFORM_IN_QUERY_MAX_ITEMS, userIds.count - offset))];
+        if (fetchUsernames) {
+            dispatch_group_enter(dispatchGroup);
+            [self fetchDPNSDocumentsForUserIds:userIdsChunk
+                                    startAfter:nil
+                          accumulatedDocuments:[NSMutableArray array]
+                                   withService:service
+                                       success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+                NSMutableDictionary<NSData *, NSMutableArray<NSDictionary *> *> *documentsByUserId = [NSMutableDictionary dictionary];
+                for (NSDictionary *document in documents) {
+                    NSDictionary *records = document[@"records"];
+                    NSData *userIdData = [records isKindOfClass:[NSDictionary class]] ? records[@"dashUniqueIdentityId"] : nil;
+                    if (!userIdData) {
+                        userIdData = document[@"$ownerId"];
+                    }
+                    if (!userIdData || !blockchainIdentitiesByUniqueId[userIdData]) continue;
+                    if (!documentsByUserId[userIdData]) {
+                        documentsByUserId[userIdData] = [NSMutableArray array];
+                    }
+                    [documentsByUserId[userIdData] addObject:document];
+                }
+                for (NSData *userIdData in documentsByUserId) {
+                    dispatch_group_enter(dispatchGroup);
+                    [blockchainIdentitiesByUniqueId[userIdData] applyUsernameDocuments:documentsByUserId[userIdData]
+                                                                             inContext:context
+                                                                            completion:^{
+                        dispatch_group_leave(dispatchGroup);
+                    }];
+                }
+                dispatch_group_leave(dispatchGroup);
+            }
+                                       failure:^(NSError *_Nonnull error) {
+                [errors addObject:error];
+                dispatch_group_leave(dispatchGroup);
+            }];
+        }
+        if (fetchProfiles) {
+            dispatch_group_enter(dispatchGroup);
+            [service getDashpayProfilesForUserIds:userIdsChunk
+                                  completionQueue:self.identityQueue
+                                          success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+                for (NSDictionary *documentDictionary in documents) {
+                    NSData *userIdData = documentDictionary[@"$ownerId"];
+                    DSBlockchainIdentity *blockchainIdentity = userIdData ? blockchainIdentitiesByUniqueId[userIdData] : nil;
+                    if (!blockchainIdentity) continue;
+                    DSTransientDashpayUser *transientDashpayUser = [[DSTransientDashpayUser alloc] initWithDashpayProfileDocument:documentDictionary];
+                    dispatch_group_enter(dispatchGroup);
+                    [blockchainIdentity applyProfileChanges:transientDashpayUser
+                                                  inContext:context
+                                                saveContext:YES
+                                                 completion:^(BOOL success, NSError *_Nullable error) {
+                        if (error) {
+                            [errors addObject:error];
+                        }
+                        dispatch_group_leave(dispatchGroup);
+                    }
+                                          onCompletionQueue:self.identityQueue];
+                }
+                dispatch_group_leave(dispatchGroup);
+            }
+                                          failure:^(NSError *_Nonnull error) {
+                [errors addObject:error];
+                dispatch_group_leave(dispatchGroup);
+            }];
+        }
+    }
+    dispatch_group_notify(dispatchGroup, completionQueue, ^{
+        if (completion) {
+            completion(!errors.count, [errors copy]);
+        }
+    });
+}
+
 - (id<DSDAPINetworkServiceRequest>)searchIdentitiesByDashpayUsernamePrefix:(NSString *)namePrefix queryDashpayProfileInfo:(BOOL)queryDashpayProfileInfo withCompletion:(IdentitiesCompletionBlock)completion {
     return [self searchIdentitiesByDashpayUsernamePrefix:namePrefix startAfter:nil limit:100 queryDashpayProfileInfo:queryDashpayProfileInfo withCompletion:completion];
 }
@@ -78,6 +78,7 @@ NS_ASSUME_NONNULL_BEGIN
 + (NSString *)localizedKeyType:(OpaqueKey *)key;
 
 + (UInt256)x11:(NSData *)data;
++ (BOOL)x11Bytes:(const void *)bytes length:(NSUInteger)length intoHash:(UInt256 *)hash;
 + (UInt256)blake3:(NSData *)data;
 
 + (NSData *)encryptData:(NSData *)data secretKey:(OpaqueKey *)secretKey publicKey:(OpaqueKey *)publicKey;
@@ -288,6 +288,14 @@
     return [DSKeyManager NSDataFrom:processor_x11(data.bytes, data.length)].UInt256;
 }
 
++ (BOOL)x11Bytes:(const void *)bytes length:(NSUInteger)length intoHash:(UInt256 *)hash {
+    ByteArray byte_array = processor_x11(bytes, length);
+    BOOL hashed = byte_array.ptr != NULL && byte_array.len == sizeof(UInt256);
+    if (hashed) memcpy(hash->u8, byte_array.ptr, sizeof(UInt256));
+    if (byte_array.ptr != NULL) processor_destroy_byte_array(byte_array.ptr, byte_array.len);
+    return hashed;
+}
+
 + (UInt256)blake3:(NSData *)data {
     return [DSKeyManager NSDataFrom:processor_blake3(data.bytes, data.length)].UInt256;
 }
@@ -43,11 +43,14 @@
 #import "DSPeer.h"
 #import "DSPeerManager+Protected.h"
 #import "DSQRInfoProcessingResult.h"
+#import "DSQuorumEntry.h"
 #import "DSSimplifiedMasternodeEntry.h"
 #import "DSTransactionManager+Protected.h"
 #import "NSError+Dash.h"
+#import "NSMutableData+Dash.h"
 
 #define SAVE_MASTERNODE_DIFF_TO_FILE (0 && DEBUG)
+#define PLATFORM_QUORUM_ENTRY_CACHE_LIMIT 256
 #define DSFullLog(FORMAT, ...) printf("%s\n", [[NSString stringWithFormat:FORMAT, ##__VA_ARGS__] UTF8String])
 
 
@@ -66,6 +69,8 @@
 @property (nonatomic, strong) dispatch_group_t processingGroup;
 @property (nonatomic, strong) dispatch_queue_t processingQueue;
 @property (nonatomic, strong) dispatch_source_t masternodeListTimer;
+@property (nonatomic, strong) NSCache<NSData *, DSQuorumEntry *> *verifiedPlatformQuorumEntries;
+@property (nonatomic, strong) id masternodeListObserver, currentMasternodeListObserver;
 @property (nonatomic) BOOL isSyncing;
 @end
 
@@ -74,6 +79,8 @@
 
 - (void)dealloc {
     [self destroyProcessors];
+    if (self.masternodeListObserver) [[NSNotificationCenter defaultCenter] removeObserver:self.masternodeListObserver];
+    if (self.currentMasternodeListObserver) [[NSNotificationCenter defaultCenter] removeObserver:self.currentMasternodeListObserver];
 }
 
 - (void)destroyProcessors {
@@ -99,6 +106,18 @@
     _processorCache = [DSMasternodeManager createProcessorCache];
     _processingGroup = dispatch_group_create();
     _processingQueue = dispatch_queue_create([[NSString stringWithFormat:@"org.dashcore.dashsync.processing.%@", uint256_data(self.chain.genesisHash).shortHexString] UTF8String], DISPATCH_QUEUE_SERIAL);
+    _verifiedPlatformQuorumEntries = [[NSCache alloc] init];
+    _verifiedPlatformQuorumEntries.countLimit = PLATFORM_QUORUM_ENTRY_CACHE_LIMIT;
+    //quorums are looked up in the masternode lists, once those change a remembered entry might not be the answer anymore
+    __weak typeof(self) weakSelf = self;
+    void (^clearVerifiedPlatformQuorumEntries)(NSNotification *) = ^(NSNotification *note) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (strongSelf && note.userInfo[DSChainManagerNotificationChainKey] == strongSelf.chain) {
+            [strongSelf.verifiedPlatformQuorumEntries removeAllObjects];
+        }
+    };
+    self.masternodeListObserver = [[NSNotificationCenter defaultCenter] addObserverForName:DSMasternodeListDidChangeNotification object:nil queue:nil usingBlock:clearVerifiedPlatformQuorumEntries];
+    self.currentMasternodeListObserver = [[NSNotificationCenter defaultCenter] addObserverForName:DSCurrentMasternodeListDidChangeNotification object:nil queue:nil usingBlock:clearVerifiedPlatformQuorumEntries];
     return self;
 }
 
@@ -841,7 +860,17 @@
 }
 
 - (DSQuorumEntry *)quorumEntryForPlatformHavingQuorumHash:(UInt256)quorumHash forBlockHeight:(uint32_t)blockHeight {
-    return [self.store quorumEntryForPlatformHavingQuorumHash:quorumHash forBlockHeight:blockHeight];
+    NSMutableData *keyData = [NSMutableData data];
+    [keyData appendUInt256:quorumHash];
+    [keyData appendUInt32:blockHeight];
+    DSQuorumEntry *quorumEntry = [self.verifiedPlatformQuorumEntries objectForKey:keyData];
+    if (quorumEntry) return quorumEntry;
+    quorumEntry = [self.store quorumEntryForPlatformHavingQuorumHash:quorumHash forBlockHeight:blockHeight];
+    if (quorumEntry.verified) {
+        //an unverified entry might get verified later, only remember the final answer
+        [self.verifiedPlatformQuorumEntries setObject:quorumEntry forKey:keyData];
+    }
+    return quorumEntry;
 }
 
 // MARK: - Meta information
@@ -23,6 +23,8 @@
 //  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //  THE SOFTWARE.
 
+#import "DSAddressManager.h"
+#import "DSInventoryTracker.h"
 #import "DSPeerManager.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -42,6 +44,10 @@ typedef NS_ENUM(NSUInteger, DSPeerManagerDesiredState)
 @property (nonatomic, readonly) NSSet *connectedPeers;
 @property (nonatomic, readonly) DSPeerManagerDesiredState desiredState;
 @property (nonatomic, readonly) DSMasternodeList *masternodeList;
+/*! @brief Inventory known by the connected peers, shared between them. */
+@property (nonatomic, readonly) DSInventoryTracker *inventoryTracker;
+/*! @brief Peers discovered through DNS seeds and addr messages, used to connect when there is no masternode list. */
+@property (nonatomic, readonly) DSAddressManager *addressManager;
 
 - (void)peerMisbehaving:(DSPeer *)peer errorMessage:(NSString *)errorMessage;
 - (void)chainSyncStopped;
@@ -32,6 +32,7 @@
 #import "DSChain+Protected.h"
 #import "DSChainEntity+CoreDataClass.h"
 #import "DSChainManager+Protected.h"
+#import "DSDNSSeedResolver.h"
 #import "DSDerivationPath.h"
 #import "DSEventManager.h"
 #import "DSGovernanceObject.h"
@@ -48,6 +49,7 @@
 #import "DSSyncState.h"
 #import "DSSpork.h"
 #import "DSSporkManager.h"
+#import "DSSystemDNSResolver.h"
 #import "DSTransaction.h"
 #import "DSTransactionEntity+CoreDataClass.h"
 #import "DSTransactionManager+Protected.h"
@@ -59,7 +61,6 @@
 #import "NSString+Bitcoin.h"
 #import "DSSendCoinJoinQueue.h"
 #import <arpa/inet.h>
-#import <netdb.h>
 
 #define TESTNET_DNS_SEEDS @[@"testnet-seed.dashdot.io"]
 //#define TESTNET_DNS_SEEDS @[@"35.92.167.154", @"52.12.116.10"]
@@ -72,6 +73,10 @@
 
 #define SYNC_COUNT_INFO @"SYNC_COUNT_INFO"
 
+#define ADDRESSES_FILE_PREFIX @"DS_PEER_ADDRESSES_"
+#define DNS_SEEDS_FILE_PREFIX @"DS_DNS_SEEDS_"
+#define DNS_SEED_TIMEOUT 5.0
+
 @interface DSPeerManager ()
 
 @property (nonatomic, strong) NSMutableOrderedSet *peers;
@@ -85,6 +90,10 @@
 @property (nonatomic, assign) DSPeerManagerDesiredState desiredState;
 @property (nonatomic, assign) uint64_t masternodeListConnectivityNonce;
 @property (nonatomic, strong) DSMasternodeList *masternodeList;
+@property (nonatomic, strong) DSInventoryTracker *inventoryTracker;
+@property (nonatomic, strong) DSAddressManager *addressManager;
+@property (nonatomic, strong) DSDNSSeedResolver *seedResolver;
+@property (nonatomic, assign) BOOL discoveringPeers;
 @property (nonatomic, readonly) dispatch_queue_t networkingQueue;
 
 @property (nonatomic, strong) NSManagedObjectContext *managedObjectContext;
@@ -101,6 +110,7 @@
     self.chain = chain;
     self.mutableConnectedPeers = [NSMutableSet set];
     self.mutableMisbehavingPeers = [NSMutableSet set];
+    self.inventoryTracker = [[DSInventoryTracker alloc] init];
 
     self.maxConnectCount = PEER_MAX_CONNECTIONS;
 
@@ -179,7 +189,7 @@
 }
 
 - (NSUInteger)peerCount {
-    return self.peers.count;
+    return self.masternodeList ? self.peers.count : self.addressManager.count;
 }
 
 
@@ -218,7 +228,7 @@
         uint32_t ip = ntohl(addrV4.s_addr);
         ipAddress.u32[3] = CFSwapInt32HostToBig(ip);
     } else if (inet_pton(AF_INET6, [address UTF8String], &addrV6)) {
-        //todo support IPV6
+        ipAddress = *(UInt128 *)&addrV6;
     } else {
     }
     return ipAddress;
@@ -234,8 +244,10 @@
     @synchronized(self) {
         _peers = nil;
     }
+    if (reason == DSDisconnectReason_ChainWipe) [self removeAllAddresses];
 }
 
+// peers given by the masternode list, the address manager is used when there is none
 - (NSMutableOrderedSet *)peers {
     if (_fixedPeer) return [NSMutableOrderedSet orderedSetWithObject:_fixedPeer];
     if (_peers.count >= _maxConnectCount) return _peers;
@@ -243,131 +255,155 @@
     @synchronized(self) {
         if (_peers.count >= _maxConnectCount) return _peers;
         _peers = [NSMutableOrderedSet orderedSet];
-
-        [self.managedObjectContext performBlockAndWait:^{
-            for (DSPeerEntity *e in [DSPeerEntity objectsInContext:self.managedObjectContext matching:@"chain == %@", [self.chain chainEntityInContext:self.managedObjectContext]]) {
-                @autoreleasepool {
-                    if (e.misbehavin == 0)
-                        [self->_peers addObject:[e peer]];
-                    else
-                        [self.mutableMisbehavingPeers addObject:[e peer]];
-                }
-            }
-        }];
-
+        if ([self.chain isDevnetAny]) [_peers addObjectsFromArray:[self registeredDevnetPeers]];
+        if (self.masternodeList) {
+            NSArray *masternodePeers = [self.masternodeList peers:[self.chain isDevnetAny] ? 8 : 500 withConnectivityNonce:self.masternodeListConnectivityNonce];
+            [_peers addObjectsFromArray:masternodePeers];
+        }
+        [_peers minusSet:self.misbehavingPeers];
         [self sortPeers];
+        return _peers;
+    }
+}
 
-        if ([self.chain isDevnetAny]) {
-            [_peers addObjectsFromArray:[self registeredDevnetPeers]];
+- (void)removeCandidatePeer:(DSPeer *)peer {
+    @synchronized(self) {
+        [_peers removeObject:peer];
+    }
+}
 
-            if (self.masternodeList) {
-                NSArray *masternodePeers = [self.masternodeList peers:8 withConnectivityNonce:self.masternodeListConnectivityNonce];
-                [_peers addObjectsFromArray:masternodePeers];
-            }
+// MARK: - Addresses
 
-            [self sortPeers];
-            return _peers;
+- (DSAddressManager *)addressManager {
+    @synchronized(self) {
+        if (!_addressManager) {
+            _addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+            [self loadAddresses];
         }
+        return _addressManager;
+    }
+}
 
-        if (self.masternodeList) {
-            NSArray *masternodePeers = [self.masternodeList peers:500 withConnectivityNonce:self.masternodeListConnectivityNonce];
-            [_peers addObjectsFromArray:masternodePeers];
-            [self sortPeers];
-            return _peers;
-        }
+- (NSString *)addressesPath {
+    NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    return [cachesDirectory stringByAppendingPathComponent:[ADDRESSES_FILE_PREFIX stringByAppendingString:self.chain.uniqueID]];
+}
 
-        // DNS peer discovery
-        NSTimeInterval now = [NSDate timeIntervalSince1970];
-        NSMutableArray *peers = [NSMutableArray arrayWithObject:[NSMutableArray array]];
-        NSArray *dnsSeeds = [self dnsSeeds];
-        if (_peers.count < PEER_MAX_CONNECTIONS || ((DSPeer *)_peers[PEER_MAX_CONNECTIONS - 1]).timestamp + 3 * DAY_TIME_INTERVAL < now) {
-            while (peers.count < dnsSeeds.count) [peers addObject:[NSMutableArray array]];
+- (void)loadAddresses {
+    NSData *data = [NSData dataWithContentsOfFile:self.addressesPath];
+    if (data && [_addressManager loadSerializedData:data]) {
+        DSLogInfo(@"DSPeerManager", @"[%@] loaded %lu peer addresses", self.chain.name, (unsigned long)_addressManager.count);
+        return;
+    }
+    // peers used to be kept in Core Data, bring them over once
+    [self.managedObjectContext performBlockAndWait:^{
+        NSArray<DSPeerEntity *> *peerEntities = [DSPeerEntity objectsInContext:self.managedObjectContext matching:@"chain == %@", [self.chain chainEntityInContext:self.managedObjectContext]];
+        if (!peerEntities.count) return;
+        for (DSPeerEntity *e in peerEntities) {
+            @autoreleasepool {
+                if (e.misbehavin == 0)
+                    [self->_addressManager addPeers:@[[e peer]] fromSource:nil];
+                else
+                    [self->_addressManager banPeer:[e peer]];
+                [self.managedObjectContext deleteObject:e];
+            }
         }
+        // the addresses are written out before the rows are gone for good
+        [[self->_addressManager serializedData] writeToFile:self.addressesPath atomically:YES];
+        [self.managedObjectContext ds_save];
+    }];
+}
 
-        if (peers.count > 0) {
-            if ([dnsSeeds count]) {
-                dispatch_apply(peers.count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
-                    NSString *servname = @(self.chain.standardPort).stringValue;
-                    struct addrinfo hints = {0, AF_UNSPEC, SOCK_STREAM, 0, 0, 0, NULL, NULL}, *servinfo, *p;
-                    UInt128 addr = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), 0}};
-
-                    NSString *dnsSeed = [dnsSeeds objectAtIndex:i];
-                    if (getaddrinfo([dnsSeed UTF8String], servname.UTF8String, &hints, &servinfo) == 0) {
-                        for (p = servinfo; p != NULL; p = p->ai_next) {
-                            if (p->ai_family == AF_INET) {
-                                addr.u64[0] = 0;
-                                addr.u32[2] = CFSwapInt32HostToBig(0xffff);
-                                addr.u32[3] = ((struct sockaddr_in *)p->ai_addr)->sin_addr.s_addr;
-                            }
-                            //                        else if (p->ai_family == AF_INET6) {
-                            //                            addr = *(UInt128 *)&((struct sockaddr_in6 *)p->ai_addr)->sin6_addr;
-                            //                        }
-                            else
-                                continue;
-
-                            uint16_t port = CFSwapInt16BigToHost(((struct sockaddr_in *)p->ai_addr)->sin_port);
-                            NSTimeInterval age = 3 * DAY_TIME_INTERVAL + arc4random_uniform(4 * DAY_TIME_INTERVAL); // add between 3 and 7 days
-                            [peers[i] addObject:[[DSPeer alloc] initWithAddress:addr
-                                                                           port:port
-                                                                        onChain:self.chain
-                                                                      timestamp:(i > 0 ? now - age : now)
-                                                                       services:SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM]];
-                        }
-
-                        freeaddrinfo(servinfo);
-                    }
-                });
-            }
+- (void)removeAllAddresses {
+    [self.addressManager removeAllAddresses];
+    [self.seedResolver removeCachedSeeds];
+    [[NSFileManager defaultManager] removeItemAtPath:self.addressesPath error:nil];
+}
 
-            for (NSArray *a in peers) [_peers addObjectsFromArray:a];
+- (DSDNSSeedResolver *)seedResolver {
+    @synchronized(self) {
+        if (!_seedResolver) {
+            NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+            NSString *cachePath = [cachesDirectory stringByAppendingPathComponent:[DNS_SEEDS_FILE_PREFIX stringByAppendingString:self.chain.uniqueID]];
+            _seedResolver = [[DSDNSSeedResolver alloc] initWithResolver:[[DSSystemDNSResolver alloc] init] cachePath:cachePath];
+        }
+        return _seedResolver;
+    }
+}
 
-            if (![self.chain isMainnet] && ![self.chain isTestnet]) {
-                [self sortPeers];
-                return _peers;
-            }
-            // if DNS peer discovery fails, fall back on a hard coded list of peers (list taken from satoshi client)
-            if (_peers.count < PEER_MAX_CONNECTIONS) {
-                if (![self.chain isMainnet] && ![TESTNET_MAIN_PEER isEqualToString:@""]) {
-                    NSArray *serviceArray = [TESTNET_MAIN_PEER componentsSeparatedByString:@":"];
-                    NSString *address = serviceArray[0];
-                    NSString *port = ([serviceArray count] > 1) ? serviceArray[1] : nil;
-                    UInt128 ipAddress = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), 0}};
-                    struct in_addr addrV4;
-                    if (inet_aton([address UTF8String], &addrV4) != 0) {
-                        uint32_t ip = ntohl(addrV4.s_addr);
-                        ipAddress.u32[3] = CFSwapInt32HostToBig(ip);
-                    }
-                    [_peers addObject:[[DSPeer alloc] initWithAddress:ipAddress
-                                                                 port:port ? [port intValue] : self.chain.standardPort
-                                                              onChain:self.chain
-                                                            timestamp:now - (WEEK_TIME_INTERVAL + arc4random_uniform(WEEK_TIME_INTERVAL))
-                                                             services:SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM]];
-                } else {
-                    UInt128 addr = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), 0}};
-
-                    NSString *bundlePath = [[NSBundle bundleForClass:self.class] pathForResource:@"DashSync" ofType:@"bundle"];
-                    NSBundle *bundle = [NSBundle bundleWithPath:bundlePath];
-                    NSString *path = [bundle pathForResource:[self.chain isMainnet] ? FIXED_PEERS : TESTNET_FIXED_PEERS ofType:@"plist"];
-                    for (NSNumber *address in [NSArray arrayWithContentsOfFile:path]) {
-                        // give hard coded peers a timestamp between 7 and 14 days ago
-                        addr.u32[3] = CFSwapInt32HostToBig(address.unsignedIntValue);
-                        [_peers addObject:[[DSPeer alloc] initWithAddress:addr
-                                                                     port:self.chain.standardPort
-                                                                  onChain:self.chain
-                                                                timestamp:now - (WEEK_TIME_INTERVAL + arc4random_uniform(WEEK_TIME_INTERVAL))
-                                                                 services:SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM]];
-                    }
-                }
-            }
+// adds peers from DNS seeds, or from the fixed list when these fail, unless enough recent addresses are known
+// seeds are resolved in the background, connecting goes on as soon as one of them answers
+- (void)discoverPeersIfNeeded {
+    if ([self.chain isDevnetAny]) {
+        [self.addressManager addPeers:[self registeredDevnetPeers] fromSource:nil];
+        return;
+    }
+    if (self.discoveringPeers) return;
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    if ([self.addressManager countOfAddressesSeenSince:now - 3 * DAY_TIME_INTERVAL] >= PEER_MAX_CONNECTIONS) return;
 
-            [self sortPeers];
+    NSArray *dnsSeeds = [self dnsSeeds];
+    if (dnsSeeds.count == 0) {
+        [self addFixedPeersIfNeeded];
+        return;
+    }
+    self.discoveringPeers = YES;
+    [self.seedResolver resolveSeeds:dnsSeeds
+        port:self.chain.standardPort
+        timeout:DNS_SEED_TIMEOUT
+        queue:self.networkingQueue
+        addressesHandler:^(NSString *seed, NSArray<NSValue *> *addresses) {
+            NSUInteger addedCount = [self.addressManager addNetworkAddresses:addresses fromSource:nil];
+            DSLogInfo(@"DSPeerManager", @"[%@] %lu new peer addresses from %@", self.chain.name, (unsigned long)addedCount, seed);
+            if (addedCount > 0 && self.desiredState == DSPeerManagerDesiredState_Connected) [self connect];
         }
+        completion:^(NSUInteger addressCount) {
+            self.discoveringPeers = NO;
+            [self addFixedPeersIfNeeded];
+            if (self.desiredState == DSPeerManagerDesiredState_Connected) [self connect];
+        }];
+}
 
-        return _peers;
+- (void)addFixedPeersIfNeeded {
+    if (![self.chain isMainnet] && ![self.chain isTestnet]) return;
+    // if DNS peer discovery fails, fall back on a hard coded list of peers (list taken from satoshi client)
+    if (self.addressManager.count >= PEER_MAX_CONNECTIONS) return;
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    NSMutableArray *fixedPeers = [NSMutableArray array];
+    if (![self.chain isMainnet] && ![TESTNET_MAIN_PEER isEqualToString:@""]) {
+        NSArray *serviceArray = [TESTNET_MAIN_PEER componentsSeparatedByString:@":"];
+        NSString *address = serviceArray[0];
+        NSString *port = ([serviceArray count] > 1) ? serviceArray[1] : nil;
+        UInt128 ipAddress = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), 0}};
+        struct in_addr addrV4;
+        if (inet_aton([address UTF8String], &addrV4) != 0) {
+            uint32_t ip = ntohl(addrV4.s_addr);
+            ipAddress.u32[3] = CFSwapInt32HostToBig(ip);
+        }
+        [fixedPeers addObject:[[DSPeer alloc] initWithAddress:ipAddress
+                                                         port:port ? [port intValue] : self.chain.standardPort
+                                                      onChain:self.chain
+                                                    timestamp:now - (WEEK_TIME_INTERVAL + arc4random_uniform(WEEK_TIME_INTERVAL))
+                                                     services:SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM]];
+    } else {
+        UInt128 addr = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), 0}};
+
+        NSString *bundlePath = [[NSBundle bundleForClass:self.class] pathForResource:@"DashSync" ofType:@"bundle"];
+        NSBundle *bundle = [NSBundle bundleWithPath:bundlePath];
+        NSString *path = [bundle pathForResource:[self.chain isMainnet] ? FIXED_PEERS : TESTNET_FIXED_PEERS ofType:@"plist"];
+        for (NSNumber *address in [NSArray arrayWithContentsOfFile:path]) {
+            // give hard coded peers a timestamp between 7 and 14 days ago
+            addr.u32[3] = CFSwapInt32HostToBig(address.unsignedIntValue);
+            [fixedPeers addObject:[[DSPeer alloc] initWithAddress:addr
+                                                             port:self.chain.standardPort
+                                                          onChain:self.chain
+                                                        timestamp:now - (WEEK_TIME_INTERVAL + arc4random_uniform(WEEK_TIME_INTERVAL))
+                                                         services:SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM]];
+        }
     }
+    [self.addressManager addPeers:fixedPeers fromSource:nil];
 }
 
-
 - (void)changeCurrentPeers {
     dispatch_async(self.networkingQueue, ^{
         for (DSPeer *p in self.connectedPeers) {
@@ -382,17 +418,13 @@
     @synchronized(self) {
         @synchronized(self.mutableMisbehavingPeers) {
             peer.misbehaving++;
-            [self.peers removeObject:peer];
+            [self removeCandidatePeer:peer];
+            [self.addressManager banPeer:peer];
             [self.mutableMisbehavingPeers addObject:peer];
             if (++self.misbehavingCount >= self.chain.peerMisbehavingThreshold) { // clear out stored peers so we get a fresh list from DNS for next connect
                 self.misbehavingCount = 0;
                 [self.mutableMisbehavingPeers removeAllObjects];
-                [self.managedObjectContext performBlockAndWait:^{
-                    NSArray *objects = [DSPeerEntity allObjectsInContext:self.managedObjectContext];
-                    for (NSManagedObject *obj in objects) {
-                        [self.managedObjectContext deleteObject:obj];
-                    }
-                }];
+                [self removeAllAddresses];
                 _peers = nil;
             }
 
@@ -430,44 +462,23 @@
 }
 
 - (void)savePeers {
-    NSMutableSet *peers = [[self.peers.set setByAddingObjectsFromSet:self.misbehavingPeers] mutableCopy];
-    NSMutableSet *addrs = [NSMutableSet set];
-
-    for (DSPeer *p in peers) {
-        if (p.address.u64[0] != 0 || p.address.u32[2] != CFSwapInt32HostToBig(0xffff)) continue; // skip IPv6 for now
-        [addrs addObject:@(CFSwapInt32BigToHost(p.address.u32[3]))];
+    for (DSPeer *peer in self.connectedPeers) {
+        [self.addressManager updatePeer:peer];
     }
-
-    [self.managedObjectContext performBlock:^{
-        [DSPeerEntity deleteObjects:[DSPeerEntity objectsInContext:self.managedObjectContext matching:@"(chain == %@) && !(address in %@)", [self.chain chainEntityInContext:self.managedObjectContext], addrs] inContext:self.managedObjectContext]; // remove deleted peers
-
-        for (DSPeerEntity *e in [DSPeerEntity objectsInContext:self.managedObjectContext matching:@"(chain == %@) && (address in %@)", [self.chain chainEntityInContext:self.managedObjectContext], addrs]) { // update existing peers
-            @autoreleasepool {
-                DSPeer *p = [peers member:[e peer]];
-
-                if (p) {
-                    e.timestamp = p.timestamp;
-                    e.services = p.services;
-                    e.misbehavin = p.misbehaving;
-                    e.priority = p.priority;
-                    e.lowPreferenceTill = p.lowPreferenceTill;
-                    e.lastRequestedMasternodeList = p.lastRequestedMasternodeList;
-                    e.lastRequestedGovernanceSync = p.lastRequestedGovernanceSync;
-                    [peers removeObject:p];
-                } else
-                    [e deleteObjectAndWait];
-            }
-        }
-
-        for (DSPeer *p in peers) {
-            @autoreleasepool {
-                [[DSPeerEntity managedObjectInBlockedContext:self.managedObjectContext] setAttributesFromPeer:p]; // add new peers
-            }
-        }
-    }];
+    NSData *data = [self.addressManager serializedData];
+    NSString *path = self.addressesPath;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [data writeToFile:path atomically:YES];
+    });
 }
 
 - (DSPeer *)peerForLocation:(UInt128)IPAddress port:(uint16_t)port {
+    for (DSPeer *peer in self.connectedPeers) {
+        if (uint128_eq(peer.address, IPAddress) && peer.port == port) {
+            return peer;
+        }
+    }
+    if (!self.masternodeList) return [self.addressManager peerAtAddress:IPAddress port:port];
     for (DSPeer *peer in self.peers) {
         if (uint128_eq(peer.address, IPAddress) && peer.port == port) {
             return peer;
@@ -546,7 +557,19 @@
         NSTimeInterval filterBuildTime = ([[NSDate date] timeIntervalSince1970] - filterUpdateStart) * 1000.0;
         DSLogInfo(@"DSPeerManager", @"Bloom filter rebuild took %.2f ms", filterBuildTime);
 
-        if (self.chain.lastSyncBlockHeight < self.chain.estimatedBlockHeight) { // if we're syncing, only update download peer
+        if (self.chainManager.merkleBlockBackfill) { // backfilling from every peer, blocks that were not applied yet are fetched again
+            [self.chainManager restartMerkleBlockBackfill];
+            for (DSPeer *p in self.connectedPeers) {
+                if (p.status != DSPeerStatus_Connected) continue;
+                p.needsFilterUpdate = YES;
+                [p sendFilterloadMessage:[self.transactionManager transactionsBloomFilterForPeer:p].data];
+                [p sendPingMessageWithPongHandler:^(BOOL success) { // wait for pong so filter is loaded
+                    if (!success) return;
+                    p.needsFilterUpdate = NO;
+                    [self.chainManager requestMerkleBlockBackfillRanges];
+                }];
+            }
+        } else if (self.chain.lastSyncBlockHeight < self.chain.estimatedBlockHeight) { // if we're syncing, only update download peer
             [self.downloadPeer sendFilterloadMessage:[self.transactionManager transactionsBloomFilterForPeer:self.downloadPeer].data];
             [self.downloadPeer sendPingMessageWithPongHandler:^(BOOL success) { // wait for pong so filter is loaded
                 if (!success) return;
@@ -633,6 +656,7 @@
 
 
     NSArray *peers = [masternodeList peers:500 withConnectivityNonce:connectivityNonce];
+    [self.addressManager addPeers:peers fromSource:nil];
 
     @synchronized(self) {
         if (!_peers) {
@@ -715,17 +739,29 @@
         self.maxConnectCount = (self.fixedPeer) ? 1 : PEER_MAX_CONNECTIONS;
         if (self.connectedPeers.count >= self.maxConnectCount) return; // already connected to maxConnectCount peers
 
-        NSMutableOrderedSet *peers = [NSMutableOrderedSet orderedSetWithOrderedSet:self.peers];
+        BOOL usesAddressManager = !self.fixedPeer && !self.masternodeList;
+        if (usesAddressManager) [self discoverPeersIfNeeded];
+        NSMutableOrderedSet *peers = usesAddressManager ? nil : [NSMutableOrderedSet orderedSetWithOrderedSet:self.peers];
 
         if (peers.count > 100) [peers removeObjectsInRange:NSMakeRange(100, peers.count - 100)];
 
-        if (peers.count > 0 && self.connectedPeers.count < self.maxConnectCount) {
+        if (self.connectedPeers.count < self.maxConnectCount) {
             @synchronized(self.mutableConnectedPeers) {
                 NSTimeInterval earliestWalletCreationTime = self.chain.earliestWalletCreationTime;
 
-                while (peers.count > 0 && self.connectedPeers.count < self.maxConnectCount) {
-                    // pick a random peer biased towards peers with more recent timestamps
-                    DSPeer *peer = peers[(NSUInteger)(pow(arc4random_uniform((uint32_t)peers.count), 2) / peers.count)];
+                while (self.connectedPeers.count < self.maxConnectCount) {
+                    DSPeer *peer = nil;
+                    if (usesAddressManager) {
+                        // a random address, away from the network groups already connected to
+                        peer = [self.addressManager selectPeerExcludingPeers:[self.connectedPeers setByAddingObjectsFromSet:self.misbehavingPeers]];
+                        if (!peer) break;
+                        [self.addressManager markAttemptToPeer:peer];
+                    } else {
+                        if (peers.count == 0) break;
+                        // pick a random peer biased towards peers with more recent timestamps
+                        peer = peers[(NSUInteger)(pow(arc4random_uniform((uint32_t)peers.count), 2) / peers.count)];
+                        [peers removeObject:peer];
+                    }
 
                     if (peer && ![self.connectedPeers containsObject:peer]) {
                         [peer setChainDelegate:self.chainManager peerDelegate:self transactionDelegate:self.transactionManager governanceDelegate:self.governanceSyncManager sporkDelegate:self.sporkManager masternodeDelegate:self.masternodeManager queue:self.networkingQueue];
@@ -740,13 +776,11 @@
 
                         [peer connect];
                     }
-
-                    [peers removeObject:peer];
                 }
             }
         }
 
-        if (peers.count == 0) {
+        if (self.connectedPeers.count == 0 && !self.discoveringPeers) {
             [self chainSyncStopped];
             dispatch_async(dispatch_get_main_queue(), ^{
                 NSError *error = [NSError errorWithCode:1 localizedDescriptionKey:@"No peers found"];
@@ -773,7 +807,7 @@
     [self.downloadPeer disconnectWithError:error];
     dispatch_async(self.networkingQueue, ^{
         if (self.downloadPeer) { // disconnect the current download peer so a new random one will be selected
-            [self.peers removeObject:self.downloadPeer];
+            [self removeCandidatePeer:self.downloadPeer];
         }
         if (completion) completion(TRUE);
     });
@@ -814,6 +848,7 @@
 
     if (peer.timestamp > now + 2 * 60 * 60 || peer.timestamp < now - 2 * 60 * 60) peer.timestamp = now; //timestamp sanity check
     self.connectFailures = 0;
+    [self.addressManager markPeerConnected:peer];
 
     // drop peers that don't carry full blocks, or aren't synced yet
     // TODO: XXXX does this work with 0.11 pruned nodes?
@@ -838,6 +873,7 @@
         }
         if (self.chain.estimatedBlockHeight >= peer.lastBlockHeight || self.chain.lastSyncBlockHeight >= peer.lastBlockHeight) {
             if (self.chain.lastSyncBlockHeight < self.chain.estimatedBlockHeight) {
+                [self.chainManager requestMerkleBlockBackfillRanges];
                 return; // don't get mempool yet if we're syncing
             }
 
@@ -946,11 +982,12 @@
         [self peerMisbehaving:peer errorMessage:error.localizedDescription]; // if it's protocol error other than timeout, the peer isn't following the rules
         banned = YES;
     } else if (error) {                                                      // timeout or some non-protocol related network error
-        [self.peers removeObject:peer];
+        [self removeCandidatePeer:peer];
         self.connectFailures++;
     }
 
     [self.transactionManager clearTransactionRelaysForPeer:peer];
+    [self.chainManager merkleBlockBackfillPeerDisconnected:peer];
 
     if ([self.downloadPeer isEqual:peer]) { // download peer disconnected
         _connected = NO;
@@ -970,12 +1007,7 @@
         @synchronized(self.mutableMisbehavingPeers) {
             [self.mutableMisbehavingPeers removeAllObjects];
         }
-        [self.managedObjectContext performBlockAndWait:^{
-            NSArray *objects = [DSPeerEntity allObjectsInContext:self.managedObjectContext];
-            for (NSManagedObject *obj in objects) {
-                [self.managedObjectContext deleteObject:obj];
-            }
-        }];
+        [self removeAllAddresses];
         @synchronized(self) {
             _peers = nil;
         }
@@ -1011,23 +1043,11 @@
     });
 }
 
-- (void)peer:(DSPeer *)peer relayedPeers:(NSArray *)peers {
+- (void)peer:(DSPeer *)peer relayedAddresses:(NSArray<NSValue *> *)addresses {
     if (self.masternodeList) return;
-    [self.peers addObjectsFromArray:peers];
-    [self.peers minusSet:self.misbehavingPeers];
-    [self sortPeers];
-
-    // limit total to 2500 peers
-    if (self.peers.count > 2500) [self.peers removeObjectsInRange:NSMakeRange(2500, self.peers.count - 2500)];
+    [self.addressManager addNetworkAddresses:addresses fromSource:peer];
 
-    NSTimeInterval now = [NSDate timeIntervalSince1970];
-
-    // remove peers more than 3 hours old, or until there are only 1000 left
-    while (self.peers.count > 1000 && ((DSPeer *)self.peers.lastObject).timestamp + 3 * 60 * 60 < now) {
-        [self.peers removeObject:self.peers.lastObject];
-    }
-
-    if (peers.count > 1 && peers.count < 1000) [self savePeers]; // peer relaying is complete when we receive <1000
+    if (addresses.count > 1 && addresses.count < 1000) [self savePeers]; // peer relaying is complete when we receive <1000
     dispatch_async(dispatch_get_main_queue(), ^{
         [[NSNotificationCenter defaultCenter] postNotificationName:DSPeerManagerPeersDidChangeNotification
                                                             object:nil
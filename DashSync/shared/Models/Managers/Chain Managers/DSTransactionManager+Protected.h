@@ -23,6 +23,9 @@
 //  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //  THE SOFTWARE.
 
+#import "DSChainLockTracker.h"
+#import "DSInstantSendLockIngestion.h"
+#import "DSSeenTransactionStore.h"
 #import "DSTransactionManager.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -31,8 +34,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readonly) NSDictionary *txRelays, *txRequests;
 @property (nonatomic, readonly) NSDictionary *publishedTx, *publishedCallback;
+@property (nonatomic, readonly) DSInstantSendLockIngestion *instantSendLockIngestion;
+@property (nonatomic, readonly) DSChainLockTracker *chainLockTracker;
+/*! @brief Transactions downloaded but not kept, not asked for again by any peer. */
+@property (nonatomic, readonly) DSSeenTransactionStore *seenTransactionStore;
 
 - (void)addUnconfirmedTransactionToPublishList:(DSTransaction *)transaction;
+/*! @brief Registers a transaction with the accounts that can contain it, peer:relayedTransaction:inBlock: holds back those of backfilled blocks until their block is applied. */
+- (void)registerRelayedTransaction:(DSTransaction *)transaction inBlock:(DSBlock *_Nullable)block fromPeer:(DSPeer *_Nullable)peer;
 - (void)clearTransactionRelaysForPeer:(DSPeer *)peer;
 - (void)removeUnrelayedTransactionsFromPeer:(DSPeer *)peer;
 - (void)updateTransactionsBloomFilter;
@@ -34,21 +34,26 @@
 #import "DSBloomFilter.h"
 #import "DSChain+Protected.h"
 #import "DSChainLock.h"
+#import "DSChainLockTracker.h"
 #import "DSChainManager+Protected.h"
+#import "DSChainManager+Transactions.h"
 #import "DSCreditFundingTransaction.h"
 #import "DSDAPIPlatformNetworkService.h"
 #import "DSError.h"
 #import "DSEventManager.h"
 #import "DSIdentitiesManager.h"
+#import "DSInstantSendLockIngestion.h"
 #import "DSInstantSendTransactionLock.h"
 #import "DSMasternodeList.h"
 #import "DSMasternodeManager+Protected.h"
 #import "DSMerkleBlock.h"
+#import "DSMerkleBlockBackfill.h"
 #import "DSOptionsManager.h"
 #import "DSPaymentProtocol.h"
 #import "DSPaymentRequest.h"
 #import "DSPeerManager+Protected.h"
 #import "DSPriceManager.h"
+#import "DSSeenTransactionStore.h"
 #import "DSSpecialTransactionsWalletHolder.h"
 #import "DSTransaction.h"
 #import "DSTransactionEntity+CoreDataClass.h"
@@ -71,6 +76,8 @@
 
 #define IX_INPUT_LOCKED_KEY @"IX_INPUT_LOCKED_KEY"
 #define MAX_TOTAL_TRANSACTIONS_FOR_BLOOM_FILTER_RETARGETING 500
+#define SEEN_TRANSACTIONS_FILE_PREFIX @"DS_SEEN_TRANSACTIONS_"
+#define INSTANT_SEND_LOCKS_WAITING_FOR_TRANSACTIONS_CAPACITY 2048
 
 #define SAVE_MAX_TRANSACTIONS_INFO (DEBUG && 0)
 #define DEBUG_CHAIN_LOCKS_WAITING_FOR_QUORUMS (DEBUG && 0)
@@ -90,8 +97,11 @@
 @property (nonatomic, strong) NSMutableArray *removeUnrelayedTransactionsLocalRequests;
 @property (nonatomic, strong) NSMutableDictionary *instantSendLocksWaitingForQuorums;
 @property (nonatomic, strong) NSMutableDictionary *instantSendLocksWaitingForTransactions;
+@property (nonatomic, strong) NSMutableOrderedSet<NSData *> *instantSendLockWaitingTransactionHashes; // in arrival order
+@property (nonatomic, strong) DSInstantSendLockIngestion *instantSendLockIngestion;
 @property (nonatomic, strong) NSMutableDictionary *chainLocksWaitingForMerkleBlocks;
-@property (nonatomic, strong) NSMutableDictionary *chainLocksWaitingForQuorums;
+@property (nonatomic, strong) DSChainLockTracker *chainLockTracker;
+@property (nonatomic, strong) DSSeenTransactionStore *seenTransactionStore;
 
 #if SAVE_MAX_TRANSACTIONS_INFO
 
@@ -124,8 +134,11 @@
     self.removeUnrelayedTransactionsLocalRequests = [NSMutableArray array];
     self.instantSendLocksWaitingForQuorums = [NSMutableDictionary dictionary];
     self.instantSendLocksWaitingForTransactions = [NSMutableDictionary dictionary];
+    self.instantSendLockWaitingTransactionHashes = [NSMutableOrderedSet orderedSet];
+    self.instantSendLockIngestion = [[DSInstantSendLockIngestion alloc] init];
     self.chainLocksWaitingForMerkleBlocks = [NSMutableDictionary dictionary];
-    self.chainLocksWaitingForQuorums = [NSMutableDictionary dictionary];
+    self.chainLockTracker = [[DSChainLockTracker alloc] init];
+    [self loadSeenTransactionStore];
     [self recreatePublishedTransactionList];
     return self;
 }
@@ -148,6 +161,39 @@
     return self.chain.chainManager;
 }
 
+// MARK: - Seen Transactions
+
+// the store is opened (and migrated) while the chain is set up, so peer threads never pay for it
+- (void)loadSeenTransactionStore {
+    NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    NSString *path = [cachesDirectory stringByAppendingPathComponent:[SEEN_TRANSACTIONS_FILE_PREFIX stringByAppendingString:self.chain.uniqueID]];
+    BOOL exists = [[NSFileManager defaultManager] fileExistsAtPath:path];
+    DSSeenTransactionStore *seenTransactionStore = [[DSSeenTransactionStore alloc] initWithPath:path];
+    if (!exists) [self moveStandaloneTransactionHashesToStore:seenTransactionStore];
+    self.seenTransactionStore = seenTransactionStore;
+}
+
+// while a backfill runs, a transaction can be dropped only because the one it spends is in a block not applied yet
+- (void)recordSeenTransactionHash:(UInt256)txHash {
+    if (self.chainManager.merkleBlockBackfill) return;
+    [self.seenTransactionStore addTransactionHash:txHash];
+}
+
+// hashes without a transaction used to be kept in Core Data, bring them over once
+- (void)moveStandaloneTransactionHashesToStore:(DSSeenTransactionStore *)store {
+    NSManagedObjectContext *context = self.chain.chainManagedObjectContext;
+    [context performBlockAndWait:^{
+        NSArray<DSTransactionHashEntity *> *transactionHashEntities = [DSTransactionHashEntity standaloneTransactionHashEntitiesOnChainEntity:[self.chain chainEntityInContext:context]];
+        if (!transactionHashEntities.count) return;
+        for (DSTransactionHashEntity *hashEntity in transactionHashEntities) {
+            [store addTransactionHash:hashEntity.txHash.UInt256 seenAt:hashEntity.timestamp ?: [NSDate timeIntervalSince1970]];
+            [context deleteObject:hashEntity];
+        }
+        [context ds_save];
+    }];
+    [store synchronize];
+}
+
 // MARK: - Helpers
 
 #if TARGET_OS_IOS
@@ -973,6 +1019,7 @@
     // the transaction likely consumed one or more wallet addresses, so check that at least the next <gap limit>
     // unused addresses are still matched by the bloom filter
     NSMutableArray *allAddressesArray = [NSMutableArray array];
+    BOOL missingAddresses = NO;
 
     for (DSWallet *wallet in self.chain.wallets) {
         // every time a new wallet address is added, the bloom filter has to be rebuilt, and each address is only used for
@@ -981,12 +1028,22 @@
         [wallet registerAddressesWithGapLimit:SEQUENCE_GAP_LIMIT_EXTERNAL unusedAccountGapLimit:SEQUENCE_UNUSED_GAP_LIMIT_EXTERNAL dashpayGapLimit:SEQUENCE_DASHPAY_GAP_LIMIT_INCOMING coinJoinGapLimit:SEQUENCE_GAP_LIMIT_INITIAL_COINJOIN internal:NO error:nil];
         [wallet registerAddressesWithGapLimit:SEQUENCE_GAP_LIMIT_INTERNAL unusedAccountGapLimit:SEQUENCE_GAP_LIMIT_INTERNAL dashpayGapLimit:SEQUENCE_DASHPAY_GAP_LIMIT_INCOMING coinJoinGapLimit:SEQUENCE_GAP_LIMIT_INITIAL_COINJOIN internal:YES error:nil];
         NSSet *addresses = [wallet.allReceiveAddresses setByAddingObjectsFromSet:wallet.allChangeAddresses];
-        [allAddressesArray addObjectsFromArray:[addresses allObjects]];
+        NSMutableArray *walletAddressesArray = [NSMutableArray arrayWithArray:[addresses allObjects]];
+
+        [walletAddressesArray addObjectsFromArray:[wallet providerOwnerAddresses]];
+        [walletAddressesArray addObjectsFromArray:[wallet providerVotingAddresses]];
+        [walletAddressesArray addObjectsFromArray:[wallet providerOperatorAddresses]];
+        [walletAddressesArray addObjectsFromArray:[wallet platformNodeAddresses]];
+
+        for (NSString *address in walletAddressesArray) {
+            NSData *hash = address.addressToHash160;
 
-        [allAddressesArray addObjectsFromArray:[wallet providerOwnerAddresses]];
-        [allAddressesArray addObjectsFromArray:[wallet providerVotingAddresses]];
-        [allAddressesArray addObjectsFromArray:[wallet providerOperatorAddresses]];
-        [allAddressesArray addObjectsFromArray:[wallet platformNodeAddresses]];
+            if (!hash || [_bloomFilter containsData:hash]) continue;
+            // blocks synced so far were not matched against the new addresses
+            [wallet invalidateBlockZones];
+            missingAddresses = YES;
+            break;
+        }
     }
 
     for (DSFundsDerivationPath *derivationPath in self.chain.standaloneDerivationPaths) {
@@ -997,12 +1054,15 @@
     }
 
     for (NSString *address in allAddressesArray) {
+        if (missingAddresses) break;
         NSData *hash = address.addressToHash160;
 
         if (!hash || [_bloomFilter containsData:hash]) continue;
+        missingAddresses = YES;
+    }
+    if (missingAddresses) {
         _bloomFilter = nil; // reset bloom filter so it's recreated with new wallet addresses
         [self.peerManager updateFilterOnPeers];
-        break;
     }
 }
 
@@ -1165,6 +1225,12 @@
 
 //The peer has sent us a transaction we are interested in and that we did not send ourselves
 - (void)peer:(DSPeer *)peer relayedTransaction:(DSTransaction *)transaction inBlock:(DSBlock *)block {
+    // a block behind the header chain is applied once the blocks before it arrived, its transactions with it
+    if (block && [self.chainManager.merkleBlockBackfill receivedTransaction:transaction inBlock:block]) return;
+    [self registerRelayedTransaction:transaction inBlock:block fromPeer:peer];
+}
+
+- (void)registerRelayedTransaction:(DSTransaction *)transaction inBlock:(DSBlock *)block fromPeer:(DSPeer *)peer {
     NSValue *hash = uint256_obj(transaction.txHash);
     BOOL syncing = (self.chain.lastSyncBlockHeight < self.chain.estimatedBlockHeight);
     void (^callback)(NSError *error) = self.publishedCallback[hash];
@@ -1197,6 +1263,7 @@
     NSMutableArray<DSAccount *> *accountsSendingValueInTransaction = [NSMutableArray array];
     if (!accounts.count) {
         if (![self.chain transactionHasLocalReferences:transaction]) {
+            [self recordSeenTransactionHash:transaction.txHash];
             return;
         }
     } else {
@@ -1212,6 +1279,7 @@
             }
         }
         if (accountsAcceptingTransaction.count == 0) {
+            [self recordSeenTransactionHash:transaction.txHash];
             return;
         }
     }
@@ -1269,7 +1337,11 @@
     DSInstantSendTransactionLock *transactionLockReceivedEarlier = [self.instantSendLocksWaitingForTransactions objectForKey:uint256_data(transaction.txHash)];
 
     if (transactionLockReceivedEarlier) {
-        [self.instantSendLocksWaitingForTransactions removeObjectForKey:uint256_data(transaction.txHash)];
+        // locks for transactions we didn't know about were not verified when they came in
+        [self removeInstantSendLockWaitingForTransactionHash:uint256_data(transaction.txHash)];
+        if (![transactionLockReceivedEarlier verifySignatureUsingIngestion:self.instantSendLockIngestion] && !transactionLockReceivedEarlier.intendedQuorum) {
+            [self.instantSendLocksWaitingForQuorums setObject:transactionLockReceivedEarlier forKey:uint256_data(transaction.txHash)];
+        }
         [transaction setInstantSendReceivedWithInstantSendLock:transactionLockReceivedEarlier];
         [transactionLockReceivedEarlier saveInitial];
     }
@@ -1356,6 +1428,7 @@
             [blockchainIdentity.wallet setGuessedWalletCreationTime:self.chain.lastSyncBlockTimestamp - HOUR_TIME_INTERVAL - (DAY_TIME_INTERVAL / arc4random() % DAY_TIME_INTERVAL)];
         }
         [self.identitiesManager checkCreditFundingTransactionForPossibleNewIdentity:(DSCreditFundingTransaction *)transaction];
+        [blockchainIdentity.wallet invalidateBlockZones];
         [self destroyTransactionsBloomFilter]; //We want to destroy it temporarily, while we wait for L2, no matter what the block should not be saved and needs to be refetched
     } else if (addedNewAccount) {
         [self destroyTransactionsBloomFilter];
@@ -1454,23 +1527,25 @@
         return; //no point to retrieve the instant send lock if we already have it
     }
 
-    BOOL verified = [instantSendTransactionLock verifySignature];
+    if (!account || !transaction) {
+        // verifying is deferred until the transaction shows up, most locks are for transactions that aren't ours
+        [self addInstantSendLockWaitingForTransaction:instantSendTransactionLock];
+        return;
+    }
+
+    BOOL verified = [instantSendTransactionLock verifySignatureUsingIngestion:self.instantSendLockIngestion];
     DSLogInfo(@"DSTransactionManager", @"InstantSend lock for tx %@ verified: %@",
               uint256_reverse_hex(instantSendTransactionLock.transactionHash), verified ? @"YES" : @"NO");
 
-    if (account && transaction) {
-        [transaction setInstantSendReceivedWithInstantSendLock:instantSendTransactionLock];
-        [instantSendTransactionLock saveInitial];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            [[NSNotificationCenter defaultCenter] postNotificationName:DSTransactionManagerTransactionStatusDidChangeNotification
-                                                                object:nil
-                                                              userInfo:@{DSChainManagerNotificationChainKey: self.chain,
-                                                                  DSTransactionManagerNotificationTransactionKey: transaction,
-                                                                  DSTransactionManagerNotificationTransactionChangesKey: @{DSTransactionManagerNotificationInstantSendTransactionLockKey: instantSendTransactionLock, DSTransactionManagerNotificationInstantSendTransactionLockVerifiedKey: @(verified)}}];
-        });
-    } else {
-        [self.instantSendLocksWaitingForTransactions setObject:instantSendTransactionLock forKey:uint256_data(instantSendTransactionLock.transactionHash)];
-    }
+    [transaction setInstantSendReceivedWithInstantSendLock:instantSendTransactionLock];
+    [instantSendTransactionLock saveInitial];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [[NSNotificationCenter defaultCenter] postNotificationName:DSTransactionManagerTransactionStatusDidChangeNotification
+                                                            object:nil
+                                                          userInfo:@{DSChainManagerNotificationChainKey: self.chain,
+                                                              DSTransactionManagerNotificationTransactionKey: transaction,
+                                                              DSTransactionManagerNotificationTransactionChangesKey: @{DSTransactionManagerNotificationInstantSendTransactionLockKey: instantSendTransactionLock, DSTransactionManagerNotificationInstantSendTransactionLockVerifiedKey: @(verified)}}];
+    });
 
     if (!verified && !instantSendTransactionLock.intendedQuorum) {
         //the quorum hasn't been retrieved yet
@@ -1478,11 +1553,27 @@
     }
 }
 
+// most of these locks are for transactions that will never be ours, the oldest are dropped past the capacity
+- (void)addInstantSendLockWaitingForTransaction:(DSInstantSendTransactionLock *)instantSendTransactionLock {
+    NSData *transactionHashData = uint256_data(instantSendTransactionLock.transactionHash);
+    [self.instantSendLocksWaitingForTransactions setObject:instantSendTransactionLock forKey:transactionHashData];
+    [self.instantSendLockWaitingTransactionHashes removeObject:transactionHashData];
+    [self.instantSendLockWaitingTransactionHashes addObject:transactionHashData];
+    if (self.instantSendLockWaitingTransactionHashes.count > INSTANT_SEND_LOCKS_WAITING_FOR_TRANSACTIONS_CAPACITY) {
+        [self removeInstantSendLockWaitingForTransactionHash:self.instantSendLockWaitingTransactionHashes.firstObject];
+    }
+}
+
+- (void)removeInstantSendLockWaitingForTransactionHash:(NSData *)transactionHashData {
+    [self.instantSendLocksWaitingForTransactions removeObjectForKey:transactionHashData];
+    [self.instantSendLockWaitingTransactionHashes removeObject:transactionHashData];
+}
+
 - (void)checkInstantSendLocksWaitingForQuorums {
     for (NSData *transactionHashData in [self.instantSendLocksWaitingForQuorums copy]) {
         if (self.instantSendLocksWaitingForTransactions[transactionHashData]) continue;
         DSInstantSendTransactionLock *instantSendTransactionLock = self.instantSendLocksWaitingForQuorums[transactionHashData];
-        BOOL verified = [instantSendTransactionLock verifySignature];
+        BOOL verified = [instantSendTransactionLock verifySignatureUsingIngestion:self.instantSendLockIngestion];
         if (verified) {
             [instantSendTransactionLock saveSignatureValid];
             DSTransaction *transaction = nil;
@@ -1521,10 +1612,11 @@
 
 - (void)peer:(DSPeer *)peer relayedHeader:(DSMerkleBlock *)block {
     //DSLogPrivate(@"relayed block %@ total transactions %d %u",uint256_hex(block.blockHash), block.totalTransactions,block.timestamp);
-    // ignore block headers that are newer than 2 days before earliestKeyTime (headers have 0 totalTransactions)
+    // ignore block headers that are newer than 2 days before earliestKeyTime (headers have 0 totalTransactions), unless
+    // the wallets had nothing in the zones being synced
     if (!self.chain.needsInitialTerminalHeadersSync &&
         (self.chain.earliestWalletCreationTime < block.timestamp + DAY_TIME_INTERVAL * 2) &&
-        !self.chainManager.chainSynchronizationFingerprint) {
+        [self.chainManager shouldRequestMerkleBlocksForZoneAfterHeight:self.chain.lastSyncBlockHeight + 1]) {
         return;
     }
 
@@ -1575,6 +1667,15 @@
         return;
     }
 
+    DSMerkleBlockBackfill *backfill = self.chainManager.merkleBlockBackfill;
+    if (backfill && [backfill containsBlockHash:block.blockHash]) { // behind the header chain, applied once the blocks before it arrived
+        if (!peer.needsFilterUpdate && [backfill receivedBlock:block fromPeer:peer]) {
+            [self.chainManager relayedNewItem];
+            [self.chainManager requestMerkleBlockBackfillRanges];
+        }
+        return;
+    }
+
 #if !SAVE_MAX_TRANSACTIONS_INFO
     [self.chain addBlock:block receivedAsHeader:NO fromPeer:peer];
 #else
@@ -1626,7 +1727,15 @@
 - (void)peer:(DSPeer *)peer relayedChainLock:(DSChainLock *)chainLock {
     DSLogInfo(@"DSTransactionManager", @"received ChainLock for block %@ at height %u from peer %@",
               uint256_reverse_hex(chainLock.blockHash), chainLock.height, peer.host);
-    BOOL verified = [chainLock verifySignature];
+    self.chainLockTracker.tipHeight = MAX(self.chain.lastTerminalBlockHeight, self.chain.estimatedBlockHeight);
+    if (![self.chainLockTracker acceptChainLock:chainLock]) {
+        DSLogDebug(@"DSTransactionManager", @"ChainLock for block %@ already received, superseded or too far above the tip", uint256_reverse_hex(chainLock.blockHash));
+        return;
+    }
+    BOOL verified = [self.chainLockTracker verifyChainLock:chainLock
+                                                usingBlock:^BOOL(DSChainLock *lock) {
+                                                    return [lock verifySignature];
+                                                }];
     DSLogInfo(@"DSTransactionManager", @"ChainLock for block %@ verified: %@",
               uint256_reverse_hex(chainLock.blockHash), verified ? @"YES" : @"NO");
 
@@ -1639,38 +1748,39 @@
         dispatch_async(dispatch_get_main_queue(), ^{
             [[NSNotificationCenter defaultCenter] postNotificationName:DSChainBlockWasLockedNotification object:nil userInfo:@{DSChainManagerNotificationChainKey: self.chain, DSChainNotificationBlockKey: block}];
         });
-    } else {
+    } else if (verified || !self.chainLocksWaitingForMerkleBlocks[uint256_data(chainLock.blockHash)]) {
         [self.chainLocksWaitingForMerkleBlocks setObject:chainLock forKey:uint256_data(chainLock.blockHash)];
     }
 
     if (!verified && !chainLock.intendedQuorum) {
         //the quorum hasn't been retrieved yet
-        [self.chainLocksWaitingForQuorums setObject:chainLock forKey:uint256_data(chainLock.blockHash)];
+        [self.chainLockTracker addChainLockWaitingForQuorum:chainLock];
     }
 }
 
 - (void)checkChainLocksWaitingForQuorums {
-    for (NSData *chainLockHashData in [self.chainLocksWaitingForQuorums copy]) {
-        if (self.chainLocksWaitingForMerkleBlocks[chainLockHashData]) continue;
-        DSChainLock *chainLock = self.chainLocksWaitingForQuorums[chainLockHashData];
-        BOOL verified = [chainLock verifySignature];
-        if (verified) {
-            [chainLock saveSignatureValid];
-            DSMerkleBlock *block = [self.chain blockForBlockHash:chainLock.blockHash];
-            [self.chainLocksWaitingForQuorums removeObjectForKey:chainLockHashData];
-            dispatch_async(dispatch_get_main_queue(), ^{
-                if (self.chain && block) {
-                    NSDictionary *userInfo = @{
-                        DSChainManagerNotificationChainKey: self.chain,
-                        DSChainNotificationBlockKey: block
-                    };
-                    dispatch_async(dispatch_get_main_queue(), ^{
-                        [[NSNotificationCenter defaultCenter] postNotificationName:DSChainBlockWasLockedNotification object:nil userInfo:userInfo];
-                    });
-                }
-            });
+    // only the highest valid lock is kept, the lower waiting ones are superseded by it
+    // locks still waiting for their merkleblock are not verified yet
+    NSSet<NSData *> *blockHashesWaitingForMerkleBlocks = [NSSet setWithArray:self.chainLocksWaitingForMerkleBlocks.allKeys];
+    DSChainLock *chainLock = [self.chainLockTracker verifyWaitingChainLocksExcludingBlockHashes:blockHashesWaitingForMerkleBlocks
+                                                                                     usingBlock:^BOOL(DSChainLock *lock) {
+                                                                                         return [lock verifySignature];
+                                                                                     }
+                                                                               quorumKnownBlock:^BOOL(DSChainLock *lock) {
+                                                                                         return [lock isSigningQuorumKnown];
+                                                                                     }];
+    if (!chainLock) return;
+    [chainLock saveSignatureValid];
+    DSMerkleBlock *block = [self.chain blockForBlockHash:chainLock.blockHash];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (self.chain && block) {
+            NSDictionary *userInfo = @{
+                DSChainManagerNotificationChainKey: self.chain,
+                DSChainNotificationBlockKey: block
+            };
+            [[NSNotificationCenter defaultCenter] postNotificationName:DSChainBlockWasLockedNotification object:nil userInfo:userInfo];
         }
-    }
+    });
 }
 
 // MARK: Fees
@@ -1695,8 +1805,7 @@
 }
 
 - (DSChainLock * _Nullable)chainLockForBlockHash:(UInt256)blockHash {
-    DSChainLock *chainLock = [self.chainLocksWaitingForQuorums objectForKey:uint256_data(blockHash)];
-    return chainLock;
+    return [self.chainLockTracker waitingChainLockForBlockHash:blockHash];
 }
 
 @end
@@ -0,0 +1,90 @@
+//
+//  DSAddressManager.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define ADDRESS_MANAGER_NEW_BUCKET_COUNT 256
+#define ADDRESS_MANAGER_TRIED_BUCKET_COUNT 64
+#define ADDRESS_MANAGER_BUCKET_SIZE 64
+#define ADDRESS_MANAGER_NEW_BUCKETS_PER_SOURCE_GROUP 32
+#define ADDRESS_MANAGER_TRIED_BUCKETS_PER_GROUP 8
+#define ADDRESS_MANAGER_MAX_BANNED_COUNT 1024
+
+// network ids from BIP155: https://github.com/bitcoin/bips/blob/master/bip-0155.mediawiki
+typedef NS_ENUM(uint8_t, DSNetworkAddressType)
+{
+    DSNetworkAddressType_IPv4 = 1,
+    DSNetworkAddressType_IPv6 = 2,
+    DSNetworkAddressType_TorV2 = 3,
+    DSNetworkAddressType_TorV3 = 4,
+    DSNetworkAddressType_I2P = 5,
+    DSNetworkAddressType_CJDNS = 6,
+};
+
+// IPv4 and IPv6 addresses are kept in the first 16 bytes as IPv4 mapped IPv6 like DSPeer, the others as sent in addrv2
+typedef struct {
+    DSNetworkAddressType type;
+    uint8_t bytes[32];
+    uint16_t port;
+    uint64_t services;
+    uint32_t timestamp;
+} DSNetworkAddress;
+
+@class DSChain, DSPeer;
+
+/*! @brief Candidate peers of a chain, bucketed by network group like the address manager of Dash Core. Relayed addresses go to a table of new addresses, in a bucket picked from the group of the address and of the peer that relayed it, and move to a table of tried addresses once connected to. A group can only fill a few buckets however many addresses it relays. Selection is random across both tables, weighted by failed attempts and latency. */
+@interface DSAddressManager : NSObject
+
+@property (nonatomic, readonly) DSChain *chain;
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic, readonly) NSUInteger newCount;
+@property (nonatomic, readonly) NSUInteger triedCount;
+
+- (instancetype)initWithChain:(DSChain *)chain;
+
++ (DSNetworkAddress)networkAddressOfPeer:(DSPeer *)peer;
+/*! @brief Network group used for bucketing, /16 for IPv4, /32 for IPv6 and the first 4 bits of overlay network addresses. */
++ (NSData *)groupOfNetworkAddress:(DSNetworkAddress)address;
+
+/*! @brief Adds an address relayed by the source peer, or from DNS seeds and fixed lists when there is no source. NO if it was already known, banned, or its bucket is taken by a better address. */
+- (BOOL)addNetworkAddress:(DSNetworkAddress)address fromSource:(DSPeer *_Nullable)source;
+- (NSUInteger)addNetworkAddresses:(NSArray<NSValue *> *)addresses fromSource:(DSPeer *_Nullable)source;
+- (NSUInteger)addPeers:(NSArray<DSPeer *> *)peers fromSource:(DSPeer *_Nullable)source;
+
+/*! @brief A reachable peer to connect to, outside the network groups of the excluded peers when possible. */
+- (DSPeer *_Nullable)selectPeerExcludingPeers:(NSSet<DSPeer *> *)excludedPeers;
+- (DSPeer *_Nullable)peerAtAddress:(UInt128)address port:(uint16_t)port;
+- (NSUInteger)countOfAddressesSeenSince:(NSTimeInterval)timestamp;
+
+- (void)markAttemptToPeer:(DSPeer *)peer;
+/*! @brief Moves the peer to the tried table and records its latency. */
+- (void)markPeerConnected:(DSPeer *)peer;
+/*! @brief Keeps the preferences of the peer set during the session. */
+- (void)updatePeer:(DSPeer *)peer;
+- (void)banPeer:(DSPeer *)peer;
+- (void)removeAllAddresses;
+
+- (NSData *)serializedData;
+/*! @brief Replaces the addresses with the ones serialized, NO if the data is not a valid serialization. */
+- (BOOL)loadSerializedData:(NSData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
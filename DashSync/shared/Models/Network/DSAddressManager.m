@@ -0,0 +1,542 @@
+//
+//  DSAddressManager.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSAddressManager.h"
+#import "DSPeer.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+#define ADDRESS_MANAGER_FILE_MAGIC 0x4d415344 // DSAM
+#define ADDRESS_MANAGER_FILE_VERSION 1
+#define ADDRESS_MANAGER_RECORD_LENGTH 88
+#define ADDRESS_MANAGER_BANNED_RECORD_LENGTH 35
+#define ADDRESS_MANAGER_NEW_SLOT_COUNT (ADDRESS_MANAGER_NEW_BUCKET_COUNT * ADDRESS_MANAGER_BUCKET_SIZE)
+#define ADDRESS_MANAGER_TRIED_SLOT_COUNT (ADDRESS_MANAGER_TRIED_BUCKET_COUNT * ADDRESS_MANAGER_BUCKET_SIZE)
+#define ADDRESS_MANAGER_SELECT_ATTEMPTS 2048
+#define ADDRESS_MANAGER_REFERENCE_LATENCY 0.5 // seconds, a peer this slow is picked half as often
+
+typedef NS_ENUM(uint8_t, DSAddressTable)
+{
+    DSAddressTable_None,
+    DSAddressTable_New,
+    DSAddressTable_Tried,
+};
+
+typedef struct {
+    DSNetworkAddress address;
+    uint64_t sourceGroup;
+    uint32_t lastTry, lastSuccess;
+    uint32_t lowPreferenceTill, lastRequestedMasternodeList, lastRequestedGovernanceSync, priority;
+    uint32_t latency; // milliseconds, averaged over the connections made
+    uint16_t attempts, successes;
+    uint32_t slot, tableIndex; // position in the buckets of its table and in the list selected from
+    DSAddressTable table;
+} DSAddressEntry;
+
+static inline BOOL is_ipv4_mapped(const uint8_t *bytes) {
+    static const uint8_t prefix[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+    return memcmp(bytes, prefix, sizeof(prefix)) == 0;
+}
+
+@interface DSAddressManager () {
+    DSAddressEntry *_entries;
+    uint32_t *_freeEntryIds;
+    NSUInteger _entryCapacity, _entryHighWater, _freeEntryCount;
+    uint32_t _newSlots[ADDRESS_MANAGER_NEW_SLOT_COUNT], _triedSlots[ADDRESS_MANAGER_TRIED_SLOT_COUNT]; // entry id + 1, zero when empty
+    uint32_t _newIds[ADDRESS_MANAGER_NEW_SLOT_COUNT], _triedIds[ADDRESS_MANAGER_TRIED_SLOT_COUNT];
+    NSUInteger _newCount, _triedCount;
+    UInt256 _key;
+}
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) NSMutableDictionary<NSData *, NSNumber *> *entryIds;
+@property (nonatomic, strong) NSMutableOrderedSet<NSData *> *bannedAddresses;
+
+@end
+
+@implementation DSAddressManager
+
+- (instancetype)initWithChain:(DSChain *)chain {
+    NSParameterAssert(chain);
+    if (!(self = [super init])) return nil;
+    self.chain = chain;
+    self.entryIds = [NSMutableDictionary dictionary];
+    self.bannedAddresses = [NSMutableOrderedSet orderedSet];
+    arc4random_buf(&_key, sizeof(_key));
+    return self;
+}
+
+- (void)dealloc {
+    free(_entries);
+    free(_freeEntryIds);
+}
+
+- (NSUInteger)count {
+    @synchronized(self) {
+        return _newCount + _triedCount;
+    }
+}
+
+- (NSUInteger)newCount {
+    @synchronized(self) {
+        return _newCount;
+    }
+}
+
+- (NSUInteger)triedCount {
+    @synchronized(self) {
+        return _triedCount;
+    }
+}
+
+// MARK: - Addresses
+
++ (DSNetworkAddress)networkAddressOfPeer:(DSPeer *)peer {
+    DSNetworkAddress address = {.port = peer.port, .services = peer.services, .timestamp = (uint32_t)MAX(peer.timestamp, 0)};
+    UInt128 ipAddress = peer.address;
+    memcpy(address.bytes, ipAddress.u8, sizeof(UInt128));
+    address.type = is_ipv4_mapped(address.bytes) ? DSNetworkAddressType_IPv4 : DSNetworkAddressType_IPv6;
+    return address;
+}
+
++ (NSData *)groupOfNetworkAddress:(DSNetworkAddress)address {
+    NSMutableData *group = [NSMutableData data];
+    [group appendUInt8:address.type];
+    switch (address.type) {
+        case DSNetworkAddressType_IPv4:
+            [group appendBytes:address.bytes + 12 length:2];
+            break;
+        case DSNetworkAddressType_IPv6:
+            [group appendBytes:address.bytes length:4];
+            break;
+        default:
+            [group appendUInt8:address.bytes[0] & 0xf0];
+            break;
+    }
+    return group;
+}
+
++ (NSData *)keyOfNetworkAddress:(const DSNetworkAddress *)address {
+    NSMutableData *key = [NSMutableData dataWithCapacity:ADDRESS_MANAGER_BANNED_RECORD_LENGTH];
+    [key appendUInt8:address->type];
+    [key appendBytes:address->bytes length:sizeof(address->bytes)];
+    [key appendUInt16:address->port];
+    return key;
+}
+
++ (BOOL)isReachable:(const DSNetworkAddress *)address {
+    return address->type == DSNetworkAddressType_IPv4 || address->type == DSNetworkAddressType_IPv6;
+}
+
+- (DSPeer *)peerOfEntry:(const DSAddressEntry *)entry {
+    UInt128 ipAddress;
+    memcpy(ipAddress.u8, entry->address.bytes, sizeof(UInt128));
+    DSPeer *peer = [[DSPeer alloc] initWithAddress:ipAddress port:entry->address.port onChain:self.chain timestamp:entry->address.timestamp services:entry->address.services];
+    peer.priority = entry->priority;
+    peer.lowPreferenceTill = entry->lowPreferenceTill;
+    peer.lastRequestedMasternodeList = entry->lastRequestedMasternodeList;
+    peer.lastRequestedGovernanceSync = entry->lastRequestedGovernanceSync;
+    return peer;
+}
+
+// MARK: - Buckets
+
+- (uint64_t)hashOfData:(NSData *)data {
+    NSMutableData *keyedData = [NSMutableData dataWithBytes:&_key length:sizeof(_key)];
+    [keyedData appendData:data];
+    return keyedData.SHA256.u64[0];
+}
+
+- (uint64_t)sourceGroupOfPeer:(DSPeer *_Nullable)source {
+    if (!source) return 0;
+    return [self hashOfData:[DSAddressManager groupOfNetworkAddress:[DSAddressManager networkAddressOfPeer:source]]];
+}
+
+- (uint32_t)slotOfEntry:(const DSAddressEntry *)entry inTable:(DSAddressTable)table {
+    NSData *key = [DSAddressManager keyOfNetworkAddress:&entry->address];
+    NSMutableData *data = [NSMutableData dataWithData:[DSAddressManager groupOfNetworkAddress:entry->address]];
+    uint64_t bucket;
+    if (table == DSAddressTable_New) {
+        [data appendUInt64:entry->sourceGroup];
+        NSMutableData *bucketData = [NSMutableData data];
+        [bucketData appendUInt64:entry->sourceGroup];
+        [bucketData appendUInt64:[self hashOfData:data] % ADDRESS_MANAGER_NEW_BUCKETS_PER_SOURCE_GROUP];
+        bucket = [self hashOfData:bucketData] % ADDRESS_MANAGER_NEW_BUCKET_COUNT;
+    } else {
+        [data appendUInt64:[self hashOfData:key] % ADDRESS_MANAGER_TRIED_BUCKETS_PER_GROUP];
+        bucket = [self hashOfData:data] % ADDRESS_MANAGER_TRIED_BUCKET_COUNT;
+    }
+    NSMutableData *positionData = [NSMutableData data];
+    [positionData appendUInt8:table];
+    [positionData appendUInt64:bucket];
+    [positionData appendData:key];
+    return (uint32_t)(bucket * ADDRESS_MANAGER_BUCKET_SIZE + [self hashOfData:positionData] % ADDRESS_MANAGER_BUCKET_SIZE);
+}
+
+// an address not worth keeping when a better one wants its slot
+- (BOOL)isTerrible:(const DSAddressEntry *)entry now:(uint32_t)now {
+    if (entry->lastTry && entry->lastTry + 60 >= now) return NO; // tried in the last minute
+    if (entry->address.timestamp > now + 10 * 60) return YES;
+    if (!entry->address.timestamp || entry->address.timestamp + 30 * DAY_TIME_INTERVAL < now) return YES;
+    if (!entry->lastSuccess && entry->attempts >= 3) return YES;
+    if (entry->lastSuccess + WEEK_TIME_INTERVAL < now && entry->attempts >= 10) return YES;
+    return NO;
+}
+
+- (double)chanceOfEntry:(const DSAddressEntry *)entry now:(uint32_t)now {
+    double chance = 1.0;
+    if (entry->lastTry && entry->lastTry + 10 * 60 > now) chance *= 0.01;
+    chance *= pow(0.66, MIN(entry->attempts, 8));
+    if (entry->latency) chance /= 1.0 + entry->latency / (ADDRESS_MANAGER_REFERENCE_LATENCY * 1000.0);
+    if (entry->lowPreferenceTill > now) chance *= 0.1;
+    return chance;
+}
+
+// MARK: - Tables
+
+- (uint32_t)allocateEntry {
+    if (_freeEntryCount) return _freeEntryIds[--_freeEntryCount];
+    if (_entryHighWater == _entryCapacity) {
+        _entryCapacity = MAX(_entryCapacity * 2, 256);
+        _entries = realloc(_entries, _entryCapacity * sizeof(DSAddressEntry));
+        _freeEntryIds = realloc(_freeEntryIds, _entryCapacity * sizeof(uint32_t));
+    }
+    return (uint32_t)_entryHighWater++;
+}
+
+- (void)removeEntryFromTable:(uint32_t)entryId {
+    DSAddressEntry *entry = &_entries[entryId];
+    BOOL isNew = entry->table == DSAddressTable_New;
+    uint32_t *slots = isNew ? _newSlots : _triedSlots, *ids = isNew ? _newIds : _triedIds;
+    NSUInteger *count = isNew ? &_newCount : &_triedCount;
+    slots[entry->slot] = 0;
+    uint32_t lastId = ids[--(*count)];
+    ids[entry->tableIndex] = lastId;
+    _entries[lastId].tableIndex = entry->tableIndex;
+    entry->table = DSAddressTable_None;
+}
+
+- (void)deleteEntry:(uint32_t)entryId {
+    DSAddressEntry *entry = &_entries[entryId];
+    if (entry->table != DSAddressTable_None) [self removeEntryFromTable:entryId];
+    [self.entryIds removeObjectForKey:[DSAddressManager keyOfNetworkAddress:&entry->address]];
+    _freeEntryIds[_freeEntryCount++] = entryId;
+}
+
+- (void)placeEntry:(uint32_t)entryId inTable:(DSAddressTable)table atSlot:(uint32_t)slot {
+    DSAddressEntry *entry = &_entries[entryId];
+    BOOL isNew = table == DSAddressTable_New;
+    (isNew ? _newSlots : _triedSlots)[slot] = entryId + 1;
+    NSUInteger *count = isNew ? &_newCount : &_triedCount;
+    (isNew ? _newIds : _triedIds)[*count] = entryId;
+    entry->tableIndex = (uint32_t)(*count)++;
+    entry->slot = slot;
+    entry->table = table;
+}
+
+// the entry is deleted when its slot is held by an address still worth keeping
+- (BOOL)addEntryToNewTable:(uint32_t)entryId now:(uint32_t)now {
+    uint32_t slot = [self slotOfEntry:&_entries[entryId] inTable:DSAddressTable_New];
+    uint32_t occupant = _newSlots[slot];
+    if (occupant) {
+        if (![self isTerrible:&_entries[occupant - 1] now:now]) {
+            [self deleteEntry:entryId];
+            return NO;
+        }
+        [self deleteEntry:occupant - 1];
+    }
+    [self placeEntry:entryId inTable:DSAddressTable_New atSlot:slot];
+    return YES;
+}
+
+- (void)moveEntryToTriedTable:(uint32_t)entryId now:(uint32_t)now {
+    if (_entries[entryId].table != DSAddressTable_None) [self removeEntryFromTable:entryId];
+    uint32_t slot = [self slotOfEntry:&_entries[entryId] inTable:DSAddressTable_Tried];
+    uint32_t occupant = _triedSlots[slot];
+    if (occupant) {
+        // the address it replaces goes back to the new table
+        [self removeEntryFromTable:occupant - 1];
+        [self addEntryToNewTable:occupant - 1 now:now];
+    }
+    [self placeEntry:entryId inTable:DSAddressTable_Tried atSlot:slot];
+}
+
+- (NSNumber *)entryIdOfPeer:(DSPeer *)peer {
+    DSNetworkAddress address = [DSAddressManager networkAddressOfPeer:peer];
+    return self.entryIds[[DSAddressManager keyOfNetworkAddress:&address]];
+}
+
+// MARK: - Adding
+
+- (BOOL)addNetworkAddress:(DSNetworkAddress)address fromSource:(DSPeer *)source {
+    if (address.type < DSNetworkAddressType_IPv4 || address.type > DSNetworkAddressType_CJDNS || address.type == DSNetworkAddressType_TorV2) return NO;
+    if (!address.port) return NO;
+    NSData *key = [DSAddressManager keyOfNetworkAddress:&address];
+    uint64_t sourceGroup = [self sourceGroupOfPeer:source];
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    @synchronized(self) {
+        if ([self.bannedAddresses containsObject:key]) return NO;
+        NSNumber *entryId = self.entryIds[key];
+        if (entryId) {
+            DSAddressEntry *entry = &_entries[entryId.unsignedIntValue];
+            if (address.timestamp > entry->address.timestamp && address.timestamp <= now + 10 * 60) entry->address.timestamp = address.timestamp;
+            entry->address.services |= address.services;
+            return NO;
+        }
+        uint32_t newId = [self allocateEntry];
+        _entries[newId] = (DSAddressEntry){.address = address, .sourceGroup = sourceGroup};
+        self.entryIds[key] = @(newId);
+        return [self addEntryToNewTable:newId now:now];
+    }
+}
+
+- (NSUInteger)addNetworkAddresses:(NSArray<NSValue *> *)addresses fromSource:(DSPeer *)source {
+    NSUInteger added = 0;
+    for (NSValue *value in addresses) {
+        DSNetworkAddress address;
+        [value getValue:&address];
+        if ([self addNetworkAddress:address fromSource:source]) added++;
+    }
+    return added;
+}
+
+- (NSUInteger)addPeers:(NSArray<DSPeer *> *)peers fromSource:(DSPeer *)source {
+    NSUInteger added = 0;
+    for (DSPeer *peer in peers) {
+        if ([self addNetworkAddress:[DSAddressManager networkAddressOfPeer:peer] fromSource:source]) added++;
+    }
+    return added;
+}
+
+// MARK: - Selection
+
+- (DSPeer *)selectPeerExcludingKeys:(NSSet<NSData *> *)excludedKeys groups:(NSSet<NSData *> *)excludedGroups {
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    double factor = 1.0;
+    for (NSUInteger i = 0; i < ADDRESS_MANAGER_SELECT_ATTEMPTS && _newCount + _triedCount; i++) {
+        BOOL tried = _triedCount && (!_newCount || arc4random_uniform(2));
+        uint32_t entryId = tried ? _triedIds[arc4random_uniform((uint32_t)_triedCount)] : _newIds[arc4random_uniform((uint32_t)_newCount)];
+        const DSAddressEntry *entry = &_entries[entryId];
+        if (![DSAddressManager isReachable:&entry->address]) continue;
+        if ([excludedKeys containsObject:[DSAddressManager keyOfNetworkAddress:&entry->address]]) continue;
+        if (excludedGroups.count && [excludedGroups containsObject:[DSAddressManager groupOfNetworkAddress:entry->address]]) continue;
+        if (factor * [self chanceOfEntry:entry now:now] * UINT32_MAX > arc4random()) return [self peerOfEntry:entry];
+        factor *= 1.2;
+    }
+    return nil;
+}
+
+- (DSPeer *)selectPeerExcludingPeers:(NSSet<DSPeer *> *)excludedPeers {
+    NSMutableSet<NSData *> *excludedKeys = [NSMutableSet set], *excludedGroups = [NSMutableSet set];
+    for (DSPeer *peer in excludedPeers) {
+        DSNetworkAddress address = [DSAddressManager networkAddressOfPeer:peer];
+        [excludedKeys addObject:[DSAddressManager keyOfNetworkAddress:&address]];
+        [excludedGroups addObject:[DSAddressManager groupOfNetworkAddress:address]];
+    }
+    @synchronized(self) {
+        // small networks may not have enough groups to keep them apart
+        return [self selectPeerExcludingKeys:excludedKeys groups:excludedGroups] ?: [self selectPeerExcludingKeys:excludedKeys groups:nil];
+    }
+}
+
+- (DSPeer *)peerAtAddress:(UInt128)address port:(uint16_t)port {
+    DSNetworkAddress networkAddress = {.port = port};
+    memcpy(networkAddress.bytes, address.u8, sizeof(UInt128));
+    networkAddress.type = is_ipv4_mapped(networkAddress.bytes) ? DSNetworkAddressType_IPv4 : DSNetworkAddressType_IPv6;
+    @synchronized(self) {
+        NSNumber *entryId = self.entryIds[[DSAddressManager keyOfNetworkAddress:&networkAddress]];
+        return entryId ? [self peerOfEntry:&_entries[entryId.unsignedIntValue]] : nil;
+    }
+}
+
+- (NSUInteger)countOfAddressesSeenSince:(NSTimeInterval)timestamp {
+    NSUInteger count = 0;
+    @synchronized(self) {
+        for (NSUInteger i = 0; i < _newCount; i++) {
+            if (_entries[_newIds[i]].address.timestamp >= timestamp) count++;
+        }
+        for (NSUInteger i = 0; i < _triedCount; i++) {
+            if (_entries[_triedIds[i]].address.timestamp >= timestamp) count++;
+        }
+    }
+    return count;
+}
+
+// MARK: - Updates
+
+- (void)markAttemptToPeer:(DSPeer *)peer {
+    @synchronized(self) {
+        NSNumber *entryId = [self entryIdOfPeer:peer];
+        if (!entryId) return;
+        DSAddressEntry *entry = &_entries[entryId.unsignedIntValue];
+        entry->lastTry = (uint32_t)[NSDate timeIntervalSince1970];
+        if (entry->attempts < UINT16_MAX) entry->attempts++;
+    }
+}
+
+- (void)markPeerConnected:(DSPeer *)peer {
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    @synchronized(self) {
+        NSNumber *entryId = [self entryIdOfPeer:peer];
+        if (!entryId) {
+            DSNetworkAddress address = [DSAddressManager networkAddressOfPeer:peer];
+            if ([self.bannedAddresses containsObject:[DSAddressManager keyOfNetworkAddress:&address]]) return;
+            uint32_t newId = [self allocateEntry];
+            _entries[newId] = (DSAddressEntry){.address = address};
+            self.entryIds[[DSAddressManager keyOfNetworkAddress:&address]] = @(newId);
+            entryId = @(newId);
+        }
+        DSAddressEntry *entry = &_entries[entryId.unsignedIntValue];
+        entry->address.timestamp = now;
+        entry->address.services = peer.services ?: entry->address.services;
+        entry->lastTry = entry->lastSuccess = now;
+        entry->attempts = 0;
+        if (entry->successes < UINT16_MAX) entry->successes++;
+        if (peer.pingTime < DBL_MAX) {
+            uint32_t latency = (uint32_t)MIN(peer.pingTime * 1000.0, UINT32_MAX);
+            entry->latency = entry->latency ? (entry->latency + latency) / 2 : MAX(latency, 1);
+        }
+        if (entry->table != DSAddressTable_Tried) [self moveEntryToTriedTable:entryId.unsignedIntValue now:now];
+    }
+}
+
+- (void)updatePeer:(DSPeer *)peer {
+    @synchronized(self) {
+        NSNumber *entryId = [self entryIdOfPeer:peer];
+        if (!entryId) return;
+        DSAddressEntry *entry = &_entries[entryId.unsignedIntValue];
+        entry->priority = peer.priority;
+        entry->lowPreferenceTill = (uint32_t)MAX(peer.lowPreferenceTill, 0);
+        entry->lastRequestedMasternodeList = (uint32_t)MAX(peer.lastRequestedMasternodeList, 0);
+        entry->lastRequestedGovernanceSync = (uint32_t)MAX(peer.lastRequestedGovernanceSync, 0);
+    }
+}
+
+- (void)banPeer:(DSPeer *)peer {
+    DSNetworkAddress address = [DSAddressManager networkAddressOfPeer:peer];
+    NSData *key = [DSAddressManager keyOfNetworkAddress:&address];
+    @synchronized(self) {
+        NSNumber *entryId = self.entryIds[key];
+        if (entryId) [self deleteEntry:entryId.unsignedIntValue];
+        [self.bannedAddresses addObject:key];
+        if (self.bannedAddresses.count > ADDRESS_MANAGER_MAX_BANNED_COUNT) [self.bannedAddresses removeObjectAtIndex:0];
+    }
+}
+
+- (void)removeAllAddresses {
+    @synchronized(self) {
+        [self.entryIds removeAllObjects];
+        [self.bannedAddresses removeAllObjects];
+        memset(_newSlots, 0, sizeof(_newSlots));
+        memset(_triedSlots, 0, sizeof(_triedSlots));
+        _newCount = _triedCount = _entryHighWater = _freeEntryCount = 0;
+    }
+}
+
+// MARK: - Serialization
+
+- (void)appendEntry:(const DSAddressEntry *)entry toData:(NSMutableData *)data {
+    [data appendUInt8:entry->address.type];
+    [data appendBytes:entry->address.bytes length:sizeof(entry->address.bytes)];
+    [data appendUInt16:entry->address.port];
+    [data appendUInt64:entry->address.services];
+    [data appendUInt32:entry->address.timestamp];
+    [data appendUInt64:entry->sourceGroup];
+    [data appendUInt32:entry->lastTry];
+    [data appendUInt32:entry->lastSuccess];
+    [data appendUInt32:entry->lowPreferenceTill];
+    [data appendUInt32:entry->lastRequestedMasternodeList];
+    [data appendUInt32:entry->lastRequestedGovernanceSync];
+    [data appendUInt32:entry->priority];
+    [data appendUInt32:entry->latency];
+    [data appendUInt16:entry->attempts];
+    [data appendUInt16:entry->successes];
+    [data appendUInt8:entry->table];
+}
+
+- (NSData *)serializedData {
+    @synchronized(self) {
+        NSMutableData *data = [NSMutableData dataWithCapacity:48 + (_newCount + _triedCount) * ADDRESS_MANAGER_RECORD_LENGTH + self.bannedAddresses.count * ADDRESS_MANAGER_BANNED_RECORD_LENGTH];
+        [data appendUInt32:ADDRESS_MANAGER_FILE_MAGIC];
+        [data appendUInt32:ADDRESS_MANAGER_FILE_VERSION];
+        [data appendUInt256:_key];
+        [data appendUInt32:(uint32_t)(_newCount + _triedCount)];
+        [data appendUInt32:(uint32_t)self.bannedAddresses.count];
+        // tried first so they get their slots back before new addresses are placed
+        for (NSUInteger i = 0; i < _triedCount; i++) {
+            [self appendEntry:&_entries[_triedIds[i]] toData:data];
+        }
+        for (NSUInteger i = 0; i < _newCount; i++) {
+            [self appendEntry:&_entries[_newIds[i]] toData:data];
+        }
+        for (NSData *key in self.bannedAddresses) {
+            [data appendData:key];
+        }
+        return data;
+    }
+}
+
+- (BOOL)loadSerializedData:(NSData *)data {
+    if (data.length < 48 || [data UInt32AtOffset:0] != ADDRESS_MANAGER_FILE_MAGIC || [data UInt32AtOffset:4] != ADDRESS_MANAGER_FILE_VERSION) return NO;
+    uint32_t entryCount = [data UInt32AtOffset:40], bannedCount = [data UInt32AtOffset:44];
+    if (entryCount > ADDRESS_MANAGER_NEW_SLOT_COUNT + ADDRESS_MANAGER_TRIED_SLOT_COUNT || bannedCount > ADDRESS_MANAGER_MAX_BANNED_COUNT) return NO;
+    if (data.length != 48 + (NSUInteger)entryCount * ADDRESS_MANAGER_RECORD_LENGTH + (NSUInteger)bannedCount * ADDRESS_MANAGER_BANNED_RECORD_LENGTH) return NO;
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    @synchronized(self) {
+        [self removeAllAddresses];
+        _key = [data UInt256AtOffset:8];
+        NSUInteger offset = 48;
+        for (uint32_t i = 0; i < entryCount; i++) {
+            DSAddressEntry entry = {0};
+            entry.address.type = [data readUInt8AtOffset:&offset];
+            memcpy(entry.address.bytes, (const uint8_t *)data.bytes + offset, sizeof(entry.address.bytes));
+            offset += sizeof(entry.address.bytes);
+            entry.address.port = [data readUInt16AtOffset:&offset];
+            entry.address.services = [data readUInt64AtOffset:&offset];
+            entry.address.timestamp = [data readUInt32AtOffset:&offset];
+            entry.sourceGroup = [data readUInt64AtOffset:&offset];
+            entry.lastTry = [data readUInt32AtOffset:&offset];
+            entry.lastSuccess = [data readUInt32AtOffset:&offset];
+            entry.lowPreferenceTill = [data readUInt32AtOffset:&offset];
+            entry.lastRequestedMasternodeList = [data readUInt32AtOffset:&offset];
+            entry.lastRequestedGovernanceSync = [data readUInt32AtOffset:&offset];
+            entry.priority = [data readUInt32AtOffset:&offset];
+            entry.latency = [data readUInt32AtOffset:&offset];
+            entry.attempts = [data readUInt16AtOffset:&offset];
+            entry.successes = [data readUInt16AtOffset:&offset];
+            DSAddressTable table = [data readUInt8AtOffset:&offset];
+            NSData *key = [DSAddressManager keyOfNetworkAddress:&entry.address];
+            if (self.entryIds[key]) continue;
+            uint32_t entryId = [self allocateEntry];
+            _entries[entryId] = entry;
+            self.entryIds[key] = @(entryId);
+            uint32_t slot = [self slotOfEntry:&entry inTable:DSAddressTable_Tried];
+            if (table == DSAddressTable_Tried && !_triedSlots[slot]) {
+                [self placeEntry:entryId inTable:DSAddressTable_Tried atSlot:slot];
+            } else {
+                [self addEntryToNewTable:entryId now:now];
+            }
+        }
+        for (uint32_t i = 0; i < bannedCount; i++) {
+            [self.bannedAddresses addObject:[data subdataWithRange:NSMakeRange(offset, ADDRESS_MANAGER_BANNED_RECORD_LENGTH)]];
+            offset += ADDRESS_MANAGER_BANNED_RECORD_LENGTH;
+        }
+        return YES;
+    }
+}
+
+@end
@@ -0,0 +1,58 @@
+//
+//  DSDNSSeedResolver.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define DNS_SEED_MIN_TTL 60
+#define DNS_SEED_MAX_TTL 86400 //24*60*60
+// cached addresses past their TTL are only used when a seed doesn't answer, and not after this long
+#define DNS_SEED_MAX_STALE_AGE 604800 //7*24*60*60
+
+typedef void (^DSDNSResolverCompletionBlock)(NSArray<NSValue *> *ipAddresses, NSTimeInterval ttl, NSError *_Nullable error);
+
+/*! @brief Looks up the A and AAAA records of a host without blocking the caller. */
+@protocol DSDNSResolver <NSObject>
+
+/*! @brief Calls back once, on any queue, with the UInt128 addresses of the host, IPv4 ones mapped to IPv6, and the lowest TTL of the records. */
+- (void)resolveHost:(NSString *)host completion:(DSDNSResolverCompletionBlock)completion;
+
+@end
+
+/*! @brief Resolves the DNS seeds of a chain in parallel. Addresses are handed over as each seed answers so connecting can start on the first answer, seeds that don't answer within the timeout are given up on, and answers are cached on disk for as long as their TTL. */
+@interface DSDNSSeedResolver : NSObject
+
+@property (nonatomic, readonly) id<DSDNSResolver> resolver;
+
+/*! @brief Without a cache path answers are only cached in memory. */
+- (instancetype)initWithResolver:(id<DSDNSResolver>)resolver cachePath:(NSString *_Nullable)cachePath;
+
+/*! @brief The addresses handler receives DSNetworkAddress values on the queue, once per seed that gave any. The completion runs on the queue after every seed has answered or timed out. */
+- (void)resolveSeeds:(NSArray<NSString *> *)seeds
+                port:(uint16_t)port
+             timeout:(NSTimeInterval)timeout
+               queue:(dispatch_queue_t)queue
+    addressesHandler:(void (^)(NSString *seed, NSArray<NSValue *> *addresses))addressesHandler
+          completion:(void (^)(NSUInteger addressCount))completion;
+
+- (void)removeCachedSeeds;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,182 @@
+//
+//  DSDNSSeedResolver.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSDNSSeedResolver.h"
+#import "DSAddressManager.h"
+#import "DSLogger.h"
+#import "DSPeer.h"
+#import "NSDate+Utils.h"
+
+#define CACHE_RESOLVED_KEY @"resolved"
+#define CACHE_EXPIRY_KEY @"expiry"
+#define CACHE_ADDRESSES_KEY @"addresses"
+
+@interface DSDNSSeedResolver ()
+
+@property (nonatomic, strong) id<DSDNSResolver> resolver;
+@property (nonatomic, copy) NSString *cachePath;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSDictionary *> *cache;
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+@end
+
+@implementation DSDNSSeedResolver
+
+- (instancetype)initWithResolver:(id<DSDNSResolver>)resolver cachePath:(NSString *)cachePath {
+    NSParameterAssert(resolver);
+
+    if (!(self = [super init])) return nil;
+
+    self.resolver = resolver;
+    self.cachePath = cachePath;
+    self.queue = dispatch_queue_create("org.dashcore.dashsync.dnsseeds", DISPATCH_QUEUE_SERIAL);
+
+    return self;
+}
+
+// MARK: - Cache
+
+// only called on the queue
+- (NSMutableDictionary<NSString *, NSDictionary *> *)cache {
+    if (!_cache) {
+        NSDictionary *storedCache = self.cachePath ? [NSDictionary dictionaryWithContentsOfFile:self.cachePath] : nil;
+        _cache = [NSMutableDictionary dictionary];
+        for (NSString *seed in storedCache) {
+            NSDictionary *entry = storedCache[seed];
+            if (![seed isKindOfClass:[NSString class]] || ![entry isKindOfClass:[NSDictionary class]]) continue;
+            NSData *addresses = entry[CACHE_ADDRESSES_KEY];
+            if (![addresses isKindOfClass:[NSData class]] || addresses.length == 0 || addresses.length % sizeof(UInt128) != 0) continue;
+            if (![entry[CACHE_RESOLVED_KEY] isKindOfClass:[NSNumber class]] || ![entry[CACHE_EXPIRY_KEY] isKindOfClass:[NSNumber class]]) continue;
+            _cache[seed] = entry;
+        }
+    }
+    return _cache;
+}
+
+- (void)saveCache {
+    if (!self.cachePath) return;
+    [self.cache writeToFile:self.cachePath atomically:YES];
+}
+
+- (void)cacheIPAddresses:(NSArray<NSValue *> *)ipAddresses ofSeed:(NSString *)seed ttl:(NSTimeInterval)ttl {
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    NSMutableData *addresses = [NSMutableData dataWithCapacity:ipAddresses.count * sizeof(UInt128)];
+    for (NSValue *value in ipAddresses) {
+        UInt128 ipAddress;
+        [value getValue:&ipAddress];
+        [addresses appendBytes:&ipAddress length:sizeof(ipAddress)];
+    }
+    self.cache[seed] = @{CACHE_RESOLVED_KEY: @(now),
+                         CACHE_EXPIRY_KEY: @(now + MIN(MAX(ttl, DNS_SEED_MIN_TTL), DNS_SEED_MAX_TTL)),
+                         CACHE_ADDRESSES_KEY: addresses};
+    [self saveCache];
+}
+
+- (NSArray<NSValue *> *)ipAddressesOfCacheEntry:(NSDictionary *)entry {
+    NSData *addresses = entry[CACHE_ADDRESSES_KEY];
+    const UInt128 *bytes = addresses.bytes;
+    NSMutableArray<NSValue *> *ipAddresses = [NSMutableArray arrayWithCapacity:addresses.length / sizeof(UInt128)];
+    for (NSUInteger i = 0; i < addresses.length / sizeof(UInt128); i++) {
+        [ipAddresses addObject:[NSValue valueWithBytes:&bytes[i] objCType:@encode(UInt128)]];
+    }
+    return ipAddresses;
+}
+
+- (void)removeCachedSeeds {
+    dispatch_async(self.queue, ^{
+        [self.cache removeAllObjects];
+        if (self.cachePath) [[NSFileManager defaultManager] removeItemAtPath:self.cachePath error:nil];
+    });
+}
+
+// MARK: - Resolution
+
+- (NSArray<NSValue *> *)networkAddressesOfIPAddresses:(NSArray<NSValue *> *)ipAddresses port:(uint16_t)port {
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    NSMutableArray<NSValue *> *addresses = [NSMutableArray arrayWithCapacity:ipAddresses.count];
+    for (NSValue *value in ipAddresses) {
+        UInt128 ipAddress;
+        [value getValue:&ipAddress];
+        DSNetworkAddress address = {.port = port, .services = SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM, .timestamp = now};
+        address.type = (ipAddress.u64[0] == 0 && ipAddress.u32[2] == CFSwapInt32HostToBig(0xffff)) ? DSNetworkAddressType_IPv4 : DSNetworkAddressType_IPv6;
+        memcpy(address.bytes, &ipAddress, sizeof(ipAddress));
+        [addresses addObject:[NSValue valueWithBytes:&address objCType:@encode(DSNetworkAddress)]];
+    }
+    return addresses;
+}
+
+- (void)resolveSeeds:(NSArray<NSString *> *)seeds
+                port:(uint16_t)port
+             timeout:(NSTimeInterval)timeout
+               queue:(dispatch_queue_t)queue
+    addressesHandler:(void (^)(NSString *seed, NSArray<NSValue *> *addresses))addressesHandler
+          completion:(void (^)(NSUInteger addressCount))completion {
+    NSParameterAssert(queue);
+    NSParameterAssert(addressesHandler);
+    NSParameterAssert(completion);
+
+    dispatch_async(self.queue, ^{
+        __block NSUInteger pendingCount = seeds.count, addressCount = 0;
+        if (pendingCount == 0) {
+            dispatch_async(queue, ^{ completion(0); });
+            return;
+        }
+        // only called on the queue, once per seed
+        void (^finishSeed)(NSString *, NSArray<NSValue *> *) = ^(NSString *seed, NSArray<NSValue *> *ipAddresses) {
+            if (ipAddresses.count > 0) {
+                NSArray<NSValue *> *addresses = [self networkAddressesOfIPAddresses:ipAddresses port:port];
+                addressCount += addresses.count;
+                dispatch_async(queue, ^{ addressesHandler(seed, addresses); });
+            }
+            if (--pendingCount == 0) {
+                NSUInteger count = addressCount;
+                dispatch_async(queue, ^{ completion(count); });
+            }
+        };
+
+        NSTimeInterval now = [NSDate timeIntervalSince1970];
+        for (NSString *seed in seeds) {
+            NSDictionary *entry = self.cache[seed];
+            if (entry && [entry[CACHE_EXPIRY_KEY] doubleValue] > now) {
+                finishSeed(seed, [self ipAddressesOfCacheEntry:entry]);
+                continue;
+            }
+            NSArray<NSValue *> *staleIPAddresses = (entry && [entry[CACHE_RESOLVED_KEY] doubleValue] > now - DNS_SEED_MAX_STALE_AGE) ? [self ipAddressesOfCacheEntry:entry] : nil;
+
+            __block BOOL finished = NO;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), self.queue, ^{
+                if (finished) return;
+                finished = YES;
+                DSLogWarn(@"DSDNSSeedResolver", @"%@ did not answer within %.1fs", seed, timeout);
+                finishSeed(seed, staleIPAddresses);
+            });
+            [self.resolver resolveHost:seed
+                            completion:^(NSArray<NSValue *> *ipAddresses, NSTimeInterval ttl, NSError *error) {
+                                dispatch_async(self.queue, ^{
+                                    // answers arriving after the timeout are still cached for the next time
+                                    if (!error && ipAddresses.count > 0) [self cacheIPAddresses:ipAddresses ofSeed:seed ttl:ttl];
+                                    if (finished) return;
+                                    finished = YES;
+                                    if (error) DSLogWarn(@"DSDNSSeedResolver", @"%@ lookup failed: %@", seed, error.localizedDescription);
+                                    finishSeed(seed, (!error && ipAddresses.count > 0) ? ipAddresses : staleIPAddresses);
+                                });
+                            }];
+        }
+    });
+}
+
+@end
@@ -0,0 +1,65 @@
+//
+//  DSInventoryTracker.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define INVENTORY_TRACKER_CAPACITY 16384
+#define INVENTORY_TRACKER_HISTORY_CAPACITY 131072
+#define INVENTORY_TRACKER_PEER_TAG_COUNT 64
+// returned when all tags are in use, a peer can't be attached without a tag
+#define INVENTORY_TRACKER_NO_PEER_TAG NSNotFound
+// marks a hash as known by every peer
+#define INVENTORY_TRACKER_ALL_PEERS (NSNotFound - 1)
+
+typedef NS_ENUM(uint8_t, DSInventoryKind)
+{
+    DSInventoryKind_Transaction,
+    DSInventoryKind_InstantSendLock,
+    DSInventoryKind_InstantSendDeterministicLock,
+    DSInventoryKind_ChainLock,
+    DSInventoryKind_GovernanceObject,
+    DSInventoryKind_GovernanceObjectVote,
+};
+
+/*! @brief Inventory hashes known by the peers of a chain, shared by all of them. The most recent hashes are kept exactly in a fixed size table, each with a bit per peer that announced it or was told about it. Older hashes roll into a two generation bloom filter, which has false positives, so it never decides what a peer knows and is only used to avoid relaying inventory again. Memory is allocated once, whatever the uptime. */
+@interface DSInventoryTracker : NSObject
+
+@property (nonatomic, readonly) NSUInteger capacity;
+@property (nonatomic, readonly) NSUInteger count;
+/*! @brief Bytes held by the table and the filter, fixed at creation. */
+@property (nonatomic, readonly) NSUInteger allocatedSize;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity historyCapacity:(NSUInteger)historyCapacity NS_DESIGNATED_INITIALIZER;
+
+/*! @brief A free peer tag, or INVENTORY_TRACKER_NO_PEER_TAG when all of them are taken. */
+- (NSUInteger)acquirePeerTag;
+/*! @brief Forgets what the peer knew so the tag can be handed out again. */
+- (void)releasePeerTag:(NSUInteger)peerTag;
+
+/*! @brief Whether the peer announced the hash or was told about it while it is in the table. */
+- (BOOL)peer:(NSUInteger)peerTag knowsHash:(UInt256)hash ofKind:(DSInventoryKind)kind;
+/*! @brief Marks the hash as known by the peer and returns whether it already was. A hash that aged out of the table is added back. */
+- (BOOL)markHash:(UInt256)hash ofKind:(DSInventoryKind)kind knownByPeer:(NSUInteger)peerTag;
+/*! @brief Whether the hash aged out of the table, with about one false positive in a million. */
+- (BOOL)historyMayContainHash:(UInt256)hash ofKind:(DSInventoryKind)kind;
+
+@end
+
+NS_ASSUME_NONNULL_END
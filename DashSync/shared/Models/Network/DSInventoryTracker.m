@@ -0,0 +1,217 @@
+//
+//  DSInventoryTracker.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSInventoryTracker.h"
+
+#define INVENTORY_TRACKER_BLOOM_HASH_FUNCTIONS 20
+#define INVENTORY_TRACKER_BLOOM_BITS_PER_ENTRY 29 // about one false positive in a million with 20 hash functions
+
+typedef struct {
+    UInt256 hash;
+    uint64_t peers;
+    uint8_t kind;
+} DSInventoryEntry;
+
+// hashes come from peers, the table and filter positions are keyed with a random seed so they can't be ground to collide
+static inline uint64_t inventory_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+@interface DSInventoryTracker () {
+    DSInventoryEntry *_entries; // ring of the exact entries, the oldest is at _head once full
+    uint32_t *_slots;           // linear probing index into _entries, offset by one so zero is empty
+    uint64_t *_generations[2];
+    NSUInteger _slotMask, _head, _count;
+    NSUInteger _generationBits, _generationCapacity, _generationCount, _currentGeneration;
+    uint64_t _usedPeerTags, _seed[4];
+}
+
+@end
+
+@implementation DSInventoryTracker
+
+- (instancetype)init {
+    return [self initWithCapacity:INVENTORY_TRACKER_CAPACITY historyCapacity:INVENTORY_TRACKER_HISTORY_CAPACITY];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity historyCapacity:(NSUInteger)historyCapacity {
+    NSParameterAssert(capacity > 0 && capacity < UINT32_MAX / 2 && historyCapacity > 1);
+    if (!(self = [super init])) return nil;
+    _capacity = capacity;
+    NSUInteger slotCount = 1;
+    while (slotCount < capacity * 2) slotCount <<= 1;
+    _slotMask = slotCount - 1;
+    _entries = calloc(capacity, sizeof(DSInventoryEntry));
+    _slots = calloc(slotCount, sizeof(uint32_t));
+    _generationCapacity = historyCapacity / 2;
+    _generationBits = (_generationCapacity * INVENTORY_TRACKER_BLOOM_BITS_PER_ENTRY + 63) & ~(NSUInteger)63;
+    _generations[0] = calloc(_generationBits / 64, sizeof(uint64_t));
+    _generations[1] = calloc(_generationBits / 64, sizeof(uint64_t));
+    arc4random_buf(_seed, sizeof(_seed));
+    return self;
+}
+
+- (void)dealloc {
+    free(_entries);
+    free(_slots);
+    free(_generations[0]);
+    free(_generations[1]);
+}
+
+- (NSUInteger)count {
+    @synchronized(self) {
+        return _count;
+    }
+}
+
+- (NSUInteger)allocatedSize {
+    return _capacity * sizeof(DSInventoryEntry) + (_slotMask + 1) * sizeof(uint32_t) + 2 * _generationBits / 8;
+}
+
+// MARK: - Peer Tags
+
+- (NSUInteger)acquirePeerTag {
+    @synchronized(self) {
+        for (NSUInteger tag = 0; tag < INVENTORY_TRACKER_PEER_TAG_COUNT; tag++) {
+            if (_usedPeerTags & (1ULL << tag)) continue;
+            _usedPeerTags |= 1ULL << tag;
+            return tag;
+        }
+        return INVENTORY_TRACKER_NO_PEER_TAG;
+    }
+}
+
+- (void)releasePeerTag:(NSUInteger)peerTag {
+    if (peerTag >= INVENTORY_TRACKER_PEER_TAG_COUNT) return;
+    @synchronized(self) {
+        uint64_t keep = ~(1ULL << peerTag);
+        for (NSUInteger i = 0; i < _count; i++) {
+            _entries[i].peers &= keep;
+        }
+        _usedPeerTags &= keep;
+    }
+}
+
+// MARK: - Lookup
+
+- (NSUInteger)homeSlotOfHash:(UInt256)hash kind:(uint8_t)kind {
+    return (inventory_mix(hash.u64[0] ^ _seed[0] ^ kind) ^ inventory_mix(hash.u64[1] ^ _seed[1])) & _slotMask;
+}
+
+// the slot holding the hash, or the empty slot ending its probe sequence
+- (NSUInteger)slotOfHash:(UInt256)hash kind:(uint8_t)kind {
+    NSUInteger slot = [self homeSlotOfHash:hash kind:kind];
+    while (_slots[slot]) {
+        DSInventoryEntry *entry = &_entries[_slots[slot] - 1];
+        if (entry->kind == kind && uint256_eq(entry->hash, hash)) return slot;
+        slot = (slot + 1) & _slotMask;
+    }
+    return slot;
+}
+
+- (void)removeSlot:(NSUInteger)slot {
+    NSUInteger hole = slot, next = (slot + 1) & _slotMask;
+    while (_slots[next]) {
+        DSInventoryEntry *entry = &_entries[_slots[next] - 1];
+        NSUInteger home = [self homeSlotOfHash:entry->hash kind:entry->kind];
+        if (((next - home) & _slotMask) >= ((next - hole) & _slotMask)) {
+            _slots[hole] = _slots[next];
+            hole = next;
+        }
+        next = (next + 1) & _slotMask;
+    }
+    _slots[hole] = 0;
+}
+
+- (BOOL)historyContainsHash:(UInt256)hash kind:(uint8_t)kind {
+    uint64_t h1 = inventory_mix(hash.u64[2] ^ _seed[2] ^ kind), h2 = inventory_mix(hash.u64[3] ^ _seed[3]) | 1;
+    for (NSUInteger g = 0; g < 2; g++) {
+        uint64_t *bits = _generations[g];
+        uint64_t i = 0;
+        for (; i < INVENTORY_TRACKER_BLOOM_HASH_FUNCTIONS; i++) {
+            uint64_t bit = (h1 + i * h2) % _generationBits;
+            if (!((bits[bit / 64] >> (bit % 64)) & 1)) break;
+        }
+        if (i == INVENTORY_TRACKER_BLOOM_HASH_FUNCTIONS) return YES;
+    }
+    return NO;
+}
+
+- (void)addHashToHistory:(UInt256)hash kind:(uint8_t)kind {
+    if (_generationCount == _generationCapacity) {
+        _currentGeneration ^= 1;
+        memset(_generations[_currentGeneration], 0, _generationBits / 8);
+        _generationCount = 0;
+    }
+    uint64_t *bits = _generations[_currentGeneration];
+    uint64_t h1 = inventory_mix(hash.u64[2] ^ _seed[2] ^ kind), h2 = inventory_mix(hash.u64[3] ^ _seed[3]) | 1;
+    for (uint64_t i = 0; i < INVENTORY_TRACKER_BLOOM_HASH_FUNCTIONS; i++) {
+        uint64_t bit = (h1 + i * h2) % _generationBits;
+        bits[bit / 64] |= 1ULL << (bit % 64);
+    }
+    _generationCount++;
+}
+
+- (BOOL)historyMayContainHash:(UInt256)hash ofKind:(DSInventoryKind)kind {
+    @synchronized(self) {
+        return !_slots[[self slotOfHash:hash kind:kind]] && [self historyContainsHash:hash kind:kind];
+    }
+}
+
+- (BOOL)peer:(NSUInteger)peerTag knowsHash:(UInt256)hash ofKind:(DSInventoryKind)kind {
+    if (peerTag == INVENTORY_TRACKER_NO_PEER_TAG) return NO;
+    @synchronized(self) {
+        NSUInteger slot = [self slotOfHash:hash kind:kind];
+        if (!_slots[slot]) return NO;
+        return peerTag == INVENTORY_TRACKER_ALL_PEERS || (_entries[_slots[slot] - 1].peers & (1ULL << peerTag)) != 0;
+    }
+}
+
+// MARK: - Updates
+
+- (BOOL)markHash:(UInt256)hash ofKind:(DSInventoryKind)kind knownByPeer:(NSUInteger)peerTag {
+    if (peerTag == INVENTORY_TRACKER_NO_PEER_TAG) return NO;
+    uint64_t peers = (peerTag == INVENTORY_TRACKER_ALL_PEERS) ? UINT64_MAX : 1ULL << peerTag;
+    @synchronized(self) {
+        NSUInteger slot = [self slotOfHash:hash kind:kind];
+        if (_slots[slot]) {
+            DSInventoryEntry *entry = &_entries[_slots[slot] - 1];
+            BOOL known = peerTag == INVENTORY_TRACKER_ALL_PEERS || (entry->peers & peers) != 0;
+            entry->peers |= peers;
+            return known;
+        }
+        if (_count == _capacity) {
+            // the oldest entry rolls into the history, which only avoids relaying it again
+            DSInventoryEntry *oldest = &_entries[_head];
+            [self removeSlot:[self slotOfHash:oldest->hash kind:oldest->kind]];
+            [self addHashToHistory:oldest->hash kind:oldest->kind];
+            slot = [self slotOfHash:hash kind:kind];
+        } else {
+            _count++;
+        }
+        _entries[_head] = (DSInventoryEntry){hash, peers, kind};
+        _slots[slot] = (uint32_t)_head + 1;
+        _head = (_head + 1) % _capacity;
+        return NO;
+    }
+}
+
+@end
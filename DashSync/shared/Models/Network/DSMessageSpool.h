@@ -0,0 +1,50 @@
+//
+//  DSMessageSpool.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// payloads from that length on are spooled instead of being read into memory
+#define MESSAGE_SPOOL_MINIMUM_LENGTH 0x00040000
+#define MESSAGE_SPOOL_BUFFER_LENGTH 0x00010000
+
+/*! @brief Writes a message payload to a temporary file as it arrives, hashing it on the way, so that only a buffer of MESSAGE_SPOOL_BUFFER_LENGTH bytes is held in memory. The finished message is mapped from the file, its pages are clean and can be dropped by the system while the message is processed. */
+@interface DSMessageSpool : NSObject
+
+@property (nonatomic, readonly) uint32_t length;
+@property (nonatomic, readonly) uint32_t receivedLength;
+@property (nonatomic, readonly, getter=isComplete) BOOL complete;
+/*! @brief The first four bytes of the double SHA256 of the payload, as found in a message header. Only valid once complete. */
+@property (nonatomic, readonly) uint32_t checksum;
+/*! @brief The most payload bytes held in memory at once. */
+@property (nonatomic, readonly) NSUInteger maximumBufferedLength;
+
++ (BOOL)shouldSpoolMessageOfType:(NSString *)type length:(uint32_t)length;
+
+/*! @brief Nil when the spool file could not be created. */
+- (instancetype _Nullable)initWithLength:(uint32_t)length;
+- (instancetype _Nullable)initWithLength:(uint32_t)length path:(NSString *)path;
+
+/*! @brief Fails when more than the expected length is appended or the spool file can not be written. */
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length;
+/*! @brief The payload mapped from the spool file, which is removed. Nil unless complete. */
+- (NSData *_Nullable)finishedMessage;
+
+@end
+
+NS_ASSUME_NONNULL_END
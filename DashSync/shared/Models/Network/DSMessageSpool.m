@@ -0,0 +1,116 @@
+//
+//  DSMessageSpool.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSMessageSpool.h"
+#import "DSLogger.h"
+#import "DSPeer.h"
+#import <CommonCrypto/CommonDigest.h>
+
+#define MESSAGE_SPOOL_FILE_PREFIX @"DS_MESSAGE_SPOOL_"
+
+@interface DSMessageSpool ()
+
+@property (nonatomic, strong) NSString *path;
+@property (nonatomic, assign) FILE *file;
+@property (nonatomic, strong) NSMutableData *buffer;
+@property (nonatomic, assign) CC_SHA256_CTX hashContext;
+@property (nonatomic, assign) uint32_t length, receivedLength, checksum;
+@property (nonatomic, assign) NSUInteger maximumBufferedLength;
+
+@end
+
+@implementation DSMessageSpool
+
++ (BOOL)shouldSpoolMessageOfType:(NSString *)type length:(uint32_t)length {
+    return length >= MESSAGE_SPOOL_MINIMUM_LENGTH && ([MSG_MNLISTDIFF isEqual:type] || [MSG_QUORUMROTATIONINFO isEqual:type]);
+}
+
+- (instancetype)initWithLength:(uint32_t)length {
+    NSString *fileName = [MESSAGE_SPOOL_FILE_PREFIX stringByAppendingString:[NSUUID UUID].UUIDString];
+    return [self initWithLength:length path:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+- (instancetype)initWithLength:(uint32_t)length path:(NSString *)path {
+    if (!(self = [super init])) return nil;
+    self.file = fopen(path.fileSystemRepresentation, "wb");
+    if (!self.file) {
+        DSLogWarn(@"DSMessageSpool", @"could not create spool file %@ (%d)", path, errno);
+        return nil;
+    }
+    setvbuf(self.file, NULL, _IONBF, 0); // the spool does its own buffering
+    self.path = path;
+    self.length = length;
+    self.buffer = [NSMutableData dataWithCapacity:MESSAGE_SPOOL_BUFFER_LENGTH];
+    CC_SHA256_Init(&_hashContext);
+    return self;
+}
+
+- (void)dealloc {
+    if (self.file) {
+        fclose(self.file);
+        [[NSFileManager defaultManager] removeItemAtPath:self.path error:nil];
+    }
+}
+
+- (BOOL)isComplete {
+    return self.receivedLength == self.length;
+}
+
+- (BOOL)flush {
+    if (self.buffer.length && fwrite(self.buffer.bytes, 1, self.buffer.length, self.file) != self.buffer.length) {
+        DSLogWarn(@"DSMessageSpool", @"could not write spool file %@ (%d)", self.path, errno);
+        return NO;
+    }
+    self.buffer.length = 0;
+    return YES;
+}
+
+- (BOOL)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    if (!self.file || length > self.length - self.receivedLength) return NO;
+    CC_SHA256_Update(&_hashContext, bytes, (CC_LONG)length);
+    self.receivedLength += length;
+    while (length > 0) {
+        NSUInteger chunkLength = MIN(length, MESSAGE_SPOOL_BUFFER_LENGTH - self.buffer.length);
+        [self.buffer appendBytes:bytes length:chunkLength];
+        self.maximumBufferedLength = MAX(self.maximumBufferedLength, self.buffer.length);
+        bytes = (const uint8_t *)bytes + chunkLength;
+        length -= chunkLength;
+        if ((self.buffer.length == MESSAGE_SPOOL_BUFFER_LENGTH || self.complete) && ![self flush]) return NO;
+    }
+    if (self.complete) {
+        uint8_t hash[CC_SHA256_DIGEST_LENGTH];
+        CC_SHA256_Final(hash, &_hashContext);
+        CC_SHA256(hash, CC_SHA256_DIGEST_LENGTH, hash);
+        self.checksum = CFSwapInt32LittleToHost(*(const uint32_t *)hash);
+    }
+    return YES;
+}
+
+- (NSData *)finishedMessage {
+    if (!self.file || !self.complete) return nil;
+    fclose(self.file);
+    self.file = NULL;
+    self.buffer = nil;
+    NSError *error = nil;
+    // the mapping outlives the removed file
+    NSData *message = [NSData dataWithContentsOfFile:self.path options:NSDataReadingMappedAlways error:&error];
+    if (!message) DSLogWarn(@"DSMessageSpool", @"could not map spool file %@: %@", self.path, error);
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:nil];
+    return message;
+}
+
+@end
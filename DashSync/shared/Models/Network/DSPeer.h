@@ -107,7 +107,8 @@ typedef NS_ENUM(uint32_t, DSInvType)
 #define MSG_FEEFILTER @"feefilter"     // BIP133: https://github.com/bitcoin/bips/blob/master/bip-0133.mediawiki
 #define MSG_SENDDSQ @"senddsq"         //version 14
 #define MSQ_SENDCMPCT @"sendcmpct"     //version 12.3
-#define MSQ_SENDADDRV2 @"sendaddrv2"
+#define MSQ_SENDADDRV2 @"sendaddrv2"  // BIP155: https://github.com/bitcoin/bips/blob/master/bip-0155.mediawiki
+#define MSG_ADDRV2 @"addrv2"
 
 //Dash specific
 
@@ -187,7 +188,8 @@ typedef void (^MempoolCompletionBlock)(BOOL success, BOOL needed, BOOL interrupt
 @property (nonatomic, readonly) DSPeer *downloadPeer;
 - (void)peerConnected:(DSPeer *)peer;
 - (void)peer:(DSPeer *)peer disconnectedWithError:(NSError *)error;
-- (void)peer:(DSPeer *)peer relayedPeers:(NSArray *)peers;
+// addresses are DSNetworkAddress values
+- (void)peer:(DSPeer *)peer relayedAddresses:(NSArray<NSValue *> *)addresses;
 
 @end
 
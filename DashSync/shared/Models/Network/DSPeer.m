@@ -28,6 +28,7 @@
 
 #import "DSPeer.h"
 #import "DSAddrRequest.h"
+#import "DSAddressManager.h"
 #import "DSLogger.h"
 #import "DSBlockchainIdentityRegistrationTransition.h"
 #import "DSBloomFilter.h"
@@ -47,14 +48,15 @@
 #import "DSGovernanceHashesRequest.h"
 #import "DSGovernanceSyncRequest.h"
 #import "DSInstantSendTransactionLock.h"
+#import "DSInventoryTracker.h"
 #import "DSInvRequest.h"
 #import "DSKeyManager.h"
 #import "DSMasternodeManager.h"
 #import "DSMerkleBlock.h"
+#import "DSMessageSpool.h"
 #import "DSNotFoundRequest.h"
 #import "DSOptionsManager.h"
-#import "DSPeerEntity+CoreDataClass.h"
-#import "DSPeerManager.h"
+#import "DSPeerManager+Protected.h"
 #import "DSPingRequest.h"
 #import "DSReachabilityManager.h"
 #import "DSSimplifiedMasternodeEntry.h"
@@ -62,8 +64,8 @@
 #import "DSSporkManager.h"
 #import "DSTransaction.h"
 #import "DSTransactionFactory.h"
-#import "DSTransactionHashEntity+CoreDataClass.h"
 #import "DSTransactionInvRequest.h"
+#import "DSTransactionManager+Protected.h"
 #import "DSVersionRequest.h"
 #import "DSCoinJoinManager.h"
 #import "NSData+DSHash.h"
@@ -98,6 +100,8 @@
 @property (nonatomic, strong) NSInputStream *inputStream;
 @property (nonatomic, strong) NSOutputStream *outputStream;
 @property (nonatomic, strong) NSMutableData *msgHeader, *msgPayload, *outputBuffer;
+@property (nonatomic, strong) DSMessageSpool *msgSpool;
+@property (nonatomic, strong) NSMutableData *msgSpoolBuffer;
 @property (nonatomic, assign) BOOL sentVerack, gotVerack;
 @property (nonatomic, assign) BOOL sentGetaddr, sentFilter, sentGetdataTxBlocks, sentGetdataMasternode, sentMempool, sentGetblocks;
 @property (nonatomic, assign) BOOL receivedGovSync;
@@ -106,14 +110,14 @@
 @property (nonatomic, assign) uint64_t localNonce;
 @property (nonatomic, assign) NSTimeInterval pingStartTime, relayStartTime;
 @property (nonatomic, strong) DSMerkleBlock *currentBlock;
-@property (nonatomic, strong) NSMutableOrderedSet *knownBlockHashes, *knownChainLockHashes, *knownTxHashes, *knownInstantSendLockHashes, *knownInstantSendLockDHashes, *currentBlockTxHashes;
-@property (nonatomic, strong) NSMutableOrderedSet *knownGovernanceObjectHashes, *knownGovernanceObjectVoteHashes;
+@property (nonatomic, strong) NSMutableOrderedSet *knownBlockHashes, *currentBlockTxHashes;
+@property (nonatomic, strong) DSInventoryTracker *inventoryTracker;
+@property (nonatomic, assign) NSUInteger inventoryPeerTag;
 @property (nonatomic, strong) NSData *lastBlockHash;
 @property (nonatomic, strong) NSMutableArray *pongHandlers;
 @property (nonatomic, strong) MempoolCompletionBlock mempoolTransactionCompletion;
 @property (nonatomic, strong) NSRunLoop *runLoop;
 @property (nonatomic, strong) DSChain *chain;
-@property (nonatomic, strong) NSManagedObjectContext *managedObjectContext;
 @property (nonatomic, assign) uint64_t receivedOrphanCount;
 @property (nonatomic, assign) NSTimeInterval mempoolRequestTime;
 @property (nonatomic, strong) dispatch_semaphore_t outputBufferSemaphore;
@@ -183,6 +187,7 @@
 
 - (void)dealloc {
     if (self.reachabilityObserver) [[NSNotificationCenter defaultCenter] removeObserver:self.reachabilityObserver];
+    [_inventoryTracker releasePeerTag:_inventoryPeerTag];
     [NSObject cancelPreviousPerformRequestsWithTarget:self];
 }
 
@@ -254,24 +259,19 @@
     self.gotVerack = self.sentVerack = NO;
     self.sentFilter = self.sentGetaddr = self.sentGetdataTxBlocks = self.sentGetdataMasternode = self.sentMempool = self.sentGetblocks = NO;
     self.needsFilterUpdate = NO;
-    self.knownTxHashes = [NSMutableOrderedSet orderedSet];
-    self.knownInstantSendLockHashes = [NSMutableOrderedSet orderedSet];
-    self.knownInstantSendLockDHashes = [NSMutableOrderedSet orderedSet];
     self.knownBlockHashes = [NSMutableOrderedSet orderedSet];
-    self.knownChainLockHashes = [NSMutableOrderedSet orderedSet];
-    self.knownGovernanceObjectHashes = [NSMutableOrderedSet orderedSet];
-    self.knownGovernanceObjectVoteHashes = [NSMutableOrderedSet orderedSet];
     self.currentBlock = nil;
     self.currentBlockTxHashes = nil;
 
-    self.managedObjectContext = [NSManagedObjectContext peerContext];
-    [self.managedObjectContext performBlockAndWait:^{
-        NSArray<DSTransactionHashEntity *> *transactionHashEntities = [DSTransactionHashEntity standaloneTransactionHashEntitiesOnChainEntity:[self.chain chainEntityInContext:self.managedObjectContext]];
-        for (DSTransactionHashEntity *hashEntity in transactionHashEntities) {
-            [self.knownTxHashes addObject:hashEntity.txHash];
-        }
-    }];
-
+    if (![self attachToInventoryTracker]) {
+        NSError *error = [NSError errorWithCode:500 localizedDescriptionKey:@"Too many connected peers to track their inventory"];
+        DSLogWarn(@"DSPeer", @"not connecting to peer %@:%u: %@", self.host, self.port, error.localizedDescription);
+        _status = DSPeerStatus_Disconnected;
+        [self dispatchAsyncInDelegateQueue:^{
+            [self.peerDelegate peer:self disconnectedWithError:error];
+        }];
+        return;
+    }
 
     NSString *label = [NSString stringWithFormat:@"peer.%@:%u", self.host, self.port];
 
@@ -299,6 +299,49 @@
     });
 }
 
+// MARK: - Inventory
+
+// fails when every peer tag of the tracker is taken
+- (BOOL)attachToInventoryTracker {
+    DSInventoryTracker *inventoryTracker = self.chain.chainManager.peerManager.inventoryTracker;
+    if (!inventoryTracker) inventoryTracker = self.inventoryTracker ?: [[DSInventoryTracker alloc] init];
+    if (self.inventoryTracker) [self.inventoryTracker releasePeerTag:self.inventoryPeerTag];
+    self.inventoryTracker = inventoryTracker;
+    self.inventoryPeerTag = [inventoryTracker acquirePeerTag];
+    return self.inventoryPeerTag != INVENTORY_TRACKER_NO_PEER_TAG;
+}
+
+// removes the hashes this peer already knows about and returns them, the others are marked as known by it when asked
+- (NSArray<NSValue *> *)removeKnownHashes:(NSMutableOrderedSet<NSValue *> *)hashes ofKind:(DSInventoryKind)kind markingOthers:(BOOL)markOthers {
+    return [self removeKnownHashes:hashes ofKind:kind markingOthers:markOthers includingHistory:NO];
+}
+
+// aged out hashes can be bloom filter false positives, they are only skipped when relaying inventory that isn't ours
+- (NSArray<NSValue *> *)removeKnownHashes:(NSMutableOrderedSet<NSValue *> *)hashes ofKind:(DSInventoryKind)kind markingOthers:(BOOL)markOthers includingHistory:(BOOL)includingHistory {
+    NSMutableArray<NSValue *> *knownHashes = [NSMutableArray array];
+    for (NSValue *hash in hashes) {
+        UInt256 h;
+        [hash getValue:&h];
+        BOOL known = includingHistory && [self.inventoryTracker historyMayContainHash:h ofKind:kind];
+        if (!known) known = markOthers ? [self.inventoryTracker markHash:h ofKind:kind knownByPeer:self.inventoryPeerTag] : [self.inventoryTracker peer:self.inventoryPeerTag knowsHash:h ofKind:kind];
+        if (known) [knownHashes addObject:hash];
+    }
+    [hashes removeObjectsInArray:knownHashes];
+    return knownHashes;
+}
+
+// transactions downloaded before and not kept are not asked for again, whichever peer announces them
+- (void)removeSeenTransactionHashes:(NSMutableOrderedSet<NSValue *> *)hashes {
+    DSSeenTransactionStore *seenTransactionStore = self.chain.chainManager.transactionManager.seenTransactionStore;
+    NSMutableArray<NSValue *> *seenHashes = [NSMutableArray array];
+    for (NSValue *hash in hashes) {
+        UInt256 h;
+        [hash getValue:&h];
+        if ([seenTransactionStore containsTransactionHash:h]) [seenHashes addObject:hash];
+    }
+    [hashes removeObjectsInArray:seenHashes];
+}
+
 - (void)disconnect {
     [self disconnectWithError:nil];
 }
@@ -313,6 +356,8 @@
     [NSObject cancelPreviousPerformRequestsWithTarget:self]; // cancel connect timeout
 
     _status = DSPeerStatus_Disconnected;
+    [self.inventoryTracker releasePeerTag:self.inventoryPeerTag];
+    self.inventoryPeerTag = INVENTORY_TRACKER_NO_PEER_TAG;
     if (self.reachabilityObserver) {
         self.reachability = nil;
         [[NSNotificationCenter defaultCenter] removeObserver:self.reachabilityObserver];
@@ -439,8 +484,10 @@
  @param completion A completion block that is called when the mempool message processing is complete. This block is provided with three boolean arguments indicating various states of the transaction processing (e.g., if it was added, already known, or rejected).
 */
 - (void)sendMempoolMessage:(NSArray *)publishedTxHashes completion:(MempoolCompletionBlock)completion {
-    @synchronized (self.knownTxHashes) {
-        [self.knownTxHashes addObjectsFromArray:publishedTxHashes];
+    for (NSValue *hash in publishedTxHashes) {
+        UInt256 h;
+        [hash getValue:&h];
+        [self.inventoryTracker markHash:h ofKind:DSInventoryKind_Transaction knownByPeer:self.inventoryPeerTag];
     }
     self.sentMempool = YES;
     [self cancelMempoolTimer];
@@ -532,50 +579,39 @@
 
 - (void)sendInvMessageForHashes:(NSArray *)invHashes ofType:(DSInvType)invType {
     NSMutableOrderedSet *hashes = [NSMutableOrderedSet orderedSetWithArray:invHashes];
-    @synchronized (self.knownTxHashes) {
-        [hashes minusOrderedSet:self.knownTxHashes];
-    }
-    if (hashes.count == 0) return;
-    DSInvRequest *request = [DSInvRequest requestWithHashes:hashes ofInvType:invType];
-    [self sendRequest:request];
-
     switch (invType) {
         case DSInvType_Tx:
-            @synchronized (self.knownTxHashes) {
-                [self.knownTxHashes unionOrderedSet:hashes];
-            }
+            [self removeKnownHashes:hashes ofKind:DSInventoryKind_Transaction markingOthers:YES];
             break;
         case DSInvType_GovernanceObjectVote:
-            [self.knownGovernanceObjectVoteHashes unionOrderedSet:hashes];
+            [self removeKnownHashes:hashes ofKind:DSInventoryKind_GovernanceObjectVote markingOthers:YES includingHistory:YES];
             break;
         case DSInvType_GovernanceObject:
-            [self.knownGovernanceObjectHashes unionOrderedSet:hashes];
+            [self removeKnownHashes:hashes ofKind:DSInventoryKind_GovernanceObject markingOthers:YES includingHistory:YES];
             break;
         case DSInvType_Block:
             [self.knownBlockHashes unionOrderedSet:hashes];
             break;
         case DSInvType_ChainLockSignature:
-            [self.knownChainLockHashes unionOrderedSet:hashes];
+            [self removeKnownHashes:hashes ofKind:DSInventoryKind_ChainLock markingOthers:YES includingHistory:YES];
             break;
         default:
+            [self removeKnownHashes:hashes ofKind:DSInventoryKind_Transaction markingOthers:NO];
             break;
     }
+    if (hashes.count == 0) return;
+    DSInvRequest *request = [DSInvRequest requestWithHashes:hashes ofInvType:invType];
+    [self sendRequest:request];
 }
 
 - (void)sendTransactionInvMessagesforTransactionHashes:(NSArray *)txInvHashes txLockRequestHashes:(NSArray *)txLockRequestInvHashes {
     NSMutableOrderedSet *txHashes = txInvHashes ? [NSMutableOrderedSet orderedSetWithArray:txInvHashes] : nil;
     NSMutableOrderedSet *txLockRequestHashes = txLockRequestInvHashes ? [NSMutableOrderedSet orderedSetWithArray:txLockRequestInvHashes] : nil;
-    @synchronized (self.knownTxHashes) {
-        [txHashes minusOrderedSet:self.knownTxHashes];
-        [txLockRequestHashes minusOrderedSet:self.knownTxHashes];
-    }
+    if (txHashes) [self removeKnownHashes:txHashes ofKind:DSInventoryKind_Transaction markingOthers:YES];
+    if (txLockRequestHashes) [self removeKnownHashes:txLockRequestHashes ofKind:DSInventoryKind_Transaction markingOthers:YES];
     if (txHashes.count + txLockRequestHashes.count == 0) return;
     DSTransactionInvRequest *request = [DSTransactionInvRequest requestWithTransactionHashes:txHashes txLockRequestHashes:txLockRequestHashes];
     [self sendRequest:request];
-    @synchronized (self.knownTxHashes) {
-        txHashes ? [self.knownTxHashes unionOrderedSet:txHashes] : nil;
-        txLockRequestHashes ? [self.knownTxHashes unionOrderedSet:txLockRequestHashes] : nil;
-    }
 }
 
 - (void)sendGetdataMessageForTxHash:(UInt256)txHash {
@@ -693,7 +729,7 @@
         [self acceptVerackMessage:message];
     else if ([MSG_ADDR isEqual:type])
         [self acceptAddrMessage:message];
-    else if ([MSQ_SENDADDRV2 isEqual:type])
+    else if ([MSG_ADDRV2 isEqual:type])
         [self acceptAddrV2Message:message];
     else if ([MSG_INV isEqual:type])
         [self acceptInvMessage:message];
@@ -778,6 +814,7 @@
         [self error:@"protocol version %u not supported", self.version];
         return;
     }
+    [self sendRequest:[DSMessageRequest requestWithType:MSQ_SENDADDRV2]]; // must come before verack
     [self sendVerackMessage];
 }
 
@@ -802,10 +839,9 @@
     } else if (!self.sentGetaddr)
         return; // simple anti-tarpitting tactic, don't accept unsolicited addresses
 
-    NSTimeInterval now = [NSDate timeIntervalSince1970];
     NSNumber *l = nil;
     NSUInteger count = (NSUInteger)[message varIntAtOffset:0 length:&l];
-    NSMutableArray *peers = [NSMutableArray array];
+    NSMutableArray<NSValue *> *addresses = [NSMutableArray array];
 
     if (count > 1000) {
         return;
@@ -816,32 +852,97 @@
     }
 
     for (NSUInteger off = l.unsignedIntegerValue; off < l.unsignedIntegerValue + 30 * count; off += 30) {
-        NSTimeInterval timestamp = [message UInt32AtOffset:off];
-        uint64_t services = [message UInt64AtOffset:off + sizeof(uint32_t)];
-        UInt128 address = *(UInt128 *)((const uint8_t *)message.bytes + off + sizeof(uint32_t) + sizeof(uint64_t));
-        uint16_t port = CFSwapInt16BigToHost(*(const uint16_t *)((const uint8_t *)message.bytes + off +
-                                                                 sizeof(uint32_t) + sizeof(uint64_t) +
-                                                                 sizeof(UInt128)));
-
-        if (!(services & SERVICES_NODE_NETWORK)) continue;                                   // skip peers that don't carry full blocks
-        if (address.u64[0] != 0 || address.u32[2] != CFSwapInt32HostToBig(0xffff)) continue; // ignore IPv6 for now
-
-        // if address time is more than 10 min in the future or older than reference date, set to 5 days old
-        if (timestamp > now + 10 * 60 || timestamp < 0) timestamp = now - 5 * 24 * 60 * 60;
-
-        // subtract two hours and add it to the list
-        [peers addObject:[[DSPeer alloc] initWithAddress:address
-                                                    port:port
-                                                 onChain:self.chain
-                                               timestamp:timestamp - 2 * 60 * 60
-                                                services:services]];
+        UInt128 ipAddress = [message UInt128AtOffset:off + sizeof(uint32_t) + sizeof(uint64_t)];
+        BOOL isIPv4 = ipAddress.u64[0] == 0 && ipAddress.u32[2] == CFSwapInt32HostToBig(0xffff);
+        DSNetworkAddress address = {.type = isIPv4 ? DSNetworkAddressType_IPv4 : DSNetworkAddressType_IPv6};
+        address.services = [message UInt64AtOffset:off + sizeof(uint32_t)];
+        memcpy(address.bytes, ipAddress.u8, sizeof(UInt128));
+        address.port = [message UInt16BigToHostAtOffset:off + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(UInt128)];
+        if ([self addRelayedAddress:&address timestamp:[message UInt32AtOffset:off]]) {
+            [addresses addObject:[NSValue valueWithBytes:&address objCType:@encode(DSNetworkAddress)]];
+        }
     }
     [self dispatchAsyncInDelegateQueue:^{
-        if (self->_status == DSPeerStatus_Connected) [self.peerDelegate peer:self relayedPeers:peers];
+        if (self->_status == DSPeerStatus_Connected) [self.peerDelegate peer:self relayedAddresses:addresses];
     }];
 }
 
 - (void)acceptAddrV2Message:(NSData *)message {
+    if (message.length > 0 && [message UInt8AtOffset:0] == 0) {
+        return;
+    } else if (!self.sentGetaddr)
+        return; // simple anti-tarpitting tactic, don't accept unsolicited addresses
+
+    NSNumber *l = nil;
+    NSUInteger count = (NSUInteger)[message varIntAtOffset:0 length:&l];
+    NSMutableArray<NSValue *> *addresses = [NSMutableArray array];
+    if (count > 1000) return;
+
+    NSUInteger off = l.unsignedIntegerValue;
+    for (NSUInteger i = 0; i < count; i++) {
+        // time, services, network id, address length, address and port, at least 9 bytes
+        if (message.length < off + 9) {
+            [self error:@"malformed addrv2 message, length is %u, address %u of %u is incomplete", (int)message.length, (int)i, (int)count];
+            return;
+        }
+        uint32_t timestamp = [message UInt32AtOffset:off];
+        off += sizeof(uint32_t);
+        DSNetworkAddress address = {.services = [message varIntAtOffset:off length:&l]};
+        off += l.unsignedIntegerValue;
+        address.type = [message UInt8AtOffset:off++];
+        NSUInteger length = (NSUInteger)[message varIntAtOffset:off length:&l];
+        off += l.unsignedIntegerValue;
+        if (length > 512 || message.length < off + length + sizeof(uint16_t)) {
+            [self error:@"malformed addrv2 message, length is %u, address %u of %u is incomplete", (int)message.length, (int)i, (int)count];
+            return;
+        }
+        const uint8_t *bytes = (const uint8_t *)message.bytes + off;
+        off += length;
+        address.port = [message UInt16BigToHostAtOffset:off];
+        off += sizeof(uint16_t);
+
+        switch (address.type) {
+            case DSNetworkAddressType_IPv4:
+                if (length != 4) continue;
+                address.bytes[10] = address.bytes[11] = 0xff;
+                memcpy(address.bytes + 12, bytes, length);
+                break;
+            case DSNetworkAddressType_IPv6: {
+                if (length != sizeof(UInt128)) continue;
+                UInt128 ipAddress;
+                memcpy(ipAddress.u8, bytes, length);
+                if (ipAddress.u64[0] == 0 && ipAddress.u32[2] == CFSwapInt32HostToBig(0xffff)) continue; // IPv4 is sent as IPv4
+                memcpy(address.bytes, bytes, length);
+                break;
+            }
+            case DSNetworkAddressType_CJDNS:
+                if (length != sizeof(UInt128)) continue;
+                memcpy(address.bytes, bytes, length);
+                break;
+            case DSNetworkAddressType_TorV3:
+            case DSNetworkAddressType_I2P:
+                if (length != sizeof(UInt256)) continue;
+                memcpy(address.bytes, bytes, length);
+                break;
+            default:
+                continue; // Tor v2 is deprecated, other networks are unknown
+        }
+        if ([self addRelayedAddress:&address timestamp:timestamp]) {
+            [addresses addObject:[NSValue valueWithBytes:&address objCType:@encode(DSNetworkAddress)]];
+        }
+    }
+    [self dispatchAsyncInDelegateQueue:^{
+        if (self->_status == DSPeerStatus_Connected) [self.peerDelegate peer:self relayedAddresses:addresses];
+    }];
+}
+
+- (BOOL)addRelayedAddress:(DSNetworkAddress *)address timestamp:(NSTimeInterval)timestamp {
+    if (!(address->services & SERVICES_NODE_NETWORK)) return NO; // skip peers that don't carry full blocks
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    // if address time is more than 10 min in the future or older than reference date, set to 5 days old
+    if (timestamp > now + 10 * 60 || timestamp <= 0) timestamp = now - 5 * 24 * 60 * 60;
+    address->timestamp = (uint32_t)(timestamp - 2 * 60 * 60); // subtract two hours
+    return YES;
 }
 
 - (NSString *)nameOfInvMessage:(DSInvType)type {
@@ -998,70 +1099,34 @@
             }
         }];
     }
-    @synchronized (self.knownTxHashes) {
-        if ([txHashes intersectsOrderedSet:self.knownTxHashes]) { // remove transactions we already have
-            for (NSValue *hash in txHashes) {
-                UInt256 h;
-                if (![self.knownTxHashes containsObject:hash]) continue;
-                [hash getValue:&h];
-                [self dispatchAsyncInDelegateQueue:^{
-                    if (self->_status == DSPeerStatus_Connected) [self.transactionDelegate peer:self hasTransactionWithHash:h];
-                }];
-            }
-            [txHashes minusOrderedSet:self.knownTxHashes];
-        }
-        [self.knownTxHashes unionOrderedSet:txHashes];
+    [self removeSeenTransactionHashes:txHashes];
+    for (NSValue *hash in [self removeKnownHashes:txHashes ofKind:DSInventoryKind_Transaction markingOthers:YES]) { // remove transactions we already have
+        UInt256 h;
+        [hash getValue:&h];
+        [self dispatchAsyncInDelegateQueue:^{
+            if (self->_status == DSPeerStatus_Connected) [self.transactionDelegate peer:self hasTransactionWithHash:h];
+        }];
     }
 
     if (instantSendLockHashes.count > 0) {
-        for (NSValue *hash in instantSendLockHashes) {
-            UInt256 h;
-
-            if (![self.knownInstantSendLockHashes containsObject:hash]) continue;
-            [hash getValue:&h];
-        }
-
-        [instantSendLockHashes minusOrderedSet:self.knownInstantSendLockHashes];
+        [self removeKnownHashes:instantSendLockHashes ofKind:DSInventoryKind_InstantSendLock markingOthers:YES];
         [self dispatchAsyncInDelegateQueue:^{
             if (self->_status == DSPeerStatus_Connected) [self.transactionDelegate peer:self hasInstantSendLockHashes:instantSendLockHashes];
         }];
-
-        [self.knownInstantSendLockHashes unionOrderedSet:instantSendLockHashes];
     }
 
     if (instantSendLockDHashes.count > 0) {
-        for (NSValue *hash in instantSendLockDHashes) {
-            UInt256 h;
-
-            if (![self.knownInstantSendLockDHashes containsObject:hash]) continue;
-            [hash getValue:&h];
-        }
-
-        [instantSendLockDHashes minusOrderedSet:self.knownInstantSendLockDHashes];
-
+        [self removeKnownHashes:instantSendLockDHashes ofKind:DSInventoryKind_InstantSendDeterministicLock markingOthers:YES];
         [self dispatchAsyncInDelegateQueue:^{
             if (self->_status == DSPeerStatus_Connected) [self.transactionDelegate peer:self hasInstantSendLockDHashes:instantSendLockDHashes];
         }];
-
-        [self.knownInstantSendLockDHashes unionOrderedSet:instantSendLockDHashes];
     }
 
-
-
     if (chainLockHashes.count > 0) {
-        for (NSValue *hash in chainLockHashes) {
-            UInt256 h;
-
-            if (![self.knownChainLockHashes containsObject:hash]) continue;
-            [hash getValue:&h];
-        }
-
-        [chainLockHashes minusOrderedSet:self.knownChainLockHashes];
+        [self removeKnownHashes:chainLockHashes ofKind:DSInventoryKind_ChainLock markingOthers:YES];
         [self dispatchAsyncInDelegateQueue:^{
             if (self->_status == DSPeerStatus_Connected) [self.transactionDelegate peer:self hasChainLockHashes:chainLockHashes];
         }];
-
-        [self.knownChainLockHashes unionOrderedSet:chainLockHashes];
     }
 
     if (txHashes.count + instantSendLockHashes.count + instantSendLockDHashes.count > 0 || (!self.needsFilterUpdate && ((blockHashes.count + chainLockHashes.count) > 0))) {
@@ -1173,14 +1238,17 @@
     if (![self.chain.chainManager.sporkManager llmqInstantSendEnabled]) {
         return;
     }
+    if (!self.sentFilter && !self.sentGetdataTxBlocks) {
+        [self error:@"got islock message before loading a filter"];
+        return;
+    }
+    // the same lock is relayed by most peers, only the first copy is parsed
+    if (![self.chain.chainManager.transactionManager.instantSendLockIngestion acceptPayload:message]) return;
     DSInstantSendTransactionLock *instantSendTransactionLock = [DSInstantSendTransactionLock instantSendTransactionLockWithNonDeterministicMessage:message onChain:self.chain];
 
     if (!instantSendTransactionLock) {
         [self error:@"malformed islock message: %@", message];
         return;
-    } else if (!self.sentFilter && !self.sentGetdataTxBlocks) {
-        [self error:@"got islock message before loading a filter"];
-        return;
     }
     [self dispatchAsyncInDelegateQueue:^{
         [self.transactionDelegate peer:self relayedInstantSendTransactionLock:instantSendTransactionLock];
@@ -1194,14 +1262,17 @@
     if (![self.chain.chainManager.sporkManager llmqInstantSendEnabled]) {
         return;
     }
+    if (!self.sentFilter && !self.sentGetdataTxBlocks) {
+        [self error:@"got isdlock message before loading a filter"];
+        return;
+    }
+    // the same lock is relayed by most peers, only the first copy is parsed
+    if (![self.chain.chainManager.transactionManager.instantSendLockIngestion acceptPayload:message]) return;
     DSInstantSendTransactionLock *instantSendTransactionLock = [DSInstantSendTransactionLock instantSendTransactionLockWithDeterministicMessage:message onChain:self.chain];
 
     if (!instantSendTransactionLock) {
         [self error:@"malformed isdlock message: %@", message];
         return;
-    } else if (!self.sentFilter && !self.sentGetdataTxBlocks) {
-        [self error:@"got isdlock message before loading a filter"];
-        return;
     }
     [self dispatchAsyncInDelegateQueue:^{
         [self.transactionDelegate peer:self relayedInstantSendTransactionLock:instantSendTransactionLock];
@@ -1449,9 +1520,8 @@
     }
 
     NSMutableOrderedSet *txHashes = [NSMutableOrderedSet orderedSetWithArray:block.transactionHashes];
-    @synchronized (self.knownTxHashes) {
-        [txHashes minusOrderedSet:self.knownTxHashes];
-    }
+    [self removeKnownHashes:txHashes ofKind:DSInventoryKind_Transaction markingOthers:NO];
+    [self removeSeenTransactionHashes:txHashes];
 
     if (txHashes.count > 0) { // wait til we get all the tx messages before processing the block
         self.currentBlock = block;
@@ -1646,26 +1716,7 @@
 // MARK: - Saving to Disk
 
 - (void)save {
-    [self.managedObjectContext performBlock:^{
-        NSArray *peerEntities = [DSPeerEntity objectsInContext:self.managedObjectContext matching:@"address == %@ && port == %@", @(CFSwapInt32BigToHost(self.address.u32[3])), @(self.port)];
-        if ([peerEntities count]) {
-            DSPeerEntity *e = [peerEntities firstObject];
-
-            @autoreleasepool {
-                e.timestamp = self.timestamp;
-                e.services = self.services;
-                e.misbehavin = self.misbehaving;
-                e.priority = self.priority;
-                e.lowPreferenceTill = self.lowPreferenceTill;
-                e.lastRequestedMasternodeList = self.lastRequestedMasternodeList;
-                e.lastRequestedGovernanceSync = self.lastRequestedGovernanceSync;
-            }
-        } else {
-            @autoreleasepool {
-                [[DSPeerEntity managedObjectInBlockedContext:self.managedObjectContext] setAttributesFromPeer:self]; // add new peers
-            }
-        }
-    }];
+    [self.chain.chainManager.peerManager.addressManager updatePeer:self];
 }
 
 // MARK: - NSStreamDelegate
@@ -1750,6 +1801,46 @@
                         goto reset; //!OCLINT
                     }
 
+                    if (!self.msgSpool && payloadLen == 0 && [DSMessageSpool shouldSpoolMessageOfType:type length:length]) {
+                        self.msgSpool = [[DSMessageSpool alloc] initWithLength:length];
+                        if (self.msgSpool) self.msgSpoolBuffer = [NSMutableData dataWithLength:MESSAGE_SPOOL_BUFFER_LENGTH];
+                    }
+
+                    if (self.msgSpool) { // large masternode list messages go to disk as they arrive
+                        if (!self.msgSpool.complete) {
+                            l = [self.inputStream read:self.msgSpoolBuffer.mutableBytes
+                                             maxLength:MIN(self.msgSpoolBuffer.length, length - self.msgSpool.receivedLength)];
+
+                            if (l < 0) {
+                                goto reset; //!OCLINT
+                            }
+
+                            if (![self.msgSpool appendBytes:self.msgSpoolBuffer.bytes length:l]) {
+                                [self error:@"error spooling %@, payload length:%u", type, length];
+                                goto reset; //!OCLINT
+                            }
+
+                            if (!self.msgSpool.complete) continue; // wait for more stream input
+                        }
+
+                        if (self.msgSpool.checksum != checksum) { // verify checksum
+                            [self error:@"error reading %@, invalid checksum %x, expected %x, payload length:%u",
+                                  type, self.msgSpool.checksum, checksum, length];
+                            goto reset; //!OCLINT
+                        }
+
+                        message = [self.msgSpool finishedMessage];
+                        if (!message) {
+                            [self error:@"error reading %@, spooled payload could not be mapped", type];
+                            goto reset; //!OCLINT
+                        }
+
+                        self.msgSpool = nil;
+                        self.msgSpoolBuffer = nil;
+                        [self acceptMessage:message type:type]; // process message
+                        goto reset; //!OCLINT
+                    }
+
                     if (payloadLen < length) { // read message payload
                         self.msgPayload.length = length;
                         l = [self.inputStream read:(uint8_t *)self.msgPayload.mutableBytes + payloadLen
@@ -1777,6 +1868,8 @@
 
                 reset: //!OCLINT // reset for next message
                     self.msgHeader.length = self.msgPayload.length = 0;
+                    self.msgSpool = nil;
+                    self.msgSpoolBuffer = nil;
                 }
             }
 
@@ -0,0 +1,28 @@
+//
+//  DSSystemDNSResolver.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSDNSSeedResolver.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Resolves hosts through DNSServiceGetAddrInfo, asking for A and AAAA records at once and reading the TTL of the answers, on a dispatch queue rather than a blocked thread. */
+@interface DSSystemDNSResolver : NSObject <DSDNSResolver>
+
+@end
+
+NS_ASSUME_NONNULL_END
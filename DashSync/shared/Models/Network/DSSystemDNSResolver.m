@@ -0,0 +1,132 @@
+//
+//  DSSystemDNSResolver.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSSystemDNSResolver.h"
+#import "NSError+Dash.h"
+#import <dns_sd.h>
+#import <netinet/in.h>
+
+@class DSSystemDNSResolver;
+
+@interface DSSystemDNSLookup : NSObject
+
+// keeps the resolver around until the lookup is over
+@property (nonatomic, strong) DSSystemDNSResolver *resolver;
+@property (nonatomic, copy) DSDNSResolverCompletionBlock completion;
+@property (nonatomic, strong) NSMutableArray<NSValue *> *ipAddresses;
+@property (nonatomic, assign) uint32_t ttl;
+@property (nonatomic, assign) BOOL answeredIPv4, answeredIPv6;
+@property (nonatomic, assign) DNSServiceRef serviceRef;
+
+@end
+
+@implementation DSSystemDNSLookup
+
+@end
+
+@interface DSSystemDNSResolver ()
+
+@property (nonatomic, strong) dispatch_queue_t queue;
+// lookups are retained here until they finish, the service only holds an unretained pointer to them
+@property (nonatomic, strong) NSMutableSet<DSSystemDNSLookup *> *lookups;
+
+- (void)lookup:(DSSystemDNSLookup *)lookup receivedAddress:(const struct sockaddr *)address flags:(DNSServiceFlags)flags errorCode:(DNSServiceErrorType)errorCode ttl:(uint32_t)ttl;
+
+@end
+
+// called on the queue of the resolver
+static void DSSystemDNSResolverCallback(DNSServiceRef serviceRef, DNSServiceFlags flags, uint32_t interfaceIndex, DNSServiceErrorType errorCode,
+    const char *hostname, const struct sockaddr *address, uint32_t ttl, void *context) {
+    DSSystemDNSLookup *lookup = (__bridge DSSystemDNSLookup *)context;
+    [lookup.resolver lookup:lookup receivedAddress:address flags:flags errorCode:errorCode ttl:ttl];
+}
+
+@implementation DSSystemDNSResolver
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+
+    self.queue = dispatch_queue_create("org.dashcore.dashsync.dnsresolver", DISPATCH_QUEUE_SERIAL);
+    self.lookups = [NSMutableSet set];
+
+    return self;
+}
+
+- (void)resolveHost:(NSString *)host completion:(DSDNSResolverCompletionBlock)completion {
+    NSParameterAssert(host);
+    NSParameterAssert(completion);
+
+    dispatch_async(self.queue, ^{
+        DSSystemDNSLookup *lookup = [[DSSystemDNSLookup alloc] init];
+        lookup.resolver = self;
+        lookup.completion = completion;
+        lookup.ipAddresses = [NSMutableArray array];
+        lookup.ttl = UINT32_MAX;
+        DNSServiceRef serviceRef = NULL;
+        // intermediate results report a missing A or AAAA record instead of waiting on it, the timeout flag bounds the whole lookup
+        DNSServiceErrorType errorCode = DNSServiceGetAddrInfo(&serviceRef, kDNSServiceFlagsReturnIntermediates | kDNSServiceFlagsTimeout, kDNSServiceInterfaceIndexAny,
+                                                              kDNSServiceProtocol_IPv4 | kDNSServiceProtocol_IPv6, host.UTF8String,
+                                                              DSSystemDNSResolverCallback, (__bridge void *)lookup);
+        if (errorCode == kDNSServiceErr_NoError) errorCode = DNSServiceSetDispatchQueue(serviceRef, self.queue);
+        if (errorCode != kDNSServiceErr_NoError) {
+            if (serviceRef) DNSServiceRefDeallocate(serviceRef);
+            completion(@[], 0, [NSError errorWithCode:500 localizedDescriptionKey:@"DNS lookup failed"]);
+            return;
+        }
+        lookup.serviceRef = serviceRef;
+        [self.lookups addObject:lookup];
+    });
+}
+
+- (void)lookup:(DSSystemDNSLookup *)lookup receivedAddress:(const struct sockaddr *)address flags:(DNSServiceFlags)flags errorCode:(DNSServiceErrorType)errorCode ttl:(uint32_t)ttl {
+    if (!lookup.serviceRef) return;
+    if (errorCode != kDNSServiceErr_NoError && errorCode != kDNSServiceErr_NoSuchRecord) {
+        [self finishLookup:lookup error:(lookup.ipAddresses.count > 0) ? nil : [NSError errorWithCode:500 localizedDescriptionKey:@"DNS lookup failed"]];
+        return;
+    }
+    if (address && address->sa_family == AF_INET) {
+        lookup.answeredIPv4 = YES;
+        if (errorCode == kDNSServiceErr_NoError && (flags & kDNSServiceFlagsAdd)) {
+            UInt128 ipAddress = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), ((const struct sockaddr_in *)address)->sin_addr.s_addr}};
+            [lookup.ipAddresses addObject:[NSValue valueWithBytes:&ipAddress objCType:@encode(UInt128)]];
+            lookup.ttl = MIN(lookup.ttl, ttl);
+        }
+    } else if (address && address->sa_family == AF_INET6) {
+        lookup.answeredIPv6 = YES;
+        if (errorCode == kDNSServiceErr_NoError && (flags & kDNSServiceFlagsAdd)) {
+            UInt128 ipAddress;
+            memcpy(&ipAddress, &((const struct sockaddr_in6 *)address)->sin6_addr, sizeof(ipAddress));
+            [lookup.ipAddresses addObject:[NSValue valueWithBytes:&ipAddress objCType:@encode(UInt128)]];
+            lookup.ttl = MIN(lookup.ttl, ttl);
+        }
+    }
+    if (lookup.answeredIPv4 && lookup.answeredIPv6 && !(flags & kDNSServiceFlagsMoreComing)) [self finishLookup:lookup error:nil];
+}
+
+- (void)finishLookup:(DSSystemDNSLookup *)lookup error:(NSError *)error {
+    DNSServiceRefDeallocate(lookup.serviceRef);
+    lookup.serviceRef = NULL;
+    [self.lookups removeObject:lookup];
+    DSDNSResolverCompletionBlock completion = lookup.completion;
+    NSArray<NSValue *> *ipAddresses = [lookup.ipAddresses copy];
+    NSTimeInterval ttl = ipAddresses.count > 0 ? lookup.ttl : 0;
+    lookup.resolver = nil;
+    lookup.completion = nil;
+    completion(ipAddresses, ttl, error);
+}
+
+@end
@@ -0,0 +1,42 @@
+//
+//  DSInstantSendLockIngestion.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define INSTANT_SEND_LOCK_SEEN_PAYLOAD_CAPACITY 8192
+#define INSTANT_SEND_LOCK_VERIFICATION_CAPACITY 4096
+
+/*! @brief First stage for InstantSend locks relayed by peers, shared by all peers of a chain. Raw islock and isdlock payloads are hashed and copies already seen are dropped before they are parsed, and signature checks are remembered per request id and quorum so a lock is verified once however many peers relay it. */
+@interface DSInstantSendLockIngestion : NSObject
+
+@property (nonatomic, readonly) NSUInteger duplicatePayloadCount;
+@property (nonatomic, readonly) NSUInteger verificationCount;
+
+- (instancetype)initWithSeenPayloadCapacity:(NSUInteger)seenPayloadCapacity verificationCapacity:(NSUInteger)verificationCapacity NS_DESIGNATED_INITIALIZER;
+
+/*! @brief NO if the same payload was already accepted, the oldest payloads are forgotten past the capacity. */
+- (BOOL)acceptPayload:(NSData *)payload;
+
+/*! @brief Result of the block the first time the request is checked against the quorum, the remembered result afterwards. A different transaction or signature for the same request and quorum is checked again. */
+- (BOOL)verifyRequestID:(UInt256)requestID quorumHash:(UInt256)quorumHash transactionHash:(UInt256)transactionHash signature:(UInt768)signature usingBlock:(BOOL (^)(void))verifyBlock;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,103 @@
+//
+//  DSInstantSendLockIngestion.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSInstantSendLockIngestion.h"
+#import "NSData+Dash.h"
+
+@interface DSInstantSendLockVerification : NSObject
+
+@property (nonatomic, assign) UInt256 transactionHash;
+@property (nonatomic, assign) UInt768 signature;
+@property (nonatomic, assign) BOOL valid;
+
+@end
+
+@implementation DSInstantSendLockVerification
+
+@end
+
+@interface DSInstantSendLockIngestion ()
+
+@property (nonatomic, assign) NSUInteger seenPayloadCapacity, verificationCapacity;
+@property (nonatomic, strong) NSMutableOrderedSet<NSData *> *seenPayloadHashes;
+// request id and quorum hash to the last check of a signature for them
+@property (nonatomic, strong) NSMutableDictionary<NSData *, DSInstantSendLockVerification *> *verifications;
+@property (nonatomic, strong) NSMutableOrderedSet<NSData *> *verificationOrder;
+@property (nonatomic, assign) NSUInteger duplicatePayloadCount, verificationCount;
+
+@end
+
+@implementation DSInstantSendLockIngestion
+
+- (instancetype)init {
+    return [self initWithSeenPayloadCapacity:INSTANT_SEND_LOCK_SEEN_PAYLOAD_CAPACITY verificationCapacity:INSTANT_SEND_LOCK_VERIFICATION_CAPACITY];
+}
+
+- (instancetype)initWithSeenPayloadCapacity:(NSUInteger)seenPayloadCapacity verificationCapacity:(NSUInteger)verificationCapacity {
+    NSParameterAssert(seenPayloadCapacity > 0 && verificationCapacity > 0);
+    if (!(self = [super init])) return nil;
+    self.seenPayloadCapacity = seenPayloadCapacity;
+    self.verificationCapacity = verificationCapacity;
+    self.seenPayloadHashes = [NSMutableOrderedSet orderedSet];
+    self.verifications = [NSMutableDictionary dictionary];
+    self.verificationOrder = [NSMutableOrderedSet orderedSet];
+    return self;
+}
+
+- (BOOL)acceptPayload:(NSData *)payload {
+    NSData *payloadHash = uint256_data(payload.SHA256);
+    @synchronized(self) {
+        if ([self.seenPayloadHashes containsObject:payloadHash]) {
+            self.duplicatePayloadCount++;
+            return NO;
+        }
+        [self.seenPayloadHashes addObject:payloadHash];
+        if (self.seenPayloadHashes.count > self.seenPayloadCapacity) [self.seenPayloadHashes removeObjectAtIndex:0];
+        return YES;
+    }
+}
+
+- (BOOL)verifyRequestID:(UInt256)requestID quorumHash:(UInt256)quorumHash transactionHash:(UInt256)transactionHash signature:(UInt768)signature usingBlock:(BOOL (^)(void))verifyBlock {
+    NSMutableData *key = [NSMutableData dataWithCapacity:sizeof(UInt256) * 2];
+    [key appendBytes:&requestID length:sizeof(UInt256)];
+    [key appendBytes:&quorumHash length:sizeof(UInt256)];
+    @synchronized(self) {
+        DSInstantSendLockVerification *verification = self.verifications[key];
+        if (verification && uint256_eq(verification.transactionHash, transactionHash) && uint768_eq(verification.signature, signature)) {
+            return verification.valid;
+        }
+    }
+    // verified outside of the lock, two peers racing on a new lock at worst both check it
+    BOOL valid = verifyBlock();
+    @synchronized(self) {
+        self.verificationCount++;
+        DSInstantSendLockVerification *verification = [[DSInstantSendLockVerification alloc] init];
+        verification.transactionHash = transactionHash;
+        verification.signature = signature;
+        verification.valid = valid;
+        self.verifications[key] = verification;
+        [self.verificationOrder removeObject:key];
+        [self.verificationOrder addObject:key];
+        if (self.verificationOrder.count > self.verificationCapacity) {
+            [self.verifications removeObjectForKey:self.verificationOrder.firstObject];
+            [self.verificationOrder removeObjectAtIndex:0];
+        }
+    }
+    return valid;
+}
+
+@end
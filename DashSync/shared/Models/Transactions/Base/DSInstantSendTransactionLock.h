@@ -11,7 +11,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class DSChain, DSSimplifiedMasternodeEntry, DSQuorumEntry, DSMasternodeList;
+@class DSChain, DSInstantSendLockIngestion, DSSimplifiedMasternodeEntry, DSQuorumEntry, DSMasternodeList;
 
 @interface DSInstantSendTransactionLock : NSObject
 
@@ -31,6 +31,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSData *)toData;
 
 - (BOOL)verifySignature;
+// repeated checks of the same request against the same quorum are answered by the ingestion when one is given
+- (BOOL)verifySignatureUsingIngestion:(DSInstantSendLockIngestion *_Nullable)ingestion;
 
 - (void)saveInitial;
 - (void)saveSignatureValid;
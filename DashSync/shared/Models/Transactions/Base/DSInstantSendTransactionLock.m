@@ -10,6 +10,7 @@
 #import "DSChainEntity+CoreDataClass.h"
 #import "DSChainManager.h"
 #import "DSInstantSendLockEntity+CoreDataClass.h"
+#import "DSInstantSendLockIngestion.h"
 #import "DSMasternodeList.h"
 #import "DSMasternodeManager.h"
 #import "DSQuorumEntry.h"
@@ -178,9 +179,14 @@
     return [data SHA256_2];
 }
 
-- (BOOL)verifySignatureAgainstQuorum:(DSQuorumEntry *)quorumEntry {
-    UInt256 signId = [self signIDForQuorumEntry:quorumEntry];
-    return key_bls_verify(quorumEntry.quorumPublicKey.u8, quorumEntry.useLegacyBLSScheme, signId.u8, self.signature.u8);
+- (BOOL)verifySignatureAgainstQuorum:(DSQuorumEntry *)quorumEntry usingIngestion:(DSInstantSendLockIngestion *)ingestion {
+    BOOL (^verifyBlock)(void) = ^BOOL {
+        UInt256 signId = [self signIDForQuorumEntry:quorumEntry];
+        return key_bls_verify(quorumEntry.quorumPublicKey.u8, quorumEntry.useLegacyBLSScheme, signId.u8, self.signature.u8);
+    };
+    // copies of the lock relayed by other peers reuse the first check
+    if (!ingestion) return verifyBlock();
+    return [ingestion verifyRequestID:self.requestID quorumHash:quorumEntry.quorumHash transactionHash:self.transactionHash signature:self.signature usingBlock:verifyBlock];
 }
 
 - (DSQuorumEntry *)findSigningQuorumReturnMasternodeList:(DSMasternodeList **)returnMasternodeList {
@@ -188,7 +194,7 @@
     LLMQType ISLockQuorumType = quorum_type_for_is_locks(self.chain.chainType);
     for (DSMasternodeList *masternodeList in [self.chain.chainManager.masternodeManager.recentMasternodeLists copy]) {
         for (DSQuorumEntry *quorumEntry in [[masternodeList quorumsOfType:ISLockQuorumType] allValues]) {
-            BOOL signatureVerified = [self verifySignatureAgainstQuorum:quorumEntry];
+            BOOL signatureVerified = [self verifySignatureAgainstQuorum:quorumEntry usingIngestion:nil];
             if (signatureVerified) {
                 foundQuorum = quorumEntry;
                 if (returnMasternodeList) *returnMasternodeList = masternodeList;
@@ -200,28 +206,32 @@
     return foundQuorum;
 }
 
-- (BOOL)verifySignatureWithQuorumOffset:(uint32_t)offset {
+- (BOOL)verifySignatureWithQuorumOffset:(uint32_t)offset usingIngestion:(DSInstantSendLockIngestion *)ingestion {
     DSQuorumEntry *quorumEntry = [self.chain.chainManager.masternodeManager quorumEntryForInstantSendRequestID:[self requestID] withBlockHeightOffset:offset];
     if (quorumEntry && quorumEntry.verified) {
-        self.signatureVerified = [self verifySignatureAgainstQuorum:quorumEntry];
+        self.signatureVerified = [self verifySignatureAgainstQuorum:quorumEntry usingIngestion:ingestion];
     }
     if (self.signatureVerified) {
         self.intendedQuorum = quorumEntry;
     } else if (quorumEntry.verified && offset == 8) {
         //try again a few blocks more in the past
-        return [self verifySignatureWithQuorumOffset:0];
+        return [self verifySignatureWithQuorumOffset:0 usingIngestion:ingestion];
     } else if (quorumEntry.verified && offset == 0) {
         //try again a few blocks more in the future
-        return [self verifySignatureWithQuorumOffset:16];
+        return [self verifySignatureWithQuorumOffset:16 usingIngestion:ingestion];
     }
     return self.signatureVerified;
 }
 
 - (BOOL)verifySignature {
+    return [self verifySignatureUsingIngestion:nil];
+}
+
+- (BOOL)verifySignatureUsingIngestion:(DSInstantSendLockIngestion *)ingestion {
     // TODO: Need to implement
     return TRUE;
     //
-    return [self verifySignatureWithQuorumOffset:8];
+    return [self verifySignatureWithQuorumOffset:8 usingIngestion:ingestion];
 }
 
 - (void)saveInitial {
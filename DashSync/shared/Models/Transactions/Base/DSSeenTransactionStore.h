@@ -0,0 +1,52 @@
+//
+//  DSSeenTransactionStore.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define SEEN_TRANSACTION_STORE_EXPIRY 1209600 // 2 weeks, as long as a transaction stays in a mempool
+#define SEEN_TRANSACTION_STORE_CAPACITY 131072
+#define SEEN_TRANSACTION_STORE_PENDING_CAPACITY 1024
+#define SEEN_TRANSACTION_STORE_FLUSH_INTERVAL 600
+
+/*! @brief Hashes of transactions already downloaded but not kept, so they are not asked for again. Stored hashes are one sorted run in a file that is mapped, not read, with the first hash of every block of entries indexed in memory. New hashes collect in a small sorted buffer merged into the run when it fills up or gets old, dropping expired hashes and the oldest ones past the capacity. */
+@interface DSSeenTransactionStore : NSObject
+
+/*! @brief Nil for a store only kept in memory. */
+@property (nonatomic, readonly, nullable) NSString *path;
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic, readonly) NSUInteger pendingCount;
+/*! @brief Bytes held in memory besides the mapped run. */
+@property (nonatomic, readonly) NSUInteger residentSize;
+
+- (instancetype)initWithPath:(NSString *_Nullable)path;
+- (instancetype)initWithPath:(NSString *_Nullable)path expiry:(NSTimeInterval)expiry capacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+- (void)addTransactionHash:(UInt256)transactionHash;
+- (void)addTransactionHash:(UInt256)transactionHash seenAt:(NSTimeInterval)timestamp;
+/*! @brief NO for a hash seen longer than the expiry ago. */
+- (BOOL)containsTransactionHash:(UInt256)transactionHash;
+
+/*! @brief Merges the pending hashes into the run and writes it. */
+- (void)synchronize;
+- (void)removeAllTransactionHashes;
+
+@end
+
+NS_ASSUME_NONNULL_END
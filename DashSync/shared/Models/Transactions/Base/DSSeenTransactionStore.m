@@ -0,0 +1,320 @@
+//
+//  DSSeenTransactionStore.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSSeenTransactionStore.h"
+#import "DSLogger.h"
+#import "NSDate+Utils.h"
+
+#define SEEN_TRANSACTION_STORE_FILE_MAGIC 0x58545344 // "DSTX"
+#define SEEN_TRANSACTION_STORE_FILE_VERSION 1
+#define SEEN_TRANSACTION_STORE_HEADER_LENGTH 12
+// a hash followed by the time it was seen
+#define SEEN_TRANSACTION_STORE_RECORD_LENGTH 36
+#define SEEN_TRANSACTION_STORE_BLOCK_LENGTH 64
+
+typedef struct {
+    UInt256 hash;
+    uint32_t timestamp;
+} DSSeenTransactionEntry;
+
+static uint64_t seen_transaction_prefix(const uint8_t *hash) {
+    // big endian so that prefixes compare like the hashes
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8; i++) prefix = (prefix << 8) | hash[i];
+    return prefix;
+}
+
+@interface DSSeenTransactionStore ()
+
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, assign) uint32_t expiry;
+@property (nonatomic, assign) NSUInteger capacity;
+// records of the sorted run, mapped from the file when there is one
+@property (nonatomic, strong) NSData *run;
+
+@end
+
+@implementation DSSeenTransactionStore {
+    NSUInteger _runCount;
+    // prefix of the first hash of each block of the run
+    uint64_t *_blockPrefixes;
+    NSUInteger _blockCount;
+    // sorted by hash
+    DSSeenTransactionEntry _pending[SEEN_TRANSACTION_STORE_PENDING_CAPACITY];
+    NSUInteger _pendingCount;
+    uint32_t _oldestPendingTimestamp;
+}
+
+- (instancetype)init {
+    return [self initWithPath:nil];
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    return [self initWithPath:path expiry:SEEN_TRANSACTION_STORE_EXPIRY capacity:SEEN_TRANSACTION_STORE_CAPACITY];
+}
+
+- (instancetype)initWithPath:(NSString *)path expiry:(NSTimeInterval)expiry capacity:(NSUInteger)capacity {
+    NSParameterAssert(capacity > 0 && capacity <= UINT32_MAX);
+    if (!(self = [super init])) return nil;
+    self.path = path;
+    self.expiry = (uint32_t)expiry;
+    self.capacity = capacity;
+    NSData *run = path ? [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil] : nil;
+    if (run && ![self loadRun:run]) {
+        DSLogWarn(@"DSSeenTransactionStore", @"discarding unreadable store at %@", path);
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_blockPrefixes);
+}
+
+// MARK: - Run
+
+- (BOOL)loadRun:(NSData *)run {
+    if (run.length < SEEN_TRANSACTION_STORE_HEADER_LENGTH) return NO;
+    uint32_t header[3];
+    memcpy(header, run.bytes, sizeof(header));
+    if (CFSwapInt32LittleToHost(header[0]) != SEEN_TRANSACTION_STORE_FILE_MAGIC || CFSwapInt32LittleToHost(header[1]) != SEEN_TRANSACTION_STORE_FILE_VERSION) return NO;
+    NSUInteger runCount = CFSwapInt32LittleToHost(header[2]);
+    if (runCount > self.capacity || run.length != SEEN_TRANSACTION_STORE_HEADER_LENGTH + runCount * SEEN_TRANSACTION_STORE_RECORD_LENGTH) return NO;
+    NSUInteger blockCount = (runCount + SEEN_TRANSACTION_STORE_BLOCK_LENGTH - 1) / SEEN_TRANSACTION_STORE_BLOCK_LENGTH;
+    uint64_t *blockPrefixes = blockCount ? malloc(blockCount * sizeof(uint64_t)) : NULL;
+    for (NSUInteger i = 0; i < blockCount; i++) {
+        blockPrefixes[i] = seen_transaction_prefix([self recordAtIndex:i * SEEN_TRANSACTION_STORE_BLOCK_LENGTH ofRun:run]);
+    }
+    free(_blockPrefixes);
+    _blockPrefixes = blockPrefixes;
+    _blockCount = blockCount;
+    _runCount = runCount;
+    self.run = run;
+    return YES;
+}
+
+- (const uint8_t *)recordAtIndex:(NSUInteger)index ofRun:(NSData *)run {
+    return (const uint8_t *)run.bytes + SEEN_TRANSACTION_STORE_HEADER_LENGTH + index * SEEN_TRANSACTION_STORE_RECORD_LENGTH;
+}
+
+static DSSeenTransactionEntry seen_transaction_entry(const uint8_t *record) {
+    DSSeenTransactionEntry entry;
+    memcpy(&entry.hash, record, sizeof(UInt256));
+    uint32_t timestamp;
+    memcpy(&timestamp, record + sizeof(UInt256), sizeof(timestamp));
+    entry.timestamp = CFSwapInt32LittleToHost(timestamp);
+    return entry;
+}
+
+// only called while synchronized, the time the hash was seen or 0
+- (uint32_t)runTimestampOfHash:(UInt256)hash {
+    if (!_runCount) return 0;
+    uint64_t prefix = seen_transaction_prefix(hash.u8);
+    // the hash can only be in the block before the first one starting above it, or in the ones starting with the same prefix
+    NSUInteger low = 0, high = _blockCount;
+    while (low < high) {
+        NSUInteger middle = (low + high) / 2;
+        if (_blockPrefixes[middle] < prefix) low = middle + 1;
+        else high = middle;
+    }
+    NSUInteger firstBlock = low ? low - 1 : 0;
+    high = _blockCount;
+    while (low < high) {
+        NSUInteger middle = (low + high) / 2;
+        if (_blockPrefixes[middle] <= prefix) low = middle + 1;
+        else high = middle;
+    }
+    NSUInteger first = firstBlock * SEEN_TRANSACTION_STORE_BLOCK_LENGTH, last = MIN(low * SEEN_TRANSACTION_STORE_BLOCK_LENGTH, _runCount);
+    while (first < last) {
+        NSUInteger middle = (first + last) / 2;
+        const uint8_t *record = [self recordAtIndex:middle ofRun:self.run];
+        int order = memcmp(record, hash.u8, sizeof(UInt256));
+        if (order == 0) return seen_transaction_entry(record).timestamp;
+        if (order < 0) first = middle + 1;
+        else last = middle;
+    }
+    return 0;
+}
+
+// MARK: - Pending
+
+// only called while synchronized, index of the hash or where it would go
+- (NSUInteger)pendingIndexOfHash:(UInt256)hash found:(BOOL *)found {
+    NSUInteger low = 0, high = _pendingCount;
+    while (low < high) {
+        NSUInteger middle = (low + high) / 2;
+        int order = memcmp(_pending[middle].hash.u8, hash.u8, sizeof(UInt256));
+        if (order == 0) {
+            *found = YES;
+            return middle;
+        }
+        if (order < 0) low = middle + 1;
+        else high = middle;
+    }
+    *found = NO;
+    return low;
+}
+
+- (NSUInteger)pendingCount {
+    @synchronized(self) {
+        return _pendingCount;
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized(self) {
+        return _runCount + _pendingCount;
+    }
+}
+
+- (NSUInteger)residentSize {
+    @synchronized(self) {
+        return _blockCount * sizeof(uint64_t) + sizeof(_pending);
+    }
+}
+
+- (void)addTransactionHash:(UInt256)transactionHash {
+    [self addTransactionHash:transactionHash seenAt:[NSDate timeIntervalSince1970]];
+}
+
+- (void)addTransactionHash:(UInt256)transactionHash seenAt:(NSTimeInterval)timestamp {
+    uint32_t seen = (uint32_t)timestamp, now = (uint32_t)[NSDate timeIntervalSince1970];
+    @synchronized(self) {
+        BOOL found;
+        NSUInteger index = [self pendingIndexOfHash:transactionHash found:&found];
+        if (found) {
+            _pending[index].timestamp = MAX(_pending[index].timestamp, seen);
+            return;
+        }
+        if (!_pendingCount || now < _oldestPendingTimestamp) _oldestPendingTimestamp = now;
+        memmove(&_pending[index + 1], &_pending[index], (_pendingCount - index) * sizeof(DSSeenTransactionEntry));
+        _pending[index] = (DSSeenTransactionEntry){.hash = transactionHash, .timestamp = seen};
+        _pendingCount++;
+        if (_pendingCount == SEEN_TRANSACTION_STORE_PENDING_CAPACITY || now - _oldestPendingTimestamp >= SEEN_TRANSACTION_STORE_FLUSH_INTERVAL) {
+            [self mergePending];
+        }
+    }
+}
+
+- (BOOL)containsTransactionHash:(UInt256)transactionHash {
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    @synchronized(self) {
+        BOOL found;
+        NSUInteger index = [self pendingIndexOfHash:transactionHash found:&found];
+        uint32_t timestamp = found ? _pending[index].timestamp : [self runTimestampOfHash:transactionHash];
+        return timestamp && (uint64_t)timestamp + self.expiry > now;
+    }
+}
+
+// MARK: - Merging
+
+- (void)synchronize {
+    @synchronized(self) {
+        if (_pendingCount) [self mergePending];
+    }
+}
+
+// only called while synchronized
+- (void)mergePending {
+    uint32_t now = (uint32_t)[NSDate timeIntervalSince1970];
+    uint32_t expired = now > self.expiry ? now - self.expiry : 0;
+    NSUInteger total = _runCount + _pendingCount;
+    DSSeenTransactionEntry *entries = malloc(MAX(total, 1) * sizeof(DSSeenTransactionEntry));
+    NSUInteger count = 0, runIndex = 0, pendingIndex = 0;
+    while (runIndex < _runCount || pendingIndex < _pendingCount) {
+        DSSeenTransactionEntry entry;
+        if (pendingIndex == _pendingCount) {
+            entry = seen_transaction_entry([self recordAtIndex:runIndex++ ofRun:self.run]);
+        } else if (runIndex == _runCount) {
+            entry = _pending[pendingIndex++];
+        } else {
+            const uint8_t *record = [self recordAtIndex:runIndex ofRun:self.run];
+            int order = memcmp(record, _pending[pendingIndex].hash.u8, sizeof(UInt256));
+            if (order < 0) {
+                entry = seen_transaction_entry(record);
+                runIndex++;
+            } else {
+                entry = _pending[pendingIndex++];
+                // seen again, the newer time wins
+                if (order == 0) entry.timestamp = MAX(entry.timestamp, seen_transaction_entry(record).timestamp), runIndex++;
+            }
+        }
+        if (entry.timestamp > expired) entries[count++] = entry;
+    }
+    if (count > self.capacity) count = [self evictOldestEntries:entries count:count];
+
+    NSMutableData *run = [NSMutableData dataWithCapacity:SEEN_TRANSACTION_STORE_HEADER_LENGTH + count * SEEN_TRANSACTION_STORE_RECORD_LENGTH];
+    uint32_t header[3] = {CFSwapInt32HostToLittle(SEEN_TRANSACTION_STORE_FILE_MAGIC), CFSwapInt32HostToLittle(SEEN_TRANSACTION_STORE_FILE_VERSION), CFSwapInt32HostToLittle((uint32_t)count)};
+    [run appendBytes:header length:sizeof(header)];
+    for (NSUInteger i = 0; i < count; i++) {
+        uint32_t timestamp = CFSwapInt32HostToLittle(entries[i].timestamp);
+        [run appendBytes:entries[i].hash.u8 length:sizeof(UInt256)];
+        [run appendBytes:&timestamp length:sizeof(timestamp)];
+    }
+    free(entries);
+    _pendingCount = 0;
+
+    NSData *mappedRun = nil;
+    if (self.path && [run writeToFile:self.path atomically:YES]) {
+        mappedRun = [NSData dataWithContentsOfFile:self.path options:NSDataReadingMappedIfSafe error:nil];
+    } else if (self.path) {
+        DSLogWarn(@"DSSeenTransactionStore", @"could not write store at %@", self.path);
+    }
+    [self loadRun:mappedRun ?: run];
+}
+
+static int seen_transaction_timestamp_compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// keeps the most recently seen entries, in order
+- (NSUInteger)evictOldestEntries:(DSSeenTransactionEntry *)entries count:(NSUInteger)count {
+    uint32_t *timestamps = malloc(count * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < count; i++) timestamps[i] = entries[i].timestamp;
+    qsort(timestamps, count, sizeof(uint32_t), seen_transaction_timestamp_compare);
+    NSUInteger evictedCount = count - self.capacity;
+    uint32_t cutoff = timestamps[evictedCount];
+    // entries seen at the cutoff time are only evicted as far as needed
+    NSUInteger evictedAtCutoff = 0;
+    for (NSUInteger i = evictedCount; i > 0 && timestamps[i - 1] == cutoff; i--) evictedAtCutoff++;
+    free(timestamps);
+    NSUInteger kept = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (entries[i].timestamp < cutoff) continue;
+        if (entries[i].timestamp == cutoff && evictedAtCutoff) {
+            evictedAtCutoff--;
+            continue;
+        }
+        entries[kept++] = entries[i];
+    }
+    return kept;
+}
+
+- (void)removeAllTransactionHashes {
+    @synchronized(self) {
+        _pendingCount = 0;
+        _runCount = 0;
+        _blockCount = 0;
+        free(_blockPrefixes);
+        _blockPrefixes = NULL;
+        self.run = nil;
+        if (self.path) [[NSFileManager defaultManager] removeItemAtPath:self.path error:nil];
+    }
+}
+
+@end
@@ -0,0 +1,37 @@
+//
+//  DSAccount+Protected.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSAccount.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSTransactionIndex, DSCoinJoinCoinIndex;
+
+@interface DSAccount ()
+
+//told about every transaction registered, confirmed or removed
+@property (nonatomic, weak, nullable) DSCoinJoinCoinIndex *coinJoinCoinIndex;
+
+//adds the transactions already in memory, used when the wallet starts being indexed by its chain
+- (void)addLoadedTransactionsToTransactionIndex:(DSTransactionIndex *)transactionIndex;
+
+//removes the persisted balance snapshot, the balance is computed from the transactions on the next load
+- (void)wipeBalanceSnapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
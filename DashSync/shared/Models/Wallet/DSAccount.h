@@ -70,6 +70,9 @@ FOUNDATION_EXPORT NSString *_Nonnull const DSAccountNewAccountShouldBeAddedFromT
 // NSValue objects containing UTXO structs
 @property (nonatomic, readonly) NSArray<NSValue *> *unspentOutputs;
 
+// incremented every time the unspent outputs are recomputed, lets caches skip comparing them
+@property (nonatomic, readonly) NSUInteger unspentOutputsRevision;
+
 // latest 100 transactions sorted by date, most recent first
 @property (atomic, readonly) NSArray<DSTransaction *> *recentTransactions;
 
@@ -245,6 +248,9 @@ FOUNDATION_EXPORT NSString *_Nonnull const DSAccountNewAccountShouldBeAddedFromT
 // returns the transaction with the given hash if it's been registered in the account (might also return non-registered)
 - (DSTransaction *_Nullable)transactionForHash:(UInt256)txHash;
 
+// a page of account transactions sorted by date, most recent first, cut from the full history that is loaded when the wallet is attached
+- (NSArray<DSTransaction *> *)transactionsInPage:(NSUInteger)page pageSize:(NSUInteger)pageSize;
+
 // true if no previous account transaction spends any of the given transaction's inputs, and no inputs are invalid
 - (BOOL)transactionIsValid:(DSTransaction *)transaction;
 
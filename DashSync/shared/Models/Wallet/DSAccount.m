@@ -23,7 +23,7 @@
 //  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //  THE SOFTWARE.
 
-#import "DSAccount.h"
+#import "DSAccount+Protected.h"
 #import "DSChain+Protected.h"
 #import "DSFundsDerivationPath.h"
 #import "DSWallet+Protected.h"
@@ -47,7 +47,9 @@
 #import "DSAddressEntity+CoreDataClass.h"
 #import "DSAuthenticationManager.h"
 #import "DSBIP39Mnemonic.h"
+#import "DSBlockZoneBitmap.h"
 #import "DSChainEntity+CoreDataClass.h"
+#import "DSCoinJoinCoinIndex.h"
 #import "DSLogger.h"
 #import "DSCoinbaseTransaction.h"
 #import "DSCreditFundingTransaction.h"
@@ -59,8 +61,11 @@
 #import "DSMasternodeManager.h"
 #import "DSPeerManager.h"
 #import "DSPriceManager.h"
+#import "DSSpendIndex.h"
 #import "DSTransactionFactory.h"
+#import "DSTransactionIndex.h"
 #import "DSTransactionInput.h"
+#import "DSTransactionOrdering.h"
 #import "DSTransactionOutput.h"
 #import "DSCoinControl.h"
 #import "NSData+Dash.h"
@@ -72,6 +77,10 @@
 
 #define AUTH_SWEEP_KEY @"AUTH_SWEEP_KEY"
 #define AUTH_SWEEP_FEE @"AUTH_SWEEP_FEE"
+#define ACCOUNT_BALANCE_SNAPSHOT_FILE_PREFIX @"ACCOUNT_BALANCE_SNAPSHOT_"
+#define ACCOUNT_BALANCE_SNAPSHOT_VERSION 2
+
+#define RECENT_TRANSACTIONS_PAGE_SIZE 100
 
 
 @class DSFundsDerivationPath, DSIncomingFundsDerivationPath, DSAccount;
@@ -85,9 +94,12 @@
 
 @property (nonatomic, strong) NSArray *balanceHistory;
 
-@property (nonatomic, strong) NSSet *spentOutputs, *invalidTransactionHashes, *pendingTransactionHashes;
+@property (nonatomic, strong) NSSet *invalidTransactionHashes, *pendingTransactionHashes;
 @property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSSet *> *pendingCoinbaseLockedTransactionHashes;
 @property (nonatomic, strong) NSMutableOrderedSet *transactions;
+@property (nonatomic, strong) DSTransactionOrdering *transactionOrdering;
+@property (nonatomic, strong) NSMapTable<DSDerivationPath *, NSNumber *> *rankedReceiveAddressCounts, *rankedChangeAddressCounts;
+@property (nonatomic, strong) DSSpendIndex *spendIndex;
 
 @property (nonatomic, strong) NSMutableArray<DSTransaction *> *transactionsToSave;
 @property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSArray<DSTransaction *> *> *transactionsToSaveInBlockSave;
@@ -115,6 +127,9 @@
 
 @property (nonatomic, assign) UInt256 firstTransactionHash;
 
+// digest of the transactions the persisted balance snapshot was computed from
+@property (nonatomic, assign) UInt256 balanceSnapshotTransactionsDigest;
+
 
 @end
 
@@ -196,6 +211,10 @@
         derivationPath.account = self;
     }
     self.transactions = [NSMutableOrderedSet orderedSet];
+    self.transactionOrdering = [[DSTransactionOrdering alloc] init];
+    self.rankedReceiveAddressCounts = [NSMapTable weakToStrongObjectsMapTable];
+    self.rankedChangeAddressCounts = [NSMapTable weakToStrongObjectsMapTable];
+    self.spendIndex = [[DSSpendIndex alloc] init];
     self.allTx = [NSMutableDictionary dictionary];
     self.managedObjectContext = context ? context : [NSManagedObjectContext chainContext];
     self.transactionsToSave = [NSMutableArray array];
@@ -241,23 +260,11 @@
                 for (DSTxOutputEntity *e in transactionOutputs) {
                     @autoreleasepool {
                         if (e.transaction.transactionHash) {
-                            NSValue *hash = uint256_obj(e.transaction.transactionHash.txHash.UInt256);
-                            if (self.allTx[hash] == nil) {
-                                DSTransaction *transaction = [e.transaction transactionForChain:self.wallet.chain];
-                                if (!transaction) continue;
-                                self.allTx[hash] = transaction;
-                                [self.transactions addObject:transaction];
-                            }
+                            if (![self addTransactionFromEntity:e.transaction]) continue;
                         }
                         DSTxInputEntity *spentInInput = e.spentInInput;
                         if (spentInInput && (spentInInput.transaction.transactionHash)) { //this has been spent, also add the transaction where it is being spent
-                            NSValue *hash = uint256_obj(spentInInput.transaction.transactionHash.txHash.UInt256);
-                            if (self.allTx[hash] == nil) {
-                                DSTransaction *transaction = [spentInInput.transaction transactionForChain:self.wallet.chain];
-                                if (!transaction) continue;
-                                self.allTx[hash] = transaction;
-                                [self.transactions addObject:transaction];
-                            }
+                            if (![self addTransactionFromEntity:spentInInput.transaction]) continue;
                         }
                     }
                 }
@@ -265,8 +272,186 @@
         }
     }];
     [self sortTransactions];
+    [self.coinJoinCoinIndex accountRemovedTransactions]; // the loaded history replaces what the index collected
     _balance = UINT64_MAX; // trigger balance changed notification even if balance is zero
-    [self updateBalance];
+    if (![self loadBalanceSnapshot]) {
+        [self updateBalance];
+    }
+}
+
+// a transaction reached through several outputs is only materialized once
+- (DSTransaction *)addTransactionFromEntity:(DSTransactionEntity *)transactionEntity {
+    NSValue *hash = uint256_obj(transactionEntity.transactionHash.txHash.UInt256);
+    DSTransaction *transaction = _allTx[hash];
+    if (!transaction) {
+        transaction = [transactionEntity transactionForChain:self.wallet.chain];
+        if (!transaction) return nil;
+        transaction = [self setIndexedTransaction:transaction forHash:hash];
+    }
+    [_transactions addObject:transaction];
+    [self.spendIndex addTransaction:transaction];
+    return transaction;
+}
+
+// MARK: - Transaction Index
+
+// every change to allTx goes through here so the chain wide transaction index stays in step, the account holds the
+// transaction the index returns so accounts sharing a transaction share the object
+- (DSTransaction *)setIndexedTransaction:(DSTransaction *)transaction forHash:(NSValue *)hash {
+    DSTransaction *indexedTransaction = [self.wallet.chain.transactionIndex addTransaction:transaction forAccount:self];
+    _allTx[hash] = indexedTransaction;
+    return indexedTransaction;
+}
+
+- (void)removeIndexedTransactionForHash:(NSValue *)hash {
+    [_allTx removeObjectForKey:hash];
+    [self.wallet.chain.transactionIndex removeTransactionHashes:@[hash] forAccount:self];
+}
+
+- (void)removeAllIndexedTransactions {
+    [self.wallet.chain.transactionIndex removeTransactionHashes:[_allTx allKeys] forAccount:self];
+    [_allTx removeAllObjects];
+}
+
+- (void)addLoadedTransactionsToTransactionIndex:(DSTransactionIndex *)transactionIndex {
+    @synchronized (self) {
+        for (NSValue *hash in [_allTx allKeys]) {
+            DSTransaction *transaction = _allTx[hash];
+            DSTransaction *indexedTransaction = [transactionIndex addTransaction:transaction forAccount:self];
+            if (indexedTransaction == transaction) continue;
+            // another wallet already holds this transaction, switch to its object
+            _allTx[hash] = indexedTransaction;
+            NSUInteger index = [_transactions indexOfObject:transaction];
+            if (index != NSNotFound) {
+                [_transactions removeObjectAtIndex:index];
+                [_transactions insertObject:indexedTransaction atIndex:index];
+            }
+            [self.spendIndex removeTransaction:transaction];
+            [self.spendIndex addTransaction:indexedTransaction];
+        }
+    }
+}
+
+// MARK: - Balance Snapshot
+
+static dispatch_queue_t DSAccountBalanceSnapshotQueue(void) {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("org.dashcore.dashsync.balancesnapshot", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+- (NSString *)balanceSnapshotPath {
+    NSString *cachesDirectory = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    NSString *fileName = [NSString stringWithFormat:@"%@%@_%u", ACCOUNT_BALANCE_SNAPSHOT_FILE_PREFIX, self.wallet.uniqueIDString, self.accountNumber];
+    return [cachesDirectory stringByAppendingPathComponent:fileName];
+}
+
+// order independent digest of every transaction hash and the height it is confirmed at, a snapshot only applies to the exact same history
+- (UInt256)transactionsDigest {
+    UInt256 digest = UINT256_ZERO;
+    NSMutableData *d = [NSMutableData dataWithCapacity:sizeof(UInt256) + sizeof(uint32_t)];
+    for (DSTransaction *transaction in _transactions) {
+        d.length = 0;
+        [d appendUInt256:transaction.txHash];
+        [d appendUInt32:transaction.blockHeight];
+        UInt256 transactionHash = d.SHA256;
+        digest = uint256_xor(digest, transactionHash);
+    }
+    return digest;
+}
+
+// restores the settled balance and UTXO set persisted by the last balance computation over the same transactions
+- (BOOL)loadBalanceSnapshot {
+    NSData *data = [NSData dataWithContentsOfFile:self.balanceSnapshotPath];
+    if (!data) return NO;
+    NSDictionary *snapshot = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:nil error:nil];
+    if (![snapshot isKindOfClass:[NSDictionary class]] || [snapshot[@"version"] unsignedIntegerValue] != ACCOUNT_BALANCE_SNAPSHOT_VERSION) return NO;
+    NSArray<NSNumber *> *derivationPathBalances = snapshot[@"derivationPathBalances"];
+    NSData *utxoData = snapshot[@"utxos"];
+    NSData *digestData = snapshot[@"transactionsDigest"];
+    if (derivationPathBalances.count != self.fundDerivationPaths.count || utxoData.length % (sizeof(UInt256) + sizeof(uint32_t)) || digestData.length != sizeof(UInt256)) return NO;
+    UInt256 transactionsDigest = [self transactionsDigest];
+    if ([snapshot[@"transactionCount"] unsignedIntegerValue] != _transactions.count || !uint256_eq(digestData.UInt256, transactionsDigest)) {
+        DSLogInfo(@"DSAccount", @"Balance snapshot of account %u is outdated", self.accountNumber);
+        return NO;
+    }
+    NSMutableOrderedSet *utxos = [NSMutableOrderedSet orderedSet];
+    for (NSUInteger offset = 0; offset < utxoData.length; offset += sizeof(UInt256) + sizeof(uint32_t)) {
+        [utxos addObject:dsutxo_obj(((DSUTXO){[utxoData UInt256AtOffset:offset], [utxoData UInt32AtOffset:offset + sizeof(UInt256)]}))];
+    }
+    [self.fundDerivationPaths enumerateObjectsUsingBlock:^(DSDerivationPath *derivationPath, NSUInteger idx, BOOL *stop) {
+        derivationPath.balance = [derivationPathBalances[idx] unsignedLongLongValue];
+    }];
+    self.utxos = utxos;
+    self.invalidTransactionHashes = [NSSet set];
+    self.spendIndex.invalidTransactionHashes = self.invalidTransactionHashes;
+    self.pendingTransactionHashes = [NSSet set];
+    self.pendingCoinbaseLockedTransactionHashes = [NSMutableDictionary dictionary];
+    _totalSent = [snapshot[@"totalSent"] unsignedLongLongValue];
+    _totalReceived = [snapshot[@"totalReceived"] unsignedLongLongValue];
+    _balance = [snapshot[@"balance"] unsignedLongLongValue];
+    self.balanceSnapshotTransactionsDigest = transactionsDigest;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(postBalanceDidChangeNotification) object:nil];
+        [self performSelector:@selector(postBalanceDidChangeNotification) withObject:nil afterDelay:0.1];
+    });
+    return YES;
+}
+
+// only settled balances are persisted, anything pending or invalid depends on the chain tip and is recomputed from the history,
+// the snapshot is built here and written on a serial queue so that the account lock isn't held during file access
+- (void)updateBalanceSnapshot {
+    if (_wallet.isTransient || !_wallet) return;
+    NSString *path = self.balanceSnapshotPath;
+    if (self.invalidTransactionHashes.count || self.pendingTransactionHashes.count || self.pendingCoinbaseLockedTransactionHashes.count) {
+        if (uint256_is_zero(self.balanceSnapshotTransactionsDigest)) return;
+        self.balanceSnapshotTransactionsDigest = UINT256_ZERO;
+        dispatch_async(DSAccountBalanceSnapshotQueue(), ^{
+            [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+        });
+        return;
+    }
+    UInt256 transactionsDigest = [self transactionsDigest];
+    if (uint256_eq(transactionsDigest, self.balanceSnapshotTransactionsDigest)) return;
+    self.balanceSnapshotTransactionsDigest = transactionsDigest;
+    NSMutableData *utxoData = [NSMutableData dataWithCapacity:self.utxos.count * (sizeof(UInt256) + sizeof(uint32_t))];
+    for (NSValue *output in self.utxos) {
+        DSUTXO o;
+        [output getValue:&o];
+        [utxoData appendUInt256:o.hash];
+        [utxoData appendUInt32:(uint32_t)o.n];
+    }
+    NSMutableArray<NSNumber *> *derivationPathBalances = [NSMutableArray array];
+    for (DSDerivationPath *derivationPath in self.fundDerivationPaths) {
+        [derivationPathBalances addObject:@(derivationPath.balance)];
+    }
+    NSDictionary *snapshot = @{@"version": @(ACCOUNT_BALANCE_SNAPSHOT_VERSION),
+                               @"balance": @(_balance),
+                               @"totalSent": @(_totalSent),
+                               @"totalReceived": @(_totalReceived),
+                               @"transactionCount": @(_transactions.count),
+                               @"transactionsDigest": uint256_data(transactionsDigest),
+                               @"utxos": utxoData,
+                               @"derivationPathBalances": derivationPathBalances};
+    dispatch_async(DSAccountBalanceSnapshotQueue(), ^{
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:snapshot format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+        if (![data writeToFile:path atomically:YES]) {
+            DSLogWarn(@"DSAccount", @"Could not write balance snapshot to %@", path);
+        }
+    });
+}
+
+- (void)wipeBalanceSnapshot {
+    if (_wallet.isTransient || !_wallet) return;
+    NSString *path = self.balanceSnapshotPath;
+    self.balanceSnapshotTransactionsDigest = UINT256_ZERO;
+    // queued behind any pending write of the snapshot
+    dispatch_async(DSAccountBalanceSnapshotQueue(), ^{
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    });
 }
 
 - (void)loadDerivationPaths {
@@ -303,8 +488,12 @@
     [self.mFundDerivationPaths removeObjectsInArray:[self.mContactIncomingFundDerivationPathsDictionary allValues]];
     [self.mContactIncomingFundDerivationPathsDictionary removeAllObjects];
     [self.mContactOutgoingFundDerivationPathsDictionary removeAllObjects];
-    [self.transactions removeAllObjects];
-    [self.allTx removeAllObjects];
+    [_transactions removeAllObjects];
+    [self.spendIndex removeAllTransactions];
+    [self removeAllIndexedTransactions];
+    [self.transactionOrdering removeAllTransactions];
+    [self.coinJoinCoinIndex accountRemovedTransactions];
+    [self wipeBalanceSnapshot];
     [self updateBalance];
 }
 
@@ -363,6 +552,11 @@
     return self.utxos.array;
 }
 
+- (void)setUtxos:(NSOrderedSet *)utxos {
+    _utxos = utxos;
+    _unspentOutputsRevision++;
+}
+
 // MARK: - Derivation Paths
 
 - (void)removeDerivationPath:(DSDerivationPath *)derivationPath {
@@ -790,9 +984,9 @@
     }
 
     self.invalidTransactionHashes = invalidTx;
+    self.spendIndex.invalidTransactionHashes = invalidTx;
     self.pendingTransactionHashes = pendingTransactionHashes;
     self.pendingCoinbaseLockedTransactionHashes = pendingCoinbaseLockedTransactionHashes;
-    self.spentOutputs = spentOutputs;
     self.utxos = utxos;
     _totalSent = totalSent;
     _totalReceived = totalReceived;
@@ -812,6 +1006,7 @@
             [self performSelector:@selector(postBalanceDidChangeNotification) withObject:nil afterDelay:0.1];
         });
     }
+    [self updateBalanceSnapshot];
 }
 
 - (void)postBalanceDidChangeNotification {
@@ -822,53 +1017,33 @@
 
 // MARK: = Helpers
 
-// chain position of first tx output address that appears in chain
-static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *addressChain) {
-    for (DSTransactionOutput *output in transaction.outputs) {
-        NSUInteger i = [addressChain indexOfObject:output.address];
-        if (i != NSNotFound) return i;
+- (void)prepareTransactionOrdering {
+    self.transactionOrdering.invalidTransactionHashes = self.invalidTransactionHashes;
+    self.transactionOrdering.pendingTransactionHashes = self.pendingTransactionHashes;
+    // only the addresses derived since the last call are ranked, in derivation order
+    for (DSDerivationPath *derivationPath in self.fundDerivationPaths) {
+        NSUInteger receiveCount = [[self.rankedReceiveAddressCounts objectForKey:derivationPath] unsignedIntegerValue];
+        NSArray *receiveAddresses = [(id)derivationPath receiveAddressesFromIndex:receiveCount];
+        if (receiveAddresses.count) {
+            [self.transactionOrdering addAddresses:receiveAddresses startingAtIndex:receiveCount internal:NO];
+            [self.rankedReceiveAddressCounts setObject:@(receiveCount + receiveAddresses.count) forKey:derivationPath];
+        }
+        if (![derivationPath isKindOfClass:[DSFundsDerivationPath class]]) continue;
+        NSUInteger changeCount = [[self.rankedChangeAddressCounts objectForKey:derivationPath] unsignedIntegerValue];
+        NSArray *changeAddresses = [(DSFundsDerivationPath *)derivationPath changeAddressesFromIndex:changeCount];
+        if (changeAddresses.count) {
+            [self.transactionOrdering addAddresses:changeAddresses startingAtIndex:changeCount internal:YES];
+            [self.rankedChangeAddressCounts setObject:@(changeCount + changeAddresses.count) forKey:derivationPath];
+        }
     }
-
-    return NSNotFound;
 }
 
-// this sorts transactions by block height in descending order, and makes a best attempt at ordering transactions within
+// this sorts transactions by block height in descending order, and orders spenders before the transactions they spend within
 // each block, however correct transaction ordering cannot be relied upon for determining wallet balance or UTXO set
 - (void)sortTransactions {
     @synchronized (self) {
-        BOOL (^isAscending)(id, id);
-        __block __weak BOOL (^_isAscending)(id, id) = isAscending = ^BOOL(DSTransaction *tx1, DSTransaction *tx2) {
-            if (!tx1 || !tx2) return NO;
-            if (tx1.blockHeight > tx2.blockHeight) return YES;
-            if (tx1.blockHeight < tx2.blockHeight) return NO;
-            NSValue *hash1 = uint256_obj(tx1.txHash), *hash2 = uint256_obj(tx2.txHash);
-            if ([tx1.inputs indexOfObjectPassingTest:^BOOL(DSTransactionInput *_Nonnull obj, NSUInteger idx, BOOL *_Nonnull stop) {
-                return uint256_eq(obj.inputHash, tx2.txHash);
-            }] != NSNotFound) return YES;
-            if ([tx2.inputs indexOfObjectPassingTest:^BOOL(DSTransactionInput *_Nonnull obj, NSUInteger idx, BOOL *_Nonnull stop) {
-                return uint256_eq(obj.inputHash, tx1.txHash);
-            }] != NSNotFound) return NO;
-            if ([self.invalidTransactionHashes containsObject:hash1] && ![self.invalidTransactionHashes containsObject:hash2]) return YES;
-            if ([self.pendingTransactionHashes containsObject:hash1] && ![self.pendingTransactionHashes containsObject:hash2]) return YES;
-
-            return NO;
-        };
-
-        NSArray *externalAddresses = self.externalAddresses;
-        NSArray *internalAddresses = self.internalAddresses;
-
-        [self.transactions sortWithOptions:NSSortStable
-                           usingComparator:^NSComparisonResult(id tx1, id tx2) {
-            if (isAscending(tx1, tx2)) return NSOrderedAscending;
-            if (isAscending(tx2, tx1)) return NSOrderedDescending;
-
-            NSUInteger i = transactionAddressIndex(tx1, internalAddresses);
-            NSUInteger j = transactionAddressIndex(tx2, (i == NSNotFound) ? externalAddresses : internalAddresses);
-
-            if (i == NSNotFound && j != NSNotFound) i = transactionAddressIndex(tx1, externalAddresses);
-            if (i == NSNotFound || j == NSNotFound || i == j) return NSOrderedSame;
-            return (i > j) ? NSOrderedAscending : NSOrderedDescending;
-        }];
+        [self prepareTransactionOrdering];
+        [self.transactionOrdering sortTransactions:self.transactions];
     }
 }
 
@@ -883,17 +1058,26 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
     }
 }
 
+// transactions sorted by date, most recent first, the history is always fully in memory since balances and spends need all of it
+- (NSArray<DSTransaction *> *)transactionsInPage:(NSUInteger)page pageSize:(NSUInteger)pageSize {
+    NSParameterAssert(pageSize);
+    @synchronized (self) {
+        NSArray<DSTransaction *> *transactions = self.transactions.array;
+        if (page * pageSize >= transactions.count) return @[];
+        return [transactions subarrayWithRange:NSMakeRange(page * pageSize, MIN(pageSize, transactions.count - page * pageSize))];
+    }
+}
+
 // last 100 transactions sorted by date, most recent first
 - (NSArray *)recentTransactions {
-    return [self.transactions.array subarrayWithRange:NSMakeRange(0, (self.transactions.count > 100) ? 100 :
-                                                                  self.transactions.count)];
+    return [self transactionsInPage:0 pageSize:RECENT_TRANSACTIONS_PAGE_SIZE];
 }
 
 // last 100 transactions sorted by date, most recent first
 - (NSArray *)recentTransactionsWithInternalOutput {
     NSMutableArray *recentTransactionArray = [NSMutableArray array];
     int i = 0;
-    while (recentTransactionArray.count < 100 && i < self.transactions.count) {
+    while (recentTransactionArray.count < RECENT_TRANSACTIONS_PAGE_SIZE && i < self.transactions.count) {
         DSTransaction *transaction = [self.transactions objectAtIndex:i];
         if ([transaction hasNonDustOutputInWallet:self.wallet]) {
             [recentTransactionArray addObject:transaction];
@@ -1215,9 +1399,10 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
                 }
                 if ([self.pendingTransactionHashes containsObject:hash] || [self.invalidTransactionHashes containsObject:hash]) needsUpdate = YES;
             } else if (height != TX_UNCONFIRMED)
-                [self.allTx removeObjectForKey:hash]; // remove confirmed non-wallet tx
+                [self removeIndexedTransactionForHash:hash]; // remove confirmed non-wallet tx
         }
 
+        if (updated.count > 0) [self.coinJoinCoinIndex accountUpdatedTransactions];
         if (hashes.count > 0 && needsUpdate) {
             [self sortTransactions];
             [self updateBalance];
@@ -1241,26 +1426,18 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
 - (BOOL)removeTransaction:(DSTransaction *)baseTransaction saveImmediately:(BOOL)saveImmediately {
     NSParameterAssert(baseTransaction);
     @synchronized (self) {
-        NSMutableSet *dependentTransactions = [NSMutableSet set];
         DSTransaction *transaction = self.allTx[uint256_obj(baseTransaction.txHash)];
         if (!transaction) return FALSE;
         UInt256 transactionHash = transaction.txHash;
-        for (DSTransaction *possibleDependentTransaction in self.transactions) {           // remove dependent transactions
-            if (possibleDependentTransaction.blockHeight < transaction.blockHeight) break; //because transactions are sorted we can break
-            if (!uint256_eq(transactionHash, possibleDependentTransaction.txHash) &&
-                [possibleDependentTransaction.inputs indexOfObjectPassingTest:^BOOL(DSTransactionInput *_Nonnull obj, NSUInteger idx, BOOL *_Nonnull stop) {
-                    return uint256_eq(obj.inputHash, transactionHash);
-                }] != NSNotFound) {
-                //this transaction is dependent on one we want to remove
-                [dependentTransactions addObject:possibleDependentTransaction];
-            }
-        }
-        for (DSTransaction *transaction in dependentTransactions) {
+        for (DSTransaction *dependentTransaction in [self.spendIndex transactionsSpendingOutputsOfTransaction:transaction]) {
             //remove all dependent transactions
-            [self removeTransaction:transaction saveImmediately:NO];
+            [self removeTransaction:dependentTransaction saveImmediately:NO];
         }
-        [self.allTx removeObjectForKey:uint256_obj(transactionHash)];
+        [self removeIndexedTransactionForHash:uint256_obj(transactionHash)];
         [self.transactions removeObject:transaction];
+        [self.spendIndex removeTransaction:transaction];
+        [self.transactionOrdering removeTransaction:transaction];
+        [self.coinJoinCoinIndex accountRemovedTransactions];
         [self updateBalance];
         [self.managedObjectContext performBlockAndWait:^{
             [DSTransactionHashEntity deleteObjects:[DSTransactionHashEntity objectsInContext:self.managedObjectContext matching:@"txHash == %@", [NSData dataWithUInt256:transactionHash]] inContext:self.managedObjectContext];
@@ -1438,7 +1615,7 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
             //this transaction is not meant for this account
             if (transaction.blockHeight == TX_UNCONFIRMED) {
                 if ([self checkIsFirstTransaction:transaction]) _firstTransactionHash = txHash; //it's okay if this isn't really the first, as it will be close enough (500 blocks close)
-                self.allTx[hash] = transaction;
+                [self setIndexedTransaction:transaction forHash:hash];
             }
             return NO;
         }
@@ -1449,8 +1626,11 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
         if ([self checkIsFirstTransaction:transaction]) _firstTransactionHash = txHash; //it's okay if this isn't really the first, as it will be close enough (500 blocks close)
         DSLogInfo(@"DSAccount", @"Registering transaction %@, inputs: %lu, outputs: %lu, blockHeight: %u",
                   uint256_reverse_hex(txHash), (unsigned long)transaction.inputs.count, (unsigned long)transaction.outputs.count, transaction.blockHeight);
-        self.allTx[hash] = transaction;
-        [self.transactions insertObject:transaction atIndex:0];
+        transaction = [self setIndexedTransaction:transaction forHash:hash];
+        [self prepareTransactionOrdering];
+        [self.transactionOrdering insertTransaction:transaction intoTransactions:self.transactions];
+        [self.spendIndex addTransaction:transaction];
+        [self.coinJoinCoinIndex accountRegisteredTransaction:transaction];
         for (NSString *address in transaction.inputAddresses) {
             for (DSFundsDerivationPath *derivationPath in self.fundDerivationPaths) {
                 [derivationPath registerTransactionAddress:address]; //only will register if derivation path contains address
@@ -1472,6 +1652,8 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
             [self.transactionsToSave addObject:transaction];
         }
     }
+    // outside of the account lock, the wallet goes through every account the first time
+    [self.wallet.blockZones addBlockHeight:transaction.blockHeight];
     return YES;
 }
 
@@ -1507,7 +1689,7 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
             DSTransaction *tx = self.allTx[hash];
             uint32_t n = input.index;
             if ((tx && ![self transactionIsValid:tx]) ||
-                [self.spentOutputs containsObject:dsutxo_obj(((DSUTXO){h, n}))]) {
+                [self.spendIndex isOutpointSpent:(DSUTXO){h, n}]) {
                 return NO;
             }
         }
@@ -1519,8 +1701,9 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
     if (!output) {
         return false;
     }
-
-    return [self.spentOutputs containsObject:output];
+    DSUTXO outpoint;
+    [output getValue:&outpoint];
+    return [self.spendIndex isOutpointSpent:outpoint];
 }
 
 - (int64_t)inputValue:(UInt256)txHash inputIndex:(uint32_t)index {
@@ -1532,7 +1715,7 @@ static NSUInteger transactionAddressIndex(DSTransaction *transaction, NSArray *a
     }
 
     if (![self transactionIsValid:tx] ||
-        [self.spentOutputs containsObject:dsutxo_obj(((DSUTXO){txHash, index}))]) {
+        [self.spendIndex isOutpointSpent:(DSUTXO){txHash, index}]) {
         return -1;
     }
 
@@ -0,0 +1,49 @@
+//
+//  DSBlockZoneBitmap.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define BLOCK_ZONE_LENGTH 500
+
+/*! @brief One bit per zone of 500 blocks, set for every zone a transaction of the wallet was confirmed in. Between syncedStartHeight and syncedHeight the bitmap is complete, a zone without its bit holds nothing for the wallet and only its headers are needed on a rescan. Outside of that range nothing is known. A mainnet wallet takes under a kilobyte. */
+@interface DSBlockZoneBitmap : NSObject
+
+/*! @brief Every transaction of the wallet from syncedStartHeight up to syncedHeight, both included, had its zone set by syncs of the wallet's current addresses. The range is empty while the start is above the end, as it is initially. */
+@property (nonatomic, assign) uint32_t syncedStartHeight;
+@property (nonatomic, assign) uint32_t syncedHeight;
+@property (nonatomic, readonly) NSUInteger zoneCount;
+@property (nonatomic, readonly) NSData *data;
+
+/*! @brief Nil when the data was not written by a bitmap. */
+- (instancetype _Nullable)initWithData:(NSData *)data;
+
+/*! @brief Unconfirmed heights are ignored. */
+- (void)addBlockHeight:(uint32_t)height;
+- (void)addZonesFromBitmap:(DSBlockZoneBitmap *)bitmap;
+- (void)removeAllZones;
+
+- (BOOL)containsZone:(uint32_t)zone;
+/*! @brief Whether the heights lie within the synced range, the end height is excluded. */
+- (BOOL)isSyncedBetweenHeight:(uint32_t)startHeight andEndHeight:(uint32_t)endHeight;
+/*! @brief Whether a zone overlapping the heights is set, the end height is excluded. */
+- (BOOL)containsZoneBetweenHeight:(uint32_t)startHeight andEndHeight:(uint32_t)endHeight;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,139 @@
+//
+//  DSBlockZoneBitmap.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSBlockZoneBitmap.h"
+#import "DSTransaction.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+// version 1 had no synced start height and is dropped
+#define BLOCK_ZONE_BITMAP_VERSION 2
+// version and synced range
+#define BLOCK_ZONE_BITMAP_HEADER_LENGTH 9
+
+@interface DSBlockZoneBitmap ()
+
+@property (nonatomic, strong) NSMutableData *bits;
+
+@end
+
+@implementation DSBlockZoneBitmap
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.bits = [NSMutableData data];
+    self.syncedStartHeight = UINT32_MAX;
+    return self;
+}
+
+- (instancetype)initWithData:(NSData *)data {
+    if (data.length < BLOCK_ZONE_BITMAP_HEADER_LENGTH || [data UInt8AtOffset:0] != BLOCK_ZONE_BITMAP_VERSION) return nil;
+    if (!(self = [self init])) return nil;
+    self.syncedStartHeight = [data UInt32AtOffset:1];
+    self.syncedHeight = [data UInt32AtOffset:5];
+    [self.bits appendData:[data subdataWithRange:NSMakeRange(BLOCK_ZONE_BITMAP_HEADER_LENGTH, data.length - BLOCK_ZONE_BITMAP_HEADER_LENGTH)]];
+    return self;
+}
+
+- (NSData *)data {
+    @synchronized(self) {
+        NSMutableData *data = [NSMutableData dataWithCapacity:BLOCK_ZONE_BITMAP_HEADER_LENGTH + self.bits.length];
+        [data appendUInt8:BLOCK_ZONE_BITMAP_VERSION];
+        [data appendUInt32:self.syncedStartHeight];
+        [data appendUInt32:self.syncedHeight];
+        [data appendData:self.bits];
+        return data;
+    }
+}
+
+- (NSUInteger)zoneCount {
+    @synchronized(self) {
+        const uint8_t *bytes = self.bits.bytes;
+        NSUInteger count = 0;
+        for (NSUInteger i = 0; i < self.bits.length; i++) {
+            count += __builtin_popcount(bytes[i]);
+        }
+        return count;
+    }
+}
+
+- (void)addBlockHeight:(uint32_t)height {
+    if (height == TX_UNCONFIRMED) return;
+    uint32_t zone = height / BLOCK_ZONE_LENGTH;
+    @synchronized(self) {
+        if (self.bits.length <= zone / 8) self.bits.length = zone / 8 + 1;
+        ((uint8_t *)self.bits.mutableBytes)[zone / 8] |= 1 << (zone % 8);
+    }
+}
+
+- (void)addZonesFromBitmap:(DSBlockZoneBitmap *)bitmap {
+    NSData *bits;
+    @synchronized(bitmap) {
+        bits = [bitmap.bits copy];
+    }
+    @synchronized(self) {
+        if (self.bits.length < bits.length) self.bits.length = bits.length;
+        uint8_t *bytes = self.bits.mutableBytes;
+        const uint8_t *otherBytes = bits.bytes;
+        for (NSUInteger i = 0; i < bits.length; i++) {
+            bytes[i] |= otherBytes[i];
+        }
+    }
+}
+
+- (void)removeAllZones {
+    @synchronized(self) {
+        self.bits.length = 0;
+        self.syncedStartHeight = UINT32_MAX;
+        self.syncedHeight = 0;
+    }
+}
+
+- (BOOL)containsZone:(uint32_t)zone {
+    @synchronized(self) {
+        if (self.bits.length <= zone / 8) return NO;
+        return (((const uint8_t *)self.bits.bytes)[zone / 8] >> (zone % 8)) & 1;
+    }
+}
+
+- (BOOL)isSyncedBetweenHeight:(uint32_t)startHeight andEndHeight:(uint32_t)endHeight {
+    @synchronized(self) {
+        return startHeight >= self.syncedStartHeight && endHeight <= (uint64_t)self.syncedHeight + 1;
+    }
+}
+
+- (BOOL)containsZoneBetweenHeight:(uint32_t)startHeight andEndHeight:(uint32_t)endHeight {
+    uint32_t zone = startHeight / BLOCK_ZONE_LENGTH;
+    uint32_t endZone = endHeight / BLOCK_ZONE_LENGTH + (endHeight % BLOCK_ZONE_LENGTH ? 1 : 0);
+    @synchronized(self) {
+        const uint8_t *bytes = self.bits.bytes;
+        endZone = MIN(endZone, (uint32_t)self.bits.length * 8);
+        // single zones up to a byte boundary, then whole bytes
+        for (; zone < endZone && zone % 8; zone++) {
+            if ((bytes[zone / 8] >> (zone % 8)) & 1) return YES;
+        }
+        for (; zone + 8 <= endZone; zone += 8) {
+            if (bytes[zone / 8]) return YES;
+        }
+        for (; zone < endZone; zone++) {
+            if ((bytes[zone / 8] >> (zone % 8)) & 1) return YES;
+        }
+        return NO;
+    }
+}
+
+@end
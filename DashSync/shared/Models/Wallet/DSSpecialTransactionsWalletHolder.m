@@ -9,7 +9,7 @@
 #import "DSAssetUnlockTransaction.h"
 #import "DSSpecialTransactionsWalletHolder.h"
 #import "DSAddressEntity+CoreDataClass.h"
-#import "DSChain.h"
+#import "DSChain+Protected.h"
 #import "DSCreditFundingTransaction.h"
 #import "DSDerivationPath.h"
 #import "DSDerivationPathEntity+CoreDataClass.h"
@@ -26,6 +26,7 @@
 #import "DSSpecialTransactionEntity+CoreDataClass.h"
 #import "DSTransactionEntity+CoreDataClass.h"
 #import "DSTransactionHashEntity+CoreDataClass.h"
+#import "DSTransactionIndex.h"
 #import "DSTxInputEntity+CoreDataClass.h"
 #import "DSTxOutputEntity+CoreDataClass.h"
 #import "DSWallet+Protected.h"
@@ -109,6 +110,11 @@
 }
 
 - (void)removeAllTransactions {
+    NSMutableArray<NSValue *> *transactionHashes = [NSMutableArray array];
+    for (DSTransaction *transaction in [self allTransactions]) {
+        [transactionHashes addObject:uint256_obj(transaction.txHash)];
+    }
+    [self.wallet.chain.transactionIndex removeSpecialTransactionHashes:transactionHashes forWallet:self.wallet];
     for (NSMutableDictionary *transactionDictionary in [self transactionDictionaries]) {
         [transactionDictionary removeAllObjects];
     }
@@ -129,6 +135,9 @@
 
 - (BOOL)registerTransaction:(DSTransaction *)transaction saveImmediately:(BOOL)saveImmediately {
     BOOL added = FALSE;
+    // hold the object the accounts of the chain already share for this hash
+    DSTransaction *indexedTransaction = [self.wallet.chain.transactionIndex transactionForHash:transaction.txHash];
+    if ([indexedTransaction isMemberOfClass:[transaction class]]) transaction = indexedTransaction;
     if ([transaction isMemberOfClass:[DSProviderRegistrationTransaction class]]) {
         if (![self.providerRegistrationTransactions objectForKey:uint256_data(transaction.txHash)]) {
             [self.providerRegistrationTransactions setObject:transaction forKey:uint256_data(transaction.txHash)];
@@ -177,6 +186,7 @@
         return NO;
     }
     if (added) {
+        [self.wallet.chain.transactionIndex addSpecialTransaction:transaction forWallet:self.wallet];
         if (saveImmediately) {
             [transaction saveInitial];
         } else {
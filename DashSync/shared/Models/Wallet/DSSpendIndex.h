@@ -0,0 +1,49 @@
+//
+//  DSSpendIndex.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "BigIntTypes.h"
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSTransaction;
+
+/*! @brief Maps each outpoint spent by the transactions of an account to the transactions spending it, in the order they were added. It is kept up to date as transactions are added and removed, so whether an output is spent, by what, and which transactions spend the outputs of another are answered without walking the account's history. The balance update publishes the transactions it found invalid alongside the unspent outputs, an outpoint only counts as spent by a transaction that is not invalid. */
+@interface DSSpendIndex : NSObject
+
+@property (nonatomic, readonly) NSUInteger spentOutpointCount;
+
+/*! @brief Double spends and transactions spending them, as of the last balance update. */
+@property (nonatomic, copy) NSSet<NSValue *> *invalidTransactionHashes;
+
+/*! @brief Indexes the inputs of a transaction, coinbase transactions don't spend anything. Adding a transaction twice is harmless. */
+- (void)addTransaction:(DSTransaction *)transaction;
+- (void)removeTransaction:(DSTransaction *)transaction;
+- (void)removeAllTransactions;
+
+- (BOOL)isOutpointSpent:(DSUTXO)outpoint;
+/*! @brief The first transaction spending the outpoint that isn't invalid. */
+- (DSTransaction *_Nullable)spendingTransactionForOutpoint:(DSUTXO)outpoint;
+/*! @brief Every transaction spending the outpoint, double spends included. */
+- (NSArray<DSTransaction *> *)spendingTransactionsForOutpoint:(DSUTXO)outpoint;
+
+/*! @brief Transactions spending outputs of the transaction. */
+- (NSArray<DSTransaction *> *)transactionsSpendingOutputsOfTransaction:(DSTransaction *)transaction;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,140 @@
+//
+//  DSSpendIndex.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSSpendIndex.h"
+#import "DSCoinbaseTransaction.h"
+#import "DSTransaction.h"
+#import "DSTransactionInput.h"
+
+@interface DSSpendIndex ()
+
+// outpoint to its spending transaction, or to a mutable array of them once it has been double spent
+@property (nonatomic, strong) NSMutableDictionary<NSValue *, id> *spenders;
+
+@end
+
+@implementation DSSpendIndex
+
+@synthesize invalidTransactionHashes = _invalidTransactionHashes;
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.spenders = [NSMutableDictionary dictionary];
+    _invalidTransactionHashes = [NSSet set];
+    return self;
+}
+
+- (NSUInteger)spentOutpointCount {
+    @synchronized(self) {
+        return self.spenders.count;
+    }
+}
+
+- (NSSet<NSValue *> *)invalidTransactionHashes {
+    @synchronized(self) {
+        return _invalidTransactionHashes;
+    }
+}
+
+- (void)setInvalidTransactionHashes:(NSSet<NSValue *> *)invalidTransactionHashes {
+    @synchronized(self) {
+        _invalidTransactionHashes = [invalidTransactionHashes copy];
+    }
+}
+
+// MARK: - Updates
+
++ (BOOL)transactionSpendsOutpoints:(DSTransaction *)transaction {
+    return !transaction.isCoinbaseClassicTransaction && ![transaction isKindOfClass:[DSCoinbaseTransaction class]];
+}
+
+- (void)addTransaction:(DSTransaction *)transaction {
+    if (![DSSpendIndex transactionSpendsOutpoints:transaction]) return;
+    @synchronized(self) {
+        for (DSTransactionInput *input in transaction.inputs) {
+            NSValue *outpoint = dsutxo_obj(((DSUTXO){input.inputHash, input.index}));
+            id spender = self.spenders[outpoint];
+            if (!spender) {
+                self.spenders[outpoint] = transaction;
+            } else if ([spender isKindOfClass:[NSMutableArray class]]) {
+                if ([spender indexOfObjectIdenticalTo:transaction] == NSNotFound) [spender addObject:transaction];
+            } else if (spender != transaction) {
+                self.spenders[outpoint] = [NSMutableArray arrayWithObjects:spender, transaction, nil];
+            }
+        }
+    }
+}
+
+- (void)removeTransaction:(DSTransaction *)transaction {
+    if (![DSSpendIndex transactionSpendsOutpoints:transaction]) return;
+    @synchronized(self) {
+        for (DSTransactionInput *input in transaction.inputs) {
+            NSValue *outpoint = dsutxo_obj(((DSUTXO){input.inputHash, input.index}));
+            id spender = self.spenders[outpoint];
+            if ([spender isKindOfClass:[NSMutableArray class]]) {
+                [spender removeObjectIdenticalTo:transaction];
+                if ([spender count] == 1) self.spenders[outpoint] = [spender firstObject];
+            } else if (spender == transaction) {
+                [self.spenders removeObjectForKey:outpoint];
+            }
+        }
+    }
+}
+
+- (void)removeAllTransactions {
+    @synchronized(self) {
+        [self.spenders removeAllObjects];
+        _invalidTransactionHashes = [NSSet set];
+    }
+}
+
+// MARK: - Lookup
+
+- (NSArray<DSTransaction *> *)spendingTransactionsForOutpointValue:(NSValue *)outpoint {
+    @synchronized(self) {
+        id spender = self.spenders[outpoint];
+        if (!spender) return @[];
+        return [spender isKindOfClass:[NSMutableArray class]] ? [spender copy] : @[spender];
+    }
+}
+
+- (NSArray<DSTransaction *> *)spendingTransactionsForOutpoint:(DSUTXO)outpoint {
+    return [self spendingTransactionsForOutpointValue:dsutxo_obj(outpoint)];
+}
+
+- (DSTransaction *)spendingTransactionForOutpoint:(DSUTXO)outpoint {
+    NSSet<NSValue *> *invalidTransactionHashes = self.invalidTransactionHashes;
+    for (DSTransaction *transaction in [self spendingTransactionsForOutpoint:outpoint]) {
+        if (![invalidTransactionHashes containsObject:uint256_obj(transaction.txHash)]) return transaction;
+    }
+    return nil;
+}
+
+- (BOOL)isOutpointSpent:(DSUTXO)outpoint {
+    return [self spendingTransactionForOutpoint:outpoint] != nil;
+}
+
+- (NSArray<DSTransaction *> *)transactionsSpendingOutputsOfTransaction:(DSTransaction *)transaction {
+    NSMutableOrderedSet<DSTransaction *> *children = [NSMutableOrderedSet orderedSet];
+    UInt256 txHash = transaction.txHash;
+    for (uint32_t n = 0; n < transaction.outputs.count; n++) {
+        [children addObjectsFromArray:[self spendingTransactionsForOutpoint:(DSUTXO){txHash, n}]];
+    }
+    return children.array;
+}
+
+@end
@@ -0,0 +1,44 @@
+//
+//  DSTransactionOrdering.h
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DSTransaction;
+
+/*! @brief Orders account transactions by block height in descending order. Transactions at the same height are ordered topologically so spenders come before the transactions they spend, ties are broken by invalid and pending transactions first, then by the position of their outputs in the address chains, then by hash. Spent input hashes and output addresses are collected once per transaction and addresses are ranked by their index in their derivation path, so ordering doesn't scan the address chains. Not thread safe, the account serializes access. */
+@interface DSTransactionOrdering : NSObject
+
+@property (nonatomic, strong, nullable) NSSet<NSValue *> *invalidTransactionHashes;
+@property (nonatomic, strong, nullable) NSSet<NSValue *> *pendingTransactionHashes;
+
+/*! @brief Ranks addresses derived from index onwards in a derivation path. Address chains only ever grow so only newly derived addresses need to be added, an address keeps the first rank it was given. */
+- (void)addAddresses:(NSArray<NSString *> *)addresses startingAtIndex:(NSUInteger)index internal:(BOOL)internal;
+
+- (void)sortTransactions:(NSMutableOrderedSet<DSTransaction *> *)transactions;
+
+/*! @brief Binary searches the already sorted transactions for the transactions at the same height and orders the transaction among them. */
+- (void)insertTransaction:(DSTransaction *)transaction intoTransactions:(NSMutableOrderedSet<DSTransaction *> *)transactions;
+
+- (void)removeTransaction:(DSTransaction *)transaction;
+
+- (void)removeAllTransactions;
+
+@end
+
+NS_ASSUME_NONNULL_END
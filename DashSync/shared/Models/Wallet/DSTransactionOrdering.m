@@ -0,0 +1,200 @@
+//
+//  DSTransactionOrdering.m
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+//  Licensed under the MIT License (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  https://opensource.org/licenses/MIT
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DSTransactionOrdering.h"
+#import "DSTransaction.h"
+#import "DSTransactionInput.h"
+#import "DSTransactionOutput.h"
+#import "NSData+Dash.h"
+
+@interface DSTransactionOrderingNode : NSObject
+
+@property (nonatomic, strong) NSValue *transactionHash;
+@property (nonatomic, strong) NSSet<NSValue *> *inputHashes;
+@property (nonatomic, strong) NSArray<NSString *> *outputAddresses;
+
+@end
+
+@implementation DSTransactionOrderingNode
+
+@end
+
+@interface DSTransactionOrdering ()
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *externalAddressRanks;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *internalAddressRanks;
+@property (nonatomic, strong) NSMutableDictionary<NSValue *, DSTransactionOrderingNode *> *nodes;
+
+@end
+
+@implementation DSTransactionOrdering
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.nodes = [NSMutableDictionary dictionary];
+    self.externalAddressRanks = [NSMutableDictionary dictionary];
+    self.internalAddressRanks = [NSMutableDictionary dictionary];
+    return self;
+}
+
+// ranks are looked up when comparing so addresses derived after a transaction was ordered don't invalidate its node
+static NSUInteger transactionAddressRank(DSTransactionOrderingNode *node, NSDictionary<NSString *, NSNumber *> *ranks) {
+    for (NSString *address in node.outputAddresses) {
+        NSNumber *rank = ranks[address];
+        if (rank) return rank.unsignedIntegerValue;
+    }
+    return NSNotFound;
+}
+
+- (void)addAddresses:(NSArray<NSString *> *)addresses startingAtIndex:(NSUInteger)index internal:(BOOL)internal {
+    NSMutableDictionary<NSString *, NSNumber *> *ranks = internal ? self.internalAddressRanks : self.externalAddressRanks;
+    [addresses enumerateObjectsUsingBlock:^(NSString *address, NSUInteger idx, BOOL *stop) {
+        if ([address isKindOfClass:[NSString class]] && !ranks[address]) ranks[address] = @(index + idx);
+    }];
+}
+
+- (DSTransactionOrderingNode *)nodeForTransaction:(DSTransaction *)transaction {
+    NSValue *transactionHash = uint256_obj(transaction.txHash);
+    DSTransactionOrderingNode *node = self.nodes[transactionHash];
+    if (node) return node;
+    node = [[DSTransactionOrderingNode alloc] init];
+    node.transactionHash = transactionHash;
+    NSMutableSet<NSValue *> *inputHashes = [NSMutableSet setWithCapacity:transaction.inputs.count];
+    for (DSTransactionInput *input in transaction.inputs) {
+        [inputHashes addObject:uint256_obj(input.inputHash)];
+    }
+    node.inputHashes = inputHashes;
+    NSMutableArray<NSString *> *outputAddresses = [NSMutableArray arrayWithCapacity:transaction.outputs.count];
+    for (DSTransactionOutput *output in transaction.outputs) {
+        if (output.address) [outputAddresses addObject:output.address];
+    }
+    node.outputAddresses = outputAddresses;
+    self.nodes[transactionHash] = node;
+    return node;
+}
+
+static NSComparisonResult compareBlockHeights(DSTransaction *transaction1, DSTransaction *transaction2) {
+    if (transaction1.blockHeight > transaction2.blockHeight) return NSOrderedAscending;
+    if (transaction1.blockHeight < transaction2.blockHeight) return NSOrderedDescending;
+    return NSOrderedSame;
+}
+
+// 0 for the internal chain, 1 for the external chain, 2 for neither
+- (NSUInteger)addressChainOfNode:(DSTransactionOrderingNode *)node rank:(NSUInteger *)rank {
+    *rank = transactionAddressRank(node, self.internalAddressRanks);
+    if (*rank != NSNotFound) return 0;
+    *rank = transactionAddressRank(node, self.externalAddressRanks);
+    return (*rank != NSNotFound) ? 1 : 2;
+}
+
+// a strict weak ordering of transactions at the same height that don't spend each other
+- (NSComparisonResult)compareNode:(DSTransactionOrderingNode *)node1 toNode:(DSTransactionOrderingNode *)node2 {
+    BOOL invalid1 = [self.invalidTransactionHashes containsObject:node1.transactionHash], invalid2 = [self.invalidTransactionHashes containsObject:node2.transactionHash];
+    if (invalid1 != invalid2) return invalid1 ? NSOrderedAscending : NSOrderedDescending;
+    BOOL pending1 = [self.pendingTransactionHashes containsObject:node1.transactionHash], pending2 = [self.pendingTransactionHashes containsObject:node2.transactionHash];
+    if (pending1 != pending2) return pending1 ? NSOrderedAscending : NSOrderedDescending;
+    // transactions to the internal chain, then to the external chain, then the others, later addresses first
+    NSUInteger rank1 = NSNotFound, rank2 = NSNotFound;
+    NSUInteger chain1 = [self addressChainOfNode:node1 rank:&rank1], chain2 = [self addressChainOfNode:node2 rank:&rank2];
+    if (chain1 != chain2) return (chain1 < chain2) ? NSOrderedAscending : NSOrderedDescending;
+    if (chain1 != 2 && rank1 != rank2) return (rank1 > rank2) ? NSOrderedAscending : NSOrderedDescending;
+    UInt256 hash1 = UINT256_ZERO, hash2 = UINT256_ZERO;
+    [node1.transactionHash getValue:&hash1];
+    [node2.transactionHash getValue:&hash2];
+    return uint256_compare(hash1, hash2);
+}
+
+- (void)appendTransaction:(DSTransaction *)transaction
+                  spenders:(NSDictionary<NSValue *, NSArray<DSTransaction *> *> *)spenders
+                  appended:(NSMutableSet<NSValue *> *)appended
+            toTransactions:(NSMutableArray<DSTransaction *> *)sortedTransactions {
+    NSValue *transactionHash = uint256_obj(transaction.txHash);
+    if ([appended containsObject:transactionHash]) return;
+    [appended addObject:transactionHash];
+    for (DSTransaction *spender in spenders[transactionHash]) {
+        [self appendTransaction:spender spenders:spenders appended:appended toTransactions:sortedTransactions];
+    }
+    [sortedTransactions addObject:transaction];
+}
+
+// transactions at a single height, ordered topologically over the spends between them
+- (NSArray<DSTransaction *> *)sortedTransactionsAtHeight:(NSArray<DSTransaction *> *)transactions {
+    if (transactions.count < 2) return transactions;
+    NSArray<DSTransaction *> *orderedTransactions = [transactions sortedArrayUsingComparator:^NSComparisonResult(DSTransaction *transaction1, DSTransaction *transaction2) {
+        return [self compareNode:[self nodeForTransaction:transaction1] toNode:[self nodeForTransaction:transaction2]];
+    }];
+    NSMutableSet<NSValue *> *transactionHashes = [NSMutableSet setWithCapacity:transactions.count];
+    for (DSTransaction *transaction in transactions) {
+        [transactionHashes addObject:uint256_obj(transaction.txHash)];
+    }
+    // spenders are listed in tie break order since they are added in that order
+    NSMutableDictionary<NSValue *, NSMutableArray<DSTransaction *> *> *spenders = [NSMutableDictionary dictionary];
+    for (DSTransaction *transaction in orderedTransactions) {
+        for (NSValue *inputHash in [self nodeForTransaction:transaction].inputHashes) {
+            if (![transactionHashes containsObject:inputHash]) continue;
+            if (!spenders[inputHash]) spenders[inputHash] = [NSMutableArray array];
+            [spenders[inputHash] addObject:transaction];
+        }
+    }
+    NSMutableArray<DSTransaction *> *sortedTransactions = [NSMutableArray arrayWithCapacity:transactions.count];
+    NSMutableSet<NSValue *> *appended = [NSMutableSet setWithCapacity:transactions.count];
+    for (DSTransaction *transaction in orderedTransactions) {
+        [self appendTransaction:transaction spenders:spenders appended:appended toTransactions:sortedTransactions];
+    }
+    return sortedTransactions;
+}
+
+- (void)sortTransactions:(NSMutableOrderedSet<DSTransaction *> *)transactions {
+    NSArray<DSTransaction *> *transactionsByHeight = [transactions.array sortedArrayWithOptions:NSSortStable
+                                                                                usingComparator:^NSComparisonResult(DSTransaction *transaction1, DSTransaction *transaction2) {
+        return compareBlockHeights(transaction1, transaction2);
+    }];
+    NSMutableArray<DSTransaction *> *sortedTransactions = [NSMutableArray arrayWithCapacity:transactionsByHeight.count];
+    NSUInteger start = 0;
+    while (start < transactionsByHeight.count) {
+        NSUInteger end = start + 1;
+        while (end < transactionsByHeight.count && transactionsByHeight[end].blockHeight == transactionsByHeight[start].blockHeight) end++;
+        [sortedTransactions addObjectsFromArray:[self sortedTransactionsAtHeight:[transactionsByHeight subarrayWithRange:NSMakeRange(start, end - start)]]];
+        start = end;
+    }
+    [transactions removeAllObjects];
+    [transactions addObjectsFromArray:sortedTransactions];
+}
+
+- (void)insertTransaction:(DSTransaction *)transaction intoTransactions:(NSMutableOrderedSet<DSTransaction *> *)transactions {
+    NSRange range = NSMakeRange(0, transactions.count);
+    NSComparator comparator = ^NSComparisonResult(DSTransaction *transaction1, DSTransaction *transaction2) {
+        return compareBlockHeights(transaction1, transaction2);
+    };
+    NSUInteger start = [transactions indexOfObject:transaction inSortedRange:range options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual usingComparator:comparator];
+    NSUInteger end = [transactions indexOfObject:transaction inSortedRange:range options:NSBinarySearchingInsertionIndex | NSBinarySearchingLastEqual usingComparator:comparator];
+    NSMutableArray<DSTransaction *> *transactionsAtHeight = [[transactions.array subarrayWithRange:NSMakeRange(start, end - start)] mutableCopy];
+    [transactionsAtHeight addObject:transaction];
+    NSArray<DSTransaction *> *sortedTransactions = [self sortedTransactionsAtHeight:transactionsAtHeight];
+    [transactions removeObjectsInRange:NSMakeRange(start, end - start)];
+    [transactions insertObjects:sortedTransactions atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(start, sortedTransactions.count)]];
+}
+
+- (void)removeTransaction:(DSTransaction *)transaction {
+    [self.nodes removeObjectForKey:uint256_obj(transaction.txHash)];
+}
+
+- (void)removeAllTransactions {
+    [self.nodes removeAllObjects];
+}
+
+@end
@@ -19,6 +19,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class DSBlockZoneBitmap;
+
 @interface DSWallet ()
 
 @property (nonatomic, readonly) NSString *mnemonicUniqueID;
@@ -31,6 +33,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, strong) NSData *transientDerivedKeyData;
 
+/*! @brief Zones of 500 blocks the transactions of the wallet were confirmed in. */
+@property (nonatomic, readonly) DSBlockZoneBitmap *blockZones;
+
 //this is used from the account to help determine best start sync position for future resync
 - (void)setGuessedWalletCreationTime:(NSTimeInterval)guessedWalletCreationTime;
 
@@ -44,6 +49,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (NSData *)chainSynchronizationFingerprintForBlockZones:(NSOrderedSet *)blockHeightZones forChainHeight:(uint32_t)chainHeight;
 
+/*! @brief A sync starts after the block at that height. */
+- (void)blockZonesWillSyncFromHeight:(uint32_t)height;
+/*! @brief Every block up to the height was synced with a filter covering the wallet, the synced range of the block zones is extended and saved. */
+- (void)blockZonesSyncedToHeight:(uint32_t)height;
+/*! @brief The wallet derives addresses earlier syncs did not look for, no zone is skipped until it was synced again. */
+- (void)invalidateBlockZones;
+/*! @brief The next sync requests merkleblocks of every zone again. */
+- (void)wipeBlockZones;
+
 - (void)loadBlockchainIdentities;
 
 - (NSData *_Nullable)requestSeedNoAuth;
@@ -22,7 +22,7 @@
 //  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 //  THE SOFTWARE.
 
-#import "DSAccount.h"
+#import "DSAccount+Protected.h"
 #import "DSAccountEntity+CoreDataClass.h"
 #import "DSAddressEntity+CoreDataProperties.h"
 #import "DSAuthenticationKeysDerivationPath+Protected.h"
@@ -36,8 +36,10 @@
 #import "DSBlockchainIdentityUpdateTransition.h"
 #import "DSBlockchainIdentityUsernameEntity+CoreDataClass.h"
 #import "DSBlockchainInvitation+Protected.h"
+#import "DSBlockZoneBitmap.h"
 #import "DSChain+Protected.h"
 #import "DSChainsManager.h"
+#import "DSCoinJoinCoinIndex.h"
 #import "DSCreditFundingDerivationPath+Protected.h"
 #import "DSCreditFundingTransaction.h"
 #import "DSCreditFundingTransactionEntity+CoreDataClass.h"
@@ -71,6 +73,8 @@
 
 #define WALLET_ACCOUNTS_KNOWN_KEY @"WALLET_ACCOUNTS_KNOWN_KEY"
 
+#define WALLET_BLOCK_ZONES_KEY @"WALLET_BLOCK_ZONES_KEY"
+
 #define WALLET_MASTERNODE_VOTERS_KEY @"WALLET_MASTERNODE_VOTERS_KEY"
 #define WALLET_MASTERNODE_OWNERS_KEY @"WALLET_MASTERNODE_OWNERS_KEY"
 #define WALLET_MASTERNODE_OPERATORS_KEY @"WALLET_MASTERNODE_OPERATORS_KEY"
@@ -94,6 +98,9 @@
 @property (nonatomic, assign) BOOL checkedWalletCreationTime;
 @property (nonatomic, assign) BOOL checkedGuessedWalletCreationTime;
 @property (nonatomic, assign) BOOL checkedVerifyWalletCreationTime;
+@property (nonatomic, strong) DSBlockZoneBitmap *blockZones;
+// first block of the running sync the current addresses were looked for in, UINT32_MAX when unknown
+@property (nonatomic, assign) uint32_t blockZonesSyncStartHeight;
 
 @property (nonatomic, strong) NSMutableDictionary<NSData *, NSNumber *> *mMasternodeOperatorIndexes;
 @property (nonatomic, strong) NSMutableDictionary<NSData *, NSNumber *> *mMasternodeOwnerIndexes;
@@ -173,6 +180,7 @@
     self.checkedWalletCreationTime = NO;
     self.checkedGuessedWalletCreationTime = NO;
     self.checkedVerifyWalletCreationTime = NO;
+    self.blockZonesSyncStartHeight = UINT32_MAX;
     return self;
 }
 
@@ -400,6 +408,7 @@
     uint32_t lastAccountNumber = [self lastAccountNumber];
     if (lastAccountNumber > [self accountsKnown]) {
         setKeychainInt(lastAccountNumber, [DSWallet accountsKnownKeyForWalletUniqueID:[self uniqueIDString]], NO);
+        [self invalidateBlockZones];
     }
 }
 
@@ -486,6 +495,12 @@
     return [NSString stringWithFormat:@"%@_%@", VERIFIED_WALLET_CREATION_TIME_KEY, uniqueID];
 }
 
++ (NSString *)blockZonesUniqueIDForUniqueID:(NSString *)uniqueID {
+    NSParameterAssert(uniqueID);
+
+    return [NSString stringWithFormat:@"%@_%@", WALLET_BLOCK_ZONES_KEY, uniqueID];
+}
+
 - (NSString *)creationTimeUniqueID {
     return [DSWallet creationTimeUniqueIDForUniqueID:self.uniqueIDString];
 }
@@ -498,6 +513,10 @@
     return [DSWallet didVerifyCreationTimeUniqueIDForUniqueID:self.uniqueIDString];
 }
 
+- (NSString *)blockZonesUniqueID {
+    return [DSWallet blockZonesUniqueIDForUniqueID:self.uniqueIDString];
+}
+
 // MARK: - Wallet Creation Time
 
 - (NSTimeInterval)walletCreationTime {
@@ -527,6 +546,11 @@
     setKeychainData(nil, self.creationTimeUniqueID, NO);
     setKeychainData(nil, self.creationGuessTimeUniqueID, NO);
     setKeychainData(nil, self.didVerifyCreationTimeUniqueID, NO);
+    [self wipeBlockZones];
+    for (DSAccount *account in self.accounts) {
+        [account wipeBalanceSnapshot];
+        [DSCoinJoinCoinIndex wipeKnownRoundsForAccount:account];
+    }
 }
 
 - (NSTimeInterval)guessedWalletCreationTime {
@@ -583,6 +607,72 @@
     }
 }
 
+// MARK: - Block Zones
+
+// kept in the keychain and removed with the other wallet info, a wallet restored from its seed phrase starts from its transactions
+- (DSBlockZoneBitmap *)blockZones {
+    @synchronized(self) {
+        if (_blockZones) return _blockZones;
+        NSData *data = self.isTransient ? nil : getKeychainData(self.blockZonesUniqueID, nil);
+        _blockZones = data ? [[DSBlockZoneBitmap alloc] initWithData:data] : nil;
+        if (!_blockZones) {
+            // the history is in memory once the accounts are loaded, no zone is skipped until the next sync
+            _blockZones = [[DSBlockZoneBitmap alloc] init];
+            for (DSTransaction *transaction in self.allTransactions) {
+                [_blockZones addBlockHeight:transaction.blockHeight];
+            }
+        }
+        return _blockZones;
+    }
+}
+
+- (void)saveBlockZones {
+    if (!self.isTransient) setKeychainData(self.blockZones.data, self.blockZonesUniqueID, NO);
+}
+
+- (void)blockZonesWillSyncFromHeight:(uint32_t)height {
+    @synchronized(self) {
+        self.blockZonesSyncStartHeight = height + 1;
+    }
+}
+
+- (void)blockZonesSyncedToHeight:(uint32_t)height {
+    DSBlockZoneBitmap *blockZones = self.blockZones;
+    @synchronized(self) {
+        uint32_t startHeight = self.blockZonesSyncStartHeight;
+        if (startHeight == UINT32_MAX || startHeight > height + 1) return;
+        // a sync continuing the synced range extends it, any other replaces it
+        if (startHeight < blockZones.syncedStartHeight || startHeight > (uint64_t)blockZones.syncedHeight + 1 || blockZones.syncedStartHeight > blockZones.syncedHeight) {
+            blockZones.syncedStartHeight = startHeight;
+        }
+        blockZones.syncedHeight = height;
+        self.blockZonesSyncStartHeight = height + 1;
+    }
+    [self saveBlockZones];
+}
+
+- (void)invalidateBlockZones {
+    @synchronized(self) {
+        self.blockZonesSyncStartHeight = self.chain.lastSyncBlockHeight + 1;
+        // accounts are still being added while the wallet loads, the bitmap is not filled from a partial history
+        DSBlockZoneBitmap *blockZones = _blockZones;
+        if (!blockZones) {
+            NSData *data = self.isTransient ? nil : getKeychainData(self.blockZonesUniqueID, nil);
+            blockZones = data ? [[DSBlockZoneBitmap alloc] initWithData:data] : nil;
+            if (!blockZones) return;
+        }
+        // the zones stay set, past syncs just did not look for the new addresses
+        blockZones.syncedStartHeight = UINT32_MAX;
+        blockZones.syncedHeight = 0;
+        if (!self.isTransient) setKeychainData(blockZones.data, self.blockZonesUniqueID, NO);
+    }
+}
+
+- (void)wipeBlockZones {
+    [self.blockZones removeAllZones];
+    setKeychainData(nil, self.blockZonesUniqueID, NO);
+}
+
 // MARK: - Chain Synchronization Fingerprint
 
 - (NSData *)chainSynchronizationFingerprint {
@@ -1032,9 +1122,10 @@
             [self chainUpdatedBlockHeight:height];
         }
     }
-    [self.specialTransactionsHolder setBlockHeight:height
-                                      andTimestamp:timestamp
-                              forTransactionHashes:txHashes];
+    NSArray *fromSpecialTransactions = [self.specialTransactionsHolder setBlockHeight:height
+                                                                         andTimestamp:timestamp
+                                                                 forTransactionHashes:txHashes];
+    if (updated.count || fromSpecialTransactions.count) [self.blockZones addBlockHeight:height];
     return [updated copy];
 }
 
@@ -1218,6 +1309,7 @@
 
     if ([self.mBlockchainIdentities objectForKey:blockchainIdentity.uniqueIDData] == nil) {
         [self addBlockchainIdentity:blockchainIdentity];
+        [self invalidateBlockZones];
     }
     NSError *error = nil;
     NSMutableDictionary *keyChainDictionary = [getKeychainDict(self.walletBlockchainIdentitiesKey, @[[NSNumber class], [NSData class]], &error) mutableCopy];
@@ -0,0 +1,192 @@
+//
+//  DSAddressManagerTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAddressManager.h"
+#import "DSChain+Protected.h"
+#import "DSPeer.h"
+
+#define SIMULATED_GROUP_COUNT 200
+#define SIMULATED_ADDRESSES_PER_GROUP 20
+#define SIMULATED_FLOOD_COUNT 10000
+#define SIMULATED_CONNECTION_COUNT 8
+
+@interface DSAddressManagerTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+
+@end
+
+@implementation DSAddressManagerTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+}
+
+- (DSPeer *)peerWithIPv4:(uint32_t)ip {
+    UInt128 address = {.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), CFSwapInt32HostToBig(ip)}};
+    return [[DSPeer alloc] initWithAddress:address port:9999 onChain:self.chain timestamp:[NSDate timeIntervalSince1970] - HOUR_TIME_INTERVAL services:SERVICES_NODE_NETWORK | SERVICES_NODE_BLOOM];
+}
+
+- (DSNetworkAddress)overlayAddressOfType:(DSNetworkAddressType)type seed:(uint8_t)seed {
+    DSNetworkAddress address = {.type = type, .port = 9999, .services = SERVICES_NODE_NETWORK, .timestamp = (uint32_t)[NSDate timeIntervalSince1970]};
+    memset(address.bytes, seed, sizeof(address.bytes));
+    return address;
+}
+
+// honest peers spread over many /16 groups, each relayed by peers of other groups
+- (void)addHonestAddressesTo:(DSAddressManager *)addressManager {
+    for (uint32_t group = 0; group < SIMULATED_GROUP_COUNT; group++) {
+        for (uint32_t i = 0; i < SIMULATED_ADDRESSES_PER_GROUP; i++) {
+            DSPeer *source = [self peerWithIPv4:(60 << 24) | ((group * 7 + i) % SIMULATED_GROUP_COUNT) << 16 | 1];
+            [addressManager addPeers:@[[self peerWithIPv4:(20 << 24) | group << 16 | i << 8 | 1]] fromSource:source];
+        }
+    }
+}
+
+// a single peer relays fresh addresses from two /16 groups it controls
+- (void)addFloodedAddressesTo:(DSAddressManager *)addressManager {
+    DSPeer *attacker = [self peerWithIPv4:(200 << 24) | 1];
+    for (uint32_t i = 0; i < SIMULATED_FLOOD_COUNT; i++) {
+        [addressManager addPeers:@[[self peerWithIPv4:(200 << 24) | (i % 2) << 16 | (i / 2)]] fromSource:attacker];
+    }
+}
+
+- (BOOL)isFloodedPeer:(DSPeer *)peer {
+    return CFSwapInt32BigToHost(peer.address.u32[3]) >> 24 == 200;
+}
+
+- (void)testSourceGroupFillsBoundedBuckets {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    [self addFloodedAddressesTo:addressManager];
+    XCTAssertLessThanOrEqual(addressManager.count, ADDRESS_MANAGER_NEW_BUCKETS_PER_SOURCE_GROUP * ADDRESS_MANAGER_BUCKET_SIZE);
+    XCTAssertEqual(addressManager.triedCount, 0);
+}
+
+- (void)testConnectedPeerMovesToTried {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    DSPeer *peer = [self peerWithIPv4:0x01020304];
+    XCTAssertTrue([addressManager addPeers:@[peer] fromSource:nil]);
+    XCTAssertFalse([addressManager addPeers:@[peer] fromSource:nil]);
+    XCTAssertEqual(addressManager.newCount, 1);
+    [addressManager markAttemptToPeer:peer];
+    [addressManager markPeerConnected:peer];
+    XCTAssertEqual(addressManager.newCount, 0);
+    XCTAssertEqual(addressManager.triedCount, 1);
+    XCTAssertEqualObjects([addressManager peerAtAddress:peer.address port:peer.port], peer);
+}
+
+- (void)testOverlayAddressesAreKeptButNotSelected {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    UInt128 ipv6Address = {.u8 = {0x2a, 0x01, 0x04, 0xf8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}};
+    DSPeer *ipv6Peer = [[DSPeer alloc] initWithAddress:ipv6Address port:9999 onChain:self.chain timestamp:[NSDate timeIntervalSince1970] services:SERVICES_NODE_NETWORK];
+    XCTAssertTrue([addressManager addPeers:@[ipv6Peer] fromSource:nil]);
+    XCTAssertTrue([addressManager addNetworkAddress:[self overlayAddressOfType:DSNetworkAddressType_TorV3 seed:1] fromSource:ipv6Peer]);
+    XCTAssertTrue([addressManager addNetworkAddress:[self overlayAddressOfType:DSNetworkAddressType_I2P seed:2] fromSource:ipv6Peer]);
+    XCTAssertFalse([addressManager addNetworkAddress:[self overlayAddressOfType:DSNetworkAddressType_TorV2 seed:3] fromSource:ipv6Peer]);
+    XCTAssertEqual(addressManager.count, 3);
+    for (NSUInteger i = 0; i < 20; i++) {
+        XCTAssertEqualObjects([addressManager selectPeerExcludingPeers:[NSSet set]], ipv6Peer);
+    }
+    XCTAssertNil([addressManager selectPeerExcludingPeers:[NSSet setWithObject:ipv6Peer]]);
+}
+
+- (void)testBannedPeerIsDropped {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    DSPeer *peer = [self peerWithIPv4:0x05060708];
+    [addressManager addPeers:@[peer] fromSource:nil];
+    [addressManager banPeer:peer];
+    XCTAssertEqual(addressManager.count, 0);
+    XCTAssertFalse([addressManager addPeers:@[peer] fromSource:nil]);
+}
+
+- (void)testSerializationRoundTrip {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    [self addHonestAddressesTo:addressManager];
+    DSPeer *connectedPeer = [self peerWithIPv4:0x0a0b0c0d];
+    connectedPeer.lowPreferenceTill = 1234567;
+    [addressManager markPeerConnected:connectedPeer];
+    [addressManager updatePeer:connectedPeer];
+    DSPeer *bannedPeer = [self peerWithIPv4:0x0a0b0c0e];
+    [addressManager banPeer:bannedPeer];
+    NSData *data = [addressManager serializedData];
+
+    DSAddressManager *loadedAddressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    XCTAssertTrue([loadedAddressManager loadSerializedData:data]);
+    XCTAssertEqual(loadedAddressManager.count, addressManager.count);
+    XCTAssertEqual(loadedAddressManager.triedCount, 1);
+    XCTAssertEqual([loadedAddressManager peerAtAddress:connectedPeer.address port:connectedPeer.port].lowPreferenceTill, 1234567);
+    XCTAssertFalse([loadedAddressManager addPeers:@[bannedPeer] fromSource:nil]);
+    XCTAssertEqualObjects([loadedAddressManager serializedData], data);
+
+    XCTAssertFalse([loadedAddressManager loadSerializedData:[data subdataWithRange:NSMakeRange(0, data.length - 1)]]);
+}
+
+- (void)testFasterPeersArePreferred {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    DSPeer *fastPeer = [self peerWithIPv4:0x0b000001], *slowPeer = [self peerWithIPv4:0x0c000001];
+    [fastPeer setValue:@(0.05) forKey:@"pingTime"];
+    [slowPeer setValue:@(2.0) forKey:@"pingTime"];
+    [addressManager markPeerConnected:fastPeer];
+    [addressManager markPeerConnected:slowPeer];
+    NSUInteger fastCount = 0;
+    for (NSUInteger i = 0; i < 1000; i++) {
+        if ([[addressManager selectPeerExcludingPeers:[NSSet set]] isEqual:fastPeer]) fastCount++;
+    }
+    XCTAssertGreaterThan(fastCount, 600);
+}
+
+// MARK: - Simulated address space
+
+- (void)testSelectedPeersAreDiverseUnderFlood {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    [self addHonestAddressesTo:addressManager];
+    [self addFloodedAddressesTo:addressManager];
+    NSMutableSet<DSPeer *> *connectedPeers = [NSMutableSet set];
+    NSMutableSet<NSData *> *groups = [NSMutableSet set];
+    NSUInteger floodedCount = 0;
+    while (connectedPeers.count < SIMULATED_CONNECTION_COUNT) {
+        DSPeer *peer = [addressManager selectPeerExcludingPeers:connectedPeers];
+        XCTAssertNotNil(peer);
+        if (!peer) break;
+        [connectedPeers addObject:peer];
+        [groups addObject:[DSAddressManager groupOfNetworkAddress:[DSAddressManager networkAddressOfPeer:peer]]];
+        if ([self isFloodedPeer:peer]) floodedCount++;
+    }
+    // the flooding peer controls two groups, it can't hold more than two of the connections
+    XCTAssertEqual(groups.count, SIMULATED_CONNECTION_COUNT);
+    XCTAssertLessThanOrEqual(floodedCount, 2);
+}
+
+// flooded addresses never answer, honest ones answer half of the time
+- (void)testPerformanceEstablishingConnectionsUnderFlood {
+    DSAddressManager *addressManager = [[DSAddressManager alloc] initWithChain:self.chain];
+    [self addHonestAddressesTo:addressManager];
+    [self addFloodedAddressesTo:addressManager];
+    __block NSUInteger attempts = 0;
+    [self measureBlock:^{
+        NSMutableSet<DSPeer *> *connectedPeers = [NSMutableSet set], *failedPeers = [NSMutableSet set];
+        attempts = 0;
+        while (connectedPeers.count < SIMULATED_CONNECTION_COUNT && attempts < 1000) {
+            DSPeer *peer = [addressManager selectPeerExcludingPeers:[connectedPeers setByAddingObjectsFromSet:failedPeers]];
+            if (!peer) break;
+            attempts++;
+            [addressManager markAttemptToPeer:peer];
+            if (![self isFloodedPeer:peer] && (CFSwapInt32BigToHost(peer.address.u32[3]) >> 8) % 2 == 0) {
+                [addressManager markPeerConnected:peer];
+                [connectedPeers addObject:peer];
+            } else {
+                [failedPeers addObject:peer];
+            }
+        }
+        XCTAssertEqual(connectedPeers.count, SIMULATED_CONNECTION_COUNT);
+    }];
+    XCTAssertLessThan(attempts, 100);
+}
+
+@end
@@ -0,0 +1,291 @@
+//
+//  DSBlockZoneBitmapTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAccount.h"
+#import "DSBlock+Protected.h"
+#import "DSBlockZoneBitmap.h"
+#import "DSChain+Protected.h"
+#import "DSChainManager+Protected.h"
+#import "DSChainManager+Transactions.h"
+#import "DSMerkleBlock.h"
+#import "DSMerkleBlockBackfill.h"
+#import "DSPeer.h"
+#import "DSTransaction.h"
+#import "DSWallet+Protected.h"
+#import "NSData+DSHash.h"
+#import "NSData+Dash.h"
+#import "NSDate+Utils.h"
+#import "NSMutableData+Dash.h"
+#import "NSString+Dash.h"
+
+#define RESTORE_START_HEIGHT 10000
+#define RESTORE_ZONE_COUNT 16
+#define RESTORE_PEER_COUNT 4
+#define RESTORE_LATENCY 0.04
+#define RESTORE_BLOCK_INTERVAL 0.0002
+
+@interface DSBlockZoneBitmapTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) DSWallet *wallet;
+@property (nonatomic, strong) NSArray<DSBlock *> *headers;
+@property (nonatomic, strong) NSDictionary<NSValue *, NSData *> *messagesByBlockHash;
+
+@end
+
+@implementation DSBlockZoneBitmapTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    // wallets other tests left on the devnet were never synced and would have every zone requested
+    for (DSWallet *wallet in [self.chain.wallets copy]) {
+        if (wallet.isTransient) [self.chain unregisterWallet:wallet];
+    }
+    self.wallet = [DSWallet transientWalletWithDerivedKeyData:@"b00102030405060708090a0b0c0d0e0f".hexToData forChain:self.chain];
+    [self.chain addWallet:self.wallet];
+}
+
+- (void)tearDown {
+    self.chain.chainManager.skipsZonesWithoutWalletActivity = NO;
+    [self.chain unregisterWallet:self.wallet];
+}
+
+- (void)testZonesOfHeights {
+    DSBlockZoneBitmap *bitmap = [[DSBlockZoneBitmap alloc] init];
+    [bitmap addBlockHeight:499];
+    [bitmap addBlockHeight:500];
+    [bitmap addBlockHeight:999];
+    [bitmap addBlockHeight:2000000];
+    [bitmap addBlockHeight:TX_UNCONFIRMED];
+    XCTAssertEqual(bitmap.zoneCount, 3);
+    XCTAssertTrue([bitmap containsZone:0]);
+    XCTAssertTrue([bitmap containsZone:1]);
+    XCTAssertFalse([bitmap containsZone:2]);
+    XCTAssertTrue([bitmap containsZone:4000]);
+    XCTAssertFalse([bitmap containsZone:100000]);
+    // the end height is excluded, a zone it starts is not
+    XCTAssertFalse([bitmap containsZoneBetweenHeight:1000 andEndHeight:2000000]);
+    XCTAssertTrue([bitmap containsZoneBetweenHeight:1000 andEndHeight:2000001]);
+    XCTAssertTrue([bitmap containsZoneBetweenHeight:1999999 andEndHeight:2000001]);
+    XCTAssertTrue([bitmap containsZoneBetweenHeight:990 andEndHeight:1000]);
+    XCTAssertFalse([bitmap containsZoneBetweenHeight:2000500 andEndHeight:3000000]);
+}
+
+- (void)testBitmapIsKeptAsData {
+    DSBlockZoneBitmap *bitmap = [[DSBlockZoneBitmap alloc] init];
+    for (uint32_t height = 0; height < 2000000; height += 37000) {
+        [bitmap addBlockHeight:height];
+    }
+    bitmap.syncedStartHeight = 1000;
+    bitmap.syncedHeight = 2000000;
+    XCTAssertLessThan(bitmap.data.length, 600);
+    DSBlockZoneBitmap *readBitmap = [[DSBlockZoneBitmap alloc] initWithData:bitmap.data];
+    XCTAssertEqual(readBitmap.syncedStartHeight, 1000);
+    XCTAssertEqual(readBitmap.syncedHeight, 2000000);
+    XCTAssertEqual(readBitmap.zoneCount, bitmap.zoneCount);
+    XCTAssertEqualObjects(readBitmap.data, bitmap.data);
+    XCTAssertNil([[DSBlockZoneBitmap alloc] initWithData:@"ff00".hexToData]);
+    XCTAssertNil([[DSBlockZoneBitmap alloc] initWithData:@"0180841e0001".hexToData], @"version 1 had no synced start height");
+}
+
+- (void)testSyncedRange {
+    DSBlockZoneBitmap *bitmap = [[DSBlockZoneBitmap alloc] init];
+    XCTAssertFalse([bitmap isSyncedBetweenHeight:0 andEndHeight:1]);
+    bitmap.syncedStartHeight = 1001;
+    bitmap.syncedHeight = 5000;
+    XCTAssertTrue([bitmap isSyncedBetweenHeight:1001 andEndHeight:5001]);
+    XCTAssertFalse([bitmap isSyncedBetweenHeight:1000 andEndHeight:1500]);
+    XCTAssertFalse([bitmap isSyncedBetweenHeight:4500 andEndHeight:5002]);
+}
+
+- (void)testBitmapsOfWalletsAreMerged {
+    DSBlockZoneBitmap *bitmap = [[DSBlockZoneBitmap alloc] init], *otherBitmap = [[DSBlockZoneBitmap alloc] init];
+    [bitmap addBlockHeight:100];
+    [otherBitmap addBlockHeight:100000];
+    [bitmap addZonesFromBitmap:otherBitmap];
+    XCTAssertEqual(bitmap.zoneCount, 2);
+    XCTAssertTrue([bitmap containsZone:200]);
+}
+
+- (void)testRegisteredTransactionsMarkTheirZone {
+    DSAccount *account = [self.wallet accountWithNumber:0];
+    DSTransaction *transaction = [[DSTransaction alloc] initOnChain:self.chain];
+    [transaction addInputHash:@"01".hexToData.SHA256 index:0 script:nil signature:nil sequence:TXIN_SEQUENCE];
+    [transaction addOutputAddress:account.receiveAddress amount:DUFFS];
+    transaction.txHash = transaction.toData.SHA256_2;
+    XCTAssertTrue([account registerTransaction:transaction saveImmediately:NO]);
+    XCTAssertEqual(self.wallet.blockZones.zoneCount, 0, @"not confirmed yet");
+    [self.wallet setBlockHeight:12345 andTimestamp:[NSDate timeIntervalSince1970] forTransactionHashes:@[uint256_obj(transaction.txHash)]];
+    XCTAssertEqual(self.wallet.blockZones.zoneCount, 1);
+    XCTAssertTrue([self.wallet.blockZones containsZone:12345 / BLOCK_ZONE_LENGTH]);
+}
+
+- (void)testOnlyZonesWithActivityAreRequestedWithinTheSyncedRange {
+    DSChainManager *chainManager = self.chain.chainManager;
+    [self.wallet.blockZones addBlockHeight:1200];
+    [self.wallet blockZonesWillSyncFromHeight:499];
+    [self.wallet blockZonesSyncedToHeight:5000];
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000], @"every zone is requested unless the rescan skips them");
+
+    chainManager.skipsZonesWithoutWalletActivity = YES;
+    XCTAssertFalse([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000]);
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:0 andEndHeight:500], @"before the synced range");
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:1000 andEndHeight:1500]);
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:4500 andEndHeight:5500], @"past the synced height");
+    XCTAssertFalse([chainManager shouldRequestMerkleBlocksForZoneAfterHeight:2000]);
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneAfterHeight:500]);
+
+    // a sync continuing the range extends it
+    [self.wallet blockZonesWillSyncFromHeight:5000];
+    [self.wallet blockZonesSyncedToHeight:6000];
+    XCTAssertFalse([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000]);
+    XCTAssertFalse([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:5000 andEndHeight:5500]);
+
+    [self.wallet wipeBlockZones];
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000]);
+}
+
+- (void)testNewAddressesInvalidateTheSyncedRange {
+    DSChainManager *chainManager = self.chain.chainManager;
+    chainManager.skipsZonesWithoutWalletActivity = YES;
+    [self.wallet.blockZones addBlockHeight:1200];
+    [self.wallet blockZonesWillSyncFromHeight:499];
+    [self.wallet blockZonesSyncedToHeight:5000];
+    XCTAssertFalse([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000]);
+
+    [self.wallet invalidateBlockZones];
+    XCTAssertTrue([self.wallet.blockZones containsZone:1200 / BLOCK_ZONE_LENGTH], @"zones with activity stay set");
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000]);
+    XCTAssertTrue([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:2000 andEndHeight:2500]);
+
+    // only a sync that looked for the new addresses makes the range skippable again
+    [self.wallet blockZonesWillSyncFromHeight:499];
+    [self.wallet blockZonesSyncedToHeight:5000];
+    XCTAssertFalse([chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:500 andEndHeight:1000]);
+}
+
+// MARK: - Restore time against a synthetic chain
+
+// every block matching a single transaction
+- (void)buildChain {
+    NSMutableArray<DSBlock *> *headers = [NSMutableArray array];
+    NSMutableDictionary<NSValue *, NSData *> *messagesByBlockHash = [NSMutableDictionary dictionary];
+    UInt256 prevBlock = [NSData dataWithBytes:"base" length:4].SHA256_2;
+    for (uint32_t height = RESTORE_START_HEIGHT; height < RESTORE_START_HEIGHT + RESTORE_ZONE_COUNT * BLOCK_ZONE_LENGTH; height++) {
+        UInt256 transactionHash = [NSData dataWithBytes:&height length:sizeof(height)].SHA256_2;
+        NSMutableData *message = [NSMutableData data];
+        [message appendUInt32:2];
+        [message appendUInt256:prevBlock];
+        [message appendUInt256:transactionHash];
+        [message appendUInt32:1600000000 + height * 150];
+        [message appendUInt32:0x207fffff];
+        [message appendUInt32:0];
+        NSMutableData *header = [message mutableCopy];
+        [header appendUInt8:0];
+        [message appendUInt32:1];
+        [message appendVarInt:1];
+        [message appendUInt256:transactionHash];
+        [message appendVarInt:1];
+        [message appendUInt8:1];
+        DSMerkleBlock *block = [DSMerkleBlock merkleBlockWithMessage:header onChain:self.chain];
+        block.height = height;
+        [headers addObject:block];
+        messagesByBlockHash[block.blockHashValue] = message;
+        prevBlock = block.blockHash;
+    }
+    self.headers = headers;
+    self.messagesByBlockHash = messagesByBlockHash;
+}
+
+// the wallet had transactions in 3 of the zones the last time it was synced
+- (void)recordWalletActivity {
+    [self.wallet wipeBlockZones];
+    for (NSNumber *zone in @[@2, @9, @10]) {
+        [self.wallet.blockZones addBlockHeight:RESTORE_START_HEIGHT + zone.unsignedIntValue * BLOCK_ZONE_LENGTH + 42];
+    }
+    [self.wallet blockZonesWillSyncFromHeight:RESTORE_START_HEIGHT - 1];
+    [self.wallet blockZonesSyncedToHeight:RESTORE_START_HEIGHT + RESTORE_ZONE_COUNT * BLOCK_ZONE_LENGTH];
+    self.chain.chainManager.skipsZonesWithoutWalletActivity = YES;
+}
+
+- (DSMerkleBlockBackfill *)restoreBackfillWithExpectation:(XCTestExpectation *)expectation {
+    DSChainManager *chainManager = self.chain.chainManager;
+    DSBlock *lastHeader = self.headers.lastObject;
+    return [[DSMerkleBlockBackfill alloc] initWithHeaders:self.headers
+        zoneFilter:^BOOL(DSBlock *firstHeader, DSBlock *lastHeader) {
+            return [chainManager shouldRequestMerkleBlocksForZoneBetweenHeight:firstHeader.height andEndHeight:lastHeader.height + 1];
+        }
+        usingBlock:^BOOL(DSBlock *block, BOOL isHeaderOnly, DSPeer *peer) {
+            if (block.height == lastHeader.height) [expectation fulfill];
+            return YES;
+        }];
+}
+
+// each peer answers a range after a round trip, its blocks taking their share of the link
+- (void)requestRangesOfBackfill:(DSMerkleBlockBackfill *)backfill fromPeers:(NSArray<DSPeer *> *)peers queue:(dispatch_queue_t)queue {
+    for (DSPeer *peer in peers) {
+        NSArray<NSValue *> *blockHashes = [backfill nextBlockHashesForPeer:peer];
+        if (!blockHashes.count) continue;
+        NSTimeInterval delay = RESTORE_LATENCY + blockHashes.count * RESTORE_BLOCK_INTERVAL;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), queue, ^{
+            for (NSValue *blockHash in blockHashes) {
+                [backfill receivedBlock:[DSMerkleBlock merkleBlockWithMessage:self.messagesByBlockHash[blockHash] onChain:self.chain] fromPeer:peer];
+            }
+            [self requestRangesOfBackfill:backfill fromPeers:peers queue:queue];
+        });
+    }
+}
+
+- (void)restoreWithBackfill:(DSMerkleBlockBackfill *)backfill expectation:(XCTestExpectation *)expectation {
+    dispatch_queue_t queue = dispatch_queue_create("org.dashcore.dashsync.blockzonetests", DISPATCH_QUEUE_SERIAL);
+    NSMutableArray<DSPeer *> *peers = [NSMutableArray array];
+    for (uint16_t i = 0; i < RESTORE_PEER_COUNT; i++) {
+        [peers addObject:[DSPeer peerWithHost:[NSString stringWithFormat:@"127.0.0.1:%u", 3001 + i] onChain:self.chain]];
+    }
+    dispatch_async(queue, ^{
+        [backfill start];
+        [self requestRangesOfBackfill:backfill fromPeers:peers queue:queue];
+    });
+    [self waitForExpectations:@[expectation] timeout:30];
+}
+
+- (void)restore {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"restored"];
+    [self restoreWithBackfill:[self restoreBackfillWithExpectation:expectation] expectation:expectation];
+}
+
+- (void)testRestoreOnlyFetchesZonesWithActivity {
+    [self buildChain];
+    [self recordWalletActivity];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"restored"];
+    DSMerkleBlockBackfill *backfill = [self restoreBackfillWithExpectation:expectation];
+    XCTAssertEqual(backfill.rangeCount, RESTORE_ZONE_COUNT);
+    XCTAssertEqual(backfill.merkleBlockRangeCount, 3);
+    [self restoreWithBackfill:backfill expectation:expectation];
+    XCTAssertTrue(backfill.complete);
+    XCTAssertEqual(backfill.requestCount, 3);
+}
+
+- (void)testPerformanceRestoreFetchingEveryZone {
+    [self buildChain];
+    [self.wallet wipeBlockZones];
+    [self measureBlock:^{
+        [self restore];
+    }];
+}
+
+- (void)testPerformanceRestoreSkippingZonesWithoutActivity {
+    [self buildChain];
+    [self recordWalletActivity];
+    [self measureBlock:^{
+        [self restore];
+    }];
+}
+
+@end
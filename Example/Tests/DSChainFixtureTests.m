@@ -0,0 +1,140 @@
+//
+//  DSChainFixtureTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAccount.h"
+#import "DSChain+Protected.h"
+#import "DSChainFixtureGenerator.h"
+#import "DSChainManager+Protected.h"
+#import "DSFullBlock.h"
+#import "DSFundsDerivationPath.h"
+#import "DSPeer.h"
+#import "DSTransactionFactory.h"
+#import "DSTransactionManager.h"
+#import "DSWallet.h"
+#import "DashSync.h"
+#import "NSString+Dash.h"
+
+@interface DSChainFixtureTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) DSWallet *wallet;
+@property (nonatomic, strong) NSArray<NSString *> *walletAddresses;
+
+@end
+
+@implementation DSChainFixtureTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_MiningTest protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    self.wallet = [DSWallet transientWalletWithDerivedKeyData:@"000102030405060708090a0b0c0d0e0f".hexToData forChain:self.chain];
+    DSFundsDerivationPath *derivationPath = [self.wallet accountWithNumber:0].bip44DerivationPath;
+    NSMutableArray<NSString *> *walletAddresses = [NSMutableArray array];
+    for (uint32_t i = 0; i < 50; i++) {
+        [walletAddresses addObject:[derivationPath addressAtIndex:i internal:NO]];
+    }
+    self.walletAddresses = walletAddresses;
+}
+
+- (DSChainFixtureConfiguration *)configuration {
+    DSChainFixtureConfiguration *configuration = [[DSChainFixtureConfiguration alloc] init];
+    configuration.blockCount = 40;
+    configuration.coinbaseMaturity = 10;
+    configuration.chainLockInterval = 4;
+    configuration.seed = 42;
+    return configuration;
+}
+
+- (NSURL *)writeFixtureNamed:(NSString *)name {
+    NSURL *url = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:name];
+    DSChainFixtureGenerator *generator = [[DSChainFixtureGenerator alloc] initWithChain:self.chain configuration:[self configuration] walletAddresses:self.walletAddresses];
+    NSError *error = nil;
+    XCTAssertTrue([generator writeFixtureToURL:url afterBlock:self.chain.lastTerminalBlock previousBlocks:self.chain.terminalBlocks error:&error], @"%@", error);
+    XCTAssertGreaterThan(generator.generatedTransactionCount, 40);
+    XCTAssertEqual(generator.generatedChainLockCount, 10);
+    XCTAssertEqual(generator.lastBlock.height, self.chain.lastTerminalBlockHeight + 40);
+    return url;
+}
+
+- (void)testFixtureIsDeterministic {
+    NSURL *first = [self writeFixtureNamed:@"fixture-a.dsfx"];
+    NSURL *second = [self writeFixtureNamed:@"fixture-b.dsfx"];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:first], [NSData dataWithContentsOfURL:second]);
+}
+
+- (void)testFixtureReplaysMessages {
+    NSURL *url = [self writeFixtureNamed:@"fixture.dsfx"];
+    NSError *error = nil;
+    DSChainFixtureReader *reader = [[DSChainFixtureReader alloc] initWithURL:url error:&error];
+    XCTAssertNotNil(reader, @"%@", error);
+    XCTAssertEqual(reader.baseBlockHeight, self.chain.lastTerminalBlockHeight);
+    NSCountedSet *types = [NSCountedSet set];
+    __block NSString *previousType = nil;
+    [reader enumerateMessagesUsingBlock:^(NSString *type, NSData *message, BOOL *stop) {
+        XCTAssertGreaterThan(message.length, 0);
+        if ([type isEqualToString:MSG_ISLOCK]) XCTAssertEqualObjects(previousType, MSG_TX);
+        [types addObject:type];
+        previousType = type;
+    }];
+    XCTAssertEqual([types countForObject:MSG_BLOCK], 40);
+    XCTAssertEqual([types countForObject:MSG_CHAINLOCK], 10);
+    XCTAssertEqual([types countForObject:MSG_TX], [types countForObject:MSG_ISLOCK]);
+}
+
+- (void)testFixtureSyncsChainAndWallet {
+    [[DashSync sharedSyncController] wipeBlockchainDataForChain:self.chain inContext:[NSManagedObjectContext chainContext]];
+    [self.chain addWallet:self.wallet];
+    [[self.wallet accountWithNumber:0].bip44DerivationPath registerAddressesWithGapLimit:SEQUENCE_GAP_LIMIT_INITIAL internal:NO error:nil];
+    DSPeer *peer = [DSPeer peerWithHost:@"0.1.2.3:3000" onChain:self.chain];
+
+    // coinbases mature when the wallet unlocks them, so what the generator can spend is the wallet balance
+    DSChainFixtureConfiguration *configuration = [self configuration];
+    configuration.blockCount = 120;
+    configuration.coinbaseMaturity = 100;
+    DSChainFixtureGenerator *generator = [[DSChainFixtureGenerator alloc] initWithChain:self.chain configuration:configuration walletAddresses:self.walletAddresses];
+    NSURL *url = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:@"fixture-sync.dsfx"];
+    NSError *error = nil;
+    XCTAssertTrue([generator writeFixtureToURL:url afterBlock:self.chain.lastSyncBlock previousBlocks:self.chain.syncBlocks error:&error], @"%@", error);
+    XCTAssertGreaterThan(generator.spendableWalletBalance, 0);
+
+    [self.chain setEstimatedBlockHeight:generator.lastBlock.height fromPeer:peer thresholdPeerCount:0];
+    self.chain.chainManager.syncPhase = DSChainSyncPhase_ChainSync;
+    DSTransactionManager *transactionManager = self.chain.chainManager.transactionManager;
+    DSChainFixtureReader *reader = [[DSChainFixtureReader alloc] initWithURL:url error:&error];
+    XCTAssertNotNil(reader, @"%@", error);
+    __block NSUInteger blockCount = 0;
+    [reader enumerateMessagesUsingBlock:^(NSString *type, NSData *message, BOOL *stop) {
+        // the signatures of islock and clsig messages are random bytes, they would only be rejected
+        if ([type isEqualToString:MSG_TX]) {
+            [transactionManager peer:peer relayedTransaction:[DSTransactionFactory transactionWithMessage:message onChain:self.chain] inBlock:nil];
+        } else if ([type isEqualToString:MSG_BLOCK]) {
+            DSFullBlock *block = [DSFullBlock fullBlockWithMessage:message onChain:self.chain];
+            for (DSTransaction *transaction in block.transactions) {
+                [transactionManager peer:peer relayedTransaction:transaction inBlock:block];
+            }
+            XCTAssertTrue([self.chain addBlock:block receivedAsHeader:NO fromPeer:nil]);
+            blockCount++;
+        }
+    }];
+
+    XCTAssertEqual(blockCount, configuration.blockCount);
+    XCTAssertEqual(self.chain.lastSyncBlockHeight, generator.lastBlock.height);
+    XCTAssertEqualObjects(uint256_hex(self.chain.lastSyncBlock.blockHash), uint256_hex(generator.lastBlock.blockHash));
+    XCTAssertEqual(self.wallet.balance, generator.spendableWalletBalance);
+    [self.chain unregisterWallet:self.wallet];
+}
+
+- (void)testReaderRejectsOtherFiles {
+    NSURL *url = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:@"not-a-fixture.dsfx"];
+    [[NSMutableData dataWithLength:64] writeToURL:url atomically:YES];
+    NSError *error = nil;
+    XCTAssertNil([[DSChainFixtureReader alloc] initWithURL:url error:&error]);
+    XCTAssertNotNil(error);
+}
+
+@end
@@ -0,0 +1,287 @@
+//
+//  DSChainLockTrackerTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "dash_shared_core.h"
+#import "DSChain+Protected.h"
+#import "DSChainLock.h"
+#import "DSChainLockTracker.h"
+#import "DSKeyManager.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+#define FLOOD_HEIGHT_COUNT 20
+#define FLOOD_PEER_COUNT 8
+
+@interface DSChainLockTrackerTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) NSData *publicKeyData;
+@property (nonatomic, assign) UInt768 signature;
+@property (nonatomic, assign) UInt256 signedDigest;
+
+@end
+
+@implementation DSChainLockTrackerTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    uint8_t seed[5] = {5, 4, 3, 2, 1};
+    BLSKey *key = key_bls_with_seed_data(seed, sizeof(seed), true);
+    NSData *message = [@"clsig" dataUsingEncoding:NSUTF8StringEncoding];
+    self.publicKeyData = [DSKeyManager NSDataFrom:key_bls_public_key(key)];
+    self.signature = [[DSKeyManager NSDataFrom:key_bls_sign_data(key, message.bytes, message.length)] UInt768AtOffset:0];
+    self.signedDigest = message.SHA256_2;
+}
+
+- (DSChainLock *)chainLockAtHeight:(uint32_t)height signature:(UInt768)signature {
+    NSMutableData *message = [NSMutableData data];
+    [message appendUInt32:height];
+    [message appendUInt256:[NSData dataWithBytes:&height length:sizeof(height)].SHA256_2];
+    [message appendUInt768:signature];
+    return [DSChainLock chainLockWithMessage:message onChain:self.chain];
+}
+
+- (DSChainLock *)chainLockAtHeight:(uint32_t)height {
+    return [self chainLockAtHeight:height signature:self.signature];
+}
+
+- (BOOL)verifySignature {
+    UInt256 digest = self.signedDigest;
+    UInt768 signature = self.signature;
+    return key_bls_verify(self.publicKeyData.bytes, true, digest.u8, signature.u8);
+}
+
+- (void)testCopiesOfALockAreDropped {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    XCTAssertTrue([tracker acceptChainLock:[self chainLockAtHeight:100]]);
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:100]]);
+    XCTAssertTrue([tracker acceptChainLock:[self chainLockAtHeight:101]]);
+    XCTAssertEqual(tracker.skippedCount, 1);
+}
+
+- (void)testLowerLocksAreSupersededByTheBestLock {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *chainLock = [self chainLockAtHeight:100];
+    XCTAssertTrue([tracker acceptChainLock:chainLock]);
+    XCTAssertTrue([tracker verifyChainLock:chainLock usingBlock:^BOOL(DSChainLock *lock) { return YES; }]);
+    XCTAssertEqual(tracker.bestChainLock, chainLock);
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:99]]);
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:100]]);
+
+    // a lock accepted before the best one was verified is not verified anymore
+    DSChainLockTracker *racingTracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *lowerChainLock = [self chainLockAtHeight:99];
+    XCTAssertTrue([racingTracker acceptChainLock:lowerChainLock]);
+    XCTAssertTrue([racingTracker acceptChainLock:chainLock]);
+    XCTAssertTrue([racingTracker verifyChainLock:chainLock usingBlock:^BOOL(DSChainLock *lock) { return YES; }]);
+    XCTAssertFalse([racingTracker verifyChainLock:lowerChainLock usingBlock:^BOOL(DSChainLock *lock) { XCTFail(); return YES; }]);
+    XCTAssertEqual(racingTracker.verificationCount, 1);
+}
+
+- (UInt768)forgedSignature {
+    UInt768 signature = self.signature;
+    signature.u8[sizeof(UInt768) - 1] ^= 0xff;
+    return signature;
+}
+
+- (void)testLockWithoutQuorumWaits {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *chainLock = [self chainLockAtHeight:100];
+    XCTAssertTrue([tracker acceptChainLock:chainLock]);
+    // without a quorum the signature was not really checked, copies with the same signature are dropped while it waits
+    XCTAssertFalse([tracker verifyChainLock:chainLock usingBlock:^BOOL(DSChainLock *lock) { return NO; }]);
+    [tracker addChainLockWaitingForQuorum:chainLock];
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:100]]);
+    // another signature for the block is not a copy, it waits next to the first one
+    DSChainLock *otherChainLock = [self chainLockAtHeight:100 signature:[self forgedSignature]];
+    XCTAssertTrue([tracker acceptChainLock:otherChainLock]);
+    [tracker addChainLockWaitingForQuorum:otherChainLock];
+    XCTAssertEqual(tracker.waitingCount, 2);
+    XCTAssertTrue(uint256_eq([tracker waitingChainLockForBlockHash:chainLock.blockHash].blockHash, chainLock.blockHash));
+    XCTAssertNil([tracker waitingChainLockForBlockHash:[self chainLockAtHeight:101].blockHash]);
+}
+
+- (void)testForgedLockDoesNotHideTheGenuineLock {
+    DSChainLockVerificationBlock verifyBlock = ^BOOL(DSChainLock *lock) {
+        return uint768_eq(lock.signature, self.signature);
+    };
+    // the quorum is known, the forged lock arrives first and fails
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *forgedChainLock = [self chainLockAtHeight:100 signature:[self forgedSignature]];
+    XCTAssertTrue([tracker acceptChainLock:forgedChainLock]);
+    XCTAssertFalse([tracker verifyChainLock:forgedChainLock usingBlock:verifyBlock]);
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:100 signature:[self forgedSignature]]], @"copies of the forged lock are not verified again");
+    DSChainLock *chainLock = [self chainLockAtHeight:100];
+    XCTAssertTrue([tracker acceptChainLock:chainLock]);
+    XCTAssertTrue([tracker verifyChainLock:chainLock usingBlock:verifyBlock]);
+    XCTAssertEqual(tracker.bestChainLock, chainLock);
+    XCTAssertEqual(tracker.verificationCount, 2);
+
+    // both arrive before the quorum, the forged one is the first waiting
+    DSChainLockTracker *waitingTracker = [[DSChainLockTracker alloc] init];
+    for (DSChainLock *lock in @[forgedChainLock, chainLock]) {
+        XCTAssertTrue([waitingTracker acceptChainLock:lock]);
+        [waitingTracker addChainLockWaitingForQuorum:lock];
+    }
+    XCTAssertEqual([waitingTracker verifyWaitingChainLocksUsingBlock:verifyBlock], chainLock);
+    XCTAssertEqual(waitingTracker.bestChainLock, chainLock);
+    XCTAssertEqual(waitingTracker.waitingCount, 0);
+}
+
+- (void)testLocksWaitingForTheirBlockAreNotVerified {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *lowerChainLock = [self chainLockAtHeight:100], *chainLock = [self chainLockAtHeight:101];
+    [tracker addChainLockWaitingForQuorum:lowerChainLock];
+    [tracker addChainLockWaitingForQuorum:chainLock];
+    NSSet<NSData *> *excludedBlockHashes = [NSSet setWithObject:uint256_data(chainLock.blockHash)];
+    DSChainLock *bestChainLock = [tracker verifyWaitingChainLocksExcludingBlockHashes:excludedBlockHashes
+                                                                           usingBlock:^BOOL(DSChainLock *lock) {
+                                                                               XCTAssertEqual(lock, lowerChainLock);
+                                                                               return YES;
+                                                                           }];
+    XCTAssertEqual(bestChainLock, lowerChainLock);
+    XCTAssertEqual(tracker.verificationCount, 1);
+    XCTAssertEqual([tracker waitingChainLockForBlockHash:chainLock.blockHash], chainLock, @"still waiting for its block");
+}
+
+- (void)testWaitingLocksAreVerifiedNewestFirst {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    for (uint32_t height = 100; height < 110; height++) {
+        DSChainLock *chainLock = [self chainLockAtHeight:height];
+        XCTAssertTrue([tracker acceptChainLock:chainLock]);
+        [tracker addChainLockWaitingForQuorum:chainLock];
+    }
+    NSMutableArray<NSNumber *> *verifiedHeights = [NSMutableArray array];
+    DSChainLock *chainLock = [tracker verifyWaitingChainLocksUsingBlock:^BOOL(DSChainLock *lock) {
+        [verifiedHeights addObject:@(lock.height)];
+        // the newest block is not known yet
+        return lock.height != 109;
+    }];
+    XCTAssertEqual(chainLock.height, 108);
+    XCTAssertEqualObjects(verifiedHeights, (@[@109, @108]));
+    XCTAssertEqual(tracker.bestChainLock, chainLock);
+    XCTAssertEqual(tracker.waitingCount, 1);
+    XCTAssertEqual(tracker.skippedCount, 8);
+    XCTAssertNotNil([tracker waitingChainLockForBlockHash:[self chainLockAtHeight:109].blockHash]);
+}
+
+- (void)testWaitingLocksAreCapped {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] initWithWaitingCapacity:4];
+    for (uint32_t height = 100; height < 110; height++) {
+        [tracker addChainLockWaitingForQuorum:[self chainLockAtHeight:height]];
+    }
+    XCTAssertEqual(tracker.waitingCount, 4);
+    XCTAssertNil([tracker waitingChainLockForBlockHash:[self chainLockAtHeight:105].blockHash]);
+    XCTAssertNotNil([tracker waitingChainLockForBlockHash:[self chainLockAtHeight:106].blockHash]);
+}
+
+- (void)testForgedHigherLocksDoNotEvictALowerWaitingLock {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] initWithWaitingCapacity:4];
+    for (uint32_t height = 1000; height < 1003; height++) {
+        [tracker addChainLockWaitingForQuorum:[self chainLockAtHeight:height signature:[self forgedSignature]]];
+    }
+    DSChainLock *chainLock = [self chainLockAtHeight:100];
+    [tracker addChainLockWaitingForQuorum:chainLock];
+    // a lock claiming a higher block doesn't outrank the lower one, the earliest waiting lock makes room
+    [tracker addChainLockWaitingForQuorum:[self chainLockAtHeight:1003 signature:[self forgedSignature]]];
+    XCTAssertEqual(tracker.waitingCount, 4);
+    XCTAssertEqual([tracker waitingChainLockForBlockHash:chainLock.blockHash], chainLock);
+    XCTAssertNil([tracker waitingChainLockForBlockHash:[self chainLockAtHeight:1000].blockHash]);
+}
+
+- (void)testWaitingLocksFailingWithAKnownQuorumAreDropped {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *forgedChainLock = [self chainLockAtHeight:101 signature:[self forgedSignature]];
+    DSChainLock *unknownQuorumChainLock = [self chainLockAtHeight:102 signature:[self forgedSignature]];
+    [tracker addChainLockWaitingForQuorum:forgedChainLock];
+    [tracker addChainLockWaitingForQuorum:unknownQuorumChainLock];
+    DSChainLock *chainLock = [tracker verifyWaitingChainLocksExcludingBlockHashes:[NSSet set]
+                                                                       usingBlock:^BOOL(DSChainLock *lock) {
+                                                                           return uint768_eq(lock.signature, self.signature);
+                                                                       }
+                                                                 quorumKnownBlock:^BOOL(DSChainLock *lock) {
+                                                                           return lock.height == 101;
+                                                                       }];
+    XCTAssertNil(chainLock);
+    XCTAssertNil([tracker waitingChainLockForBlockHash:forgedChainLock.blockHash]);
+    XCTAssertEqual([tracker waitingChainLockForBlockHash:unknownQuorumChainLock.blockHash], unknownQuorumChainLock, @"its quorum may still come");
+    XCTAssertEqual(tracker.waitingCount, 1);
+}
+
+- (void)testReceivedLocksAreBounded {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    DSChainLock *firstChainLock = [self chainLockAtHeight:100 signature:[self forgedSignature]];
+    XCTAssertTrue([tracker acceptChainLock:firstChainLock]);
+    for (uint32_t height = 101; height <= 100 + CHAIN_LOCK_TRACKER_ENTRY_CAPACITY; height++) {
+        XCTAssertTrue([tracker acceptChainLock:[self chainLockAtHeight:height signature:[self forgedSignature]]]);
+    }
+    // the earliest lock was forgotten to make room, the latest is still known
+    XCTAssertTrue([tracker acceptChainLock:[self chainLockAtHeight:100 signature:[self forgedSignature]]]);
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:100 + CHAIN_LOCK_TRACKER_ENTRY_CAPACITY signature:[self forgedSignature]]]);
+}
+
+- (void)testLocksFarAboveTheTipAreNotAccepted {
+    DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+    XCTAssertTrue([tracker acceptChainLock:[self chainLockAtHeight:5000]], @"no tip known yet");
+    tracker.tipHeight = 1000;
+    XCTAssertFalse([tracker acceptChainLock:[self chainLockAtHeight:1001 + CHAIN_LOCK_TRACKER_MAXIMUM_HEIGHT_ABOVE_TIP]]);
+    XCTAssertTrue([tracker acceptChainLock:[self chainLockAtHeight:1000 + CHAIN_LOCK_TRACKER_MAXIMUM_HEIGHT_ABOVE_TIP]]);
+}
+
+// MARK: - Lock flood
+
+- (NSArray<DSChainLock *> *)floodedChainLocks {
+    // every peer relays every new lock, the same lock arriving from each of them
+    NSMutableArray<DSChainLock *> *chainLocks = [NSMutableArray array];
+    for (uint32_t height = 0; height < FLOOD_HEIGHT_COUNT; height++) {
+        for (uint32_t peer = 0; peer < FLOOD_PEER_COUNT; peer++) {
+            [chainLocks addObject:[self chainLockAtHeight:1000 + height]];
+        }
+    }
+    return chainLocks;
+}
+
+- (void)testPerformanceVerifyingEveryRelayedLock {
+    NSArray<DSChainLock *> *chainLocks = [self floodedChainLocks];
+    [self measureBlock:^{
+        for (DSChainLock *chainLock in chainLocks) {
+            XCTAssertTrue([self verifySignature]);
+        }
+    }];
+}
+
+- (void)testPerformanceTrackingRelayedLocks {
+    NSArray<DSChainLock *> *chainLocks = [self floodedChainLocks];
+    [self measureBlock:^{
+        DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+        for (DSChainLock *chainLock in chainLocks) {
+            if (![tracker acceptChainLock:chainLock]) continue;
+            XCTAssertTrue([tracker verifyChainLock:chainLock usingBlock:^BOOL(DSChainLock *lock) { return [self verifySignature]; }]);
+        }
+        XCTAssertEqual(tracker.verificationCount, FLOOD_HEIGHT_COUNT);
+        XCTAssertEqual(tracker.skippedCount, FLOOD_HEIGHT_COUNT * (FLOOD_PEER_COUNT - 1));
+    }];
+}
+
+- (void)testPerformanceCatchingUpOnWaitingLocks {
+    NSArray<DSChainLock *> *chainLocks = [self floodedChainLocks];
+    [self measureBlock:^{
+        // quorums arrive after the whole flood, only the newest lock needs a check
+        DSChainLockTracker *tracker = [[DSChainLockTracker alloc] init];
+        for (DSChainLock *chainLock in chainLocks) {
+            if ([tracker acceptChainLock:chainLock]) [tracker addChainLockWaitingForQuorum:chainLock];
+        }
+        DSChainLock *bestChainLock = [tracker verifyWaitingChainLocksUsingBlock:^BOOL(DSChainLock *lock) { return [self verifySignature]; }];
+        XCTAssertEqual(bestChainLock.height, 1000 + FLOOD_HEIGHT_COUNT - 1);
+        XCTAssertEqual(tracker.verificationCount, 1);
+        XCTAssertEqual(tracker.waitingCount, 0);
+    }];
+}
+
+@end
@@ -0,0 +1,282 @@
+//
+//  DSCoinJoinCoinIndexTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAccount+Protected.h"
+#import "DSAccount.h"
+#import "DSChain+Protected.h"
+#import "DSCoinJoinCoinIndex.h"
+#import "DSCoinJoinWrapper.h"
+#import "DSFundsDerivationPath.h"
+#import "DSTransaction.h"
+#import "DSTransactionOutput.h"
+#import "DSWallet.h"
+#import "NSData+DSHash.h"
+#import "NSString+Dash.h"
+
+#define DENOMINATION_SMALLEST 100001
+#define DENOMINATION_SMALL 1000010
+#define DENOMINATION_MEDIUM 10000100
+#define COLLATERAL_AMOUNT 20000
+#define OTHER_AMOUNT (3 * DUFFS)
+#define MASTERNODE_AMOUNT (1000 * DUFFS)
+
+// answers for the mixing engine, a coin is fully mixed from four rounds on
+@interface DSCoinJoinCoinIndexTestWrapper : NSObject
+
+@property (nonatomic, strong) NSMutableDictionary<NSValue *, NSNumber *> *rounds;
+@property (nonatomic, assign) NSUInteger roundsRequestCount;
+
+@end
+
+@implementation DSCoinJoinCoinIndexTestWrapper
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.rounds = [NSMutableDictionary dictionary];
+    return self;
+}
+
+- (int32_t)getRealOutpointCoinJoinRounds:(DSUTXO)utxo {
+    self.roundsRequestCount++;
+    NSNumber *rounds = self.rounds[dsutxo_obj(utxo)];
+    return rounds ? rounds.intValue : -1;
+}
+
+- (BOOL)isFullyMixed:(DSUTXO)utxo {
+    return self.rounds[dsutxo_obj(utxo)].intValue >= 4;
+}
+
+- (NSArray<NSNumber *> *)getStandardDenominations {
+    return @[@(1000010000), @(100001000), @(DENOMINATION_MEDIUM), @(DENOMINATION_SMALL), @(DENOMINATION_SMALLEST)];
+}
+
+- (uint64_t)getCollateralAmount {
+    return 10000;
+}
+
+@end
+
+@interface DSCoinJoinCoinIndexTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) DSWallet *wallet;
+@property (nonatomic, strong) DSAccount *account;
+@property (nonatomic, strong) DSCoinJoinCoinIndex *coinIndex;
+@property (nonatomic, assign) uint32_t nonce;
+
+@end
+
+@implementation DSCoinJoinCoinIndexTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    self.wallet = [DSWallet transientWalletWithDerivedKeyData:@"6a1d2e3f4b5c6d7e8f90a1b2c3d4e5f6".hexToData forChain:self.chain];
+    [self.chain addWallet:self.wallet];
+    self.account = [self.wallet accountWithNumber:0];
+    self.coinIndex = [[DSCoinJoinCoinIndex alloc] initWithAccount:self.account];
+}
+
+- (void)tearDown {
+    [self.chain unregisterWallet:self.wallet];
+}
+
+- (DSTransaction *)registerTransactionSpending:(NSArray<NSValue *> *)outpoints paying:(NSArray<NSNumber *> *)amounts {
+    return [self registerTransactionSpending:outpoints paying:amounts toAddresses:nil];
+}
+
+// a transaction paying each amount to the account, to the receive address unless addresses are given
+- (DSTransaction *)registerTransactionSpending:(NSArray<NSValue *> *)outpoints paying:(NSArray<NSNumber *> *)amounts toAddresses:(NSArray<NSString *> *)addresses {
+    DSTransaction *transaction = [[DSTransaction alloc] initOnChain:self.chain];
+    if (!outpoints.count) {
+        UInt256 hash = [NSData dataWithBytes:&_nonce length:sizeof(uint32_t)].SHA256;
+        self.nonce++;
+        outpoints = @[dsutxo_obj(((DSUTXO){hash, 0}))];
+    }
+    for (NSValue *value in outpoints) {
+        DSUTXO outpoint;
+        [value getValue:&outpoint];
+        [transaction addInputHash:outpoint.hash index:outpoint.n script:nil signature:nil sequence:TXIN_SEQUENCE];
+    }
+    [amounts enumerateObjectsUsingBlock:^(NSNumber *amount, NSUInteger idx, BOOL *stop) {
+        [transaction addOutputAddress:addresses ? addresses[idx] : self.account.receiveAddress amount:amount.unsignedLongLongValue];
+    }];
+    transaction.blockHeight = 100 + self.nonce++;
+    transaction.txHash = transaction.toData.SHA256_2;
+    XCTAssertTrue([self.account registerTransaction:transaction saveImmediately:NO]);
+    return transaction;
+}
+
+- (NSArray<NSNumber *> *)amountsForCoinType:(CoinType)coinType minimumAmount:(uint64_t)minimumAmount maximumAmount:(uint64_t)maximumAmount {
+    NSMutableArray<NSNumber *> *amounts = [NSMutableArray array];
+    [self.coinIndex enumerateCoinsForCoinType:coinType
+                                minimumAmount:minimumAmount
+                                maximumAmount:maximumAmount
+                                   usingBlock:^(DSCoinJoinIndexedCoin *coin, BOOL *stop) {
+                                       [amounts addObject:@(coin.amount)];
+                                   }];
+    return amounts;
+}
+
+- (NSArray<NSNumber *> *)amountsForCoinType:(CoinType)coinType {
+    return [self amountsForCoinType:coinType minimumAmount:0 maximumAmount:UINT64_MAX];
+}
+
+- (void)testCoinsAreClassifiedAndSortedByAmount {
+    DSTransaction *transaction = [self registerTransactionSpending:@[] paying:@[@(OTHER_AMOUNT), @(DENOMINATION_SMALL), @(COLLATERAL_AMOUNT), @(MASTERNODE_AMOUNT), @(DENOMINATION_SMALLEST)]];
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyReadyToMix], (@[@(DENOMINATION_SMALLEST), @(DENOMINATION_SMALL)]));
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyCoinJoinCollateral], @[@(COLLATERAL_AMOUNT)]);
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyNonDenominated], (@[@(OTHER_AMOUNT), @(MASTERNODE_AMOUNT)]));
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyMasternodeCollateral], @[@(MASTERNODE_AMOUNT)]);
+    XCTAssertEqual([self amountsForCoinType:CoinType_AllCoins].count, 5);
+    XCTAssertEqual(self.coinIndex.coinCount, 5);
+
+    __block NSUInteger visited = 0;
+    [self.coinIndex enumerateCoinsForCoinType:CoinType_AllCoins
+                                minimumAmount:0
+                                maximumAmount:UINT64_MAX
+                                   usingBlock:^(DSCoinJoinIndexedCoin *coin, BOOL *stop) {
+                                       visited++;
+                                       XCTAssertTrue(coin.isMine);
+                                       XCTAssertEqual(coin.transaction, transaction);
+                                       XCTAssertEqual(coin.output, transaction.outputs[coin.outpoint.n]);
+                                       XCTAssertEqual(coin.amount, coin.output.amount);
+                                       DSCoinJoinCoinKind kind = (coin.amount == DENOMINATION_SMALLEST || coin.amount == DENOMINATION_SMALL) ? DSCoinJoinCoinKind_Denominated : (coin.amount == COLLATERAL_AMOUNT) ? DSCoinJoinCoinKind_Collateral : DSCoinJoinCoinKind_Other;
+                                       XCTAssertEqual(coin.kind, kind);
+                                   }];
+    XCTAssertEqual(visited, 5);
+    XCTAssertTrue([self.coinIndex isAddressUsedInOutputs:transaction.outputs.firstObject.address]);
+    XCTAssertFalse([self.coinIndex isAddressUsedInOutputs:self.account.changeAddress]);
+}
+
+- (void)testRangeLookups {
+    [self registerTransactionSpending:@[] paying:@[@(DENOMINATION_MEDIUM), @(DENOMINATION_SMALLEST), @(DENOMINATION_SMALL), @(DENOMINATION_SMALLEST), @(DENOMINATION_MEDIUM)]];
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyReadyToMix minimumAmount:DENOMINATION_SMALL maximumAmount:UINT64_MAX], (@[@(DENOMINATION_SMALL), @(DENOMINATION_MEDIUM), @(DENOMINATION_MEDIUM)]));
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyReadyToMix minimumAmount:0 maximumAmount:DENOMINATION_SMALL], (@[@(DENOMINATION_SMALLEST), @(DENOMINATION_SMALLEST), @(DENOMINATION_SMALL)]));
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyReadyToMix minimumAmount:DENOMINATION_SMALLEST + 1 maximumAmount:DENOMINATION_MEDIUM - 1], @[@(DENOMINATION_SMALL)]);
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyReadyToMix minimumAmount:DENOMINATION_SMALL + 1 maximumAmount:DENOMINATION_MEDIUM - 1], @[]);
+    // nothing but denominations in range, no collateral or other coins are visited
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyNonDenominated minimumAmount:DENOMINATION_SMALLEST maximumAmount:DENOMINATION_MEDIUM], @[]);
+
+    __block NSUInteger visited = 0;
+    [self.coinIndex enumerateCoinsForCoinType:CoinType_OnlyReadyToMix
+                                minimumAmount:0
+                                maximumAmount:UINT64_MAX
+                                   usingBlock:^(DSCoinJoinIndexedCoin *coin, BOOL *stop) {
+                                       *stop = ++visited == 2;
+                                   }];
+    XCTAssertEqual(visited, 2);
+}
+
+- (void)testIncrementalUpdates {
+    DSTransaction *funding = [self registerTransactionSpending:@[] paying:@[@(DENOMINATION_SMALL), @(OTHER_AMOUNT)]];
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_AllCoins], (@[@(DENOMINATION_SMALL), @(OTHER_AMOUNT)]));
+
+    // new coins are picked up and spent ones leave the index
+    DSTransaction *spend = [self registerTransactionSpending:@[dsutxo_obj(((DSUTXO){funding.txHash, 1}))] paying:@[@(COLLATERAL_AMOUNT), @(DENOMINATION_SMALLEST)]];
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyReadyToMix], (@[@(DENOMINATION_SMALLEST), @(DENOMINATION_SMALL)]));
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyCoinJoinCollateral], @[@(COLLATERAL_AMOUNT)]);
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_OnlyNonDenominated], @[]);
+    XCTAssertEqual(self.coinIndex.coinCount, 3);
+
+    // removing the spend gives the spent coin back
+    [self.account removeTransaction:spend saveImmediately:NO];
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_AllCoins], (@[@(DENOMINATION_SMALL), @(OTHER_AMOUNT)]));
+    XCTAssertEqual(self.coinIndex.coinCount, 2);
+    XCTAssertTrue([self.coinIndex isAddressUsedInOutputs:funding.outputs.firstObject.address]);
+
+    [self.account removeTransaction:funding saveImmediately:NO];
+    XCTAssertEqualObjects([self amountsForCoinType:CoinType_AllCoins], @[]);
+    XCTAssertEqual(self.coinIndex.coinCount, 0);
+}
+
+// MARK: - Totals
+
+static NSValue *outpointOf(DSTransaction *transaction, uint32_t n) {
+    return dsutxo_obj(((DSUTXO){transaction.txHash, n}));
+}
+
+// a new index computes every coin's contribution from scratch
+- (void)assertTotalsOfIndex:(DSCoinJoinCoinIndex *)coinIndex matchRecomputationWithWrapper:(DSCoinJoinCoinIndexTestWrapper *)wrapper {
+    int32_t inputs = 0, rounds = 0, expectedInputs = 0, expectedRounds = 0;
+    uint64_t anonymizedBalance = 0, denominatedBalance = 0, expectedAnonymizedBalance = 0, expectedDenominatedBalance = 0;
+    [coinIndex getMixingProgressInputs:&inputs rounds:&rounds withWrapper:(DSCoinJoinWrapper *)wrapper];
+    [coinIndex getAnonymizedBalance:&anonymizedBalance denominatedBalance:&denominatedBalance withWrapper:(DSCoinJoinWrapper *)wrapper];
+    DSCoinJoinCoinIndex *recomputation = [[DSCoinJoinCoinIndex alloc] initWithAccount:self.account knownRoundsPath:nil];
+    [recomputation getMixingProgressInputs:&expectedInputs rounds:&expectedRounds withWrapper:(DSCoinJoinWrapper *)wrapper];
+    [recomputation getAnonymizedBalance:&expectedAnonymizedBalance denominatedBalance:&expectedDenominatedBalance withWrapper:(DSCoinJoinWrapper *)wrapper];
+    // the recomputation took over the account's reports
+    self.account.coinJoinCoinIndex = coinIndex;
+    XCTAssertEqual(coinIndex.coinCount, recomputation.coinCount);
+    XCTAssertEqual(inputs, expectedInputs);
+    XCTAssertEqual(rounds, expectedRounds);
+    XCTAssertEqual(anonymizedBalance, expectedAnonymizedBalance);
+    XCTAssertEqual(denominatedBalance, expectedDenominatedBalance);
+}
+
+- (void)testRunningTotalsMatchARecomputation {
+    DSCoinJoinCoinIndexTestWrapper *wrapper = [[DSCoinJoinCoinIndexTestWrapper alloc] init];
+    NSArray<NSString *> *coinJoinAddresses = [self.account.coinJoinDerivationPath registerAddressesWithGapLimit:6 internal:NO error:nil];
+    XCTAssertEqual(coinJoinAddresses.count, 6);
+    DSTransaction *mixed = [self registerTransactionSpending:@[] paying:@[@(DENOMINATION_SMALL), @(DENOMINATION_SMALL), @(DENOMINATION_MEDIUM)] toAddresses:[coinJoinAddresses subarrayWithRange:NSMakeRange(0, 3)]];
+    wrapper.rounds[outpointOf(mixed, 0)] = @4;
+    wrapper.rounds[outpointOf(mixed, 1)] = @2;
+    wrapper.rounds[outpointOf(mixed, 2)] = @6;
+    [self registerTransactionSpending:@[] paying:@[@(OTHER_AMOUNT), @(DENOMINATION_SMALLEST)]];
+    [self assertTotalsOfIndex:self.coinIndex matchRecomputationWithWrapper:wrapper];
+    int32_t rounds = 0;
+    uint64_t anonymizedBalance = 0, denominatedBalance = 0;
+    [self.coinIndex getMixingProgressInputs:nil rounds:&rounds withWrapper:(DSCoinJoinWrapper *)wrapper];
+    [self.coinIndex getAnonymizedBalance:&anonymizedBalance denominatedBalance:&denominatedBalance withWrapper:(DSCoinJoinWrapper *)wrapper];
+    XCTAssertEqual(rounds, 12);
+    XCTAssertEqual(anonymizedBalance, DENOMINATION_SMALL + DENOMINATION_MEDIUM);
+    XCTAssertEqual(denominatedBalance, 2 * DENOMINATION_SMALL + DENOMINATION_MEDIUM + DENOMINATION_SMALLEST);
+
+    // a mixed coin spent into a new one and a collateral
+    DSTransaction *spend = [self registerTransactionSpending:@[outpointOf(mixed, 1)] paying:@[@(DENOMINATION_SMALL), @(COLLATERAL_AMOUNT)] toAddresses:@[coinJoinAddresses[3], self.account.changeAddress]];
+    wrapper.rounds[outpointOf(spend, 0)] = @3;
+    [self assertTotalsOfIndex:self.coinIndex matchRecomputationWithWrapper:wrapper];
+
+    [self.account removeTransaction:spend saveImmediately:NO];
+    [self assertTotalsOfIndex:self.coinIndex matchRecomputationWithWrapper:wrapper];
+
+    // a coin whose rounds aren't known yet gets them once a later transaction comes in
+    DSTransaction *unknown = [self registerTransactionSpending:@[] paying:@[@(DENOMINATION_SMALL)] toAddresses:@[coinJoinAddresses[4]]];
+    [self assertTotalsOfIndex:self.coinIndex matchRecomputationWithWrapper:wrapper];
+    wrapper.rounds[outpointOf(unknown, 0)] = @5;
+    [self registerTransactionSpending:@[] paying:@[@(OTHER_AMOUNT)]];
+    [self assertTotalsOfIndex:self.coinIndex matchRecomputationWithWrapper:wrapper];
+    [self.coinIndex getMixingProgressInputs:nil rounds:&rounds withWrapper:(DSCoinJoinWrapper *)wrapper];
+    XCTAssertEqual(rounds, 17);
+}
+
+- (void)testKnownRoundsSurviveAReload {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    DSCoinJoinCoinIndex *coinIndex = [[DSCoinJoinCoinIndex alloc] initWithAccount:self.account knownRoundsPath:path];
+    DSCoinJoinCoinIndexTestWrapper *wrapper = [[DSCoinJoinCoinIndexTestWrapper alloc] init];
+    NSArray<NSString *> *coinJoinAddresses = [self.account.coinJoinDerivationPath registerAddressesWithGapLimit:2 internal:NO error:nil];
+    DSTransaction *mixed = [self registerTransactionSpending:@[] paying:@[@(DENOMINATION_SMALL), @(DENOMINATION_MEDIUM)] toAddresses:coinJoinAddresses];
+    wrapper.rounds[outpointOf(mixed, 0)] = @3;
+    wrapper.rounds[outpointOf(mixed, 1)] = @5;
+    int32_t inputs = 0, rounds = 0;
+    [coinIndex getMixingProgressInputs:&inputs rounds:&rounds withWrapper:(DSCoinJoinWrapper *)wrapper];
+    XCTAssertEqual(inputs, 2);
+    XCTAssertEqual(rounds, 8);
+    XCTAssertEqual(wrapper.roundsRequestCount, 2);
+
+    // a new index of the account, as after a restart, doesn't ask for rounds it already knows
+    DSCoinJoinCoinIndexTestWrapper *restartedWrapper = [[DSCoinJoinCoinIndexTestWrapper alloc] init];
+    DSCoinJoinCoinIndex *reloadedIndex = [[DSCoinJoinCoinIndex alloc] initWithAccount:self.account knownRoundsPath:path];
+    [reloadedIndex getMixingProgressInputs:&inputs rounds:&rounds withWrapper:(DSCoinJoinWrapper *)restartedWrapper];
+    XCTAssertEqual(inputs, 2);
+    XCTAssertEqual(rounds, 8);
+    XCTAssertEqual(restartedWrapper.roundsRequestCount, 0);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+@end
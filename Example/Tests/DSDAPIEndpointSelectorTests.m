@@ -0,0 +1,141 @@
+//
+//  DSDAPIEndpointSelectorTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSDAPIEndpointSelector.h"
+
+#define SIMULATED_REQUEST_COUNT 4000
+#define SIMULATED_FAILURE_TIMEOUT 5.0
+
+@interface DSDAPIEndpointSelectorTests : XCTestCase
+
+@property (nonatomic, strong) NSArray<NSString *> *hosts;
+@property (nonatomic, strong) NSDictionary<NSString *, NSNumber *> *simulatedLatencies;
+@property (nonatomic, strong) NSDictionary<NSString *, NSNumber *> *simulatedFailureRates;
+@property (nonatomic, assign) uint32_t randomState;
+
+@end
+
+@implementation DSDAPIEndpointSelectorTests
+
+- (void)setUp {
+    // a farm of simulated DAPI nodes: most answer in about 50ms, one is slow and one is half dead
+    NSMutableArray<NSString *> *hosts = [NSMutableArray array];
+    NSMutableDictionary<NSString *, NSNumber *> *latencies = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSString *, NSNumber *> *failureRates = [NSMutableDictionary dictionary];
+    for (uint32_t i = 0; i < 10; i++) {
+        NSString *host = [NSString stringWithFormat:@"10.0.0.%u", i + 1];
+        [hosts addObject:host];
+        latencies[host] = @(0.04 + 0.002 * i);
+        failureRates[host] = @(0.0);
+    }
+    latencies[hosts[3]] = @(2.0);
+    failureRates[hosts[7]] = @(0.5);
+    self.hosts = hosts;
+    self.simulatedLatencies = latencies;
+    self.simulatedFailureRates = failureRates;
+    self.randomState = 2463534242; // fixed seed, every run simulates the same latencies and failures
+}
+
+// xorshift32, uniform enough for the simulation
+- (uint32_t)randomBelow:(uint32_t)bound {
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    return _randomState % bound;
+}
+
+// returns the time the simulated request took, failures cost a timeout and are retried on another node
+- (NSTimeInterval)simulateRequestWithSelector:(DSDAPIEndpointSelector *_Nullable)selector {
+    NSTimeInterval elapsed = 0;
+    for (uint32_t attempt = 0; attempt < 5; attempt++) {
+        NSString *host = selector ? [selector selectHostFromHosts:self.hosts excludingHost:nil] : self.hosts[[self randomBelow:(uint32_t)self.hosts.count]];
+        [selector requestStartedForHost:host];
+        NSTimeInterval latency = [self.simulatedLatencies[host] doubleValue] * (0.8 + 0.4 * ([self randomBelow:1000] / 1000.0));
+        if ([self randomBelow:1000] < [self.simulatedFailureRates[host] doubleValue] * 1000) {
+            [selector recordFailureForHost:host];
+            elapsed += SIMULATED_FAILURE_TIMEOUT;
+            continue;
+        }
+        [selector recordSuccessForHost:host latency:latency];
+        return elapsed + latency;
+    }
+    return elapsed;
+}
+
+- (NSTimeInterval)p99OfLatencies:(NSMutableArray<NSNumber *> *)latencies {
+    [latencies sortUsingSelector:@selector(compare:)];
+    return [latencies[(latencies.count * 99) / 100] doubleValue];
+}
+
+- (void)testTailLatencyAgainstSimulatedNodes {
+    DSDAPIEndpointSelector *selector = [[DSDAPIEndpointSelector alloc] init];
+    selector.ejectionDuration = 3600; // longer than the simulation, nothing gets probed back
+    for (NSString *host in self.hosts) {
+        [selector addHost:host];
+    }
+    NSMutableArray<NSNumber *> *selectedLatencies = [NSMutableArray array], *randomLatencies = [NSMutableArray array];
+    for (uint32_t i = 0; i < SIMULATED_REQUEST_COUNT; i++) {
+        [selectedLatencies addObject:@([self simulateRequestWithSelector:selector])];
+        [randomLatencies addObject:@([self simulateRequestWithSelector:nil])];
+    }
+    NSTimeInterval selectedP99 = [self p99OfLatencies:selectedLatencies];
+    NSTimeInterval randomP99 = [self p99OfLatencies:randomLatencies];
+    XCTAssertLessThan(selectedP99, 0.5, @"Slow and failing nodes should be avoided (p99 %f vs %f when picking at random)", selectedP99, randomP99);
+    XCTAssertGreaterThan(randomP99, selectedP99);
+    XCTAssertTrue([selector isHostEjected:self.hosts[7]], @"The half dead node should have been ejected");
+    XCTAssertGreaterThan([selector latencyForHost:self.hosts[3]], 1.0);
+    XCTAssertLessThan([selector hedgeDelay], 1.0, @"The hedge delay should follow the healthy nodes");
+}
+
+- (void)testEjectionAndProbe {
+    DSDAPIEndpointSelector *selector = [[DSDAPIEndpointSelector alloc] init];
+    selector.ejectionDuration = 0;
+    NSArray<NSString *> *hosts = @[@"10.0.0.1", @"10.0.0.2"];
+    for (NSUInteger i = 0; i < selector.consecutiveFailuresBeforeEjection; i++) {
+        [selector requestStartedForHost:hosts[0]];
+        [selector recordFailureForHost:hosts[0]];
+    }
+    XCTAssertTrue([selector isHostEjected:hosts[0]]);
+    for (uint32_t i = 0; i < 20; i++) {
+        XCTAssertEqualObjects([selector selectHostFromHosts:hosts excludingHost:nil], hosts[1], @"An ejected node should not be picked while a healthy one is available");
+    }
+    XCTAssertEqualObjects([selector selectHostFromHosts:hosts excludingHost:hosts[1]], hosts[0], @"An ejected node is still better than no node");
+
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[hosts[0]]);
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[], @"A node is only probed once per ejection");
+    XCTAssertTrue([selector isHostEjected:hosts[0]], @"A node stays out of rotation while it is being probed");
+    [selector recordSuccessForHost:hosts[0] latency:0.05];
+    XCTAssertFalse([selector isHostEjected:hosts[0]], @"A successful probe puts the node back in rotation");
+
+    // a failed probe ejects it again right away
+    for (NSUInteger i = 0; i < selector.consecutiveFailuresBeforeEjection; i++) {
+        [selector recordFailureForHost:hosts[0]];
+    }
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[hosts[0]]);
+    [selector recordFailureForHost:hosts[0]];
+    XCTAssertTrue([selector isHostEjected:hosts[0]]);
+}
+
+- (void)testProbeWithoutAnswerTimesOut {
+    DSDAPIEndpointSelector *selector = [[DSDAPIEndpointSelector alloc] init];
+    selector.ejectionDuration = 0;
+    selector.probeTimeout = 0;
+    NSString *host = @"10.0.0.1";
+    for (NSUInteger i = 0; i < selector.consecutiveFailuresBeforeEjection; i++) {
+        [selector recordFailureForHost:host];
+    }
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[host]);
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[host], @"A probe that timed out ejects the node again and it gets probed anew");
+    selector.probeTimeout = 3600;
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[host]);
+    XCTAssertEqualObjects([selector hostsNeedingProbe], @[], @"A probe still waiting for its answer is not sent again");
+    XCTAssertTrue([selector isHostEjected:host]);
+}
+
+@end
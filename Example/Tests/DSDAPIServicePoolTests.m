@@ -0,0 +1,96 @@
+//
+//  DSDAPIServicePoolTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSDAPIServicePool.h"
+
+#define TEST_PORT 3010
+
+@interface DSDAPIServicePoolTests : XCTestCase
+
+@end
+
+@implementation DSDAPIServicePoolTests
+
+- (id)serviceFromPool:(DSDAPIServicePool *)pool ofClass:(Class)serviceClass forHost:(NSString *)host {
+    return [pool serviceOfClass:serviceClass
+                        forHost:host
+                           port:TEST_PORT
+                         create:^id {
+                             return [[serviceClass alloc] init];
+                         }];
+}
+
+- (void)testServicesAreReusedPerNodeAndClass {
+    DSDAPIServicePool *pool = [[DSDAPIServicePool alloc] init];
+    NSObject *service = [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"];
+    XCTAssertEqual([self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"], service);
+    // a second kind of service shares the node's entry
+    NSMutableArray *otherService = [self serviceFromPool:pool ofClass:[NSMutableArray class] forHost:@"10.0.0.1"];
+    XCTAssertNotEqual((id)otherService, (id)service);
+    XCTAssertEqual(pool.entryCount, 1);
+    // the same host on another port is another node
+    id otherPortService = [pool serviceOfClass:[NSObject class] forHost:@"10.0.0.1" port:TEST_PORT + 1 create:^id { return [[NSObject alloc] init]; }];
+    XCTAssertNotEqual(otherPortService, service);
+    XCTAssertEqual(pool.entryCount, 2);
+    XCTAssertEqual(pool.reusedCount, 1);
+    XCTAssertEqual(pool.openedCount, 3);
+    XCTAssertEqualObjects([pool pooledHostsForPort:TEST_PORT], @[@"10.0.0.1"]);
+}
+
+- (void)testLeastRecentlyUsedNodeIsEvicted {
+    DSDAPIServicePool *pool = [[DSDAPIServicePool alloc] init];
+    pool.maximumEntryCount = 3;
+    NSObject *first = [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"];
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.2"];
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.3"];
+    // using the first node again makes the second one the least recently used
+    XCTAssertEqual([self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"], first);
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.4"];
+    XCTAssertEqual(pool.entryCount, 3);
+    XCTAssertEqual(pool.evictedCount, 1);
+    XCTAssertNil([pool pooledServiceOfClass:[NSObject class] forHost:@"10.0.0.2" port:TEST_PORT]);
+    XCTAssertEqual([pool pooledServiceOfClass:[NSObject class] forHost:@"10.0.0.1" port:TEST_PORT], first);
+    NSArray<NSString *> *expectedHosts = @[@"10.0.0.3", @"10.0.0.1", @"10.0.0.4"];
+    XCTAssertEqualObjects([pool pooledHostsForPort:TEST_PORT], expectedHosts);
+}
+
+- (void)testLookupsDoNotPoolOrTouchNodes {
+    DSDAPIServicePool *pool = [[DSDAPIServicePool alloc] init];
+    pool.maximumEntryCount = 2;
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"];
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.2"];
+    XCTAssertNil([pool pooledServiceOfClass:[NSObject class] forHost:@"10.0.0.3" port:TEST_PORT]);
+    XCTAssertNotNil([pool pooledServiceOfClass:[NSObject class] forHost:@"10.0.0.1" port:TEST_PORT]);
+    XCTAssertEqual(pool.entryCount, 2);
+    // the lookup didn't make the first node recently used, so it is the one evicted
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.3"];
+    XCTAssertNil([pool pooledServiceOfClass:[NSObject class] forHost:@"10.0.0.1" port:TEST_PORT]);
+}
+
+- (void)testIdleNodesAreEvicted {
+    DSDAPIServicePool *pool = [[DSDAPIServicePool alloc] init];
+    pool.idleTimeout = 0.05;
+    NSObject *service = [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertNotEqual([self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"], service);
+    XCTAssertEqual(pool.evictedCount, 1);
+    XCTAssertEqual(pool.entryCount, 1);
+}
+
+- (void)testRemovedNodesAreDropped {
+    DSDAPIServicePool *pool = [[DSDAPIServicePool alloc] init];
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.1"];
+    [self serviceFromPool:pool ofClass:[NSObject class] forHost:@"10.0.0.2"];
+    [pool removeServicesForHost:@"10.0.0.1" port:TEST_PORT];
+    XCTAssertEqualObjects([pool pooledHostsForPort:TEST_PORT], @[@"10.0.0.2"]);
+    [pool removeAllServices];
+    XCTAssertEqual(pool.entryCount, 0);
+}
+
+@end
@@ -0,0 +1,232 @@
+//
+//  DSDNSSeedResolverTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAddressManager.h"
+#import "DSDNSSeedResolver.h"
+
+#define FAST_SEED @"fast.seed.test"
+#define SLOW_SEED @"slow.seed.test"
+#define DEAD_SEED @"dead.seed.test"
+
+// answers from a table of hosts after a fixed latency, hosts with no answer never call back
+@interface DSFakeDNSResolver : NSObject <DSDNSResolver>
+
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSArray<NSValue *> *> *answers;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *latencies;
+@property (nonatomic, assign) NSTimeInterval ttl;
+@property (atomic, assign) NSUInteger lookupCount;
+
+@end
+
+@implementation DSFakeDNSResolver
+
+- (instancetype)init {
+    if (!(self = [super init])) return nil;
+    self.answers = [NSMutableDictionary dictionary];
+    self.latencies = [NSMutableDictionary dictionary];
+    self.ttl = 300;
+    return self;
+}
+
+- (void)setHost:(NSString *)host addressCount:(uint32_t)addressCount ipv6:(BOOL)ipv6 latency:(NSTimeInterval)latency {
+    NSMutableArray<NSValue *> *addresses = [NSMutableArray array];
+    for (uint32_t i = 0; i < addressCount; i++) {
+        uint32_t ip = (uint32_t)(host.hash & 0xff) << 24 | (i + 1) << 8 | 1;
+        UInt128 address = ipv6 ? (UInt128){.u32 = {CFSwapInt32HostToBig(0x2a0104f8), 0, 0, CFSwapInt32HostToBig(ip)}} : (UInt128){.u32 = {0, 0, CFSwapInt32HostToBig(0xffff), CFSwapInt32HostToBig(ip)}};
+        [addresses addObject:[NSValue valueWithBytes:&address objCType:@encode(UInt128)]];
+    }
+    self.answers[host] = addresses;
+    self.latencies[host] = @(latency);
+}
+
+- (void)resolveHost:(NSString *)host completion:(DSDNSResolverCompletionBlock)completion {
+    self.lookupCount++;
+    NSArray<NSValue *> *answer = self.answers[host];
+    if (!answer) return;
+    NSTimeInterval ttl = self.ttl;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)([self.latencies[host] doubleValue] * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        completion(answer, ttl, nil);
+    });
+}
+
+@end
+
+@interface DSDNSSeedResolverTests : XCTestCase
+
+@property (nonatomic, copy) NSString *cachePath;
+
+@end
+
+@implementation DSDNSSeedResolverTests
+
+- (void)setUp {
+    self.cachePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.cachePath error:nil];
+}
+
+- (dispatch_queue_t)queue {
+    return dispatch_queue_create("org.dashcore.dashsync.dnsseedstests", DISPATCH_QUEUE_SERIAL);
+}
+
+// resolves the seeds and returns the seeds in the order they answered
+- (NSArray<NSString *> *)resolveSeeds:(NSArray<NSString *> *)seeds withResolver:(DSDNSSeedResolver *)resolver timeout:(NSTimeInterval)timeout addressCount:(NSUInteger *)addressCount {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"seeds resolved"];
+    NSMutableArray<NSString *> *answeredSeeds = [NSMutableArray array];
+    __block NSUInteger count = 0;
+    [resolver resolveSeeds:seeds
+        port:19999
+        timeout:timeout
+        queue:[self queue]
+        addressesHandler:^(NSString *seed, NSArray<NSValue *> *addresses) {
+            [answeredSeeds addObject:seed];
+            for (NSValue *value in addresses) {
+                DSNetworkAddress address;
+                [value getValue:&address];
+                XCTAssertEqual(address.port, 19999);
+            }
+        }
+        completion:^(NSUInteger resolvedCount) {
+            count = resolvedCount;
+            [expectation fulfill];
+        }];
+    [self waitForExpectations:@[expectation] timeout:timeout + 5];
+    if (addressCount) *addressCount = count;
+    return answeredSeeds;
+}
+
+- (void)testFastSeedAnswersFirst {
+    DSFakeDNSResolver *fakeResolver = [[DSFakeDNSResolver alloc] init];
+    [fakeResolver setHost:FAST_SEED addressCount:4 ipv6:NO latency:0.01];
+    [fakeResolver setHost:SLOW_SEED addressCount:6 ipv6:YES latency:0.5];
+    DSDNSSeedResolver *resolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:nil];
+    NSUInteger addressCount = 0;
+    NSArray<NSString *> *answeredSeeds = [self resolveSeeds:@[SLOW_SEED, FAST_SEED] withResolver:resolver timeout:2 addressCount:&addressCount];
+    XCTAssertEqualObjects(answeredSeeds, (@[FAST_SEED, SLOW_SEED]));
+    XCTAssertEqual(addressCount, 10);
+}
+
+- (void)testAddressTypes {
+    DSFakeDNSResolver *fakeResolver = [[DSFakeDNSResolver alloc] init];
+    [fakeResolver setHost:FAST_SEED addressCount:1 ipv6:NO latency:0];
+    [fakeResolver setHost:SLOW_SEED addressCount:1 ipv6:YES latency:0];
+    DSDNSSeedResolver *resolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:nil];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"seeds resolved"];
+    NSMutableDictionary<NSString *, NSNumber *> *types = [NSMutableDictionary dictionary];
+    [resolver resolveSeeds:@[FAST_SEED, SLOW_SEED]
+        port:9999
+        timeout:1
+        queue:[self queue]
+        addressesHandler:^(NSString *seed, NSArray<NSValue *> *addresses) {
+            DSNetworkAddress address;
+            [addresses.firstObject getValue:&address];
+            types[seed] = @(address.type);
+        }
+        completion:^(NSUInteger addressCount) {
+            [expectation fulfill];
+        }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    XCTAssertEqualObjects(types[FAST_SEED], @(DSNetworkAddressType_IPv4));
+    XCTAssertEqualObjects(types[SLOW_SEED], @(DSNetworkAddressType_IPv6));
+}
+
+- (void)testSeedTimesOut {
+    DSFakeDNSResolver *fakeResolver = [[DSFakeDNSResolver alloc] init];
+    [fakeResolver setHost:FAST_SEED addressCount:3 ipv6:NO latency:0];
+    DSDNSSeedResolver *resolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:nil];
+    NSDate *start = [NSDate date];
+    NSUInteger addressCount = 0;
+    NSArray<NSString *> *answeredSeeds = [self resolveSeeds:@[DEAD_SEED, FAST_SEED] withResolver:resolver timeout:0.3 addressCount:&addressCount];
+    XCTAssertEqualObjects(answeredSeeds, @[FAST_SEED]);
+    XCTAssertEqual(addressCount, 3);
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 2);
+}
+
+- (void)testCachedAnswersRespectTTL {
+    DSFakeDNSResolver *fakeResolver = [[DSFakeDNSResolver alloc] init];
+    [fakeResolver setHost:FAST_SEED addressCount:2 ipv6:NO latency:0];
+    DSDNSSeedResolver *resolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:self.cachePath];
+    [self resolveSeeds:@[FAST_SEED] withResolver:resolver timeout:1 addressCount:nil];
+    [self resolveSeeds:@[FAST_SEED] withResolver:resolver timeout:1 addressCount:nil];
+    XCTAssertEqual(fakeResolver.lookupCount, 1);
+
+    // a new instance reads the cache from disk
+    DSDNSSeedResolver *reloadedResolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:self.cachePath];
+    NSUInteger addressCount = 0;
+    [self resolveSeeds:@[FAST_SEED] withResolver:reloadedResolver timeout:1 addressCount:&addressCount];
+    XCTAssertEqual(fakeResolver.lookupCount, 1);
+    XCTAssertEqual(addressCount, 2);
+
+    // once expired the seed is asked again
+    NSMutableDictionary *cache = [[NSDictionary dictionaryWithContentsOfFile:self.cachePath] mutableCopy];
+    NSMutableDictionary *entry = [cache[FAST_SEED] mutableCopy];
+    entry[@"expiry"] = @([entry[@"expiry"] doubleValue] - 2 * fakeResolver.ttl);
+    cache[FAST_SEED] = entry;
+    [cache writeToFile:self.cachePath atomically:YES];
+    DSDNSSeedResolver *expiredResolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:self.cachePath];
+    [self resolveSeeds:@[FAST_SEED] withResolver:expiredResolver timeout:1 addressCount:nil];
+    XCTAssertEqual(fakeResolver.lookupCount, 2);
+}
+
+- (void)testStaleCacheIsUsedWhenSeedDoesNotAnswer {
+    DSFakeDNSResolver *fakeResolver = [[DSFakeDNSResolver alloc] init];
+    fakeResolver.ttl = 0; // clamped to the minimum TTL
+    [fakeResolver setHost:FAST_SEED addressCount:2 ipv6:NO latency:0];
+    DSDNSSeedResolver *resolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:self.cachePath];
+    [self resolveSeeds:@[FAST_SEED] withResolver:resolver timeout:1 addressCount:nil];
+    NSDictionary *entry = [NSDictionary dictionaryWithContentsOfFile:self.cachePath][FAST_SEED];
+    XCTAssertEqualWithAccuracy([entry[@"expiry"] doubleValue] - [entry[@"resolved"] doubleValue], DNS_SEED_MIN_TTL, 1);
+
+    NSMutableDictionary *cache = [[NSDictionary dictionaryWithContentsOfFile:self.cachePath] mutableCopy];
+    NSMutableDictionary *expiredEntry = [entry mutableCopy];
+    expiredEntry[@"expiry"] = @(0);
+    cache[FAST_SEED] = expiredEntry;
+    [cache writeToFile:self.cachePath atomically:YES];
+    [fakeResolver.answers removeObjectForKey:FAST_SEED];
+    DSDNSSeedResolver *offlineResolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:self.cachePath];
+    NSUInteger addressCount = 0;
+    [self resolveSeeds:@[FAST_SEED] withResolver:offlineResolver timeout:0.2 addressCount:&addressCount];
+    XCTAssertEqual(addressCount, 2);
+}
+
+// MARK: - Injected latency
+
+// time until the first addresses can be connected to, one seed answering quickly and two stalling until the timeout
+- (void)testPerformanceTimeToFirstPeer {
+    DSFakeDNSResolver *fakeResolver = [[DSFakeDNSResolver alloc] init];
+    [fakeResolver setHost:FAST_SEED addressCount:8 ipv6:NO latency:0.05];
+    [fakeResolver setHost:SLOW_SEED addressCount:8 ipv6:YES latency:1.5];
+    __block NSTimeInterval timeToFirstPeer = 0, timeToAllSeeds = 0;
+    [self measureBlock:^{
+        DSDNSSeedResolver *resolver = [[DSDNSSeedResolver alloc] initWithResolver:fakeResolver cachePath:nil];
+        XCTestExpectation *expectation = [self expectationWithDescription:@"seeds resolved"];
+        NSDate *start = [NSDate date];
+        __block BOOL receivedAddresses = NO;
+        [resolver resolveSeeds:@[SLOW_SEED, DEAD_SEED, FAST_SEED]
+            port:9999
+            timeout:1
+            queue:[self queue]
+            addressesHandler:^(NSString *seed, NSArray<NSValue *> *addresses) {
+                if (receivedAddresses) return;
+                receivedAddresses = YES;
+                timeToFirstPeer = [[NSDate date] timeIntervalSinceDate:start];
+            }
+            completion:^(NSUInteger addressCount) {
+                timeToAllSeeds = [[NSDate date] timeIntervalSinceDate:start];
+                [expectation fulfill];
+            }];
+        [self waitForExpectations:@[expectation] timeout:5];
+    }];
+    XCTAssertLessThan(timeToFirstPeer, 0.5);
+    XCTAssertLessThan(timeToAllSeeds, 1.5);
+}
+
+@end
@@ -0,0 +1,163 @@
+//
+//  DSDarkGravityWaveTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "BigIntTypes.h"
+#import "DSBlock.h"
+#import "DSChain.h"
+#import "DSDarkGravityWave.h"
+#import "NSData+Dash.h"
+
+#define SIMULATED_HEADER_COUNT 3000
+#define SIMULATED_CHECKPOINT_HEIGHT 1000000
+
+@interface DSDarkGravityWaveTests : XCTestCase
+
+@property (nonatomic, assign) uint64_t randomState;
+
+@end
+
+@implementation DSDarkGravityWaveTests
+
+- (void)setUp {
+    self.randomState = 0x2f6b3a1d9c4e5f70;
+}
+
+// deterministic so a failure can be replayed
+- (uint32_t)nextRandom {
+    self.randomState = self.randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(self.randomState >> 33);
+}
+
+- (uint32_t)simulatedTargetOnChain:(DSChain *)chain {
+    switch ([self nextRandom] % 16) {
+        case 0:
+            return chain.maxProofOfWorkTarget;
+        case 1:
+            return 0x1e00ffff - [self nextRandom] % 0x100;
+        default:
+            return (0x19 + [self nextRandom] % 2) << 24 | (0x100000 + [self nextRandom] % 0x6fffff);
+    }
+}
+
+- (uint32_t)simulatedTimestampAfter:(uint32_t)timestamp {
+    switch ([self nextRandom] % 32) {
+        case 0:
+            return timestamp - [self nextRandom] % 400; // miners' clocks disagree
+        case 1:
+            return timestamp + 600 + [self nextRandom] % 9000; // long enough for minimum difficulty blocks
+        default:
+            return timestamp + [self nextRandom] % 400;
+    }
+}
+
+- (DSBlock *)blockAfter:(DSBlock *_Nullable)previous height:(uint32_t)height branch:(uint32_t)branch onChain:(DSChain *)chain {
+    UInt256 blockHash = UINT256_ZERO;
+    blockHash.u32[0] = height;
+    blockHash.u32[1] = branch;
+    blockHash.u32[7] = 0xd9b;
+    uint32_t timestamp = previous ? [self simulatedTimestampAfter:previous.timestamp] : 1390095618;
+    return [[DSBlock alloc] initWithVersion:2 blockHash:blockHash prevBlock:previous ? previous.blockHash : UINT256_ZERO timestamp:timestamp merkleRoot:UINT256_ZERO target:[self simulatedTargetOnChain:chain] chainWork:UINT256_ZERO height:height onChain:chain];
+}
+
+- (void)assertBlock:(DSBlock *)block withPreviousBlocks:(NSDictionary *)previousBlocks matchesDarkGravityWave:(DSDarkGravityWave *)darkGravityWave {
+    XCTAssertEqual([darkGravityWave canCalculateDifficultyForBlock:block withPreviousBlocks:previousBlocks], [block canCalculateDifficultyWithPreviousBlocks:previousBlocks], @"at height %u", block.height);
+    XCTAssertEqual([darkGravityWave darkGravityWaveTargetForBlock:block withPreviousBlocks:previousBlocks], [block darkGravityWaveTargetWithPreviousBlocks:previousBlocks], @"at height %u", block.height);
+}
+
+- (void)checkTargetsOnChain:(DSChain *)chain {
+    DSDarkGravityWave *darkGravityWave = [[DSDarkGravityWave alloc] initWithChain:chain];
+    NSMutableDictionary<NSValue *, DSBlock *> *blocks = [NSMutableDictionary dictionary];
+    NSMutableArray<DSBlock *> *mainBranch = [NSMutableArray array];
+    DSBlock *previous = nil;
+    for (uint32_t height = 0; height < SIMULATED_HEADER_COUNT; height++) {
+        DSBlock *block = [self blockAfter:previous height:height branch:0 onChain:chain];
+        [self assertBlock:block withPreviousBlocks:blocks matchesDarkGravityWave:darkGravityWave];
+        blocks[block.blockHashValue] = block;
+        [mainBranch addObject:block];
+        previous = block;
+        if (height % 500 == 250) {
+            // a short fork, then back on the main branch
+            DSBlock *forkBlock = mainBranch[height - 10];
+            for (uint32_t i = 1; i <= 15; i++) {
+                forkBlock = [self blockAfter:forkBlock height:height - 10 + i branch:height onChain:chain];
+                [self assertBlock:forkBlock withPreviousBlocks:blocks matchesDarkGravityWave:darkGravityWave];
+                blocks[forkBlock.blockHashValue] = forkBlock;
+            }
+        }
+    }
+    XCTAssertEqual(darkGravityWave.count, DGW_PAST_BLOCKS_MAX + 1);
+}
+
+- (void)testTargetsMatchWalkOnMainnet {
+    [self checkTargetsOnChain:[DSChain mainnet]];
+}
+
+- (void)testTargetsMatchWalkOnTestnet {
+    [self checkTargetsOnChain:[DSChain testnet]];
+}
+
+- (void)testTargetsMatchWalkAfterCheckpoint {
+    // syncing from a checkpoint, the window is incomplete for the first headers
+    DSChain *chain = [DSChain mainnet];
+    DSDarkGravityWave *darkGravityWave = [[DSDarkGravityWave alloc] initWithChain:chain];
+    NSMutableDictionary<NSValue *, DSBlock *> *blocks = [NSMutableDictionary dictionary];
+    DSBlock *previous = [self blockAfter:nil height:SIMULATED_CHECKPOINT_HEIGHT branch:0 onChain:chain];
+    blocks[previous.blockHashValue] = previous;
+    for (uint32_t height = SIMULATED_CHECKPOINT_HEIGHT + 1; height < SIMULATED_CHECKPOINT_HEIGHT + 100; height++) {
+        DSBlock *block = [self blockAfter:previous height:height branch:0 onChain:chain];
+        [self assertBlock:block withPreviousBlocks:blocks matchesDarkGravityWave:darkGravityWave];
+        blocks[block.blockHashValue] = block;
+        previous = block;
+    }
+    [darkGravityWave reset];
+    [self assertBlock:[self blockAfter:previous height:previous.height + 1 branch:0 onChain:chain] withPreviousBlocks:blocks matchesDarkGravityWave:darkGravityWave];
+}
+
+// MARK: - Per header validation cost
+
+- (NSArray<DSBlock *> *)simulatedHeadersOnChain:(DSChain *)chain previousBlocks:(NSMutableDictionary *)blocks {
+    NSMutableArray<DSBlock *> *headers = [NSMutableArray array];
+    DSBlock *previous = nil;
+    for (uint32_t height = 0; height < SIMULATED_HEADER_COUNT; height++) {
+        DSBlock *block = [self blockAfter:previous height:height branch:0 onChain:chain];
+        blocks[block.blockHashValue] = block;
+        [headers addObject:block];
+        previous = block;
+    }
+    return headers;
+}
+
+- (void)testPerformanceWalk {
+    DSChain *chain = [DSChain mainnet];
+    NSMutableDictionary *blocks = [NSMutableDictionary dictionary];
+    NSArray<DSBlock *> *headers = [self simulatedHeadersOnChain:chain previousBlocks:blocks];
+    [self measureBlock:^{
+        for (DSBlock *block in headers) {
+            if ([block canCalculateDifficultyWithPreviousBlocks:blocks]) {
+                [block darkGravityWaveTargetWithPreviousBlocks:blocks];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceSlidingWindow {
+    DSChain *chain = [DSChain mainnet];
+    NSMutableDictionary *blocks = [NSMutableDictionary dictionary];
+    NSArray<DSBlock *> *headers = [self simulatedHeadersOnChain:chain previousBlocks:blocks];
+    [self measureBlock:^{
+        DSDarkGravityWave *darkGravityWave = [[DSDarkGravityWave alloc] initWithChain:chain];
+        for (DSBlock *block in headers) {
+            if ([darkGravityWave canCalculateDifficultyForBlock:block withPreviousBlocks:blocks]) {
+                [darkGravityWave darkGravityWaveTargetForBlock:block withPreviousBlocks:blocks];
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,121 @@
+//
+//  DSInstantSendLockIngestionTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "dash_shared_core.h"
+#import "DSInstantSendLockIngestion.h"
+#import "DSKeyManager.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+#define BENCHMARK_LOCK_COUNT 50
+#define BENCHMARK_PEER_COUNT 8
+
+@interface DSInstantSendLockIngestionTests : XCTestCase
+
+@property (nonatomic, strong) NSData *publicKeyData;
+@property (nonatomic, assign) UInt768 signature;
+@property (nonatomic, assign) UInt256 signedDigest;
+@property (nonatomic, strong) NSArray<NSData *> *payloads;
+
+@end
+
+@implementation DSInstantSendLockIngestionTests
+
+- (void)setUp {
+    uint8_t seed[5] = {5, 4, 3, 2, 1};
+    BLSKey *key = key_bls_with_seed_data(seed, sizeof(seed), true);
+    NSData *message = [@"islock" dataUsingEncoding:NSUTF8StringEncoding];
+    self.publicKeyData = [DSKeyManager NSDataFrom:key_bls_public_key(key)];
+    self.signature = [[DSKeyManager NSDataFrom:key_bls_sign_data(key, message.bytes, message.length)] UInt768AtOffset:0];
+    self.signedDigest = message.SHA256_2;
+    NSMutableArray<NSData *> *payloads = [NSMutableArray array];
+    for (uint32_t i = 0; i < BENCHMARK_LOCK_COUNT; i++) {
+        NSMutableData *payload = [NSMutableData data];
+        [payload appendVarInt:1];
+        [payload appendUInt256:[NSData dataWithBytes:&i length:sizeof(i)].SHA256];
+        [payload appendUInt32:0];
+        [payload appendUInt256:[NSData dataWithBytes:&i length:sizeof(i)].SHA256_2];
+        [payload appendUInt768:self.signature];
+        [payloads addObject:payload];
+    }
+    self.payloads = payloads;
+}
+
+- (BOOL)verifySignature {
+    UInt256 digest = self.signedDigest;
+    UInt768 signature = self.signature;
+    return key_bls_verify(self.publicKeyData.bytes, true, digest.u8, signature.u8);
+}
+
+- (void)testDuplicatePayloadsAreDropped {
+    DSInstantSendLockIngestion *ingestion = [[DSInstantSendLockIngestion alloc] init];
+    XCTAssertTrue([ingestion acceptPayload:self.payloads[0]]);
+    XCTAssertFalse([ingestion acceptPayload:[self.payloads[0] copy]]);
+    XCTAssertTrue([ingestion acceptPayload:self.payloads[1]]);
+    XCTAssertEqual(ingestion.duplicatePayloadCount, 1);
+}
+
+- (void)testSeenPayloadsAreForgottenPastCapacity {
+    DSInstantSendLockIngestion *ingestion = [[DSInstantSendLockIngestion alloc] initWithSeenPayloadCapacity:2 verificationCapacity:2];
+    XCTAssertTrue([ingestion acceptPayload:self.payloads[0]]);
+    XCTAssertTrue([ingestion acceptPayload:self.payloads[1]]);
+    XCTAssertTrue([ingestion acceptPayload:self.payloads[2]]);
+    XCTAssertFalse([ingestion acceptPayload:self.payloads[2]]);
+    XCTAssertTrue([ingestion acceptPayload:self.payloads[0]]);
+}
+
+- (void)testVerificationIsMemoizedPerRequestAndQuorum {
+    DSInstantSendLockIngestion *ingestion = [[DSInstantSendLockIngestion alloc] init];
+    UInt256 requestID = self.payloads[0].SHA256, quorumHash = self.payloads[1].SHA256, transactionHash = self.payloads[2].SHA256;
+    __block NSUInteger checks = 0;
+    BOOL (^verifyBlock)(void) = ^BOOL {
+        checks++;
+        return [self verifySignature];
+    };
+    XCTAssertTrue([ingestion verifyRequestID:requestID quorumHash:quorumHash transactionHash:transactionHash signature:self.signature usingBlock:verifyBlock]);
+    XCTAssertTrue([ingestion verifyRequestID:requestID quorumHash:quorumHash transactionHash:transactionHash signature:self.signature usingBlock:verifyBlock]);
+    XCTAssertEqual(checks, 1);
+
+    [ingestion verifyRequestID:requestID quorumHash:transactionHash transactionHash:transactionHash signature:self.signature usingBlock:verifyBlock];
+    XCTAssertEqual(checks, 2);
+    // a conflicting lock for the same request must not inherit the result
+    XCTAssertFalse([ingestion verifyRequestID:requestID quorumHash:quorumHash transactionHash:quorumHash signature:self.signature usingBlock:^BOOL { checks++; return NO; }]);
+    XCTAssertEqual(checks, 3);
+    XCTAssertEqual(ingestion.verificationCount, 3);
+}
+
+// MARK: - Multi peer relay
+
+- (void)testPerformanceVerifyingEveryRelayedCopy {
+    [self measureBlock:^{
+        dispatch_apply(BENCHMARK_LOCK_COUNT * BENCHMARK_PEER_COUNT, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            XCTAssertTrue([self verifySignature]);
+        });
+    }];
+}
+
+- (void)testPerformanceIngestingRelayedCopies {
+    UInt256 quorumHash = self.signedDigest;
+    UInt768 signature = self.signature;
+    [self measureBlock:^{
+        DSInstantSendLockIngestion *ingestion = [[DSInstantSendLockIngestion alloc] init];
+        dispatch_apply(BENCHMARK_LOCK_COUNT * BENCHMARK_PEER_COUNT, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            NSData *payload = self.payloads[i % BENCHMARK_LOCK_COUNT];
+            if (![ingestion acceptPayload:payload]) return;
+            UInt256 requestID = payload.SHA256;
+            XCTAssertTrue([ingestion verifyRequestID:requestID quorumHash:quorumHash transactionHash:requestID signature:signature usingBlock:^BOOL {
+                return [self verifySignature];
+            }]);
+        });
+        XCTAssertEqual(ingestion.verificationCount, BENCHMARK_LOCK_COUNT);
+        XCTAssertEqual(ingestion.duplicatePayloadCount, BENCHMARK_LOCK_COUNT * (BENCHMARK_PEER_COUNT - 1));
+    }];
+}
+
+@end
@@ -0,0 +1,155 @@
+//
+//  DSInventoryTrackerTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSInventoryTracker.h"
+#import "NSData+Dash.h"
+
+#define SOAK_HASH_COUNT 1000000
+#define SOAK_PEER_COUNT 8
+
+@interface DSInventoryTrackerTests : XCTestCase
+
+@end
+
+@implementation DSInventoryTrackerTests
+
+- (UInt256)hashAtIndex:(uint32_t)index {
+    return [NSData dataWithBytes:&index length:sizeof(index)].SHA256;
+}
+
+- (void)testHashesAreKnownPerPeer {
+    DSInventoryTracker *tracker = [[DSInventoryTracker alloc] init];
+    NSUInteger peerA = [tracker acquirePeerTag], peerB = [tracker acquirePeerTag];
+    XCTAssertNotEqual(peerA, peerB);
+    UInt256 hash = [self hashAtIndex:1];
+    XCTAssertFalse([tracker markHash:hash ofKind:DSInventoryKind_Transaction knownByPeer:peerA]);
+    XCTAssertTrue([tracker markHash:hash ofKind:DSInventoryKind_Transaction knownByPeer:peerA]);
+    XCTAssertTrue([tracker peer:peerA knowsHash:hash ofKind:DSInventoryKind_Transaction]);
+    XCTAssertFalse([tracker peer:peerB knowsHash:hash ofKind:DSInventoryKind_Transaction]);
+    XCTAssertFalse([tracker markHash:hash ofKind:DSInventoryKind_Transaction knownByPeer:peerB]);
+    XCTAssertTrue([tracker peer:peerB knowsHash:hash ofKind:DSInventoryKind_Transaction]);
+    XCTAssertEqual(tracker.count, 1);
+
+    UInt256 storedHash = [self hashAtIndex:2];
+    XCTAssertFalse([tracker markHash:storedHash ofKind:DSInventoryKind_Transaction knownByPeer:INVENTORY_TRACKER_ALL_PEERS]);
+    XCTAssertTrue([tracker peer:peerA knowsHash:storedHash ofKind:DSInventoryKind_Transaction]);
+    XCTAssertTrue([tracker peer:peerB knowsHash:storedHash ofKind:DSInventoryKind_Transaction]);
+}
+
+- (void)testKindsAreTrackedSeparately {
+    DSInventoryTracker *tracker = [[DSInventoryTracker alloc] init];
+    NSUInteger peer = [tracker acquirePeerTag];
+    UInt256 hash = [self hashAtIndex:3];
+    [tracker markHash:hash ofKind:DSInventoryKind_InstantSendLock knownByPeer:peer];
+    XCTAssertTrue([tracker peer:peer knowsHash:hash ofKind:DSInventoryKind_InstantSendLock]);
+    XCTAssertFalse([tracker peer:peer knowsHash:hash ofKind:DSInventoryKind_InstantSendDeterministicLock]);
+    XCTAssertFalse([tracker peer:peer knowsHash:hash ofKind:DSInventoryKind_Transaction]);
+}
+
+- (void)testReleasedPeerTagIsForgotten {
+    DSInventoryTracker *tracker = [[DSInventoryTracker alloc] init];
+    NSUInteger peer = [tracker acquirePeerTag];
+    UInt256 hash = [self hashAtIndex:4];
+    [tracker markHash:hash ofKind:DSInventoryKind_ChainLock knownByPeer:peer];
+    [tracker releasePeerTag:peer];
+    NSUInteger reusedPeer = [tracker acquirePeerTag];
+    XCTAssertEqual(reusedPeer, peer);
+    XCTAssertFalse([tracker peer:reusedPeer knowsHash:hash ofKind:DSInventoryKind_ChainLock]);
+}
+
+- (void)testPeerTagsRunOut {
+    DSInventoryTracker *tracker = [[DSInventoryTracker alloc] init];
+    for (NSUInteger i = 0; i < INVENTORY_TRACKER_PEER_TAG_COUNT; i++) {
+        XCTAssertNotEqual([tracker acquirePeerTag], INVENTORY_TRACKER_NO_PEER_TAG);
+    }
+    XCTAssertEqual([tracker acquirePeerTag], INVENTORY_TRACKER_NO_PEER_TAG);
+    // a peer without a tag knows nothing and marks nothing for the others
+    UInt256 hash = [self hashAtIndex:5];
+    XCTAssertFalse([tracker markHash:hash ofKind:DSInventoryKind_Transaction knownByPeer:INVENTORY_TRACKER_NO_PEER_TAG]);
+    XCTAssertFalse([tracker markHash:hash ofKind:DSInventoryKind_Transaction knownByPeer:INVENTORY_TRACKER_NO_PEER_TAG]);
+    XCTAssertFalse([tracker peer:0 knowsHash:hash ofKind:DSInventoryKind_Transaction]);
+    XCTAssertEqual(tracker.count, 0);
+    [tracker releasePeerTag:INVENTORY_TRACKER_NO_PEER_TAG];
+    XCTAssertEqual([tracker acquirePeerTag], INVENTORY_TRACKER_NO_PEER_TAG);
+    [tracker releasePeerTag:INVENTORY_TRACKER_PEER_TAG_COUNT - 1];
+    XCTAssertEqual([tracker acquirePeerTag], INVENTORY_TRACKER_PEER_TAG_COUNT - 1);
+}
+
+- (void)testOldHashesRollIntoHistory {
+    DSInventoryTracker *tracker = [[DSInventoryTracker alloc] initWithCapacity:64 historyCapacity:1024];
+    NSUInteger peerA = [tracker acquirePeerTag], peerB = [tracker acquirePeerTag];
+    for (uint32_t i = 0; i < 512; i++) {
+        XCTAssertFalse([tracker markHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction knownByPeer:peerA]);
+        XCTAssertLessThanOrEqual(tracker.count, 64);
+    }
+    // aged out hashes are only in the history, which doesn't say which peers know them
+    for (uint32_t i = 0; i < 448; i++) {
+        XCTAssertTrue([tracker historyMayContainHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+        XCTAssertFalse([tracker peer:peerA knowsHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+    }
+    for (uint32_t i = 448; i < 512; i++) {
+        XCTAssertFalse([tracker historyMayContainHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+        XCTAssertTrue([tracker peer:peerA knowsHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+        XCTAssertFalse([tracker peer:peerB knowsHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+    }
+    XCTAssertFalse([tracker historyMayContainHash:[self hashAtIndex:100000] ofKind:DSInventoryKind_Transaction]);
+    XCTAssertFalse([tracker peer:peerA knowsHash:[self hashAtIndex:100000] ofKind:DSInventoryKind_Transaction]);
+
+    // marking an aged out hash puts it back in the table for that peer only
+    XCTAssertFalse([tracker markHash:[self hashAtIndex:0] ofKind:DSInventoryKind_Transaction knownByPeer:peerB]);
+    XCTAssertTrue([tracker peer:peerB knowsHash:[self hashAtIndex:0] ofKind:DSInventoryKind_Transaction]);
+    XCTAssertFalse([tracker peer:peerA knowsHash:[self hashAtIndex:0] ofKind:DSInventoryKind_Transaction]);
+    XCTAssertFalse([tracker historyMayContainHash:[self hashAtIndex:0] ofKind:DSInventoryKind_Transaction]);
+    XCTAssertEqual(tracker.count, 64);
+}
+
+- (void)testHistoryAgesOut {
+    DSInventoryTracker *tracker = [[DSInventoryTracker alloc] initWithCapacity:64 historyCapacity:1024];
+    NSUInteger peer = [tracker acquirePeerTag];
+    // each generation holds half the history capacity, the oldest is cleared once both are full
+    for (uint32_t i = 0; i < 64 + 512 * 3; i++) {
+        [tracker markHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction knownByPeer:peer];
+    }
+    for (uint32_t i = 0; i < 512; i++) {
+        XCTAssertFalse([tracker historyMayContainHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+    }
+    for (uint32_t i = 1024; i < 64 + 512 * 3 - 64; i++) {
+        XCTAssertTrue([tracker historyMayContainHash:[self hashAtIndex:i] ofKind:DSInventoryKind_Transaction]);
+    }
+}
+
+// MARK: - Soak
+
+- (void)testPerformanceMemoryStaysBoundedUnderFlood {
+    NSMutableData *hashes = [NSMutableData dataWithLength:SOAK_HASH_COUNT * sizeof(UInt256)];
+    UInt256 *hashBytes = hashes.mutableBytes;
+    for (uint32_t i = 0; i < SOAK_HASH_COUNT; i++) {
+        UInt256 hash = UINT256_ZERO;
+        hash.u32[0] = i;
+        hash.u64[1] = i * 0x9e3779b97f4a7c15ULL;
+        hash.u64[2] = ~hash.u64[1];
+        hash.u64[3] = i * 0xc2b2ae3d27d4eb4fULL;
+        hashBytes[i] = hash;
+    }
+    [self measureBlock:^{
+        DSInventoryTracker *tracker = [[DSInventoryTracker alloc] init];
+        NSUInteger allocatedSize = tracker.allocatedSize;
+        NSUInteger peers[SOAK_PEER_COUNT];
+        for (NSUInteger p = 0; p < SOAK_PEER_COUNT; p++) {
+            peers[p] = [tracker acquirePeerTag];
+        }
+        for (uint32_t i = 0; i < SOAK_HASH_COUNT; i++) {
+            [tracker markHash:hashBytes[i] ofKind:DSInventoryKind_Transaction knownByPeer:peers[i % SOAK_PEER_COUNT]];
+        }
+        XCTAssertEqual(tracker.count, tracker.capacity);
+        XCTAssertEqual(tracker.allocatedSize, allocatedSize);
+    }];
+}
+
+@end
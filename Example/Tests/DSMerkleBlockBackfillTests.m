@@ -0,0 +1,416 @@
+//
+//  DSMerkleBlockBackfillTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAccount.h"
+#import "DSBlock+Protected.h"
+#import "DSChain+Protected.h"
+#import "DSMerkleBlock.h"
+#import "DSMerkleBlockBackfill.h"
+#import "DSPeer.h"
+#import "DSTransaction.h"
+#import "DSWallet.h"
+#import "NSData+Dash.h"
+#import "NSDate+Utils.h"
+#import "NSMutableData+Dash.h"
+#import "NSString+Dash.h"
+
+#define BACKFILL_START_HEIGHT 1000
+#define RECORDED_CHAIN_LENGTH 2000
+#define REPLAY_PEER_COUNT 4
+#define REPLAY_LATENCY 0.04
+#define REPLAY_BLOCK_INTERVAL 0.0002
+
+// serves merkleblocks of a recorded chain like a remote node would: requests are answered in order, each block
+// taking its share of the link after half a round trip
+@interface DSReplayPeer : NSObject
+
+@property (nonatomic, strong) DSPeer *peer;
+@property (nonatomic, strong) NSData *recording;
+@property (nonatomic, strong) NSDictionary<NSValue *, NSValue *> *messageRanges;
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, assign) NSTimeInterval busyUntil;
+
+@end
+
+@implementation DSReplayPeer
+
+- (instancetype)initWithRecordingAtPath:(NSString *)path peer:(DSPeer *)peer queue:(dispatch_queue_t)queue {
+    if (!(self = [super init])) return nil;
+    self.peer = peer;
+    self.queue = queue;
+    self.recording = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+    NSMutableDictionary<NSValue *, NSValue *> *messageRanges = [NSMutableDictionary dictionary];
+    for (NSUInteger offset = 0; offset < self.recording.length;) {
+        NSRange range = NSMakeRange(offset + sizeof(uint32_t), [self.recording UInt32AtOffset:offset]);
+        DSMerkleBlock *block = [DSMerkleBlock merkleBlockWithMessage:[self.recording subdataWithRange:range] onChain:peer.chain];
+        messageRanges[uint256_obj(block.blockHash)] = [NSValue valueWithRange:range];
+        offset = NSMaxRange(range);
+    }
+    self.messageRanges = messageRanges;
+    return self;
+}
+
+// only called on the queue
+- (NSTimeInterval)scheduleResponseOfLength:(NSUInteger)length {
+    NSTimeInterval start = MAX([NSDate timeIntervalSince1970] + REPLAY_LATENCY / 2, self.busyUntil);
+    self.busyUntil = start + length * REPLAY_BLOCK_INTERVAL;
+    return start - [NSDate timeIntervalSince1970] + REPLAY_LATENCY / 2;
+}
+
+- (void)after:(NSTimeInterval)delay perform:(dispatch_block_t)block {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.queue, block);
+}
+
+- (void)sendGetblocksWithCompletion:(dispatch_block_t)completion {
+    [self after:[self scheduleResponseOfLength:0] perform:completion];
+}
+
+- (void)sendGetdataWithBlockHashes:(NSArray<NSValue *> *)blockHashes relayingTo:(void (^)(DSMerkleBlock *block, DSPeer *peer))relayBlock {
+    NSTimeInterval delay = [self scheduleResponseOfLength:blockHashes.count];
+    for (NSUInteger index = 0; index < blockHashes.count; index++) {
+        NSData *message = [self.recording subdataWithRange:self.messageRanges[blockHashes[index]].rangeValue];
+        [self after:delay + (index + 1) * REPLAY_BLOCK_INTERVAL perform:^{
+            relayBlock([DSMerkleBlock merkleBlockWithMessage:message onChain:self.peer.chain], self.peer);
+        }];
+    }
+}
+
+@end
+
+@interface DSMerkleBlockBackfillTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) NSString *recordingPath;
+@property (nonatomic, strong) NSArray<NSData *> *messages;
+@property (nonatomic, strong) NSArray<DSBlock *> *headers;
+@property (nonatomic, strong) NSDictionary<NSValue *, NSData *> *messagesByBlockHash;
+@property (nonatomic, strong) NSMutableArray<DSBlock *> *appliedBlocks;
+// tip of the replayed sync, only used on the replay queue
+@property (nonatomic, assign) UInt256 lastBlockHash;
+
+@end
+
+@implementation DSMerkleBlockBackfillTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    self.recordingPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    self.appliedBlocks = [NSMutableArray array];
+    [self recordChainOfLength:RECORDED_CHAIN_LENGTH];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.recordingPath error:nil];
+}
+
+// merkleblocks each matching a single transaction, written the way they came over the wire
+- (void)recordChainOfLength:(uint32_t)length {
+    NSMutableArray<NSData *> *messages = [NSMutableArray array];
+    NSMutableArray<DSBlock *> *headers = [NSMutableArray array];
+    NSMutableDictionary<NSValue *, NSData *> *messagesByBlockHash = [NSMutableDictionary dictionary];
+    NSMutableData *recording = [NSMutableData data];
+    UInt256 prevBlock = [NSData dataWithBytes:"base" length:4].SHA256_2;
+    for (uint32_t height = BACKFILL_START_HEIGHT; height < BACKFILL_START_HEIGHT + length; height++) {
+        UInt256 transactionHash = [NSData dataWithBytes:&height length:sizeof(height)].SHA256_2;
+        NSMutableData *message = [NSMutableData data];
+        [message appendUInt32:2];
+        [message appendUInt256:prevBlock];
+        [message appendUInt256:transactionHash];
+        [message appendUInt32:1600000000 + height * 150];
+        [message appendUInt32:0x207fffff];
+        [message appendUInt32:0];
+        NSMutableData *header = [message mutableCopy];
+        [header appendUInt8:0];
+        [message appendUInt32:1];
+        [message appendVarInt:1];
+        [message appendUInt256:transactionHash];
+        [message appendVarInt:1];
+        [message appendUInt8:1];
+        DSMerkleBlock *block = [DSMerkleBlock merkleBlockWithMessage:header onChain:self.chain];
+        block.height = height;
+        [headers addObject:block];
+        [messages addObject:message];
+        messagesByBlockHash[block.blockHashValue] = message;
+        [recording appendUInt32:(uint32_t)message.length];
+        [recording appendData:message];
+        prevBlock = block.blockHash;
+    }
+    [recording writeToFile:self.recordingPath atomically:YES];
+    self.messages = messages;
+    self.headers = headers;
+    self.messagesByBlockHash = messagesByBlockHash;
+}
+
+- (DSPeer *)peerWithPort:(uint16_t)port {
+    return [DSPeer peerWithHost:[NSString stringWithFormat:@"127.0.0.1:%u", port] onChain:self.chain];
+}
+
+- (DSMerkleBlock *)blockAtHeight:(uint32_t)height {
+    return [DSMerkleBlock merkleBlockWithMessage:self.messages[height - BACKFILL_START_HEIGHT] onChain:self.chain];
+}
+
+- (DSMerkleBlockBackfill *)backfillWithLength:(uint32_t)length windowRanges:(NSUInteger)windowRanges zoneFilter:(DSMerkleBlockBackfillZoneFilterBlock)zoneFilter {
+    return [[DSMerkleBlockBackfill alloc] initWithHeaders:[self.headers subarrayWithRange:NSMakeRange(0, length)] windowRanges:windowRanges zoneFilter:zoneFilter usingBlock:^BOOL(DSBlock *block, NSArray<DSTransaction *> *transactions, BOOL isHeaderOnly, DSPeer *peer) {
+        XCTAssertEqual(block.height, BACKFILL_START_HEIGHT + self.appliedBlocks.count);
+        XCTAssertEqual(isHeaderOnly, block.totalTransactions == 0);
+        [self.appliedBlocks addObject:block];
+        return YES;
+    }];
+}
+
+- (void)deliverBlockHashes:(NSArray<NSValue *> *)blockHashes toBackfill:(DSMerkleBlockBackfill *)backfill fromPeer:(DSPeer *)peer {
+    for (NSValue *blockHash in blockHashes) {
+        XCTAssertTrue([backfill receivedBlock:[DSMerkleBlock merkleBlockWithMessage:self.messagesByBlockHash[blockHash] onChain:self.chain] fromPeer:peer]);
+    }
+}
+
+- (void)testBlocksAreAppliedInOrder {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:1200 windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:nil];
+    XCTAssertEqual(backfill.rangeCount, 3);
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002];
+    NSArray<NSValue *> *firstBlockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    NSArray<NSValue *> *secondBlockHashes = [backfill nextBlockHashesForPeer:secondPeer];
+    XCTAssertEqual(firstBlockHashes.count, 500);
+    XCTAssertEqual(secondBlockHashes.count, 500);
+    XCTAssertNil([backfill nextBlockHashesForPeer:firstPeer], @"the peer still has a range to deliver");
+
+    [self deliverBlockHashes:secondBlockHashes toBackfill:backfill fromPeer:secondPeer];
+    XCTAssertEqual(self.appliedBlocks.count, 0);
+    XCTAssertEqual(backfill.bufferedCount, 500);
+    [self deliverBlockHashes:firstBlockHashes.reverseObjectEnumerator.allObjects toBackfill:backfill fromPeer:firstPeer];
+    XCTAssertEqual(self.appliedBlocks.count, 1000);
+    XCTAssertEqual(backfill.appliedHeight, BACKFILL_START_HEIGHT + 999);
+    XCTAssertEqual(backfill.bufferedCount, 0);
+    XCTAssertEqual(backfill.maximumBufferedCount, 1000);
+
+    [self deliverBlockHashes:[backfill nextBlockHashesForPeer:secondPeer] toBackfill:backfill fromPeer:secondPeer];
+    XCTAssertTrue(backfill.complete);
+    XCTAssertEqual(self.appliedBlocks.count, 1200);
+}
+
+- (void)testBlocksNotMatchingTheirHeaderAreRejected {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:1000 windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:nil];
+    DSPeer *peer = [self peerWithPort:3001];
+    DSBlock *header = self.headers[10];
+    DSMerkleBlock *forgedBlock = [[DSMerkleBlock alloc] initWithVersion:2 blockHash:header.blockHash prevBlock:self.headers[5].blockHash merkleRoot:header.merkleRoot timestamp:header.timestamp target:header.target chainWork:UINT256_ZERO nonce:0 totalTransactions:1 hashes:nil flags:nil height:0 chainLock:nil onChain:self.chain];
+    XCTAssertTrue([backfill containsBlockHash:forgedBlock.blockHash]);
+    XCTAssertFalse([backfill receivedBlock:forgedBlock fromPeer:peer]);
+    XCTAssertEqual(backfill.rejectedCount, 1);
+
+    XCTAssertFalse([backfill containsBlockHash:[self blockAtHeight:BACKFILL_START_HEIGHT + 1500].blockHash]);
+    XCTAssertFalse([backfill receivedBlock:[self blockAtHeight:BACKFILL_START_HEIGHT + 1500] fromPeer:peer]);
+    XCTAssertTrue([backfill receivedBlock:[self blockAtHeight:BACKFILL_START_HEIGHT + 10] fromPeer:peer]);
+    XCTAssertFalse([backfill receivedBlock:[self blockAtHeight:BACKFILL_START_HEIGHT + 10] fromPeer:peer], @"already buffered");
+    XCTAssertEqual(backfill.bufferedCount, 1);
+}
+
+- (void)testRangesOfOtherZonesOnlyNeedTheirHeaders {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:1200 windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:^BOOL(DSBlock *firstHeader, DSBlock *lastHeader) {
+        return firstHeader.height == 1500;
+    }];
+    XCTAssertEqual(backfill.merkleBlockRangeCount, 1);
+    [backfill start];
+    XCTAssertEqual(self.appliedBlocks.count, 500);
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002];
+    NSArray<NSValue *> *blockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    XCTAssertEqualObjects(blockHashes.firstObject, self.headers[500].blockHashValue);
+    XCTAssertNil([backfill nextBlockHashesForPeer:secondPeer]);
+    [self deliverBlockHashes:blockHashes toBackfill:backfill fromPeer:firstPeer];
+    XCTAssertTrue(backfill.complete);
+    XCTAssertEqual(backfill.requestCount, 1);
+}
+
+- (void)testRangesOfALostPeerAreRequestedAgain {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:1000 windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:nil];
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002], *thirdPeer = [self peerWithPort:3003];
+    NSArray<NSValue *> *blockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    [backfill nextBlockHashesForPeer:secondPeer];
+    [self deliverBlockHashes:[blockHashes subarrayWithRange:NSMakeRange(0, 100)] toBackfill:backfill fromPeer:firstPeer];
+    XCTAssertEqual(self.appliedBlocks.count, 100);
+    XCTAssertNil([backfill nextBlockHashesForPeer:thirdPeer]);
+
+    [backfill peerDisconnected:firstPeer];
+    NSArray<NSValue *> *missingBlockHashes = [backfill nextBlockHashesForPeer:thirdPeer];
+    XCTAssertEqualObjects(missingBlockHashes, [blockHashes subarrayWithRange:NSMakeRange(100, 400)]);
+    [self deliverBlockHashes:missingBlockHashes toBackfill:backfill fromPeer:thirdPeer];
+    XCTAssertEqual(self.appliedBlocks.count, 500);
+}
+
+- (void)testStalledRangeIsHandedToAnotherPeer {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:1000 windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:nil];
+    backfill.requestTimeout = -1;
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002], *thirdPeer = [self peerWithPort:3003];
+    NSArray<NSValue *> *blockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    XCTAssertNotEqualObjects([backfill nextBlockHashesForPeer:secondPeer], blockHashes, @"queued ranges go first");
+    XCTAssertEqualObjects([backfill nextBlockHashesForPeer:thirdPeer], blockHashes);
+}
+
+- (void)testRestartRequestsBufferedBlocksAgain {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:1200 windowRanges:MERKLE_BLOCK_BACKFILL_WINDOW_RANGES zoneFilter:nil];
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002];
+    NSArray<NSValue *> *firstBlockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    NSArray<NSValue *> *secondBlockHashes = [backfill nextBlockHashesForPeer:secondPeer];
+    [self deliverBlockHashes:[firstBlockHashes subarrayWithRange:NSMakeRange(0, 200)] toBackfill:backfill fromPeer:firstPeer];
+    [self deliverBlockHashes:secondBlockHashes toBackfill:backfill fromPeer:secondPeer];
+
+    // blocks that came with the old filter could miss transactions of new addresses
+    [backfill restart];
+    XCTAssertEqual(backfill.bufferedCount, 0);
+    XCTAssertEqualObjects([backfill nextBlockHashesForPeer:secondPeer], [firstBlockHashes subarrayWithRange:NSMakeRange(200, 300)]);
+    XCTAssertEqualObjects([backfill nextBlockHashesForPeer:firstPeer], secondBlockHashes);
+}
+
+- (void)testWindowBoundsTheReorderBuffer {
+    DSMerkleBlockBackfill *backfill = [self backfillWithLength:RECORDED_CHAIN_LENGTH windowRanges:2 zoneFilter:nil];
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002], *thirdPeer = [self peerWithPort:3003];
+    NSArray<NSValue *> *firstBlockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    NSArray<NSValue *> *secondBlockHashes = [backfill nextBlockHashesForPeer:secondPeer];
+    [self deliverBlockHashes:secondBlockHashes toBackfill:backfill fromPeer:secondPeer];
+    XCTAssertNil([backfill nextBlockHashesForPeer:thirdPeer]);
+    XCTAssertNil([backfill nextBlockHashesForPeer:secondPeer]);
+    [self deliverBlockHashes:firstBlockHashes toBackfill:backfill fromPeer:firstPeer];
+    XCTAssertEqualObjects([backfill nextBlockHashesForPeer:thirdPeer].firstObject, self.headers[1000].blockHashValue);
+    XCTAssertLessThanOrEqual(backfill.maximumBufferedCount, 2 * MERKLE_BLOCK_BACKFILL_RANGE_LENGTH);
+}
+
+- (void)testBlockNotExtendingTheChainStopsTheBackfill {
+    __block NSUInteger appliedCount = 0;
+    DSMerkleBlockBackfill *backfill = [[DSMerkleBlockBackfill alloc] initWithHeaders:[self.headers subarrayWithRange:NSMakeRange(0, 1000)] zoneFilter:nil usingBlock:^BOOL(DSBlock *block, NSArray<DSTransaction *> *transactions, BOOL isHeaderOnly, DSPeer *peer) {
+        return ++appliedCount < 50;
+    }];
+    DSPeer *peer = [self peerWithPort:3001];
+    [backfill nextBlockHashesForPeer:peer];
+    for (uint32_t height = BACKFILL_START_HEIGHT; height < BACKFILL_START_HEIGHT + 60; height++) {
+        [backfill receivedBlock:[self blockAtHeight:height] fromPeer:peer];
+    }
+    XCTAssertTrue(backfill.failed);
+    XCTAssertFalse(backfill.complete);
+    XCTAssertEqual(appliedCount, 50);
+    XCTAssertEqual(backfill.appliedHeight, BACKFILL_START_HEIGHT + 48);
+    XCTAssertNil([backfill nextBlockHashesForPeer:[self peerWithPort:3002]]);
+}
+
+- (DSTransaction *)transactionSpending:(DSUTXO)outpoint toAddress:(NSString *)address amount:(uint64_t)amount {
+    DSTransaction *transaction = [[DSTransaction alloc] initOnChain:self.chain];
+    [transaction addInputHash:outpoint.hash index:outpoint.n script:nil signature:nil sequence:TXIN_SEQUENCE];
+    [transaction addOutputAddress:address amount:amount];
+    transaction.txHash = transaction.toData.SHA256_2;
+    return transaction;
+}
+
+- (void)testTransactionsAreRegisteredWithTheirBlock {
+    DSWallet *wallet = [DSWallet transientWalletWithDerivedKeyData:@"00112233445566778899aabbccddeeff".hexToData forChain:self.chain];
+    DSWallet *otherWallet = [DSWallet transientWalletWithDerivedKeyData:@"ffeeddccbbaa99887766554433221100".hexToData forChain:self.chain];
+    [self.chain addWallet:wallet];
+    DSAccount *account = [wallet accountWithNumber:0];
+    DSTransaction *funding = [self transactionSpending:(DSUTXO){[NSData dataWithBytes:"funding" length:7].SHA256_2, 0} toAddress:account.receiveAddress amount:DUFFS];
+    // no change output, only the funding transaction tells that the spend belongs to the account
+    DSTransaction *spend = [self transactionSpending:(DSUTXO){funding.txHash, 0} toAddress:[otherWallet accountWithNumber:0].receiveAddress amount:DUFFS - 1000];
+    NSMutableArray<DSTransaction *> *registeredTransactions = [NSMutableArray array];
+    DSMerkleBlockBackfill *backfill = [[DSMerkleBlockBackfill alloc] initWithHeaders:[self.headers subarrayWithRange:NSMakeRange(0, 1000)] zoneFilter:nil usingBlock:^BOOL(DSBlock *block, NSArray<DSTransaction *> *transactions, BOOL isHeaderOnly, DSPeer *peer) {
+        for (DSTransaction *transaction in transactions) {
+            transaction.blockHeight = block.height;
+            if ([account registerTransaction:transaction saveImmediately:NO]) [registeredTransactions addObject:transaction];
+        }
+        return YES;
+    }];
+    DSPeer *firstPeer = [self peerWithPort:3001], *secondPeer = [self peerWithPort:3002];
+    NSArray<NSValue *> *firstBlockHashes = [backfill nextBlockHashesForPeer:firstPeer];
+    NSArray<NSValue *> *secondBlockHashes = [backfill nextBlockHashesForPeer:secondPeer];
+    DSMerkleBlock *fundingBlock = [self blockAtHeight:BACKFILL_START_HEIGHT + 10], *spendingBlock = [self blockAtHeight:BACKFILL_START_HEIGHT + 600];
+
+    // the spending block is served first, its transaction comes ahead of it like peers send them
+    XCTAssertTrue([backfill receivedTransaction:spend inBlock:spendingBlock]);
+    XCTAssertTrue([backfill receivedTransaction:spend inBlock:spendingBlock]);
+    [self deliverBlockHashes:secondBlockHashes toBackfill:backfill fromPeer:secondPeer];
+    XCTAssertNil([account transactionForHash:spend.txHash]);
+    XCTAssertTrue([backfill receivedTransaction:funding inBlock:fundingBlock]);
+    [self deliverBlockHashes:firstBlockHashes toBackfill:backfill fromPeer:firstPeer];
+
+    XCTAssertTrue(backfill.complete);
+    XCTAssertEqualObjects(registeredTransactions, (@[funding, spend]));
+    XCTAssertTrue([account isSpent:dsutxo_obj(((DSUTXO){funding.txHash, 0}))]);
+    XCTAssertEqual(account.balance, 0);
+    XCTAssertFalse([backfill receivedTransaction:funding inBlock:fundingBlock], @"the block was applied already");
+    [self.chain unregisterWallet:wallet];
+}
+
+// MARK: - Sync time against replay peers
+
+- (NSArray<DSReplayPeer *> *)replayPeersWithCount:(NSUInteger)count queue:(dispatch_queue_t)queue {
+    NSMutableArray<DSReplayPeer *> *replayPeers = [NSMutableArray array];
+    for (uint16_t i = 0; i < count; i++) {
+        [replayPeers addObject:[[DSReplayPeer alloc] initWithRecordingAtPath:self.recordingPath peer:[self peerWithPort:3001 + i] queue:queue]];
+    }
+    return replayPeers;
+}
+
+// what a single download peer does: getblocks is answered with an inv of the next blocks, those are asked for with
+// getdata while the next getblocks goes out, and blocks are added as they arrive
+- (void)syncFromIndex:(NSUInteger)startIndex withDownloadPeer:(DSReplayPeer *)replayPeer expectation:(XCTestExpectation *)expectation {
+    [replayPeer sendGetblocksWithCompletion:^{
+        NSUInteger endIndex = MIN(startIndex + MERKLE_BLOCK_BACKFILL_RANGE_LENGTH, self.headers.count);
+        NSMutableArray<NSValue *> *blockHashes = [NSMutableArray array];
+        for (NSUInteger index = startIndex; index < endIndex; index++) {
+            [blockHashes addObject:self.headers[index].blockHashValue];
+        }
+        if (endIndex < self.headers.count) [self syncFromIndex:endIndex withDownloadPeer:replayPeer expectation:expectation];
+        [replayPeer sendGetdataWithBlockHashes:blockHashes relayingTo:^(DSMerkleBlock *block, DSPeer *peer) {
+            XCTAssertTrue(uint256_eq(block.prevBlock, self.lastBlockHash));
+            self.lastBlockHash = block.blockHash;
+            if (uint256_eq(block.blockHash, self.headers.lastObject.blockHash)) [expectation fulfill];
+        }];
+    }];
+}
+
+- (void)requestRangesOfBackfill:(DSMerkleBlockBackfill *)backfill fromReplayPeers:(NSArray<DSReplayPeer *> *)replayPeers {
+    for (DSReplayPeer *replayPeer in replayPeers) {
+        NSArray<NSValue *> *blockHashes = [backfill nextBlockHashesForPeer:replayPeer.peer];
+        if (!blockHashes.count) continue;
+        [replayPeer sendGetdataWithBlockHashes:blockHashes relayingTo:^(DSMerkleBlock *block, DSPeer *peer) {
+            XCTAssertTrue([backfill receivedBlock:block fromPeer:peer]);
+            [self requestRangesOfBackfill:backfill fromReplayPeers:replayPeers];
+        }];
+    }
+}
+
+- (void)testPerformanceSyncFromOneDownloadPeer {
+    [self measureBlock:^{
+        dispatch_queue_t queue = dispatch_queue_create("org.dashcore.dashsync.backfilltests", DISPATCH_QUEUE_SERIAL);
+        DSReplayPeer *replayPeer = [self replayPeersWithCount:1 queue:queue].firstObject;
+        XCTestExpectation *expectation = [self expectationWithDescription:@"synced"];
+        self.lastBlockHash = self.headers.firstObject.prevBlock;
+        dispatch_async(queue, ^{
+            [self syncFromIndex:0 withDownloadPeer:replayPeer expectation:expectation];
+        });
+        [self waitForExpectations:@[expectation] timeout:30];
+    }];
+}
+
+- (void)testPerformanceBackfillFromReplayPeers {
+    [self measureBlock:^{
+        dispatch_queue_t queue = dispatch_queue_create("org.dashcore.dashsync.backfilltests", DISPATCH_QUEUE_SERIAL);
+        NSArray<DSReplayPeer *> *replayPeers = [self replayPeersWithCount:REPLAY_PEER_COUNT queue:queue];
+        XCTestExpectation *expectation = [self expectationWithDescription:@"synced"];
+        self.lastBlockHash = self.headers.firstObject.prevBlock;
+        DSMerkleBlockBackfill *backfill = [[DSMerkleBlockBackfill alloc] initWithHeaders:self.headers zoneFilter:nil usingBlock:^BOOL(DSBlock *block, NSArray<DSTransaction *> *transactions, BOOL isHeaderOnly, DSPeer *peer) {
+            XCTAssertTrue(uint256_eq(block.prevBlock, self.lastBlockHash));
+            self.lastBlockHash = block.blockHash;
+            if (uint256_eq(block.blockHash, self.headers.lastObject.blockHash)) [expectation fulfill];
+            return YES;
+        }];
+        dispatch_async(queue, ^{
+            [self requestRangesOfBackfill:backfill fromReplayPeers:replayPeers];
+        });
+        [self waitForExpectations:@[expectation] timeout:30];
+        XCTAssertLessThanOrEqual(backfill.maximumBufferedCount, MERKLE_BLOCK_BACKFILL_WINDOW_RANGES * MERKLE_BLOCK_BACKFILL_RANGE_LENGTH);
+    }];
+}
+
+@end
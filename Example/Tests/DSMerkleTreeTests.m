@@ -0,0 +1,320 @@
+//
+//  DSMerkleTreeTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSMerkleTree.h"
+#import "NSData+Dash.h"
+#import "NSMutableData+Dash.h"
+
+#define FUZZ_ITERATION_COUNT 2000
+#define BENCHMARK_ELEMENT_COUNT 20000
+#define BENCHMARK_MAX_LEAF_COUNT 100000
+
+static int ceil_log2(int x) {
+    int r = (x & (x - 1)) ? 1 : 0;
+
+    while ((x >>= 1) != 0) r++;
+    return r;
+}
+
+static uint64_t tree_width(uint32_t elementCount, int height) {
+    return ((uint64_t)elementCount + (1ULL << height) - 1) >> height;
+}
+
+static UInt256 hash_pair(UInt256 left, UInt256 right) {
+    NSMutableData *d = [NSMutableData data];
+    [d appendUInt256:left];
+    [d appendUInt256:right];
+    return d.SHA256_2;
+}
+
+@interface DSMerkleTreeTests : XCTestCase
+
+@end
+
+@implementation DSMerkleTreeTests
+
+// MARK: - Encoding
+
+- (UInt256)hashAtHeight:(int)height position:(uint64_t)position leaves:(const UInt256 *)leaves count:(uint32_t)count {
+    if (height == 0) return leaves[position];
+    UInt256 left = [self hashAtHeight:height - 1 position:position * 2 leaves:leaves count:count];
+    UInt256 right = (position * 2 + 1 < tree_width(count, height - 1)) ? [self hashAtHeight:height - 1 position:position * 2 + 1 leaves:leaves count:count] : left;
+    return hash_pair(left, right);
+}
+
+// BIP37 encoding, as done by Dash Core when answering getdata for a filtered block
+- (void)encodeHeight:(int)height position:(uint64_t)position leaves:(const UInt256 *)leaves matches:(const BOOL *)matches count:(uint32_t)count hashes:(NSMutableData *)hashes bits:(NSMutableArray<NSNumber *> *)bits {
+    BOOL parentOfMatch = NO;
+    for (uint64_t p = position << height; p < (position + 1) << height && p < count; p++) {
+        parentOfMatch |= matches[p];
+    }
+    [bits addObject:@(parentOfMatch)];
+    if (height == 0 || !parentOfMatch) {
+        [hashes appendUInt256:[self hashAtHeight:height position:position leaves:leaves count:count]];
+    } else {
+        [self encodeHeight:height - 1 position:position * 2 leaves:leaves matches:matches count:count hashes:hashes bits:bits];
+        if (position * 2 + 1 < tree_width(count, height - 1)) {
+            [self encodeHeight:height - 1 position:position * 2 + 1 leaves:leaves matches:matches count:count hashes:hashes bits:bits];
+        }
+    }
+}
+
+- (DSMerkleTree *)treeWithLeaves:(const UInt256 *)leaves matches:(const BOOL *)matches count:(uint32_t)count {
+    NSMutableData *hashes = [NSMutableData data];
+    NSMutableArray<NSNumber *> *bits = [NSMutableArray array];
+    [self encodeHeight:ceil_log2(count) position:0 leaves:leaves matches:matches count:count hashes:hashes bits:bits];
+    NSMutableData *flags = [NSMutableData dataWithLength:(bits.count + 7) / 8];
+    uint8_t *flagBytes = flags.mutableBytes;
+    for (NSUInteger i = 0; i < bits.count; i++) {
+        if (bits[i].boolValue) flagBytes[i / 8] |= 1 << (i % 8);
+    }
+    return [[DSMerkleTree alloc] initWithHashes:hashes flags:flags treeElementCount:count hashFunction:DSMerkleTreeHashFunction_SHA256_2];
+}
+
+// MARK: - Reference
+
+// the recursive walk used before the iterative decoder, kept to check the decoder against it
+- (UInt256)referenceWalkTree:(DSMerkleTree *)tree hashIdx:(NSUInteger *)hashIdx flagIdx:(NSUInteger *)flagIdx depth:(int)depth matches:(NSMutableArray *)matches exhausted:(BOOL *)exhausted {
+    if (*flagIdx / 8 >= tree.flags.length || (*hashIdx + 1) * sizeof(UInt256) > tree.hashes.length) {
+        *exhausted = YES;
+        return UINT256_ZERO;
+    }
+    BOOL flag = (((const uint8_t *)tree.flags.bytes)[*flagIdx / 8] & (1 << (*flagIdx % 8)));
+    (*flagIdx)++;
+    if (!flag || depth == ceil_log2(tree.treeElementCount)) {
+        UInt256 hash = [tree.hashes UInt256AtOffset:(*hashIdx) * sizeof(UInt256)];
+        (*hashIdx)++;
+        if (flag) [matches addObject:uint256_obj(hash)];
+        return hash;
+    }
+    BOOL leftExhausted = NO, rightExhausted = NO;
+    UInt256 left = [self referenceWalkTree:tree hashIdx:hashIdx flagIdx:flagIdx depth:depth + 1 matches:matches exhausted:&leftExhausted];
+    UInt256 right = [self referenceWalkTree:tree hashIdx:hashIdx flagIdx:flagIdx depth:depth + 1 matches:matches exhausted:&rightExhausted];
+    if (rightExhausted) right = left;
+    return hash_pair(left, right);
+}
+
+- (UInt256)referenceRootOfTree:(DSMerkleTree *)tree matches:(NSMutableArray *)matches {
+    NSUInteger hashIdx = 0, flagIdx = 0;
+    BOOL exhausted = NO;
+    return [self referenceWalkTree:tree hashIdx:&hashIdx flagIdx:&flagIdx depth:0 matches:matches exhausted:&exhausted];
+}
+
+// MARK: - Tests
+
+- (void)randomLeaves:(UInt256 *)leaves matches:(BOOL *)matches count:(uint32_t)count matchOneIn:(uint32_t)matchOneIn {
+    for (uint32_t i = 0; i < count; i++) {
+        arc4random_buf(&leaves[i], sizeof(UInt256));
+        matches[i] = arc4random_uniform(matchOneIn) == 0;
+    }
+}
+
+- (void)testOddRows {
+    // three transactions, the last one matched, so the right branch of the root has no right child
+    UInt256 leaves[3];
+    BOOL matches[3] = {NO, NO, YES};
+    [self randomLeaves:leaves matches:(BOOL[3]){0} count:3 matchOneIn:1];
+    DSMerkleTree *tree = [self treeWithLeaves:leaves matches:matches count:3];
+    XCTAssertTrue(tree.isValid);
+    XCTAssertTrue(uint256_eq(tree.merkleRoot, [self hashAtHeight:2 position:0 leaves:leaves count:3]));
+    XCTAssertEqualObjects(tree.elementHashes, @[uint256_obj(leaves[2])]);
+    XCTAssertEqual(((const uint32_t *)tree.matchedPositions.bytes)[0], 2);
+    XCTAssertTrue([tree containsHash:leaves[2]]);
+    XCTAssertFalse([tree containsHash:leaves[0]]); // only stored as part of a branch hash
+}
+
+- (void)testSingleElement {
+    UInt256 leaf;
+    arc4random_buf(&leaf, sizeof(leaf));
+    DSMerkleTree *tree = [self treeWithLeaves:&leaf matches:(BOOL[1]){YES} count:1];
+    XCTAssertTrue(tree.isValid);
+    XCTAssertTrue(uint256_eq(tree.merkleRoot, leaf));
+    XCTAssertEqualObjects(tree.elementHashes, @[uint256_obj(leaf)]);
+}
+
+- (void)testDuplicatedBranchIsRejected {
+    // CVE-2012-2459, a block of four transactions where the last two are the same hashes like a block of three
+    UInt256 leaves[4];
+    [self randomLeaves:leaves matches:(BOOL[4]){0} count:4 matchOneIn:1];
+    leaves[3] = leaves[2];
+    DSMerkleTree *tree = [self treeWithLeaves:leaves matches:(BOOL[4]){NO, NO, YES, YES} count:4];
+    XCTAssertFalse(tree.isValid);
+    XCTAssertFalse([tree merkleTreeHasRoot:[self hashAtHeight:2 position:0 leaves:leaves count:4]]);
+}
+
+- (void)testUnusedHashesAreRejected {
+    UInt256 leaves[8];
+    BOOL matches[8];
+    [self randomLeaves:leaves matches:matches count:8 matchOneIn:3];
+    matches[5] = YES;
+    DSMerkleTree *tree = [self treeWithLeaves:leaves matches:matches count:8];
+    XCTAssertTrue(tree.isValid);
+    NSMutableData *hashes = [tree.hashes mutableCopy];
+    [hashes appendUInt256:leaves[0]];
+    DSMerkleTree *paddedTree = [[DSMerkleTree alloc] initWithHashes:hashes flags:tree.flags treeElementCount:8 hashFunction:DSMerkleTreeHashFunction_SHA256_2];
+    XCTAssertFalse(paddedTree.isValid);
+}
+
+// random trees decode to the root, matches and positions they were encoded from, like the recursive walk
+- (void)testFuzzAgainstEncoder {
+    for (NSUInteger iteration = 0; iteration < FUZZ_ITERATION_COUNT; iteration++) {
+        uint32_t count = 1 + arc4random_uniform(iteration % 4 == 0 ? 3000 : 64);
+        UInt256 *leaves = malloc(count * sizeof(UInt256));
+        BOOL *matches = malloc(count * sizeof(BOOL));
+        [self randomLeaves:leaves matches:matches count:count matchOneIn:1 + arc4random_uniform(20)];
+        DSMerkleTree *tree = [self treeWithLeaves:leaves matches:matches count:count];
+        XCTAssertTrue(tree.isValid);
+        XCTAssertTrue(uint256_eq(tree.merkleRoot, [self hashAtHeight:ceil_log2(count) position:0 leaves:leaves count:count]));
+
+        NSMutableArray *referenceMatches = [NSMutableArray array];
+        XCTAssertTrue(uint256_eq(tree.merkleRoot, [self referenceRootOfTree:tree matches:referenceMatches]));
+        XCTAssertEqualObjects(tree.elementHashes, referenceMatches);
+
+        NSUInteger matchedIdx = 0;
+        const uint32_t *positions = tree.matchedPositions.bytes;
+        for (uint32_t i = 0; i < count; i++) {
+            if (!matches[i]) continue;
+            XCTAssertEqual(positions[matchedIdx], i);
+            XCTAssertTrue(uint256_eq([tree.matchedHashes UInt256AtOffset:matchedIdx * sizeof(UInt256)], leaves[i]));
+            XCTAssertTrue([tree containsHash:leaves[i]]);
+            matchedIdx++;
+        }
+        XCTAssertEqual(matchedIdx, tree.matchedHashes.length / sizeof(UInt256));
+        free(leaves);
+        free(matches);
+    }
+}
+
+// corrupted trees either fail to decode or decode exactly like the recursive walk, without reading out of bounds
+- (void)testFuzzCorruptedTrees {
+    for (NSUInteger iteration = 0; iteration < FUZZ_ITERATION_COUNT; iteration++) {
+        uint32_t count = 1 + arc4random_uniform(200);
+        UInt256 *leaves = malloc(count * sizeof(UInt256));
+        BOOL *matches = malloc(count * sizeof(BOOL));
+        [self randomLeaves:leaves matches:matches count:count matchOneIn:1 + arc4random_uniform(10)];
+        DSMerkleTree *tree = [self treeWithLeaves:leaves matches:matches count:count];
+        NSMutableData *hashes = [tree.hashes mutableCopy], *flags = [tree.flags mutableCopy];
+        uint32_t corruptedCount = count;
+        switch (arc4random_uniform(5)) {
+            case 0:
+                ((uint8_t *)flags.mutableBytes)[arc4random_uniform((uint32_t)flags.length)] ^= 1 << arc4random_uniform(8);
+                break;
+            case 1:
+                hashes.length -= sizeof(UInt256);
+                break;
+            case 2:
+                flags.length -= 1;
+                break;
+            case 3:
+                ((uint8_t *)hashes.mutableBytes)[arc4random_uniform((uint32_t)hashes.length)] ^= 1;
+                break;
+            default:
+                corruptedCount = 1 + arc4random_uniform(count * 2);
+                break;
+        }
+        DSMerkleTree *corruptedTree = [[DSMerkleTree alloc] initWithHashes:hashes flags:flags treeElementCount:corruptedCount hashFunction:DSMerkleTreeHashFunction_SHA256_2];
+        if (corruptedTree.isValid) {
+            NSMutableArray *referenceMatches = [NSMutableArray array];
+            XCTAssertTrue(uint256_eq(corruptedTree.merkleRoot, [self referenceRootOfTree:corruptedTree matches:referenceMatches]));
+            XCTAssertEqualObjects(corruptedTree.elementHashes, referenceMatches);
+        } else {
+            XCTAssertTrue(uint256_is_zero(corruptedTree.merkleRoot));
+            XCTAssertEqual(corruptedTree.elementHashes.count, 0);
+        }
+        free(leaves);
+        free(matches);
+    }
+}
+
+// MARK: - Building
+
+// the level by level construction over arrays of NSData used before the flat buffer builder
+- (NSData *)referenceRootOfLeaves:(NSArray<NSData *> *)leaves {
+    NSArray<NSData *> *level = leaves;
+    while (level.count > 1) {
+        NSMutableArray<NSData *> *higherLevel = [NSMutableArray array];
+        for (NSUInteger i = 0; i < level.count; i += 2) {
+            NSMutableData *combined = [level[i] mutableCopy];
+            [combined appendData:(i + 1 < level.count) ? level[i + 1] : level[i]];
+            [higherLevel addObject:[NSData dataWithUInt256:combined.SHA256_2]];
+        }
+        level = higherLevel;
+    }
+    return level.firstObject;
+}
+
+- (NSData *)randomPackedLeaves:(uint32_t)count {
+    NSMutableData *leaves = [NSMutableData dataWithLength:count * sizeof(UInt256)];
+    arc4random_buf(leaves.mutableBytes, leaves.length);
+    return leaves;
+}
+
+- (void)testRootMatchesReference {
+    XCTAssertTrue(uint256_is_zero([DSMerkleTree merkleRootOfHashes:[NSData data] hashFunction:DSMerkleTreeHashFunction_SHA256_2]));
+    for (uint32_t count = 1; count <= 70; count++) {
+        NSData *leaves = [self randomPackedLeaves:count];
+        NSMutableArray<NSData *> *leafArray = [NSMutableArray array];
+        for (uint32_t i = 0; i < count; i++) {
+            [leafArray addObject:[leaves subdataWithRange:NSMakeRange(i * sizeof(UInt256), sizeof(UInt256))]];
+        }
+        UInt256 root = [DSMerkleTree merkleRootOfHashes:leaves hashFunction:DSMerkleTreeHashFunction_SHA256_2];
+        XCTAssertEqualObjects(uint256_data(root), [self referenceRootOfLeaves:leafArray]);
+        XCTAssertEqualObjects([NSData merkleRootFromHashes:leafArray], [self referenceRootOfLeaves:leafArray]);
+        XCTAssertTrue(uint256_eq(root, [self hashAtHeight:ceil_log2(count) position:0 leaves:leaves.bytes count:count]));
+    }
+}
+
+- (void)testBranchesProveEveryLeaf {
+    for (NSNumber *hashFunction in @[@(DSMerkleTreeHashFunction_SHA256_2), @(DSMerkleTreeHashFunction_BLAKE3)]) {
+        for (uint32_t count = 1; count <= 33; count++) {
+            NSData *leaves = [self randomPackedLeaves:count];
+            UInt256 root = [DSMerkleTree merkleRootOfHashes:leaves hashFunction:hashFunction.integerValue];
+            for (uint32_t i = 0; i < count; i++) {
+                NSData *branch = [DSMerkleTree merkleBranchOfHashes:leaves leafIndex:i hashFunction:hashFunction.integerValue];
+                XCTAssertEqual(branch.length / sizeof(UInt256), ceil_log2(count));
+                UInt256 leaf = [leaves UInt256AtOffset:i * sizeof(UInt256)];
+                XCTAssertTrue(uint256_eq([DSMerkleTree merkleRootOfBranch:branch leaf:leaf leafIndex:i hashFunction:hashFunction.integerValue], root));
+                if (count > 1) XCTAssertFalse(uint256_eq([DSMerkleTree merkleRootOfBranch:branch leaf:leaf leafIndex:i ^ 1 hashFunction:hashFunction.integerValue], root));
+            }
+            XCTAssertNil([DSMerkleTree merkleBranchOfHashes:leaves leafIndex:count hashFunction:hashFunction.integerValue]);
+        }
+    }
+}
+
+// MARK: - Performance
+
+- (void)testPerformanceBuildingRoots {
+    NSData *leaves = [self randomPackedLeaves:BENCHMARK_MAX_LEAF_COUNT];
+    [self measureBlock:^{
+        for (uint32_t count = 1; count <= BENCHMARK_MAX_LEAF_COUNT; count *= 10) {
+            NSData *someLeaves = [leaves subdataWithRange:NSMakeRange(0, count * sizeof(UInt256))];
+            XCTAssertFalse(uint256_is_zero([DSMerkleTree merkleRootOfHashes:someLeaves hashFunction:DSMerkleTreeHashFunction_SHA256_2]));
+            XCTAssertEqual([DSMerkleTree merkleBranchOfHashes:someLeaves leafIndex:count - 1 hashFunction:DSMerkleTreeHashFunction_SHA256_2].length, ceil_log2(count) * sizeof(UInt256));
+        }
+    }];
+}
+
+- (void)testPerformanceDecodingMerkleBlock {
+    UInt256 *leaves = malloc(BENCHMARK_ELEMENT_COUNT * sizeof(UInt256));
+    BOOL *matches = malloc(BENCHMARK_ELEMENT_COUNT * sizeof(BOOL));
+    [self randomLeaves:leaves matches:matches count:BENCHMARK_ELEMENT_COUNT matchOneIn:50];
+    DSMerkleTree *tree = [self treeWithLeaves:leaves matches:matches count:BENCHMARK_ELEMENT_COUNT];
+    UInt256 root = [self hashAtHeight:ceil_log2(BENCHMARK_ELEMENT_COUNT) position:0 leaves:leaves count:BENCHMARK_ELEMENT_COUNT];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 20; i++) {
+            DSMerkleTree *decodedTree = [[DSMerkleTree alloc] initWithHashes:tree.hashes flags:tree.flags treeElementCount:BENCHMARK_ELEMENT_COUNT hashFunction:DSMerkleTreeHashFunction_SHA256_2];
+            XCTAssertTrue([decodedTree merkleTreeHasRoot:root]);
+            XCTAssertGreaterThan(decodedTree.elementHashes.count, 0);
+        }
+    }];
+    free(leaves);
+    free(matches);
+}
+
+@end
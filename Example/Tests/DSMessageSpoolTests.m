@@ -0,0 +1,175 @@
+//
+//  DSMessageSpoolTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSChain.h"
+#import "DSChainConstants.h"
+#import "DSChainManager.h"
+#import "DSMasternodeList.h"
+#import "DSMasternodeManager+Mndiff.h"
+#import "DSMasternodeProcessorContext.h"
+#import "DSMessageSpool.h"
+#import "DSMnDiffProcessingResult.h"
+#import "DSPeer.h"
+#import "NSData+Dash.h"
+#import "NSString+Bitcoin.h"
+
+// bytes a buffered read asks the stream for at once
+#define BUFFERED_READ_LENGTH MESSAGE_SPOOL_BUFFER_LENGTH
+
+@interface DSMessageSpoolTests : XCTestCase
+
+@property (nonatomic, strong) NSArray<NSString *> *fixtures;
+@property (nonatomic, strong) NSDictionary<NSString *, NSNumber *> *diffFixtureHeights; // full diffs from genesis
+
+@end
+
+@implementation DSMessageSpoolTests
+
+- (void)setUp {
+    self.fixtures = @[@"MNLIST_1746460", @"MNL_0_1090944", @"MNL_0_1096704", @"ML_at_122088", @"MNL_1090944_1091520"];
+    self.diffFixtureHeights = @{@"MNL_0_1090944": @1090944, @"MNL_0_1096704": @1096704, @"ML_at_122088": @122088};
+}
+
+- (NSString *)pathForFixture:(NSString *)fixture {
+    NSString *path = [[NSBundle bundleForClass:[self class]] pathForResource:fixture ofType:@"dat"];
+    XCTAssertNotNil(path, @"File must exist for file %@", fixture);
+    return path;
+}
+
+// reads the fixture the way a peer reads its input stream, in reads of at most the spool buffer length
+- (DSMessageSpool *)spoolFixture:(NSString *)fixture readLength:(NSUInteger)readLength {
+    NSString *path = [self pathForFixture:fixture];
+    uint32_t length = (uint32_t)[[[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil] fileSize];
+    DSMessageSpool *spool = [[DSMessageSpool alloc] initWithLength:length];
+    NSMutableData *readBuffer = [NSMutableData dataWithLength:readLength];
+    NSInputStream *stream = [NSInputStream inputStreamWithFileAtPath:path];
+    [stream open];
+    while (!spool.complete) {
+        NSInteger l = [stream read:readBuffer.mutableBytes maxLength:MIN(readLength, length - spool.receivedLength)];
+        if (l <= 0) break;
+        XCTAssertTrue([spool appendBytes:readBuffer.bytes length:l]);
+    }
+    [stream close];
+    return spool;
+}
+
+- (NSData *)bufferedFixture:(NSString *)fixture {
+    NSString *path = [self pathForFixture:fixture];
+    uint32_t length = (uint32_t)[[[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil] fileSize];
+    NSMutableData *payload = [NSMutableData dataWithLength:length];
+    NSInputStream *stream = [NSInputStream inputStreamWithFileAtPath:path];
+    [stream open];
+    NSUInteger payloadLength = 0;
+    while (payloadLength < length) {
+        NSInteger l = [stream read:(uint8_t *)payload.mutableBytes + payloadLength maxLength:MIN(BUFFERED_READ_LENGTH, length - payloadLength)];
+        if (l <= 0) break;
+        payloadLength += l;
+    }
+    [stream close];
+    return payload;
+}
+
+- (void)testSpooledFixturesMatchPayloadAndChecksum {
+    for (NSString *fixture in self.fixtures) {
+        NSData *payload = [NSData dataWithContentsOfFile:[self pathForFixture:fixture]];
+        for (NSNumber *readLength in @[@(997), @(MESSAGE_SPOOL_BUFFER_LENGTH), @(3 * MESSAGE_SPOOL_BUFFER_LENGTH + 5)]) {
+            DSMessageSpool *spool = [self spoolFixture:fixture readLength:readLength.unsignedIntegerValue];
+            XCTAssertTrue(spool.complete, @"%@", fixture);
+            XCTAssertEqual(spool.checksum, CFSwapInt32LittleToHost(payload.SHA256_2.u32[0]), @"%@", fixture);
+            XCTAssertLessThanOrEqual(spool.maximumBufferedLength, (NSUInteger)MESSAGE_SPOOL_BUFFER_LENGTH);
+            XCTAssertEqualObjects([spool finishedMessage], payload, @"%@", fixture);
+        }
+    }
+}
+
+- (void)testSpoolRejectsExtraBytesAndIncompleteMessages {
+    uint8_t bytes[16] = {0};
+    DSMessageSpool *spool = [[DSMessageSpool alloc] initWithLength:12];
+    XCTAssertTrue([spool appendBytes:bytes length:8]);
+    XCTAssertNil([spool finishedMessage]);
+    XCTAssertFalse([spool appendBytes:bytes length:8]);
+    XCTAssertTrue([spool appendBytes:bytes length:4]);
+    XCTAssertEqualObjects([spool finishedMessage], [NSData dataWithBytes:bytes length:12]);
+}
+
+- (void)testSpoolFileIsRemoved {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    uint8_t bytes[4] = {1, 2, 3, 4};
+    DSMessageSpool *spool = [[DSMessageSpool alloc] initWithLength:4 path:path];
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:path]);
+    [spool appendBytes:bytes length:4];
+    NSData *message = [spool finishedMessage];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:path]);
+    XCTAssertEqualObjects(message, [NSData dataWithBytes:bytes length:4]);
+
+    @autoreleasepool {
+        __unused DSMessageSpool *abandonedSpool = [[DSMessageSpool alloc] initWithLength:8 path:path];
+        [abandonedSpool appendBytes:bytes length:4];
+    }
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:path]);
+}
+
+- (void)testOnlyLargeMasternodeListMessagesAreSpooled {
+    XCTAssertTrue([DSMessageSpool shouldSpoolMessageOfType:MSG_MNLISTDIFF length:MESSAGE_SPOOL_MINIMUM_LENGTH]);
+    XCTAssertTrue([DSMessageSpool shouldSpoolMessageOfType:MSG_QUORUMROTATIONINFO length:MESSAGE_SPOOL_MINIMUM_LENGTH]);
+    XCTAssertFalse([DSMessageSpool shouldSpoolMessageOfType:MSG_MNLISTDIFF length:MESSAGE_SPOOL_MINIMUM_LENGTH - 1]);
+    XCTAssertFalse([DSMessageSpool shouldSpoolMessageOfType:MSG_MERKLEBLOCK length:MESSAGE_SPOOL_MINIMUM_LENGTH]);
+}
+
+- (DSMnDiffProcessingResult *)processDiffMessage:(NSData *)message ofFixture:(NSString *)fixture {
+    DSChain *chain = [fixture hasPrefix:@"ML_at_"] ? [DSChain testnet] : [DSChain mainnet];
+    uint32_t blockHeight = self.diffFixtureHeights[fixture].unsignedIntValue;
+    DSMasternodeProcessorContext *mndiffContext = [[DSMasternodeProcessorContext alloc] init];
+    [mndiffContext setIsFromSnapshot:YES];
+    [mndiffContext setUseInsightAsBackup:NO];
+    [mndiffContext setChain:chain];
+    [mndiffContext setMasternodeListLookup:^DSMasternodeList *_Nonnull(UInt256 blockHash) {
+        return nil;
+    }];
+    [mndiffContext setMerkleRootLookup:^UInt256(UInt256 blockHash) {
+        return UINT256_ZERO;
+    }];
+    [mndiffContext setBlockHeightLookup:^uint32_t(UInt256 blockHash) {
+        return blockHeight;
+    }];
+    return [chain.chainManager.masternodeManager processMasternodeDiffFromFile:message protocolVersion:DEFAULT_CHECKPOINT_PROTOCOL_VERSION withContext:mndiffContext];
+}
+
+- (void)testSpooledDiffProcesses {
+    NSData *message = [[self spoolFixture:@"ML_at_122088" readLength:MESSAGE_SPOOL_BUFFER_LENGTH] finishedMessage];
+    DSMnDiffProcessingResult *result = [self processDiffMessage:message ofFixture:@"ML_at_122088"];
+    XCTAssertTrue(uint256_eq(@"94d0af97187af3b9311c98b1cf40c9c9849df0af55dc63b097b80d4cf6c816c5".hexToData.UInt256, result.masternodeList.masternodeMerkleRoot));
+    XCTAssertTrue(result.rootMNListValid);
+}
+
+// peak memory of receiving and processing the full diffs, the buffered replay holds each payload in memory like the peer used to
+// both replays hand the message to the same processing so that only the way it was received differs
+- (void)testPerformancePeakMemoryProcessingBufferedDiffs {
+    [self measureWithMetrics:@[[[XCTMemoryMetric alloc] init]] block:^{
+        for (NSString *fixture in self.diffFixtureHeights) {
+            @autoreleasepool {
+                NSData *message = [self bufferedFixture:fixture];
+                XCTAssertNotNil([self processDiffMessage:message ofFixture:fixture].masternodeList, @"%@", fixture);
+            }
+        }
+    }];
+}
+
+- (void)testPerformancePeakMemoryProcessingSpooledDiffs {
+    [self measureWithMetrics:@[[[XCTMemoryMetric alloc] init]] block:^{
+        for (NSString *fixture in self.diffFixtureHeights) {
+            @autoreleasepool {
+                NSData *message = [[self spoolFixture:fixture readLength:MESSAGE_SPOOL_BUFFER_LENGTH] finishedMessage];
+                XCTAssertNotNil([self processDiffMessage:message ofFixture:fixture].masternodeList, @"%@", fixture);
+            }
+        }
+    }];
+}
+
+@end
@@ -19,10 +19,12 @@
 
 #import "BigIntTypes.h"
 #import "DSAccount.h"
+#import "DSBlockMiner.h"
 #import "DSChain+Protected.h"
 #import "DSChainManager.h"
 #import "DSChainManager+Mining.h"
 #import "DSFullBlock.h"
+#import "DSKeyManager.h"
 #import "DSWallet.h"
 #import "NSData+DSHash.h"
 #import "NSData+Dash.h"
@@ -84,4 +86,32 @@
 }
 
 
+- (DSFullBlock *)emptyBlockAfterLastTerminalBlock {
+    DSBlock *previousBlock = self.chain.lastTerminalBlock;
+    DSAccount *account = [self.wallet accountWithNumber:0];
+    DSCoinbaseTransaction *coinbaseTransaction = [[DSCoinbaseTransaction alloc] initWithCoinbaseMessage:@"From iOS" paymentAddresses:@[account.receiveAddress] atHeight:previousBlock.height + 1 onChain:self.chain];
+    return [[DSFullBlock alloc] initWithCoinbaseTransaction:coinbaseTransaction transactions:[NSSet set] previousBlockHash:previousBlock.blockHash previousBlocks:self.chain.terminalBlocks timestamp:[[NSDate date] timeIntervalSince1970] height:previousBlock.height + 1 onChain:self.chain];
+}
+
+- (void)testParallelMinerHeader {
+    DSFullBlock *block = [self emptyBlockAfterLastTerminalBlock];
+    DSBlockMiner *miner = [[DSBlockMiner alloc] init];
+    miner.threadCount = 4;
+    uint64_t attempts = 0;
+    XCTAssertTrue([block mineBlockAfterBlock:self.chain.lastTerminalBlock withNonceOffset:0 withTimeout:60 usingMiner:miner rAttempts:&attempts]);
+    XCTAssertGreaterThan(attempts, 0);
+    XCTAssertEqual(attempts, miner.attempts);
+    XCTAssertTrue(uint256_eq([DSKeyManager x11:[block toData]], block.blockHash), @"The nonce and timestamp written back must give the mined hash");
+    XCTAssertFalse(uint256_sup(block.blockHash, setCompactLE(block.target)));
+}
+
+- (void)testCancelledMiner {
+    DSFullBlock *block = [self emptyBlockAfterLastTerminalBlock];
+    DSBlockMiner *miner = [[DSBlockMiner alloc] init];
+    [miner cancel];
+    uint64_t attempts = 0;
+    XCTAssertFalse([block mineBlockAfterBlock:self.chain.lastTerminalBlock withNonceOffset:0 withTimeout:60 usingMiner:miner rAttempts:&attempts]);
+    XCTAssertEqual(attempts, 0);
+}
+
 @end
@@ -0,0 +1,280 @@
+//
+//  DSPlatformDocumentsCacheTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSChain+Protected.h"
+#import "DSChainManager.h"
+#import "DSDAPIPlatformNetworkService.h"
+#import "DSDAPIPlatformNetworkServiceProtocol.h"
+#import "DSIdentitiesManager+Protected.h"
+#import "DSPlatformDocumentsCache.h"
+#import "DSPlatformDocumentsRequest.h"
+#import "NSData+Dash.h"
+
+// answers DPNS in queries from a fixed list of documents, a page at a time
+@interface DSPlatformDocumentsCacheTestService : NSObject
+
+@property (nonatomic, strong) NSArray<NSDictionary *> *documents;
+@property (nonatomic, strong) NSMutableArray *startAfters;
+
+@end
+
+@implementation DSPlatformDocumentsCacheTestService
+
+- (id<DSDAPINetworkServiceRequest>)getDPNSDocumentsForIdentitiesWithUserIds:(NSArray<NSData *> *)userIds
+                                                                 startAfter:(NSData *)startAfter
+                                                            completionQueue:(dispatch_queue_t)completionQueue
+                                                                    success:(void (^)(NSArray<NSDictionary *> *documents))success
+                                                                    failure:(void (^)(NSError *error))failure {
+    [self.startAfters addObject:startAfter ?: [NSNull null]];
+    NSUInteger start = 0;
+    if (startAfter) {
+        start = [self.documents indexOfObjectPassingTest:^BOOL(NSDictionary *document, NSUInteger idx, BOOL *stop) {
+            return [document[@"$id"] isEqualToData:startAfter];
+        }] + 1;
+    }
+    NSArray<NSDictionary *> *page = [self.documents subarrayWithRange:NSMakeRange(start, MIN(DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT, self.documents.count - start))];
+    dispatch_async(completionQueue, ^{
+        success(page);
+    });
+    return nil;
+}
+
+@end
+
+@interface DSPlatformDocumentsCacheTests : XCTestCase
+
+@property (nonatomic, strong) DSPlatformDocumentsCache *cache;
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@property (nonatomic, assign) NSUInteger fetchCount;
+
+@end
+
+@implementation DSPlatformDocumentsCacheTests
+
+- (void)setUp {
+    self.cache = [[DSPlatformDocumentsCache alloc] init];
+    self.completionQueue = dispatch_queue_create("org.dashcore.dashsync.tests.documents", DISPATCH_QUEUE_SERIAL);
+    self.fetchCount = 0;
+}
+
+- (NSData *)userIdWithIndex:(uint32_t)index {
+    return [NSData dataWithBytes:&index length:sizeof(uint32_t)].SHA256_2;
+}
+
+- (DSPlatformDocumentsRequest *)requestForUserIdWithIndex:(uint32_t)index {
+    return [DSPlatformDocumentsRequest dpnsRequestForUserIds:@[[self userIdWithIndex:index]]];
+}
+
+- (NSArray<NSDictionary *> *)documentsForIndex:(uint32_t)index {
+    return @[@{@"$id": [self userIdWithIndex:index]}];
+}
+
+// queries the cache and waits for the answer, the fetch answers right away
+- (NSArray<NSDictionary *> *)documentsForRequest:(DSPlatformDocumentsRequest *)request documents:(NSArray<NSDictionary *> *)documents {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"documents"];
+    __block NSArray<NSDictionary *> *receivedDocuments = nil;
+    [self.cache documentsForRequest:request
+        host:nil
+        completionQueue:self.completionQueue
+        success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+            receivedDocuments = documents;
+            [expectation fulfill];
+        }
+        failure:^(NSError *_Nonnull error) {
+            XCTFail(@"%@", error);
+            [expectation fulfill];
+        }
+        fetch:^id<DSDAPINetworkServiceRequest>(DSPlatformDocumentsSuccessBlock success, DSPlatformDocumentsFailureBlock failure) {
+            self.fetchCount++;
+            success(documents);
+            return nil;
+        }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    return receivedDocuments;
+}
+
+// MARK: - Coalescing
+
+- (void)testIdenticalQueriesInFlightAreCoalesced {
+    DSPlatformDocumentsRequest *request = [self requestForUserIdWithIndex:0];
+    NSArray<NSDictionary *> *documents = [self documentsForIndex:0];
+    __block DSPlatformDocumentsSuccessBlock pendingSuccess = nil;
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; i++) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"coalesced"];
+        [expectations addObject:expectation];
+        [self.cache documentsForRequest:request
+            host:nil
+            completionQueue:self.completionQueue
+            success:^(NSArray<NSDictionary *> *_Nonnull receivedDocuments) {
+                XCTAssertEqualObjects(receivedDocuments, documents);
+                [expectation fulfill];
+            }
+            failure:^(NSError *_Nonnull error) {
+                XCTFail(@"%@", error);
+            }
+            fetch:^id<DSDAPINetworkServiceRequest>(DSPlatformDocumentsSuccessBlock success, DSPlatformDocumentsFailureBlock failure) {
+                self.fetchCount++;
+                pendingSuccess = success;
+                return nil;
+            }];
+    }
+    XCTAssertEqual(self.fetchCount, 1);
+    XCTAssertEqual(self.cache.missCount, 1);
+    XCTAssertEqual(self.cache.coalescedCount, 2);
+    pendingSuccess(documents);
+    [self waitForExpectations:expectations timeout:5];
+
+    XCTAssertEqualObjects([self documentsForRequest:request documents:@[]], documents);
+    XCTAssertEqual(self.fetchCount, 1);
+    XCTAssertEqual(self.cache.hitCount, 1);
+}
+
+- (void)testQueriesAreCoalescedPerHost {
+    DSPlatformDocumentsRequest *request = [self requestForUserIdWithIndex:0];
+    NSMutableDictionary<NSString *, DSPlatformDocumentsSuccessBlock> *pendingSuccesses = [NSMutableDictionary dictionary];
+    NSMutableArray<XCTestExpectation *> *expectations = [NSMutableArray array];
+    for (NSString *host in @[@"10.0.0.1", @"10.0.0.2", @"10.0.0.1"]) {
+        XCTestExpectation *expectation = [self expectationWithDescription:host];
+        [expectations addObject:expectation];
+        [self.cache documentsForRequest:request
+            host:host
+            completionQueue:self.completionQueue
+            success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+                [expectation fulfill];
+            }
+            failure:^(NSError *_Nonnull error) {
+                XCTFail(@"%@", error);
+            }
+            fetch:^id<DSDAPINetworkServiceRequest>(DSPlatformDocumentsSuccessBlock success, DSPlatformDocumentsFailureBlock failure) {
+                self.fetchCount++;
+                pendingSuccesses[host] = success;
+                return nil;
+            }];
+    }
+    // a read hedged to a second node goes out to it instead of joining the first
+    XCTAssertEqual(self.fetchCount, 2);
+    XCTAssertEqual(self.cache.coalescedCount, 1);
+    pendingSuccesses[@"10.0.0.1"]([self documentsForIndex:0]);
+    pendingSuccesses[@"10.0.0.2"]([self documentsForIndex:0]);
+    [self waitForExpectations:expectations timeout:5];
+
+    // the results themselves are shared by every host
+    [self documentsForRequest:request documents:@[]];
+    XCTAssertEqual(self.fetchCount, 2);
+    XCTAssertEqual(self.cache.hitCount, 1);
+}
+
+- (void)testFailuresAreNotCached {
+    DSPlatformDocumentsRequest *request = [self requestForUserIdWithIndex:0];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"failure"];
+    [self.cache documentsForRequest:request
+        host:nil
+        completionQueue:self.completionQueue
+        success:^(NSArray<NSDictionary *> *_Nonnull documents) {
+            XCTFail(@"the fetch failed");
+        }
+        failure:^(NSError *_Nonnull error) {
+            [expectation fulfill];
+        }
+        fetch:^id<DSDAPINetworkServiceRequest>(DSPlatformDocumentsSuccessBlock success, DSPlatformDocumentsFailureBlock failure) {
+            self.fetchCount++;
+            failure([NSError errorWithDomain:DSDAPINetworkServiceErrorDomain code:500 userInfo:nil]);
+            return nil;
+        }];
+    [self waitForExpectations:@[expectation] timeout:5];
+
+    XCTAssertEqualObjects([self documentsForRequest:request documents:[self documentsForIndex:0]], [self documentsForIndex:0]);
+    XCTAssertEqual(self.fetchCount, 2);
+}
+
+// MARK: - Expiry and bound
+
+- (void)testResultsExpireAfterTimeToLive {
+    self.cache.timeToLive = 0.2;
+    DSPlatformDocumentsRequest *request = [self requestForUserIdWithIndex:0];
+    [self documentsForRequest:request documents:[self documentsForIndex:0]];
+    [self documentsForRequest:request documents:[self documentsForIndex:0]];
+    XCTAssertEqual(self.fetchCount, 1);
+
+    [NSThread sleepForTimeInterval:0.3];
+    [self documentsForRequest:request documents:[self documentsForIndex:0]];
+    XCTAssertEqual(self.fetchCount, 2);
+    XCTAssertEqual(self.cache.hitCount, 1);
+    XCTAssertEqual(self.cache.missCount, 2);
+}
+
+- (void)testLeastRecentlyUsedResultsAreDroppedPastTheMaximumEntryCount {
+    self.cache.maximumEntryCount = 2;
+    for (uint32_t i = 0; i < 3; i++) {
+        [self documentsForRequest:[self requestForUserIdWithIndex:i] documents:[self documentsForIndex:i]];
+    }
+    XCTAssertEqual(self.fetchCount, 3);
+
+    // the first result was dropped when the third was stored
+    [self documentsForRequest:[self requestForUserIdWithIndex:1] documents:@[]];
+    XCTAssertEqual(self.fetchCount, 3);
+    [self documentsForRequest:[self requestForUserIdWithIndex:0] documents:[self documentsForIndex:0]];
+    XCTAssertEqual(self.fetchCount, 4);
+
+    // storing it again dropped the third result, used less recently than the second
+    [self documentsForRequest:[self requestForUserIdWithIndex:1] documents:@[]];
+    XCTAssertEqual(self.fetchCount, 4);
+    [self documentsForRequest:[self requestForUserIdWithIndex:2] documents:[self documentsForIndex:2]];
+    XCTAssertEqual(self.fetchCount, 5);
+}
+
+- (void)testRemovedDocumentTypeIsFetchedAgain {
+    DSPlatformDocumentsRequest *request = [self requestForUserIdWithIndex:0];
+    [self documentsForRequest:request documents:[self documentsForIndex:0]];
+    [self.cache removeDocumentsForContractId:UINT256_ZERO documentType:@"domain"];
+    [self documentsForRequest:request documents:[self documentsForIndex:0]];
+    XCTAssertEqual(self.fetchCount, 2);
+}
+
+// MARK: - In query paging
+
+- (void)testPagesOfAnInQueryAreCachedSeparately {
+    NSArray<NSData *> *userIds = @[[self userIdWithIndex:0], [self userIdWithIndex:1]];
+    DSPlatformDocumentsRequest *firstPage = [DSPlatformDocumentsRequest dpnsRequestForUserIds:userIds startAfter:nil];
+    DSPlatformDocumentsRequest *secondPage = [DSPlatformDocumentsRequest dpnsRequestForUserIds:userIds startAfter:[self userIdWithIndex:2]];
+    XCTAssertEqual(firstPage.limit, DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT);
+    [self documentsForRequest:firstPage documents:[self documentsForIndex:0]];
+    XCTAssertEqualObjects([self documentsForRequest:secondPage documents:[self documentsForIndex:1]], [self documentsForIndex:1]);
+    XCTAssertEqual(self.fetchCount, 2);
+}
+
+- (void)testInQueryIsPagedUntilAShortPage {
+    DSChain *chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    DSPlatformDocumentsCacheTestService *service = [[DSPlatformDocumentsCacheTestService alloc] init];
+    NSMutableArray<NSDictionary *> *documents = [NSMutableArray array];
+    for (uint32_t i = 0; i < 2 * DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT + 3; i++) {
+        [documents addObject:@{@"$id": [self userIdWithIndex:i]}];
+    }
+    service.documents = documents;
+    service.startAfters = [NSMutableArray array];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"pages"];
+    [chain.chainManager.identitiesManager fetchDPNSDocumentsForUserIds:@[[self userIdWithIndex:0]]
+        startAfter:nil
+        accumulatedDocuments:[NSMutableArray array]
+        withService:(DSDAPIPlatformNetworkService *)service
+        success:^(NSArray<NSDictionary *> *_Nonnull receivedDocuments) {
+            XCTAssertEqualObjects(receivedDocuments, documents);
+            [expectation fulfill];
+        }
+        failure:^(NSError *_Nonnull error) {
+            XCTFail(@"%@", error);
+            [expectation fulfill];
+        }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    XCTAssertEqualObjects(service.startAfters, (@[[NSNull null], documents[DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT - 1][@"$id"], documents[2 * DAPI_DOCUMENT_RESPONSE_COUNT_LIMIT - 1][@"$id"]]));
+}
+
+@end
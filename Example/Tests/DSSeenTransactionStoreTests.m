@@ -0,0 +1,130 @@
+//
+//  DSSeenTransactionStoreTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSSeenTransactionStore.h"
+#import "NSData+Dash.h"
+#import "NSDate+Utils.h"
+
+#define LOOKUP_COUNT 10000
+
+@interface DSSeenTransactionStoreTests : XCTestCase
+
+@property (nonatomic, strong) NSString *path;
+
+@end
+
+@implementation DSSeenTransactionStoreTests
+
+- (void)setUp {
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:nil];
+}
+
+- (UInt256)transactionHash:(uint32_t)i {
+    return [NSData dataWithBytes:&i length:sizeof(i)].SHA256_2;
+}
+
+- (void)fillStore:(DSSeenTransactionStore *)store count:(uint32_t)count {
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    for (uint32_t i = 0; i < count; i++) {
+        [store addTransactionHash:[self transactionHash:i] seenAt:now - count + i];
+    }
+    [store synchronize];
+}
+
+- (void)testHashesAreKeptAcrossLaunches {
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    [store addTransactionHash:[self transactionHash:1]];
+    XCTAssertTrue([store containsTransactionHash:[self transactionHash:1]]);
+    XCTAssertEqual(store.pendingCount, 1);
+    [store synchronize];
+    XCTAssertEqual(store.pendingCount, 0);
+
+    DSSeenTransactionStore *reopenedStore = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    XCTAssertEqual(reopenedStore.count, 1);
+    XCTAssertTrue([reopenedStore containsTransactionHash:[self transactionHash:1]]);
+    XCTAssertFalse([reopenedStore containsTransactionHash:[self transactionHash:2]]);
+}
+
+- (void)testPendingHashesAreMergedOnceFull {
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    for (uint32_t i = 0; i < SEEN_TRANSACTION_STORE_PENDING_CAPACITY; i++) {
+        [store addTransactionHash:[self transactionHash:i]];
+    }
+    XCTAssertEqual(store.pendingCount, 0);
+    XCTAssertEqual(store.count, SEEN_TRANSACTION_STORE_PENDING_CAPACITY);
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:self.path]);
+    for (uint32_t i = 0; i < SEEN_TRANSACTION_STORE_PENDING_CAPACITY; i++) {
+        XCTAssertTrue([store containsTransactionHash:[self transactionHash:i]]);
+    }
+}
+
+- (void)testHashSeenAgainIsNotDuplicated {
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    [store addTransactionHash:[self transactionHash:1] seenAt:now - SEEN_TRANSACTION_STORE_EXPIRY + 10];
+    [store synchronize];
+    [store addTransactionHash:[self transactionHash:1] seenAt:now];
+    [store synchronize];
+    XCTAssertEqual(store.count, 1);
+    XCTAssertTrue([store containsTransactionHash:[self transactionHash:1]]);
+}
+
+- (void)testExpiredHashesAreDropped {
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    NSTimeInterval now = [NSDate timeIntervalSince1970];
+    [store addTransactionHash:[self transactionHash:1] seenAt:now - SEEN_TRANSACTION_STORE_EXPIRY - 1];
+    [store addTransactionHash:[self transactionHash:2] seenAt:now];
+    XCTAssertFalse([store containsTransactionHash:[self transactionHash:1]]);
+    [store synchronize];
+    XCTAssertEqual(store.count, 1);
+    XCTAssertTrue([store containsTransactionHash:[self transactionHash:2]]);
+}
+
+- (void)testOldestHashesAreEvictedPastCapacity {
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path expiry:SEEN_TRANSACTION_STORE_EXPIRY capacity:100];
+    [self fillStore:store count:150];
+    XCTAssertEqual(store.count, 100);
+    for (uint32_t i = 0; i < 150; i++) {
+        XCTAssertEqual([store containsTransactionHash:[self transactionHash:i]], i >= 50);
+    }
+}
+
+- (void)testUnreadableStoreIsDiscarded {
+    [[@"not a store" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:self.path atomically:YES];
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    XCTAssertEqual(store.count, 0);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.path]);
+}
+
+// MARK: - Long uptime
+
+- (void)testFullStoreStaysSmallInMemory {
+    [self fillStore:[[DSSeenTransactionStore alloc] initWithPath:self.path] count:SEEN_TRANSACTION_STORE_CAPACITY + SEEN_TRANSACTION_STORE_PENDING_CAPACITY];
+    DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+    XCTAssertEqual(store.count, SEEN_TRANSACTION_STORE_CAPACITY);
+    // the run itself stays in the mapped file, a row per hash is never loaded
+    XCTAssertLessThan(store.residentSize, 128 * 1024);
+}
+
+- (void)testPerformanceOpeningFullStoreAndLookingUp {
+    [self fillStore:[[DSSeenTransactionStore alloc] initWithPath:self.path] count:SEEN_TRANSACTION_STORE_CAPACITY];
+    [self measureBlock:^{
+        // what a connection pays now, instead of fetching every stored hash
+        DSSeenTransactionStore *store = [[DSSeenTransactionStore alloc] initWithPath:self.path];
+        for (uint32_t i = 0; i < LOOKUP_COUNT; i++) {
+            XCTAssertTrue([store containsTransactionHash:[self transactionHash:i * 13]]);
+        }
+    }];
+}
+
+@end
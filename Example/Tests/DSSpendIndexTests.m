@@ -0,0 +1,233 @@
+//
+//  DSSpendIndexTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAccount.h"
+#import "DSChain+Protected.h"
+#import "DSSpendIndex.h"
+#import "DSTransaction.h"
+#import "DSTransactionOutput.h"
+#import "DSWallet.h"
+#import "NSData+DSHash.h"
+#import "NSString+Dash.h"
+
+@interface DSSpendIndexTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) DSWallet *wallet;
+@property (nonatomic, assign) uint32_t nonce;
+
+@end
+
+@implementation DSSpendIndexTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    self.wallet = [DSWallet transientWalletWithDerivedKeyData:@"5f0c1d2e3a4b5c6d7e8f90a1b2c3d4e5".hexToData forChain:self.chain];
+    [self.chain addWallet:self.wallet];
+}
+
+- (void)tearDown {
+    [self.chain unregisterWallet:self.wallet];
+}
+
+- (DSUTXO)externalOutpoint {
+    UInt256 hash = [NSData dataWithBytes:&_nonce length:sizeof(uint32_t)].SHA256;
+    self.nonce++;
+    return (DSUTXO){hash, 0};
+}
+
+// each transaction gets a distinct amount so that double spends of the same outpoint have distinct hashes
+- (DSTransaction *)transactionSpending:(NSArray<NSValue *> *)outpoints toAddress:(NSString *)address blockHeight:(uint32_t)blockHeight {
+    DSTransaction *transaction = [[DSTransaction alloc] initOnChain:self.chain];
+    for (NSValue *value in outpoints) {
+        DSUTXO outpoint;
+        [value getValue:&outpoint];
+        [transaction addInputHash:outpoint.hash index:outpoint.n script:nil signature:nil sequence:TXIN_SEQUENCE];
+    }
+    [transaction addOutputAddress:address amount:DUFFS - self.nonce++];
+    [transaction addOutputAddress:address amount:DUFFS];
+    transaction.blockHeight = blockHeight;
+    transaction.txHash = transaction.toData.SHA256_2;
+    return transaction;
+}
+
+- (DSTransaction *)transactionSpending:(NSArray<NSValue *> *)outpoints {
+    return [self transactionSpending:outpoints toAddress:[self.wallet accountWithNumber:0].receiveAddress blockHeight:TX_UNCONFIRMED];
+}
+
+- (uint64_t)outputAmountOfTransaction:(DSTransaction *)transaction {
+    uint64_t amount = 0;
+    for (DSTransactionOutput *output in transaction.outputs) {
+        amount += output.amount;
+    }
+    return amount;
+}
+
+// MARK: - Index
+
+- (void)testSpendsAndDoubleSpends {
+    DSSpendIndex *spendIndex = [[DSSpendIndex alloc] init];
+    DSUTXO outpoint = [self externalOutpoint];
+    DSTransaction *spend = [self transactionSpending:@[dsutxo_obj(outpoint)]];
+    DSTransaction *doubleSpend = [self transactionSpending:@[dsutxo_obj(outpoint), dsutxo_obj([self externalOutpoint])]];
+    XCTAssertFalse([spendIndex isOutpointSpent:outpoint]);
+
+    [spendIndex addTransaction:spend];
+    [spendIndex addTransaction:spend];
+    XCTAssertEqual(spendIndex.spentOutpointCount, 1);
+    XCTAssertEqual([spendIndex spendingTransactionForOutpoint:outpoint], spend);
+
+    [spendIndex addTransaction:doubleSpend];
+    XCTAssertEqual(spendIndex.spentOutpointCount, 2);
+    XCTAssertEqualObjects([spendIndex spendingTransactionsForOutpoint:outpoint], (@[spend, doubleSpend]));
+
+    spendIndex.invalidTransactionHashes = [NSSet setWithObject:uint256_obj(spend.txHash)];
+    XCTAssertEqual([spendIndex spendingTransactionForOutpoint:outpoint], doubleSpend);
+    spendIndex.invalidTransactionHashes = [NSSet setWithObjects:uint256_obj(spend.txHash), uint256_obj(doubleSpend.txHash), nil];
+    XCTAssertFalse([spendIndex isOutpointSpent:outpoint]);
+    XCTAssertEqual([spendIndex spendingTransactionsForOutpoint:outpoint].count, 2);
+
+    [spendIndex removeTransaction:doubleSpend];
+    XCTAssertEqual(spendIndex.spentOutpointCount, 1);
+    XCTAssertEqualObjects([spendIndex spendingTransactionsForOutpoint:outpoint], @[spend]);
+    [spendIndex removeAllTransactions];
+    XCTAssertEqual(spendIndex.spentOutpointCount, 0);
+    XCTAssertFalse([spendIndex isOutpointSpent:outpoint]);
+}
+
+- (void)testSpendersOfOutputs {
+    DSSpendIndex *spendIndex = [[DSSpendIndex alloc] init];
+    DSUTXO outpoint = [self externalOutpoint];
+    DSTransaction *parent = [self transactionSpending:@[dsutxo_obj(outpoint)]];
+    DSTransaction *child = [self transactionSpending:@[dsutxo_obj(((DSUTXO){parent.txHash, 0}))]];
+    DSTransaction *sibling = [self transactionSpending:@[dsutxo_obj(((DSUTXO){parent.txHash, 1}))]];
+    DSTransaction *grandchild = [self transactionSpending:@[dsutxo_obj(((DSUTXO){child.txHash, 0})), dsutxo_obj(((DSUTXO){sibling.txHash, 0}))]];
+    for (DSTransaction *transaction in @[grandchild, parent, sibling, child]) {
+        [spendIndex addTransaction:transaction];
+    }
+    XCTAssertEqualObjects([spendIndex transactionsSpendingOutputsOfTransaction:parent], (@[child, sibling]));
+    XCTAssertEqualObjects([spendIndex transactionsSpendingOutputsOfTransaction:child], @[grandchild]);
+    XCTAssertEqualObjects([spendIndex transactionsSpendingOutputsOfTransaction:grandchild], @[]);
+}
+
+// MARK: - Account
+
+// not an address of the test wallet
+#define EXTERNAL_ADDRESS @"yWq16XLivcRsCLcxWKbKPxJ35XASd4r9RY"
+
+- (void)testAccountConfirmedDoubleSpendInvalidatesPendingSpend {
+    DSAccount *account = [self.wallet accountWithNumber:0];
+    DSTransaction *funding = [self transactionSpending:@[dsutxo_obj([self externalOutpoint])] toAddress:account.receiveAddress blockHeight:100];
+    [account registerTransaction:funding saveImmediately:NO];
+    NSValue *fundingOutput = dsutxo_obj(((DSUTXO){funding.txHash, 0}));
+    uint64_t unspentFundingAmount = funding.outputs[1].amount;
+
+    DSTransaction *pendingSpend = [self transactionSpending:@[fundingOutput] toAddress:account.changeAddress blockHeight:TX_UNCONFIRMED];
+    [account registerTransaction:pendingSpend saveImmediately:NO];
+    DSTransaction *pendingChild = [self transactionSpending:@[dsutxo_obj(((DSUTXO){pendingSpend.txHash, 0}))] toAddress:account.changeAddress blockHeight:TX_UNCONFIRMED];
+    [account registerTransaction:pendingChild saveImmediately:NO];
+    XCTAssertTrue([account transactionIsValid:pendingSpend]);
+    XCTAssertTrue([account transactionIsValid:pendingChild]);
+    XCTAssertEqual(account.balance, unspentFundingAmount + pendingSpend.outputs[1].amount + [self outputAmountOfTransaction:pendingChild]);
+
+    // a conflicting spend of the same output is mined
+    DSTransaction *minedDoubleSpend = [self transactionSpending:@[fundingOutput] toAddress:EXTERNAL_ADDRESS blockHeight:101];
+    XCTAssertTrue([account registerTransaction:minedDoubleSpend saveImmediately:NO]);
+    XCTAssertTrue([account transactionIsValid:minedDoubleSpend]);
+    XCTAssertFalse([account transactionIsValid:pendingSpend]);
+    XCTAssertFalse([account transactionIsValid:pendingChild]);
+    XCTAssertTrue([account isSpent:fundingOutput]);
+    XCTAssertFalse([account isSpent:dsutxo_obj(((DSUTXO){pendingSpend.txHash, 0}))]);
+    XCTAssertEqual(account.balance, unspentFundingAmount);
+    XCTAssertEqualObjects(account.unspentOutputs, @[dsutxo_obj(((DSUTXO){funding.txHash, 1}))]);
+
+    // a third spend seen afterwards is rejected outright
+    DSTransaction *lateDoubleSpend = [self transactionSpending:@[fundingOutput]];
+    XCTAssertFalse([account transactionIsValid:lateDoubleSpend]);
+}
+
+- (void)testAccountReorgRestoresInvalidatedSpend {
+    DSAccount *account = [self.wallet accountWithNumber:0];
+    DSTransaction *funding = [self transactionSpending:@[dsutxo_obj([self externalOutpoint])] toAddress:account.receiveAddress blockHeight:100];
+    [account registerTransaction:funding saveImmediately:NO];
+    NSValue *fundingOutput = dsutxo_obj(((DSUTXO){funding.txHash, 0}));
+    uint64_t unspentFundingAmount = funding.outputs[1].amount;
+
+    DSTransaction *pendingSpend = [self transactionSpending:@[fundingOutput] toAddress:account.changeAddress blockHeight:TX_UNCONFIRMED];
+    [account registerTransaction:pendingSpend saveImmediately:NO];
+    DSTransaction *pendingChild = [self transactionSpending:@[dsutxo_obj(((DSUTXO){pendingSpend.txHash, 0}))] toAddress:account.changeAddress blockHeight:TX_UNCONFIRMED];
+    [account registerTransaction:pendingChild saveImmediately:NO];
+    uint64_t pendingBalance = unspentFundingAmount + pendingSpend.outputs[1].amount + [self outputAmountOfTransaction:pendingChild];
+    XCTAssertEqual(account.balance, pendingBalance);
+
+    DSTransaction *minedDoubleSpend = [self transactionSpending:@[fundingOutput] toAddress:EXTERNAL_ADDRESS blockHeight:101];
+    [account registerTransaction:minedDoubleSpend saveImmediately:NO];
+    XCTAssertFalse([account transactionIsValid:pendingSpend]);
+    XCTAssertFalse([account transactionIsValid:pendingChild]);
+    XCTAssertEqual(account.balance, unspentFundingAmount);
+
+    // the block with the conflicting spend is disconnected, the invalidated spend and its child are valid again
+    XCTAssertTrue([account removeTransaction:minedDoubleSpend saveImmediately:NO]);
+    XCTAssertNil([account transactionForHash:minedDoubleSpend.txHash]);
+    XCTAssertTrue([account transactionIsValid:pendingSpend]);
+    XCTAssertTrue([account transactionIsValid:pendingChild]);
+    XCTAssertTrue([account isSpent:fundingOutput]);
+    XCTAssertTrue([account isSpent:dsutxo_obj(((DSUTXO){pendingSpend.txHash, 0}))]);
+    XCTAssertEqual(account.balance, pendingBalance);
+
+    // and invalid again once the new chain mines the conflicting spend after all
+    DSTransaction *remined = [self transactionSpending:@[fundingOutput] toAddress:EXTERNAL_ADDRESS blockHeight:102];
+    [account registerTransaction:remined saveImmediately:NO];
+    XCTAssertFalse([account transactionIsValid:pendingSpend]);
+    XCTAssertFalse([account transactionIsValid:pendingChild]);
+    XCTAssertEqual(account.balance, unspentFundingAmount);
+}
+
+- (void)testAccountDoubleSpendAndReorg {
+    DSAccount *account = [self.wallet accountWithNumber:0];
+    DSTransaction *funding = [self transactionSpending:@[dsutxo_obj([self externalOutpoint])] toAddress:account.receiveAddress blockHeight:100];
+    XCTAssertTrue([account registerTransaction:funding saveImmediately:NO]);
+    NSValue *fundingOutput = dsutxo_obj(((DSUTXO){funding.txHash, 0}));
+    XCTAssertFalse([account isSpent:fundingOutput]);
+
+    DSTransaction *confirmedSpend = [self transactionSpending:@[fundingOutput] toAddress:account.changeAddress blockHeight:101];
+    DSTransaction *doubleSpend = [self transactionSpending:@[fundingOutput]];
+    XCTAssertTrue([account transactionIsValid:doubleSpend]);
+    [account registerTransaction:confirmedSpend saveImmediately:NO];
+    XCTAssertFalse([account transactionIsValid:doubleSpend]);
+
+    [account registerTransaction:doubleSpend saveImmediately:NO];
+    DSTransaction *doubleSpendChild = [self transactionSpending:@[dsutxo_obj(((DSUTXO){doubleSpend.txHash, 0}))]];
+    [account registerTransaction:doubleSpendChild saveImmediately:NO];
+    XCTAssertTrue([account isSpent:fundingOutput]);
+    XCTAssertFalse([account transactionIsValid:doubleSpend]);
+    XCTAssertFalse([account transactionIsValid:doubleSpendChild]);
+    XCTAssertEqual([account inputValue:funding.txHash inputIndex:0], -1);
+    XCTAssertEqual([account inputValue:funding.txHash inputIndex:1], DUFFS);
+
+    DSTransaction *confirmedChild = [self transactionSpending:@[dsutxo_obj(((DSUTXO){confirmedSpend.txHash, 1}))] toAddress:account.receiveAddress blockHeight:102];
+    [account registerTransaction:confirmedChild saveImmediately:NO];
+    XCTAssertTrue([account isSpent:dsutxo_obj(((DSUTXO){confirmedSpend.txHash, 1}))]);
+
+    // the block confirming the spend is disconnected, taking its descendants with it
+    [account removeTransaction:confirmedSpend saveImmediately:NO];
+    XCTAssertNil([account transactionForHash:confirmedSpend.txHash]);
+    XCTAssertNil([account transactionForHash:confirmedChild.txHash]);
+    XCTAssertFalse([account isSpent:dsutxo_obj(((DSUTXO){confirmedSpend.txHash, 1}))]);
+    XCTAssertTrue([account transactionIsValid:doubleSpend]);
+    XCTAssertTrue([account transactionIsValid:doubleSpendChild]);
+    XCTAssertTrue([account isSpent:fundingOutput]);
+
+    [account removeTransaction:funding saveImmediately:NO];
+    XCTAssertNil([account transactionForHash:doubleSpend.txHash]);
+    XCTAssertNil([account transactionForHash:doubleSpendChild.txHash]);
+    XCTAssertFalse([account isSpent:fundingOutput]);
+}
+
+@end
@@ -0,0 +1,173 @@
+//
+//  DSTransactionIndexTests.m
+//  DashSync_Tests
+//
+//  Copyright © 2026 Dash Core Group. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "DSAccount.h"
+#import "DSChain+Protected.h"
+#import "DSTransaction.h"
+#import "DSTransactionIndex.h"
+#import "DSWallet.h"
+#import "NSData+DSHash.h"
+#import "NSString+Dash.h"
+
+#define BENCHMARK_WALLET_COUNT 16
+#define BENCHMARK_TRANSACTIONS_PER_WALLET 500
+#define BENCHMARK_LOOKUPS 20000
+
+@interface DSTransactionIndexTests : XCTestCase
+
+@property (nonatomic, strong) DSChain *chain;
+@property (nonatomic, strong) NSMutableArray<DSWallet *> *wallets;
+@property (nonatomic, assign) uint32_t inputIndex;
+
+@end
+
+@implementation DSTransactionIndexTests
+
+- (void)setUp {
+    self.chain = [DSChain setUpDevnetWithIdentifier:DevnetType_Mobile2 protocolVersion:PROTOCOL_VERSION_DEVNET minProtocolVersion:DEFAULT_MIN_PROTOCOL_VERSION_DEVNET withCheckpoints:nil withMinimumDifficultyBlocks:UINT32_MAX withDefaultPort:3000 withDefaultDapiJRPCPort:3000 withDefaultDapiGRPCPort:3010 dpnsContractID:UINT256_ZERO dashpayContractID:UINT256_ZERO isTransient:YES];
+    self.wallets = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    for (DSWallet *wallet in self.wallets) {
+        if ([self.chain.wallets containsObject:wallet]) [self.chain unregisterWallet:wallet];
+    }
+}
+
+- (DSWallet *)walletWithNumber:(uint8_t)number addedToChain:(BOOL)added {
+    NSMutableData *derivedKeyData = [@"000102030405060708090a0b0c0d0e0f".hexToData mutableCopy];
+    ((uint8_t *)derivedKeyData.mutableBytes)[0] = 0xa0 + number;
+    DSWallet *wallet = [DSWallet transientWalletWithDerivedKeyData:derivedKeyData forChain:self.chain];
+    [self.wallets addObject:wallet];
+    if (added) [self.chain addWallet:wallet];
+    return wallet;
+}
+
+- (DSTransaction *)transactionPayingAddresses:(NSArray<NSString *> *)addresses {
+    DSTransaction *transaction = [[DSTransaction alloc] initOnChain:self.chain];
+    UInt256 inputHash = [NSData dataWithBytes:&_inputIndex length:sizeof(uint32_t)].SHA256;
+    self.inputIndex++;
+    [transaction addInputHash:inputHash index:0 script:nil signature:nil sequence:TXIN_SEQUENCE];
+    for (NSString *address in addresses) {
+        [transaction addOutputAddress:address amount:DUFFS];
+    }
+    transaction.txHash = transaction.toData.SHA256_2;
+    return transaction;
+}
+
+- (void)testRegisteredTransactionsAreIndexed {
+    DSWallet *wallet = [self walletWithNumber:0 addedToChain:YES];
+    DSAccount *account = [wallet accountWithNumber:0];
+    DSTransaction *transaction = [self transactionPayingAddresses:@[account.receiveAddress]];
+    XCTAssertNil([self.chain transactionForHash:transaction.txHash]);
+    XCTAssertTrue([account registerTransaction:transaction saveImmediately:NO]);
+
+    DSWallet *owningWallet = nil;
+    XCTAssertEqual([self.chain transactionForHash:transaction.txHash returnWallet:&owningWallet], transaction);
+    XCTAssertEqual(owningWallet, wallet);
+    DSTransaction *foundTransaction = nil;
+    XCTAssertEqualObjects([self.chain accountsForTransactionHash:transaction.txHash transaction:&foundTransaction], @[account]);
+    XCTAssertEqual(foundTransaction, transaction);
+
+    XCTAssertTrue([account removeTransaction:transaction saveImmediately:NO]);
+    XCTAssertNil([self.chain transactionForHash:transaction.txHash]);
+    XCTAssertEqual([self.chain accountsForTransactionHash:transaction.txHash transaction:nil].count, 0);
+}
+
+- (void)testTransactionSharedByWallets {
+    DSAccount *firstAccount = [[self walletWithNumber:1 addedToChain:YES] accountWithNumber:0];
+    DSAccount *secondAccount = [[self walletWithNumber:2 addedToChain:YES] accountWithNumber:0];
+    DSTransaction *transaction = [self transactionPayingAddresses:@[firstAccount.receiveAddress, secondAccount.receiveAddress]];
+    [firstAccount registerTransaction:transaction saveImmediately:NO];
+    [secondAccount registerTransaction:transaction saveImmediately:NO];
+    DSTransactionIndexEntry *entry = [self.chain.transactionIndex entryForTransactionHash:transaction.txHash];
+    XCTAssertEqualObjects(entry.accounts, (@[firstAccount, secondAccount]));
+    XCTAssertEqualObjects(entry.wallets, (@[firstAccount.wallet, secondAccount.wallet]));
+
+    [self.chain unregisterWallet:firstAccount.wallet];
+    XCTAssertEqualObjects([self.chain accountsForTransactionHash:transaction.txHash transaction:nil], @[secondAccount]);
+}
+
+- (void)testAccountsShareTheIndexedTransaction {
+    DSAccount *firstAccount = [[self walletWithNumber:4 addedToChain:YES] accountWithNumber:0];
+    DSAccount *secondAccount = [[self walletWithNumber:5 addedToChain:YES] accountWithNumber:0];
+    DSAccount *thirdAccount = [[self walletWithNumber:6 addedToChain:NO] accountWithNumber:0];
+    DSTransaction *transaction = [self transactionPayingAddresses:@[firstAccount.receiveAddress, secondAccount.receiveAddress, thirdAccount.receiveAddress]];
+    [firstAccount registerTransaction:transaction saveImmediately:NO];
+    // the same transaction deserialized again, as it arrives from another peer or store
+    [secondAccount registerTransaction:[DSTransaction transactionWithMessage:transaction.toData onChain:self.chain] saveImmediately:NO];
+    XCTAssertEqual([secondAccount transactionForHash:transaction.txHash], transaction);
+
+    DSTransaction *unindexedTransaction = [DSTransaction transactionWithMessage:transaction.toData onChain:self.chain];
+    [thirdAccount registerTransaction:unindexedTransaction saveImmediately:NO];
+    XCTAssertEqual([thirdAccount transactionForHash:transaction.txHash], unindexedTransaction);
+    [self.chain addWallet:thirdAccount.wallet];
+    XCTAssertEqual([thirdAccount transactionForHash:transaction.txHash], transaction);
+    XCTAssertEqual(thirdAccount.allTransactions.firstObject, transaction);
+}
+
+- (void)testWalletsAreIndexedOnceOnTheChain {
+    DSWallet *wallet = [self walletWithNumber:3 addedToChain:NO];
+    DSAccount *account = [wallet accountWithNumber:0];
+    DSTransaction *transaction = [self transactionPayingAddresses:@[account.receiveAddress]];
+    [account registerTransaction:transaction saveImmediately:NO];
+    XCTAssertNil([self.chain transactionForHash:transaction.txHash]);
+    [self.chain addWallet:wallet];
+    XCTAssertEqual([self.chain transactionForHash:transaction.txHash], transaction);
+    [self.chain unregisterWallet:wallet];
+    XCTAssertNil([self.chain transactionForHash:transaction.txHash]);
+}
+
+// MARK: - Contention
+
+- (NSArray<NSValue *> *)registerBenchmarkTransactions {
+    NSMutableArray<NSValue *> *transactionHashes = [NSMutableArray array];
+    for (uint8_t i = 0; i < BENCHMARK_WALLET_COUNT; i++) {
+        DSAccount *account = [[self walletWithNumber:0x10 + i addedToChain:YES] accountWithNumber:0];
+        for (NSUInteger t = 0; t < BENCHMARK_TRANSACTIONS_PER_WALLET; t++) {
+            DSTransaction *transaction = [self transactionPayingAddresses:@[account.receiveAddress]];
+            [account registerTransaction:transaction saveImmediately:NO];
+            [transactionHashes addObject:uint256_obj(transaction.txHash)];
+        }
+    }
+    return transactionHashes;
+}
+
+- (void)testPerformanceAccountScanLookups {
+    NSArray<NSValue *> *transactionHashes = [self registerBenchmarkTransactions];
+    NSArray<DSWallet *> *wallets = self.chain.wallets;
+    [self measureBlock:^{
+        dispatch_apply(BENCHMARK_LOOKUPS, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            UInt256 txHash;
+            [transactionHashes[i % transactionHashes.count] getValue:&txHash];
+            DSTransaction *found = nil;
+            for (DSWallet *wallet in wallets) {
+                for (DSAccount *account in wallet.accounts) {
+                    found = [account transactionForHash:txHash];
+                    if (found) break;
+                }
+                if (found) break;
+            }
+            XCTAssertNotNil(found);
+        });
+    }];
+}
+
+- (void)testPerformanceIndexLookups {
+    NSArray<NSValue *> *transactionHashes = [self registerBenchmarkTransactions];
+    [self measureBlock:^{
+        dispatch_apply(BENCHMARK_LOOKUPS, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            UInt256 txHash;
+            [transactionHashes[i % transactionHashes.count] getValue:&txHash];
+            XCTAssertNotNil([self.chain transactionForHash:txHash]);
+        });
+    }];
+}
+
+@end
@@ -34,6 +34,7 @@
 #import "DSTransactionFactory.h"
 #import "DSTransactionInput.h"
 #import "DSTransactionManager.h"
+#import "DSTransactionOrdering.h"
 #import "DSTransactionOutput.h"
 #import "DSTransition+Protected.h"
 #import "DSWallet.h"
@@ -370,6 +371,206 @@
 //
 //}
 
+// MARK: - testTransactionOrdering
+
+// every transaction comes after transactions at higher heights and before the transactions it spends at its height
+- (void)assertTransactionOrder:(NSOrderedSet<DSTransaction *> *)transactions {
+    for (NSUInteger i = 0; i < transactions.count; i++) {
+        DSTransaction *transaction = transactions[i];
+        if (i > 0) {
+            XCTAssertGreaterThanOrEqual(transactions[i - 1].blockHeight, transaction.blockHeight, @"Transactions should be sorted by block height, most recent first");
+        }
+        for (DSTransactionInput *input in transaction.inputs) {
+            for (NSUInteger j = 0; j < i; j++) {
+                XCTAssertFalse(uint256_eq(transactions[j].txHash, input.inputHash) && transactions[j].blockHeight == transaction.blockHeight, @"A spender should come before the transaction it spends");
+            }
+        }
+    }
+}
+
+- (void)testTransactionOrdering {
+    DSChain *testnet = [DSChain testnet];
+    NSMutableArray<NSString *> *addresses = [NSMutableArray array];
+    NSMutableArray<NSData *> *scripts = [NSMutableArray array];
+    for (uint32_t i = 1; i <= 40; i++) {
+        NSMutableData *secret = [NSMutableData dataWithLength:28];
+        [secret appendUInt32:CFSwapInt32HostToBig(i)];
+        OpaqueKey *key = [DSKeyManager keyWithPrivateKeyData:secret ofType:KeyKind_ECDSA];
+        NSString *address = [DSKeyManager addressForKey:key forChainType:testnet.chainType];
+        [addresses addObject:address];
+        [scripts addObject:[DSKeyManager scriptPubKeyForAddress:address forChain:testnet]];
+        processor_destroy_opaque_key(key);
+    }
+    // the last five addresses don't belong to the wallet
+    NSArray<NSString *> *externalAddresses = [addresses subarrayWithRange:NSMakeRange(0, 20)];
+    NSArray<NSString *> *internalAddresses = [addresses subarrayWithRange:NSMakeRange(20, 15)];
+
+    // a recorded wallet: a few hundred transactions over a handful of blocks, some spending others in the same block
+    __block uint32_t seed = 7;
+    uint32_t (^next)(uint32_t) = ^uint32_t(uint32_t bound) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) % bound;
+    };
+    NSMutableArray<DSTransaction *> *transactions = [NSMutableArray array];
+    NSMutableSet<NSValue *> *invalidTransactionHashes = [NSMutableSet set], *pendingTransactionHashes = [NSMutableSet set];
+    for (uint32_t i = 0; i < 300; i++) {
+        uint32_t blockHeight = (next(10) == 0) ? TX_UNCONFIRMED : 1000 + next(25);
+        UInt256 inputHash = [NSData dataWithUInt32:i + UINT16_MAX].SHA256_2;
+        for (DSTransaction *previous in [transactions reverseObjectEnumerator]) {
+            if (previous.blockHeight == blockHeight && next(3) == 0) {
+                inputHash = previous.txHash;
+                break;
+            }
+        }
+        NSString *address1 = addresses[next(40)], *address2 = addresses[next(40)];
+        DSTransaction *transaction = [[DSTransaction alloc] initWithInputHashes:@[uint256_obj(inputHash)]
+                                                                   inputIndexes:@[@0]
+                                                                   inputScripts:@[scripts[0]]
+                                                                outputAddresses:@[address1, address2]
+                                                                  outputAmounts:@[@(100000 + i), @(200000 + i)]
+                                                                        onChain:testnet];
+        transaction.txHash = [NSData dataWithUInt32:i].SHA256_2;
+        transaction.blockHeight = blockHeight;
+        if (blockHeight == TX_UNCONFIRMED && next(2) == 0) {
+            [(next(2) ? invalidTransactionHashes : pendingTransactionHashes) addObject:uint256_obj(transaction.txHash)];
+        }
+        [transactions addObject:transaction];
+    }
+
+    DSTransactionOrdering *ordering = [[DSTransactionOrdering alloc] init];
+    ordering.invalidTransactionHashes = invalidTransactionHashes;
+    ordering.pendingTransactionHashes = pendingTransactionHashes;
+    [ordering addAddresses:externalAddresses startingAtIndex:0 internal:NO];
+    [ordering addAddresses:internalAddresses startingAtIndex:0 internal:YES];
+    NSMutableOrderedSet<DSTransaction *> *sorted = [NSMutableOrderedSet orderedSetWithArray:transactions];
+    [ordering sortTransactions:sorted];
+    XCTAssertEqual(sorted.count, transactions.count);
+    [self assertTransactionOrder:sorted];
+
+    // the order doesn't depend on the order transactions are sorted or inserted in
+    NSMutableOrderedSet<DSTransaction *> *reversed = [NSMutableOrderedSet orderedSetWithArray:[[transactions reverseObjectEnumerator] allObjects]];
+    [ordering sortTransactions:reversed];
+    XCTAssertEqualObjects(reversed.array, sorted.array);
+    NSMutableOrderedSet<DSTransaction *> *inserted = [NSMutableOrderedSet orderedSet];
+    for (DSTransaction *transaction in transactions) {
+        [ordering insertTransaction:transaction intoTransactions:inserted];
+    }
+    XCTAssertEqualObjects(inserted.array, sorted.array);
+}
+
+- (void)testUnconfirmedSpendersAreOrderedBeforeTheTransactionsTheySpend {
+    DSChain *testnet = [DSChain testnet];
+    NSMutableArray<NSString *> *addresses = [NSMutableArray array];
+    NSMutableArray<NSData *> *scripts = [NSMutableArray array];
+    for (uint32_t i = 1; i <= 12; i++) {
+        NSMutableData *secret = [NSMutableData dataWithLength:28];
+        [secret appendUInt32:CFSwapInt32HostToBig(i)];
+        OpaqueKey *key = [DSKeyManager keyWithPrivateKeyData:secret ofType:KeyKind_ECDSA];
+        NSString *address = [DSKeyManager addressForKey:key forChainType:testnet.chainType];
+        [addresses addObject:address];
+        [scripts addObject:[DSKeyManager scriptPubKeyForAddress:address forChain:testnet]];
+        processor_destroy_opaque_key(key);
+    }
+    // three unconfirmed chains of four transactions, each paying to earlier addresses than the one it spends so the address ranks alone would put parents first
+    NSMutableArray<DSTransaction *> *transactions = [NSMutableArray array];
+    NSMutableSet<NSValue *> *pendingTransactionHashes = [NSMutableSet set];
+    for (uint32_t chain = 0; chain < 3; chain++) {
+        UInt256 inputHash = [NSData dataWithUInt32:chain + UINT16_MAX].SHA256_2;
+        for (uint32_t depth = 0; depth < 4; depth++) {
+            DSTransaction *transaction = [[DSTransaction alloc] initWithInputHashes:@[uint256_obj(inputHash)]
+                                                                       inputIndexes:@[@0]
+                                                                       inputScripts:@[scripts[0]]
+                                                                    outputAddresses:@[addresses[(3 - depth) * 3 + chain]]
+                                                                      outputAmounts:@[@(100000 - depth)]
+                                                                            onChain:testnet];
+            transaction.txHash = [NSData dataWithUInt32:chain * 4 + depth].SHA256_2;
+            transaction.blockHeight = TX_UNCONFIRMED;
+            if (depth == 0) {
+                // a pending parent would be ordered first if the tie break could override the spends
+                [pendingTransactionHashes addObject:uint256_obj(transaction.txHash)];
+            }
+            [transactions addObject:transaction];
+            inputHash = transaction.txHash;
+        }
+    }
+    DSTransaction *confirmed = [[DSTransaction alloc] initWithInputHashes:@[uint256_obj(transactions.lastObject.txHash)]
+                                                             inputIndexes:@[@0]
+                                                             inputScripts:@[scripts[0]]
+                                                          outputAddresses:@[addresses[11]]
+                                                            outputAmounts:@[@(50000)]
+                                                                  onChain:testnet];
+    confirmed.txHash = [NSData dataWithUInt32:100].SHA256_2;
+    confirmed.blockHeight = 1000;
+    [transactions addObject:confirmed];
+
+    DSTransactionOrdering *ordering = [[DSTransactionOrdering alloc] init];
+    ordering.pendingTransactionHashes = pendingTransactionHashes;
+    [ordering addAddresses:addresses startingAtIndex:0 internal:NO];
+    NSMutableOrderedSet<DSTransaction *> *sorted = [NSMutableOrderedSet orderedSetWithArray:transactions];
+    [ordering sortTransactions:sorted];
+    [self assertTransactionOrder:sorted];
+    XCTAssertEqual(sorted.lastObject, confirmed);
+
+    // parents arriving after their spenders, in every chain
+    __block uint32_t seed = 11;
+    for (uint32_t round = 0; round < 10; round++) {
+        NSMutableArray<DSTransaction *> *shuffled = [transactions mutableCopy];
+        for (NSUInteger i = shuffled.count - 1; i > 0; i--) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            [shuffled exchangeObjectAtIndex:i withObjectAtIndex:seed % (i + 1)];
+        }
+        NSMutableOrderedSet<DSTransaction *> *inserted = [NSMutableOrderedSet orderedSet];
+        for (DSTransaction *transaction in shuffled) {
+            [ordering insertTransaction:transaction intoTransactions:inserted];
+            [self assertTransactionOrder:inserted];
+        }
+        XCTAssertEqualObjects(inserted.array, sorted.array);
+    }
+}
+
+- (void)testAddressesDerivedAfterOrderingAreRanked {
+    DSChain *testnet = [DSChain testnet];
+    NSMutableArray<NSString *> *addresses = [NSMutableArray array];
+    NSMutableArray<NSData *> *scripts = [NSMutableArray array];
+    for (uint32_t i = 1; i <= 6; i++) {
+        NSMutableData *secret = [NSMutableData dataWithLength:28];
+        [secret appendUInt32:CFSwapInt32HostToBig(i)];
+        OpaqueKey *key = [DSKeyManager keyWithPrivateKeyData:secret ofType:KeyKind_ECDSA];
+        NSString *address = [DSKeyManager addressForKey:key forChainType:testnet.chainType];
+        [addresses addObject:address];
+        [scripts addObject:[DSKeyManager scriptPubKeyForAddress:address forChain:testnet]];
+        processor_destroy_opaque_key(key);
+    }
+    NSMutableArray<DSTransaction *> *transactions = [NSMutableArray array];
+    for (uint32_t i = 0; i < 6; i++) {
+        DSTransaction *transaction = [[DSTransaction alloc] initWithInputHashes:@[uint256_obj([NSData dataWithUInt32:i + UINT16_MAX].SHA256_2)]
+                                                                   inputIndexes:@[@0]
+                                                                   inputScripts:@[scripts[0]]
+                                                                outputAddresses:@[addresses[i]]
+                                                                  outputAmounts:@[@(100000)]
+                                                                        onChain:testnet];
+        transaction.txHash = [NSData dataWithUInt32:i].SHA256_2;
+        transaction.blockHeight = 1000;
+        [transactions addObject:transaction];
+    }
+
+    // the addresses are derived in two steps, the second after the transactions were ordered
+    DSTransactionOrdering *ordering = [[DSTransactionOrdering alloc] init];
+    [ordering addAddresses:[addresses subarrayWithRange:NSMakeRange(0, 3)] startingAtIndex:0 internal:NO];
+    NSMutableOrderedSet<DSTransaction *> *inserted = [NSMutableOrderedSet orderedSet];
+    for (DSTransaction *transaction in transactions) {
+        [ordering insertTransaction:transaction intoTransactions:inserted];
+    }
+    XCTAssertEqualObjects([inserted.array subarrayWithRange:NSMakeRange(0, 3)], [[transactions subarrayWithRange:NSMakeRange(0, 3)] reverseObjectEnumerator].allObjects);
+    [ordering addAddresses:[addresses subarrayWithRange:NSMakeRange(3, 3)] startingAtIndex:3 internal:NO];
+    // an address keeps its first rank
+    [ordering addAddresses:@[addresses[0]] startingAtIndex:10 internal:NO];
+    [ordering sortTransactions:inserted];
+    XCTAssertEqualObjects(inserted.array, [transactions reverseObjectEnumerator].allObjects);
+}
+
 /**
  * Inputs:
  * 1) hashes (in reversed byte-order) lexicographically in ASC.